@@ -4,8 +4,21 @@
 
 #include "frc/apriltag/AprilTagDetector.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <utility>
+#include <vector>
+
+#include <wpi/SmallVector.h>
+#include <wpi/function_ref.h>
 
 #ifdef _WIN32
 #pragma warning(disable : 4200)
@@ -21,6 +34,136 @@
 
 using namespace frc;
 
+namespace {
+
+// Worker threads shared by all detectors for batch detection.  A batch is a
+// set of independent tasks (one per image); the calling thread and any idle
+// workers that pick up the batch claim its tasks one at a time until none
+// are left, so a slow image doesn't hold up the others.
+class BatchWorkerPool {
+ public:
+  static BatchWorkerPool& GetInstance() {
+    static BatchWorkerPool instance;
+    return instance;
+  }
+
+  ~BatchWorkerPool();
+
+  // Runs func(0) to func(numTasks - 1) on the calling thread and up to
+  // numHelpers worker threads; returns when all tasks have completed.
+  void Run(size_t numTasks, size_t numHelpers,
+           wpi::function_ref<void(size_t)> func);
+
+ private:
+  struct Batch {
+    Batch(size_t numTasks, wpi::function_ref<void(size_t)> func)
+        : numTasks{numTasks}, func{func} {}
+
+    size_t numTasks;
+    wpi::function_ref<void(size_t)> func;
+    std::atomic<size_t> next{0};
+    int numActive = 0;  // helpers running tasks; protected by m_mutex
+  };
+
+  static void RunTasks(Batch& batch);
+  void WorkerMain();
+
+  std::mutex m_mutex;
+  std::condition_variable m_workCond;
+  std::condition_variable m_doneCond;
+  // one entry per helper requested by each batch
+  std::deque<Batch*> m_queue;
+  std::vector<std::thread> m_threads;
+  bool m_stop = false;
+};
+
+}  // namespace
+
+BatchWorkerPool::~BatchWorkerPool() {
+  {
+    std::scoped_lock lock{m_mutex};
+    m_stop = true;
+  }
+  m_workCond.notify_all();
+  for (auto&& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void BatchWorkerPool::Run(size_t numTasks, size_t numHelpers,
+                          wpi::function_ref<void(size_t)> func) {
+  Batch batch{numTasks, func};
+  numHelpers = (std::min)(numHelpers, numTasks - 1);
+  if (numHelpers > 0) {
+    std::scoped_lock lock{m_mutex};
+    // don't create more threads than the hardware can run
+    size_t maxThreads = (std::max)(std::thread::hardware_concurrency(), 2u) - 1;
+    while (m_threads.size() < (std::min)(numHelpers, maxThreads)) {
+      m_threads.emplace_back([this] { WorkerMain(); });
+    }
+    m_queue.insert(m_queue.end(), numHelpers, &batch);
+  }
+  m_workCond.notify_all();
+
+  RunTasks(batch);
+
+  // All tasks have been claimed; remove helper requests that weren't picked
+  // up and wait for helpers still running tasks
+  std::unique_lock lock{m_mutex};
+  m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), &batch),
+                m_queue.end());
+  m_doneCond.wait(lock, [&] { return batch.numActive == 0; });
+}
+
+void BatchWorkerPool::RunTasks(Batch& batch) {
+  for (;;) {
+    size_t i = batch.next++;
+    if (i >= batch.numTasks) {
+      return;
+    }
+    batch.func(i);
+  }
+}
+
+void BatchWorkerPool::WorkerMain() {
+  std::unique_lock lock{m_mutex};
+  for (;;) {
+    m_workCond.wait(lock, [&] { return m_stop || !m_queue.empty(); });
+    if (m_stop) {
+      return;
+    }
+    Batch* batch = m_queue.front();
+    m_queue.pop_front();
+    ++batch->numActive;
+    lock.unlock();
+    RunTasks(*batch);
+    lock.lock();
+    --batch->numActive;
+    m_doneCond.notify_all();
+  }
+}
+
+namespace {
+
+// Moves a detection made in a region of an image into the coordinates of
+// the full image
+void OffsetDetection(apriltag_detection_t* det, int dx, int dy) {
+  det->c[0] += dx;
+  det->c[1] += dy;
+  for (auto&& p : det->p) {
+    p[0] += dx;
+    p[1] += dy;
+  }
+  // H maps tag coordinates to homogeneous image coordinates, so prepend a
+  // translation
+  for (int col = 0; col < 3; ++col) {
+    MATD_EL(det->H, 0, col) += dx * MATD_EL(det->H, 2, col);
+    MATD_EL(det->H, 1, col) += dy * MATD_EL(det->H, 2, col);
+  }
+}
+
+}  // namespace
+
 AprilTagDetector::Results::Results(void* impl, const private_init&)
     : span{reinterpret_cast<AprilTagDetection**>(
                static_cast<zarray_t*>(impl)->data),
@@ -48,9 +191,15 @@ AprilTagDetector& AprilTagDetector::operator=(AprilTagDetector&& rhs) {
   Destroy();
   m_impl = rhs.m_impl;
   rhs.m_impl = nullptr;
+  m_batchImpls = std::move(rhs.m_batchImpls);
+  rhs.m_batchImpls.clear();
   m_families = std::move(rhs.m_families);
   rhs.m_families.clear();
   m_qtpCriticalAngle = rhs.m_qtpCriticalAngle;
+  m_tracking = rhs.m_tracking;
+  m_trackedRegions = std::move(rhs.m_trackedRegions);
+  m_numTracked = rhs.m_numTracked;
+  m_framesSinceFullSearch = rhs.m_framesSinceFullSearch;
   return *this;
 }
 
@@ -103,6 +252,18 @@ AprilTagDetector::GetQuadThresholdParameters() const {
   };
 }
 
+void AprilTagDetector::SetTrackingParameters(
+    const TrackingParameters& params) {
+  m_tracking = params;
+  ResetTracking();
+}
+
+void AprilTagDetector::ResetTracking() {
+  m_trackedRegions.clear();
+  m_numTracked = 0;
+  m_framesSinceFullSearch = 0;
+}
+
 bool AprilTagDetector::AddFamily(std::string_view fam, int bitsCorrected) {
   auto& data = m_families[fam];
   if (data) {
@@ -143,13 +304,178 @@ void AprilTagDetector::ClearFamilies() {
 
 AprilTagDetector::Results AprilTagDetector::Detect(int width, int height,
                                                    int stride, uint8_t* buf) {
-  image_u8_t img{width, height, stride, buf};
-  return {
-      apriltag_detector_detect(static_cast<apriltag_detector_t*>(m_impl), &img),
-      Results::private_init{}};
+  if (!m_tracking.enabled) {
+    image_u8_t img{width, height, stride, buf};
+    return {apriltag_detector_detect(static_cast<apriltag_detector_t*>(m_impl),
+                                     &img),
+            Results::private_init{}};
+  }
+
+  zarray_t* detections = nullptr;
+  ++m_framesSinceFullSearch;
+  if (m_numTracked > 0 &&
+      m_framesSinceFullSearch < m_tracking.fullFrameInterval) {
+    detections =
+        static_cast<zarray_t*>(DetectRegions(width, height, stride, buf));
+  }
+  if (!detections) {
+    image_u8_t img{width, height, stride, buf};
+    detections = apriltag_detector_detect(
+        static_cast<apriltag_detector_t*>(m_impl), &img);
+    m_framesSinceFullSearch = 0;
+  }
+  UpdateTracking(detections, width, height);
+  return {detections, Results::private_init{}};
+}
+
+void* AprilTagDetector::DetectRegions(int width, int height, int stride,
+                                      uint8_t* buf) {
+  // regions from a different image size are meaningless, and if the regions
+  // cover most of the image, searching them isn't worth it
+  int64_t area = 0;
+  for (auto&& region : m_trackedRegions) {
+    if (region.x1 > width || region.y1 > height) {
+      return nullptr;
+    }
+    area += static_cast<int64_t>(region.x1 - region.x0) *
+            (region.y1 - region.y0);
+  }
+  if (area * 2 > static_cast<int64_t>(width) * height) {
+    return nullptr;
+  }
+
+  auto impl = static_cast<apriltag_detector_t*>(m_impl);
+  zarray_t* detections = zarray_create(sizeof(apriltag_detection_t*));
+  for (auto&& region : m_trackedRegions) {
+    image_u8_t img{region.x1 - region.x0, region.y1 - region.y0, stride,
+                   buf + region.y0 * stride + region.x0};
+    zarray_t* regionDetections = apriltag_detector_detect(impl, &img);
+    for (int i = 0; i < zarray_size(regionDetections); ++i) {
+      apriltag_detection_t* det;
+      zarray_get(regionDetections, i, &det);
+      OffsetDetection(det, region.x0, region.y0);
+      zarray_add(detections, &det);
+    }
+    zarray_destroy(regionDetections);
+  }
+
+  // if a tag was lost, it may have moved out of its region, so search the
+  // full frame instead
+  if (zarray_size(detections) < m_numTracked) {
+    apriltag_detections_destroy(detections);
+    return nullptr;
+  }
+  return detections;
+}
+
+void AprilTagDetector::UpdateTracking(void* detections, int width,
+                                      int height) {
+  auto dets = static_cast<zarray_t*>(detections);
+  m_numTracked = zarray_size(dets);
+  m_trackedRegions.clear();
+  auto& impl = *static_cast<apriltag_detector_t*>(m_impl);
+  int align = (std::max)(static_cast<int>(impl.quad_decimate), 1);
+  for (int i = 0; i < m_numTracked; ++i) {
+    apriltag_detection_t* det;
+    zarray_get(dets, i, &det);
+    double minX = det->p[0][0];
+    double maxX = minX;
+    double minY = det->p[0][1];
+    double maxY = minY;
+    for (auto&& p : det->p) {
+      minX = (std::min)(minX, p[0]);
+      maxX = (std::max)(maxX, p[0]);
+      minY = (std::min)(minY, p[1]);
+      maxY = (std::max)(maxY, p[1]);
+    }
+    double size = (std::max)(maxX - minX, maxY - minY);
+    double margin = (std::max)(m_tracking.marginScale * size,
+                               static_cast<double>(m_tracking.minMargin));
+    // align the region to the decimation grid so quads are found at the
+    // same positions as in a full-frame search
+    int x0 = (std::max)(static_cast<int>(std::floor(minX - margin)), 0);
+    int y0 = (std::max)(static_cast<int>(std::floor(minY - margin)), 0);
+    Region region{
+        x0 - x0 % align, y0 - y0 % align,
+        (std::min)(static_cast<int>(std::ceil(maxX + margin)) + 1, width),
+        (std::min)(static_cast<int>(std::ceil(maxY + margin)) + 1, height)};
+
+    // merge with any overlapping regions so no tag is detected twice
+    for (auto it = m_trackedRegions.begin(); it != m_trackedRegions.end();) {
+      if (it->x0 < region.x1 && region.x0 < it->x1 && it->y0 < region.y1 &&
+          region.y0 < it->y1) {
+        region.x0 = (std::min)(region.x0, it->x0);
+        region.y0 = (std::min)(region.y0, it->y0);
+        region.x1 = (std::max)(region.x1, it->x1);
+        region.y1 = (std::max)(region.y1, it->y1);
+        m_trackedRegions.erase(it);
+        it = m_trackedRegions.begin();  // merged region may overlap others
+      } else {
+        ++it;
+      }
+    }
+    m_trackedRegions.emplace_back(region);
+  }
+}
+
+std::vector<AprilTagDetector::Results> AprilTagDetector::Detect(
+    std::span<const Image> images) {
+  std::vector<Results> results;
+  if (images.empty()) {
+    return results;
+  }
+  auto& impl = *static_cast<apriltag_detector_t*>(m_impl);
+
+  // Each image gets its own detector with the same configuration and
+  // families.  The families are shared (their decode tables are read-only
+  // during detection), so they're added directly rather than through
+  // apriltag_detector_add_family_bits().
+  int numImages = images.size();
+  int numThreads = (std::max)(impl.nthreads, 1);
+  int threadsPerImage = (std::max)(numThreads / numImages, 1);
+  while (m_batchImpls.size() < images.size()) {
+    m_batchImpls.emplace_back(apriltag_detector_create());
+  }
+  for (int i = 0; i < numImages; ++i) {
+    auto& batchImpl = *static_cast<apriltag_detector_t*>(m_batchImpls[i]);
+    batchImpl.nthreads = threadsPerImage;
+    batchImpl.quad_decimate = impl.quad_decimate;
+    batchImpl.quad_sigma = impl.quad_sigma;
+    batchImpl.refine_edges = impl.refine_edges;
+    batchImpl.decode_sharpening = impl.decode_sharpening;
+    batchImpl.debug = impl.debug;
+    batchImpl.qtp = impl.qtp;
+    zarray_clear(batchImpl.tag_families);
+    for (int j = 0; j < zarray_size(impl.tag_families); ++j) {
+      apriltag_family_t* fam;
+      zarray_get(impl.tag_families, j, &fam);
+      zarray_add(batchImpl.tag_families, &fam);
+    }
+  }
+
+  wpi::SmallVector<zarray_t*, 4> detections(images.size());
+  BatchWorkerPool::GetInstance().Run(
+      images.size(), (std::min)(numThreads, numImages) - 1, [&](size_t i) {
+        image_u8_t img{images[i].width, images[i].height, images[i].stride,
+                       images[i].buf};
+        detections[i] = apriltag_detector_detect(
+            static_cast<apriltag_detector_t*>(m_batchImpls[i]), &img);
+      });
+
+  results.reserve(images.size());
+  for (auto&& detection : detections) {
+    results.emplace_back(detection, Results::private_init{});
+  }
+  return results;
 }
 
 void AprilTagDetector::Destroy() {
+  for (auto batchImpl : m_batchImpls) {
+    // the families belong to the main detector
+    zarray_clear(static_cast<apriltag_detector_t*>(batchImpl)->tag_families);
+    apriltag_detector_destroy(static_cast<apriltag_detector_t*>(batchImpl));
+  }
+  m_batchImpls.clear();
   if (m_impl) {
     apriltag_detector_destroy(static_cast<apriltag_detector_t*>(m_impl));
   }
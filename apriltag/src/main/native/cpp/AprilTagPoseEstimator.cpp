@@ -4,9 +4,17 @@
 
 #include "frc/apriltag/AprilTagPoseEstimator.h"
 
+#include <array>
+#include <cmath>
+#include <optional>
+
+#include <Eigen/Cholesky>
+#include <Eigen/Geometry>
 #include <Eigen/QR>
+#include <wpi/SmallVector.h>
 
 #include "frc/apriltag/AprilTagDetection.h"
+#include "frc/apriltag/AprilTagFieldLayout.h"
 
 #ifdef _WIN32
 #pragma warning(disable : 4200)
@@ -42,16 +50,22 @@ static Eigen::Matrix3d OrthogonalizeRotationMatrix(
   return Q;
 }
 
+// Converts a pose and frees its matrices
 static Transform3d MakePose(const apriltag_pose_t& pose) {
   if (!pose.R || !pose.t) {
+    matd_destroy(pose.R);
+    matd_destroy(pose.t);
     return {};
   }
-  return {Translation3d{units::meter_t{pose.t->data[0]},
-                        units::meter_t{pose.t->data[1]},
-                        units::meter_t{pose.t->data[2]}},
-          Rotation3d{OrthogonalizeRotationMatrix(
-              Eigen::Map<Eigen::Matrix<double, 3, 3, Eigen::RowMajor>>{
-                  pose.R->data})}};
+  Transform3d rv{Translation3d{units::meter_t{pose.t->data[0]},
+                               units::meter_t{pose.t->data[1]},
+                               units::meter_t{pose.t->data[2]}},
+                 Rotation3d{OrthogonalizeRotationMatrix(
+                     Eigen::Map<Eigen::Matrix<double, 3, 3, Eigen::RowMajor>>{
+                         pose.R->data})}};
+  matd_destroy(pose.R);
+  matd_destroy(pose.t);
+  return rv;
 }
 
 static apriltag_detection_info_t MakeDetectionInfo(
@@ -152,3 +166,163 @@ Transform3d AprilTagPoseEstimator::Estimate(
   matd_destroy(detection.H);
   return rv;
 }
+
+namespace {
+
+// A tag corner on the field and where it was seen in the image
+struct CornerObservation {
+  Eigen::Vector3d fieldPoint;
+  Eigen::Vector2d pixel;
+};
+
+}  // namespace
+
+// Gets the corners of a tag in field layout tag coordinates, in detection
+// corner order (bottom left, bottom right, top right, top left, as seen facing
+// the tag). The tag's +X axis points out of its face and +Z up, so +Y is to
+// the right of someone facing the tag.
+static std::array<Eigen::Vector3d, 4> GetTagCorners(units::meter_t tagSize) {
+  double s = tagSize.value() / 2;
+  return {Eigen::Vector3d{0, -s, -s}, Eigen::Vector3d{0, s, -s},
+          Eigen::Vector3d{0, s, s}, Eigen::Vector3d{0, -s, s}};
+}
+
+// Converts a single-tag estimate (camera +X right, +Y down, +Z forward; tag
+// +X right, +Y down, +Z into the tag) into a camera pose on the field
+static Pose3d GetCameraPose(const Pose3d& tagPose,
+                            const Transform3d& cameraToTag) {
+  // camera axes: East-Down-North to North-West-Up
+  const Eigen::Matrix3d C{{0, 0, 1}, {-1, 0, 0}, {0, -1, 0}};
+  // field layout tag axes in detector tag coordinates
+  const Eigen::Matrix3d D{{0, 1, 0}, {0, 0, -1}, {-1, 0, 0}};
+  Transform3d transform{
+      Translation3d{Eigen::Vector3d{C * cameraToTag.Translation().ToVector()}},
+      Rotation3d{Eigen::Matrix3d{C * cameraToTag.Rotation().ToMatrix() * D}}};
+  return tagPose.TransformBy(transform.Inverse());
+}
+
+// Computes the normal equations for a camera pose (R, t): J^T J and J^T r,
+// where J is the Jacobian of the corner pixel positions with respect to a
+// perturbation (translation, then rotation) in camera coordinates and r is
+// the reprojection residuals. Returns the sum of squared residuals, or NaN if
+// a corner is behind the camera.
+static double Linearize(std::span<const CornerObservation> observations,
+                        const AprilTagPoseEstimator::Config& config,
+                        const Eigen::Matrix3d& R, const Eigen::Vector3d& t,
+                        Eigen::Matrix<double, 6, 6>* JtJ,
+                        Eigen::Vector<double, 6>* Jtr) {
+  JtJ->setZero();
+  Jtr->setZero();
+  double sse = 0;
+  for (auto&& obs : observations) {
+    // point in camera coordinates (+X forward, +Y left, +Z up)
+    Eigen::Vector3d P = R.transpose() * (obs.fieldPoint - t);
+    if (P.x() <= 1e-6) {
+      return NAN;
+    }
+    // project into the image (+u right, +v down)
+    double invZ = 1 / P.x();
+    double x = -P.y() * invZ;
+    double y = -P.z() * invZ;
+    Eigen::Vector2d r{obs.pixel.x() - (config.fx * x + config.cx),
+                      obs.pixel.y() - (config.fy * y + config.cy)};
+    sse += r.squaredNorm();
+
+    Eigen::Matrix<double, 2, 3> dUVdP{
+        {-config.fx * x * invZ, -config.fx * invZ, 0},
+        {-config.fy * y * invZ, 0, -config.fy * invZ}};
+    // a perturbation (dt, dr) of the camera moves P by -dt + P x dr
+    Eigen::Matrix<double, 3, 6> dPdX;
+    dPdX.leftCols<3>() = -Eigen::Matrix3d::Identity();
+    dPdX.rightCols<3>() << 0, -P.z(), P.y(), P.z(), 0, -P.x(), -P.y(), P.x(),
+        0;
+    Eigen::Matrix<double, 2, 6> J = dUVdP * dPdX;
+    *JtJ += J.transpose() * J;
+    *Jtr += J.transpose() * r;
+  }
+  return sse;
+}
+
+std::optional<AprilTagMultiTagPoseEstimate>
+AprilTagPoseEstimator::EstimateMultiTag(
+    std::span<const AprilTagDetection* const> detections,
+    const AprilTagFieldLayout& layout,
+    std::optional<Pose3d> initialGuess) const {
+  constexpr int kMaxIterations = 20;
+
+  auto tagCorners = GetTagCorners(m_config.tagSize);
+  wpi::SmallVector<CornerObservation, 32> observations;
+  const AprilTagDetection* largest = nullptr;
+  Pose3d largestPose;
+  double largestArea = 0;
+  int numTags = 0;
+  for (auto detection : detections) {
+    auto tagPose = layout.GetTagPose(detection->GetId());
+    if (!tagPose) {
+      continue;
+    }
+    ++numTags;
+    Eigen::Matrix3d R = tagPose->Rotation().ToMatrix();
+    Eigen::Vector3d t = tagPose->Translation().ToVector();
+    double area = 0;
+    for (int i = 0; i < 4; ++i) {
+      auto& corner = detection->GetCorner(i);
+      auto& next = detection->GetCorner((i + 1) % 4);
+      observations.emplace_back(R * tagCorners[i] + t,
+                                Eigen::Vector2d{corner.x, corner.y});
+      area += corner.x * next.y - next.x * corner.y;
+    }
+    if (std::abs(area) > largestArea) {
+      largest = detection;
+      largestPose = *tagPose;
+      largestArea = std::abs(area);
+    }
+  }
+  if (numTags == 0) {
+    return std::nullopt;
+  }
+
+  if (!initialGuess) {
+    initialGuess = GetCameraPose(largestPose, Estimate(*largest));
+  }
+  Eigen::Matrix3d R = initialGuess->Rotation().ToMatrix();
+  Eigen::Vector3d t = initialGuess->Translation().ToVector();
+
+  // Gauss-Newton iteration
+  Eigen::Matrix<double, 6, 6> JtJ;
+  Eigen::Vector<double, 6> Jtr;
+  double sse = 0;
+  for (int iter = 0; iter < kMaxIterations; ++iter) {
+    sse = Linearize(observations, m_config, R, t, &JtJ, &Jtr);
+    if (!std::isfinite(sse)) {
+      return std::nullopt;
+    }
+    Eigen::Vector<double, 6> dx = JtJ.ldlt().solve(Jtr);
+    if (!dx.allFinite()) {
+      return std::nullopt;
+    }
+    t += R * dx.head<3>();
+    if (double angle = dx.tail<3>().norm(); angle > 0) {
+      R = R * Eigen::AngleAxisd{angle, dx.tail<3>() / angle}.toRotationMatrix();
+    }
+    if (dx.squaredNorm() < 1e-20) {
+      break;
+    }
+  }
+  sse = Linearize(observations, m_config, R, t, &JtJ, &Jtr);
+  if (!std::isfinite(sse)) {
+    return std::nullopt;
+  }
+
+  // rotate the covariance from camera to field coordinates
+  Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Zero();
+  A.topLeftCorner<3, 3>() = R;
+  A.bottomRightCorner<3, 3>() = R;
+  Eigen::Matrix<double, 6, 6> covariance =
+      A * JtJ.ldlt().solve(Eigen::Matrix<double, 6, 6>::Identity()) *
+      A.transpose();
+
+  return AprilTagMultiTagPoseEstimate{
+      Pose3d{Translation3d{t}, Rotation3d{R}}, covariance,
+      std::sqrt(sse / observations.size()), numTags};
+}
@@ -10,6 +10,7 @@
 #include <span>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <units/angle.h>
 #include <wpi/StringMap.h>
@@ -124,6 +125,41 @@ class WPILIB_DLLEXPORT AprilTagDetector {
     bool deglitch = false;
   };
 
+  /** Tracking parameters. */
+  struct TrackingParameters {
+    bool operator==(const TrackingParameters&) const = default;
+
+    /**
+     * Whether tracking is enabled. When enabled, Detect() only searches the
+     * regions around the tags detected in the previous frame, which is much
+     * faster than searching the full frame when tags move little between
+     * frames. The full frame is still searched periodically (see
+     * fullFrameInterval) to find new tags, and whenever a tracked tag is
+     * lost or no tags are being tracked. Default is disabled (false).
+     */
+    bool enabled = false;
+
+    /**
+     * How often (in frames) the full frame is searched when tracking. For
+     * example, 10 means every 10th frame is a full-frame search. Values of 1
+     * or less search the full frame every frame. Default is 10.
+     */
+    int fullFrameInterval = 10;
+
+    /**
+     * How far to expand the search region around each tracked tag, as a
+     * fraction of the tag's size in the previous frame. Larger values allow
+     * for faster motion. Default is 0.5.
+     */
+    double marginScale = 0.5;
+
+    /**
+     * Minimum expansion of the search region around each tracked tag, in
+     * pixels. Default is 16 pixels.
+     */
+    int minMargin = 16;
+  };
+
   /**
    * Array of detection results. Each array element is a pointer to an
    * AprilTagDetection.
@@ -155,8 +191,13 @@ class WPILIB_DLLEXPORT AprilTagDetector {
   AprilTagDetector& operator=(const AprilTagDetector&) = delete;
   AprilTagDetector(AprilTagDetector&& rhs)
       : m_impl{rhs.m_impl},
+        m_batchImpls{std::move(rhs.m_batchImpls)},
         m_families{std::move(rhs.m_families)},
-        m_qtpCriticalAngle{rhs.m_qtpCriticalAngle} {
+        m_qtpCriticalAngle{rhs.m_qtpCriticalAngle},
+        m_tracking{rhs.m_tracking},
+        m_trackedRegions{std::move(rhs.m_trackedRegions)},
+        m_numTracked{rhs.m_numTracked},
+        m_framesSinceFullSearch{rhs.m_framesSinceFullSearch} {
     rhs.m_impl = nullptr;
   }
   AprilTagDetector& operator=(AprilTagDetector&& rhs);
@@ -194,6 +235,27 @@ class WPILIB_DLLEXPORT AprilTagDetector {
    */
   QuadThresholdParameters GetQuadThresholdParameters() const;
 
+  /**
+   * Sets tracking parameters. Changing the parameters resets tracking.
+   *
+   * @param params Parameters
+   */
+  void SetTrackingParameters(const TrackingParameters& params);
+
+  /**
+   * Gets tracking parameters.
+   *
+   * @return Parameters
+   */
+  TrackingParameters GetTrackingParameters() const { return m_tracking; }
+
+  /**
+   * Forgets the tags tracked from previous frames, so the next call to
+   * Detect() searches the full frame. Call this when switching between
+   * cameras or after a discontinuity in the image stream.
+   */
+  void ResetTracking();
+
   /** @} */
 
   /**
@@ -228,6 +290,9 @@ class WPILIB_DLLEXPORT AprilTagDetector {
    * Detect tags from an 8-bit image.
    * The image must be grayscale.
    *
+   * If tracking is enabled (see SetTrackingParameters()), this may search
+   * only the regions around the tags detected by the previous call.
+   *
    * @param width width of the image
    * @param height height of the image
    * @param stride number of bytes between image rows (often the same as width)
@@ -249,14 +314,62 @@ class WPILIB_DLLEXPORT AprilTagDetector {
     return Detect(width, height, width, buf);
   }
 
+  /** An 8-bit grayscale image, for detecting tags from several images. */
+  struct Image {
+    /** Width of the image */
+    int width;
+
+    /** Height of the image */
+    int height;
+
+    /** Number of bytes between image rows (often the same as width) */
+    int stride;
+
+    /** Image buffer */
+    uint8_t* buf;
+  };
+
+  /**
+   * Detect tags from several 8-bit images at once (e.g. one image from each
+   * of several cameras). The images must be grayscale.
+   *
+   * Instead of processing each image in turn, the images are processed
+   * concurrently on a pool of worker threads shared by all detectors, so
+   * that several cameras don't each need their own threads. The configured
+   * number of threads is the total for the batch, including the calling
+   * thread; if there are more threads than images, the extra threads are
+   * split among the images.
+   *
+   * @param images images
+   * @return Results for each image, in the same order as images
+   */
+  std::vector<Results> Detect(std::span<const Image> images);
+
  private:
   void Destroy();
   void DestroyFamilies();
   void DestroyFamily(std::string_view name, void* data);
 
+  // image region (in pixels) around one or more tracked tags
+  struct Region {
+    int x0;
+    int y0;
+    int x1;  // exclusive
+    int y1;  // exclusive
+  };
+
+  void* DetectRegions(int width, int height, int stride, uint8_t* buf);
+  void UpdateTracking(void* detections, int width, int height);
+
   void* m_impl;
+  // detectors for each image of a batch (see Detect(span))
+  std::vector<void*> m_batchImpls;
   wpi::StringMap<void*> m_families;
   units::radian_t m_qtpCriticalAngle = 10_deg;
+  TrackingParameters m_tracking;
+  std::vector<Region> m_trackedRegions;
+  int m_numTracked = 0;
+  int m_framesSinceFullSearch = 0;
 };
 
 }  // namespace frc
@@ -0,0 +1,37 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <Eigen/Core>
+#include <wpi/SymbolExports.h>
+
+#include "frc/geometry/Pose3d.h"
+
+namespace frc {
+
+/** A camera pose estimate from all of the tags seen in one image. */
+struct WPILIB_DLLEXPORT AprilTagMultiTagPoseEstimate {
+  /**
+   * Pose of the camera on the field. The camera looks along its +X axis,
+   * with +Y to the left and +Z up.
+   */
+  Pose3d pose;
+
+  /**
+   * Covariance of the pose, assuming corner positions with 1 pixel standard
+   * deviation (scale by the square of the actual standard deviation). The
+   * first three rows/columns are the translation and the last three are the
+   * rotation (as a small rotation vector), both in field coordinates.
+   */
+  Eigen::Matrix<double, 6, 6> covariance;
+
+  /** Root mean square corner reprojection error, in pixels. */
+  double error;
+
+  /** Number of tags used for the estimate. */
+  int numTags;
+};
+
+}  // namespace frc
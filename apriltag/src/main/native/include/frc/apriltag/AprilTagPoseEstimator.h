@@ -4,17 +4,21 @@
 
 #pragma once
 
+#include <optional>
 #include <span>
 
 #include <units/length.h>
 #include <wpi/SymbolExports.h>
 
+#include "frc/apriltag/AprilTagMultiTagPoseEstimate.h"
 #include "frc/apriltag/AprilTagPoseEstimate.h"
+#include "frc/geometry/Pose3d.h"
 #include "frc/geometry/Transform3d.h"
 
 namespace frc {
 
 class AprilTagDetection;
+class AprilTagFieldLayout;
 
 /** Pose estimators for AprilTag tags. */
 class WPILIB_DLLEXPORT AprilTagPoseEstimator {
@@ -138,6 +142,31 @@ class WPILIB_DLLEXPORT AprilTagPoseEstimator {
   Transform3d Estimate(std::span<const double, 9> homography,
                        std::span<const double, 8> corners) const;
 
+  /**
+   * Estimates the camera pose on the field from all of the tags detected in
+   * one image, using the tag poses in a field layout. This minimizes the
+   * reprojection error of all of the tag corners at once with Gauss-Newton
+   * iteration, so it's more accurate than combining single-tag estimates and
+   * isn't subject to single-tag pose ambiguity.
+   *
+   * The iteration starts from initialGuess if provided; the previous frame's
+   * estimate is usually a good guess and makes convergence faster. Otherwise
+   * it starts from the single-tag estimate of the largest tag.
+   *
+   * Multiply the camera pose by the inverse of the robot-to-camera transform
+   * to get the robot pose.
+   *
+   * @param detections Tag detections (tags not in the layout are ignored)
+   * @param layout Field layout
+   * @param initialGuess Initial camera pose estimate (optional)
+   * @return Pose estimate, or std::nullopt if none of the tags are in the
+   *         layout or the iteration failed
+   */
+  std::optional<AprilTagMultiTagPoseEstimate> EstimateMultiTag(
+      std::span<const AprilTagDetection* const> detections,
+      const AprilTagFieldLayout& layout,
+      std::optional<Pose3d> initialGuess = std::nullopt) const;
+
  private:
   Config m_config;
 };
@@ -2,12 +2,53 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <vector>
+
 #include <gtest/gtest.h>
+#include <wpi/RawFrame.h>
 
+#include "frc/apriltag/AprilTag.h"
 #include "frc/apriltag/AprilTagDetector.h"
 
 using namespace frc;
 
+namespace {
+constexpr int kTagScale = 10;
+
+// Draws a tag36h11 tag, scaled up, with its top left corner at (x, y)
+void DrawTag(std::vector<uint8_t>& buf, int width, int id, int x, int y) {
+  wpi::RawFrame tag;
+  AprilTag::Generate36h11AprilTagImage(&tag, id);
+  for (int ty = 0; ty < tag.height * kTagScale; ++ty) {
+    for (int tx = 0; tx < tag.width * kTagScale; ++tx) {
+      buf[(y + ty) * width + x + tx] =
+          tag.data[(ty / kTagScale) * tag.stride + tx / kTagScale];
+    }
+  }
+}
+
+// Renders a tag36h11 tag centered on a white background
+std::vector<uint8_t> RenderTag(int id, int size) {
+  std::vector<uint8_t> buf(size * size, 255);
+  int offset = (size - 10 * kTagScale) / 2;
+  DrawTag(buf, size, id, offset, offset);
+  return buf;
+}
+
+std::vector<int> GetIds(const AprilTagDetector::Results& results) {
+  std::vector<int> ids;
+  for (auto&& detection : results) {
+    ids.emplace_back(detection->GetId());
+  }
+  return ids;
+}
+}  // namespace
+
 TEST(AprilTagDetectorTest, ConfigDefaults) {
   AprilTagDetector detector;
   auto config = detector.GetConfig();
@@ -61,3 +102,115 @@ TEST(AprilTagDetectorTest, RemoveFamily) {
   detector.AddFamily("tag16h5");
   detector.RemoveFamily("tag16h5");
 }
+
+TEST(AprilTagDetectorTest, DetectBatch) {
+  constexpr int kSize = 200;
+  AprilTagDetector detector;
+  detector.AddFamily("tag36h11");
+  detector.SetConfig({.numThreads = 4});
+
+  std::vector<std::vector<uint8_t>> bufs;
+  std::vector<AprilTagDetector::Image> images;
+  for (int id : {1, 5, 12, 27, 3}) {
+    bufs.emplace_back(RenderTag(id, kSize));
+  }
+  for (auto&& buf : bufs) {
+    images.push_back({kSize, kSize, kSize, buf.data()});
+  }
+
+  auto results = detector.Detect(images);
+  ASSERT_EQ(results.size(), images.size());
+  EXPECT_EQ(GetIds(results[0]), std::vector<int>{1});
+  EXPECT_EQ(GetIds(results[1]), std::vector<int>{5});
+  EXPECT_EQ(GetIds(results[2]), std::vector<int>{12});
+  EXPECT_EQ(GetIds(results[3]), std::vector<int>{27});
+  EXPECT_EQ(GetIds(results[4]), std::vector<int>{3});
+
+  // same as detecting each image individually
+  for (size_t i = 0; i < images.size(); ++i) {
+    auto single = detector.Detect(kSize, kSize, bufs[i].data());
+    EXPECT_EQ(GetIds(single), GetIds(results[i]));
+  }
+
+  // a smaller batch reuses the per-image detectors
+  auto results2 = detector.Detect(std::span{images}.subspan(3));
+  ASSERT_EQ(results2.size(), 2u);
+  EXPECT_EQ(GetIds(results2[0]), std::vector<int>{27});
+  EXPECT_EQ(GetIds(results2[1]), std::vector<int>{3});
+}
+
+TEST(AprilTagDetectorTest, DetectBatchEmpty) {
+  AprilTagDetector detector;
+  detector.AddFamily("tag36h11");
+  ASSERT_TRUE(detector.Detect(std::span<const AprilTagDetector::Image>{})
+                  .empty());
+}
+
+TEST(AprilTagDetectorTest, TrackingDefaults) {
+  AprilTagDetector detector;
+  auto params = detector.GetTrackingParameters();
+  ASSERT_EQ(params, AprilTagDetector::TrackingParameters{});
+}
+
+TEST(AprilTagDetectorTest, Tracking) {
+  constexpr int kWidth = 640;
+  constexpr int kHeight = 480;
+  AprilTagDetector detector;
+  detector.AddFamily("tag36h11");
+  detector.SetTrackingParameters({.enabled = true, .fullFrameInterval = 3});
+  AprilTagDetector reference;
+  reference.AddFamily("tag36h11");
+
+  auto render = [&](std::initializer_list<std::array<int, 3>> tags) {
+    std::vector<uint8_t> buf(kWidth * kHeight, 255);
+    for (auto&& [id, x, y] : tags) {
+      DrawTag(buf, kWidth, id, x, y);
+    }
+    return buf;
+  };
+  auto expectSame = [&](std::vector<uint8_t>& buf) {
+    auto tracked = detector.Detect(kWidth, kHeight, buf.data());
+    auto full = reference.Detect(kWidth, kHeight, buf.data());
+    // tracked results may be in a different order
+    std::vector<const AprilTagDetection*> results{tracked.begin(),
+                                                  tracked.end()};
+    std::vector<const AprilTagDetection*> expected{full.begin(), full.end()};
+    ASSERT_EQ(results.size(), expected.size());
+    std::sort(results.begin(), results.end(),
+              [](auto a, auto b) { return a->GetId() < b->GetId(); });
+    std::sort(expected.begin(), expected.end(),
+              [](auto a, auto b) { return a->GetId() < b->GetId(); });
+    for (size_t i = 0; i < results.size(); ++i) {
+      EXPECT_EQ(results[i]->GetId(), expected[i]->GetId());
+      EXPECT_NEAR(results[i]->GetCenter().x, expected[i]->GetCenter().x, 0.1);
+      EXPECT_NEAR(results[i]->GetCenter().y, expected[i]->GetCenter().y, 0.1);
+      for (int j = 0; j < 4; ++j) {
+        EXPECT_NEAR(results[i]->GetCorner(j).x, expected[i]->GetCorner(j).x,
+                    0.1);
+        EXPECT_NEAR(results[i]->GetCorner(j).y, expected[i]->GetCorner(j).y,
+                    0.1);
+      }
+      EXPECT_NEAR(results[i]->GetHomography()[2],
+                  expected[i]->GetHomography()[2], 0.1);
+      EXPECT_NEAR(results[i]->GetHomography()[5],
+                  expected[i]->GetHomography()[5], 0.1);
+    }
+  };
+
+  // full frame, then tracked as the tags move a little
+  auto frame = render({{{1, 50, 50}}, {{2, 400, 300}}});
+  expectSame(frame);
+  frame = render({{{1, 56, 53}}, {{2, 395, 306}}});
+  expectSame(frame);
+  frame = render({{{1, 62, 56}}, {{2, 390, 312}}});
+  expectSame(frame);
+
+  // a new tag is found on the next full-frame search
+  frame = render({{{1, 62, 56}}, {{2, 390, 312}}, {{3, 250, 50}}});
+  auto results = detector.Detect(kWidth, kHeight, frame.data());
+  EXPECT_EQ(results.size(), 3u);
+
+  // a tag that jumps out of its region triggers a full-frame search
+  frame = render({{{1, 62, 56}}, {{2, 100, 300}}, {{3, 250, 50}}});
+  expectSame(frame);
+}
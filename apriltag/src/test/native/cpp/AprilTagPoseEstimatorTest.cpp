@@ -0,0 +1,148 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <stdint.h>
+
+#include <numbers>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wpi/RawFrame.h>
+
+#include "frc/apriltag/AprilTag.h"
+#include "frc/apriltag/AprilTagDetector.h"
+#include "frc/apriltag/AprilTagFieldLayout.h"
+#include "frc/apriltag/AprilTagPoseEstimator.h"
+#include "frc/geometry/Pose3d.h"
+
+using namespace frc;
+
+namespace {
+
+constexpr int kWidth = 640;
+constexpr int kHeight = 480;
+constexpr double kFocalLength = 500;
+constexpr auto kDistance = 2_m;
+// tag36h11 images are 10 cells wide, with 8 cells between the black edges
+constexpr int kTagScale = 10;
+constexpr auto kTagSize = 8 * kTagScale * kDistance / kFocalLength;
+
+const AprilTagPoseEstimator::Config kConfig{
+    kTagSize, kFocalLength, kFocalLength, kWidth / 2.0, kHeight / 2.0};
+
+// The camera looks at a wall of tags facing it, kDistance away. For each tag,
+// draws it in the image (with its top left corner at (x, y)) and adds it to
+// the layout, relative to the given camera pose.
+class TagScene {
+ public:
+  explicit TagScene(const Pose3d& cameraPose)
+      : m_cameraPose{cameraPose}, m_image(kWidth * kHeight, 255) {}
+
+  void AddTag(int id, int x, int y) {
+    wpi::RawFrame tag;
+    AprilTag::Generate36h11AprilTagImage(&tag, id);
+    for (int ty = 0; ty < tag.height * kTagScale; ++ty) {
+      for (int tx = 0; tx < tag.width * kTagScale; ++tx) {
+        m_image[(y + ty) * kWidth + x + tx] =
+            tag.data[(ty / kTagScale) * tag.stride + tx / kTagScale];
+      }
+    }
+    double u = x + tag.width * kTagScale / 2.0 - kConfig.cx;
+    double v = y + tag.height * kTagScale / 2.0 - kConfig.cy;
+    Transform3d cameraToTag{
+        Translation3d{kDistance, -u * kDistance / kFocalLength,
+                      -v * kDistance / kFocalLength},
+        Rotation3d{0_deg, 0_deg, 180_deg}};
+    m_tags.emplace_back(id, m_cameraPose.TransformBy(cameraToTag));
+  }
+
+  AprilTagFieldLayout GetLayout() const { return {m_tags, 20_m, 10_m}; }
+
+  AprilTagDetector::Results Detect(AprilTagDetector& detector) {
+    return detector.Detect(kWidth, kHeight, m_image.data());
+  }
+
+ private:
+  Pose3d m_cameraPose;
+  std::vector<uint8_t> m_image;
+  std::vector<AprilTag> m_tags;
+};
+
+void ExpectPoseNear(const Pose3d& expected, const Pose3d& actual,
+                    double tolerance = 0.01) {
+  EXPECT_NEAR(expected.X().value(), actual.X().value(), tolerance);
+  EXPECT_NEAR(expected.Y().value(), actual.Y().value(), tolerance);
+  EXPECT_NEAR(expected.Z().value(), actual.Z().value(), tolerance);
+  auto error = (actual.Rotation() - expected.Rotation()).Angle();
+  EXPECT_NEAR(error.value(), 0, tolerance);
+}
+
+}  // namespace
+
+TEST(AprilTagPoseEstimatorTest, MultiTag) {
+  Pose3d cameraPose{3_m, 2_m, 0.5_m, Rotation3d{0.1_rad, -0.2_rad, 0.7_rad}};
+  TagScene scene{cameraPose};
+  scene.AddTag(1, 40, 30);
+  scene.AddTag(2, 450, 60);
+  scene.AddTag(3, 200, 320);
+  auto layout = scene.GetLayout();
+
+  AprilTagDetector detector;
+  detector.AddFamily("tag36h11");
+  auto detections = scene.Detect(detector);
+  ASSERT_EQ(detections.size(), 3u);
+
+  AprilTagPoseEstimator estimator{kConfig};
+  auto estimate = estimator.EstimateMultiTag(detections, layout);
+  ASSERT_TRUE(estimate);
+  EXPECT_EQ(estimate->numTags, 3);
+  EXPECT_LT(estimate->error, 1.0);
+  ExpectPoseNear(cameraPose, estimate->pose);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_GT(estimate->covariance(i, i), 0);
+  }
+
+  // warm start from the previous estimate gives the same result
+  auto estimate2 =
+      estimator.EstimateMultiTag(detections, layout, estimate->pose);
+  ASSERT_TRUE(estimate2);
+  ExpectPoseNear(estimate->pose, estimate2->pose);
+}
+
+TEST(AprilTagPoseEstimatorTest, MultiTagSingleTag) {
+  Pose3d cameraPose{1_m, -2_m, 0.3_m, Rotation3d{0_rad, 0_rad, 2.5_rad}};
+  TagScene scene{cameraPose};
+  scene.AddTag(7, 250, 180);
+
+  AprilTagDetector detector;
+  detector.AddFamily("tag36h11");
+  auto detections = scene.Detect(detector);
+  ASSERT_EQ(detections.size(), 1u);
+
+  AprilTagPoseEstimator estimator{kConfig};
+  auto estimate = estimator.EstimateMultiTag(detections, scene.GetLayout());
+  ASSERT_TRUE(estimate);
+  EXPECT_EQ(estimate->numTags, 1);
+  // a single tag constrains the pose less
+  ExpectPoseNear(cameraPose, estimate->pose, 0.03);
+}
+
+TEST(AprilTagPoseEstimatorTest, MultiTagNotInLayout) {
+  TagScene scene{Pose3d{}};
+  scene.AddTag(1, 40, 30);
+  scene.AddTag(2, 450, 60);
+  auto layout = scene.GetLayout();
+  TagScene other{Pose3d{}};
+  other.AddTag(3, 250, 180);
+
+  AprilTagDetector detector;
+  detector.AddFamily("tag36h11");
+  AprilTagPoseEstimator estimator{kConfig};
+
+  // tags missing from the layout are ignored
+  auto detections = other.Detect(detector);
+  ASSERT_EQ(detections.size(), 1u);
+  EXPECT_FALSE(estimator.EstimateMultiTag(detections, layout));
+  EXPECT_FALSE(estimator.EstimateMultiTag({}, layout));
+}
@@ -882,7 +882,15 @@ public class CameraServerJNI {
     /** kSourceBytesReceived. */
     kSourceBytesReceived(1),
     /** kSourceFramesReceived. */
-    kSourceFramesReceived(2);
+    kSourceFramesReceived(2),
+    /** kSourceConversions. */
+    kSourceConversions(3),
+    /** kSourceConversionCacheHits. */
+    kSourceConversionCacheHits(4),
+    /** kSourceImageAllocations. */
+    kSourceImageAllocations(5),
+    /** kSourceImagePoolReuses. */
+    kSourceImagePoolReuses(6);
 
     private final int value;
 
@@ -4,18 +4,110 @@
 
 #include "Frame.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <utility>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include "Instance.h"
+#include "PixelConvert.h"
 #include "SourceImpl.h"
 
 using namespace cs;
 
+namespace {
+
+// Conversion planning.  Each conversion has an approximate relative cost per
+// pixel; to create a requested image, the planner finds the cheapest sequence
+// of conversions from any image already in the frame (the original image or
+// intermediate images created for earlier requests, e.g. by other sinks).
+
+constexpr double kNoPath = std::numeric_limits<double>::infinity();
+
+// Formats that can be created as intermediate images
+constexpr VideoMode::PixelFormat kIntermediateFormats[] = {
+    VideoMode::kBGR, VideoMode::kGray, VideoMode::kY16, VideoMode::kRGB565,
+    VideoMode::kBGRA};
+
+// Returns the cost per pixel of a direct conversion, or -1 if there isn't one
+double GetConvertCost(VideoMode::PixelFormat from, VideoMode::PixelFormat to) {
+  switch (from) {
+    case VideoMode::kMJPEG:
+      return to == VideoMode::kBGR ? 12 : to == VideoMode::kGray ? 8 : -1;
+    case VideoMode::kYUYV:
+    case VideoMode::kUYVY:
+      return to == VideoMode::kBGR ? 1 : to == VideoMode::kGray ? 0.25 : -1;
+    case VideoMode::kRGB565:
+      return to == VideoMode::kBGR ? 1 : -1;
+    case VideoMode::kBGR:
+      switch (to) {
+        case VideoMode::kMJPEG:
+          return 10;
+        case VideoMode::kRGB565:
+        case VideoMode::kGray:
+        case VideoMode::kBGRA:
+          return 1;
+        default:
+          return -1;
+      }
+    case VideoMode::kGray:
+      switch (to) {
+        case VideoMode::kMJPEG:
+          return 6;
+        case VideoMode::kBGR:
+          return 1;
+        case VideoMode::kY16:
+          return 0.25;
+        default:
+          return -1;
+      }
+    case VideoMode::kY16:
+      return to == VideoMode::kGray ? 1.5 : -1;
+    default:
+      return -1;
+  }
+}
+
+// Returns the cost per pixel (of the larger image) of resizing, or -1 if
+// the format can't be resized (compressed and packed formats)
+double GetResizeCost(VideoMode::PixelFormat pixelFormat) {
+  switch (pixelFormat) {
+    case VideoMode::kGray:
+      return 0.5;
+    case VideoMode::kY16:
+      return 0.75;
+    case VideoMode::kBGR:
+      return 1;
+    case VideoMode::kBGRA:
+      return 1.25;
+    default:
+      return -1;
+  }
+}
+
+bool IsGrayscale(VideoMode::PixelFormat pixelFormat) {
+  return pixelFormat == VideoMode::kGray || pixelFormat == VideoMode::kY16;
+}
+
+// Image (existing or potential) in the conversion graph
+struct PlanNode {
+  VideoMode::PixelFormat pixelFormat;
+  int width;
+  int height;
+  Image* image{nullptr};  // existing image (start node)
+  double cost{kNoPath};
+  size_t prev{0};
+  bool done{false};
+};
+
+}  // namespace
+
 Frame::Frame(SourceImpl& source, std::string_view error, Time time,
              WPI_TimestampSource timeSrc)
     : m_impl{source.AllocFrameImpl().release()} {
@@ -205,179 +297,278 @@ Image* Frame::ConvertImpl(Image* image, VideoMode::PixelFormat pixelFormat,
                           requiredJpegQuality)) {
     return image;
   }
-  Image* cur = image;
+  std::scoped_lock lock(m_impl->mutex);
+  ImageSpec spec{image->width, image->height, pixelFormat, requiredJpegQuality,
+                 defaultJpegQuality};
+  Plan plan;
+  if (!PlanImage(spec, image, &plan)) {
+    return nullptr;  // Unsupported
+  }
+  RecordConversions(IsCacheHit(plan) ? 1 : 0,
+                    static_cast<int>(plan.steps.size()));
+  return ExecutePlan(spec, plan);
+}
 
-  // If the source image is a JPEG, we need to decode it before we can do
-  // anything else with it.  Note that if the destination format is JPEG, we
-  // still need to do this (unless it was already a JPEG, in which case we
-  // would have returned above).
-  if (cur->pixelFormat == VideoMode::kMJPEG) {
-    cur = ConvertMJPEGToBGR(cur);
-    if (pixelFormat == VideoMode::kBGR) {
-      return cur;
+bool Frame::PlanImage(const ImageSpec& spec, Image* source, Plan* plan) const {
+  plan->start = nullptr;
+  plan->cost = 0;
+  plan->steps.clear();
+
+  // If the image already exists, there's nothing to do
+  if (Image* image = GetExistingImage(spec.width, spec.height, spec.pixelFormat,
+                                      spec.requiredJpegQuality)) {
+    plan->start = image;
+    return true;
+  }
+
+  // Existing images are the starting points.  When converting a specific
+  // image, only consider images of the same size.
+  wpi::SmallVector<PlanNode, 32> nodes;
+  auto findNode = [&](VideoMode::PixelFormat pixelFormat, int width,
+                      int height) {
+    return std::find_if(nodes.begin(), nodes.end(), [&](const auto& node) {
+      return node.pixelFormat == pixelFormat && node.width == width &&
+             node.height == height;
+    });
+  };
+  auto addStart = [&](Image* image) {
+    auto it = findNode(image->pixelFormat, image->width, image->height);
+    if (it == nodes.end()) {
+      nodes.push_back(
+          {image->pixelFormat, image->width, image->height, image, 0.0});
+    } else if (image->pixelFormat == VideoMode::kMJPEG &&
+               it->image->jpegQuality != -1 &&
+               (image->jpegQuality == -1 ||
+                image->jpegQuality > it->image->jpegQuality)) {
+      // prefer the highest quality JPEG (no quality setting is considered
+      // highest, e.g. directly from the camera)
+      it->image = image;
     }
+  };
+  if (source) {
+    addStart(source);
+  }
+  for (auto image : m_impl->images) {
+    if (!source || image->Is(spec.width, spec.height)) {
+      addStart(image);
+    }
+  }
+  if (nodes.empty()) {
+    return false;
   }
 
-  // Color convert
-  switch (pixelFormat) {
-    case VideoMode::kRGB565:
-      // If source is YUYV, UYVY, Gray, or Y16, need to convert to BGR first
-      if (cur->pixelFormat == VideoMode::kYUYV) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else {
-          cur = ConvertYUYVToBGR(cur);
-        }
-      } else if (cur->pixelFormat == VideoMode::kUYVY) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else {
-          cur = ConvertUYVYToBGR(cur);
-        }
-      } else if (cur->pixelFormat == VideoMode::kGray) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else {
-          cur = ConvertGrayToBGR(cur);
-        }
-      } else if (cur->pixelFormat == VideoMode::kY16) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else if (Image* newImage = GetExistingImage(cur->width, cur->height,
-                                                      VideoMode::kGray)) {
-          cur = ConvertGrayToBGR(newImage);
-        } else {
-          cur = ConvertGrayToBGR(ConvertY16ToGray(cur));
-        }
-      }
-      return ConvertBGRToRGB565(cur);
-    case VideoMode::kGray:
-    case VideoMode::kY16:
-      // If source is also grayscale, convert directly
-      if (pixelFormat == VideoMode::kGray &&
-          cur->pixelFormat == VideoMode::kY16) {
-        return ConvertY16ToGray(cur);
-      } else if (pixelFormat == VideoMode::kY16 &&
-                 cur->pixelFormat == VideoMode::kGray) {
-        return ConvertGrayToY16(cur);
+  // Grayscale images can't be used to create color images if a color image
+  // is available
+  bool color = std::any_of(nodes.begin(), nodes.end(), [](const auto& node) {
+    return !IsGrayscale(node.pixelFormat);
+  });
+
+  // Intermediate images can be any of the existing sizes (followed by a
+  // resize) or the requested size
+  auto addNode = [&](VideoMode::PixelFormat pixelFormat, int width,
+                     int height) {
+    if (findNode(pixelFormat, width, height) == nodes.end()) {
+      nodes.push_back({pixelFormat, width, height});
+    }
+  };
+  for (size_t i = 0, numStart = nodes.size(); i < numStart; ++i) {
+    int width = nodes[i].width;
+    int height = nodes[i].height;
+    for (auto pixelFormat : kIntermediateFormats) {
+      addNode(pixelFormat, width, height);
+    }
+  }
+  for (auto pixelFormat : kIntermediateFormats) {
+    addNode(pixelFormat, spec.width, spec.height);
+  }
+
+  // A JPEG target is always a new image, as any existing JPEG image of the
+  // same size has the wrong quality
+  size_t target;
+  if (spec.pixelFormat == VideoMode::kMJPEG) {
+    target = nodes.size();
+    nodes.push_back({VideoMode::kMJPEG, spec.width, spec.height});
+  } else {
+    auto it = findNode(spec.pixelFormat, spec.width, spec.height);
+    if (it == nodes.end()) {
+      return false;
+    }
+    target = it - nodes.begin();
+  }
+
+  // Find the cheapest path (Dijkstra's algorithm).  There are only a few
+  // dozen nodes, so a linear search for the closest node is fine.
+  for (;;) {
+    PlanNode* from = nullptr;
+    for (auto&& node : nodes) {
+      if (!node.done && node.cost != kNoPath &&
+          (!from || node.cost < from->cost)) {
+        from = &node;
       }
-      // If source is YUYV, UYVY, convert directly to Gray
-      // If RGB565, need to convert to BGR first
-      if (cur->pixelFormat == VideoMode::kYUYV) {
-        cur = ConvertYUYVToGray(cur);
-      } else if (cur->pixelFormat == VideoMode::kUYVY) {
-        cur = ConvertUYVYToGray(cur);
-      } else if (cur->pixelFormat == VideoMode::kRGB565) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else {
-          cur = ConvertRGB565ToBGR(cur);
-        }
-        cur = ConvertBGRToGray(cur);
+    }
+    if (!from) {
+      return false;  // no path
+    }
+    if (from == &nodes[target]) {
+      break;
+    }
+    from->done = true;
+
+    double fromPixels = static_cast<double>(from->width) * from->height;
+    for (auto&& to : nodes) {
+      if (to.done || to.image ||
+          (color && IsGrayscale(from->pixelFormat) &&
+           !IsGrayscale(to.pixelFormat))) {
+        continue;
       }
-      if (pixelFormat == VideoMode::kY16) {
-        cur = ConvertGrayToY16(cur);
+      double cost;
+      if (to.width == from->width && to.height == from->height) {
+        cost = GetConvertCost(from->pixelFormat, to.pixelFormat) * fromPixels;
+      } else if (to.pixelFormat == from->pixelFormat &&
+                 to.width == spec.width && to.height == spec.height) {
+        cost = GetResizeCost(from->pixelFormat) *
+               (std::max)(fromPixels, static_cast<double>(to.width) *
+                                          to.height);
+      } else {
+        continue;
       }
-      return cur;
-    case VideoMode::kBGR:
-    case VideoMode::kMJPEG:
-      if (cur->pixelFormat == VideoMode::kYUYV) {
-        cur = ConvertYUYVToBGR(cur);
-      } else if (cur->pixelFormat == VideoMode::kUYVY) {
-        cur = ConvertUYVYToBGR(cur);
-      } else if (cur->pixelFormat == VideoMode::kRGB565) {
-        cur = ConvertRGB565ToBGR(cur);
-      } else if (cur->pixelFormat == VideoMode::kGray) {
-        if (pixelFormat == VideoMode::kBGR) {
-          return ConvertGrayToBGR(cur);
-        } else {
-          return ConvertGrayToMJPEG(cur, defaultJpegQuality);
-        }
-      } else if (cur->pixelFormat == VideoMode::kY16) {
-        // Check to see if Gray version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kGray)) {
-          cur = newImage;
-        } else {
-          cur = ConvertY16ToGray(cur);
-        }
-        if (pixelFormat == VideoMode::kBGR) {
-          return ConvertGrayToBGR(cur);
-        } else {
-          return ConvertGrayToMJPEG(cur, defaultJpegQuality);
-        }
+      if (cost >= 0 && from->cost + cost < to.cost) {
+        to.cost = from->cost + cost;
+        to.prev = from - nodes.data();
       }
-      break;
-    case VideoMode::kBGRA:
-      // If source is RGB565, YUYV, UYVY, Gray or Y16, need to convert to BGR
-      // first
-      if (cur->pixelFormat == VideoMode::kRGB565) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else {
-          cur = ConvertRGB565ToBGR(cur);
-        }
-      } else if (cur->pixelFormat == VideoMode::kYUYV) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else {
-          cur = ConvertYUYVToBGR(cur);
-        }
-      } else if (cur->pixelFormat == VideoMode::kUYVY) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else {
-          cur = ConvertUYVYToBGR(cur);
+    }
+  }
+
+  // Walk back from the target to build the list of steps
+  plan->cost = nodes[target].cost;
+  size_t i = target;
+  for (; !nodes[i].image; i = nodes[i].prev) {
+    plan->steps.push_back(
+        {nodes[i].pixelFormat, nodes[i].width, nodes[i].height});
+  }
+  plan->start = nodes[i].image;
+  std::reverse(plan->steps.begin(), plan->steps.end());
+  return true;
+}
+
+Image* Frame::ExecutePlan(const ImageSpec& spec, const Plan& plan) {
+  Image* cur = plan.start;
+  if (plan.steps.empty()) {
+    return cur;
+  }
+
+  WPI_DEBUG4(Instance::GetInstance().logger,
+             "converting image from {}x{} type {} to {}x{} type {}", cur->width,
+             cur->height, static_cast<int>(cur->pixelFormat), spec.width,
+             spec.height, static_cast<int>(spec.pixelFormat));
+
+  int jpegQuality = spec.requiredJpegQuality != -1 ? spec.requiredJpegQuality
+                                                   : spec.defaultJpegQuality;
+  for (auto&& step : plan.steps) {
+    if (!cur->Is(step.width, step.height)) {
+      cur = ResizeImage(cur, step.width, step.height);
+      continue;
+    }
+    switch (step.pixelFormat) {
+      case VideoMode::kBGR:
+        switch (cur->pixelFormat) {
+          case VideoMode::kMJPEG:
+            cur = ConvertMJPEGToBGR(cur);
+            break;
+          case VideoMode::kYUYV:
+            cur = ConvertYUYVToBGR(cur);
+            break;
+          case VideoMode::kUYVY:
+            cur = ConvertUYVYToBGR(cur);
+            break;
+          case VideoMode::kRGB565:
+            cur = ConvertRGB565ToBGR(cur);
+            break;
+          case VideoMode::kGray:
+            cur = ConvertGrayToBGR(cur);
+            break;
+          default:
+            return nullptr;
         }
-      } else if (cur->pixelFormat == VideoMode::kGray) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else {
-          cur = ConvertGrayToBGR(cur);
+        break;
+      case VideoMode::kGray:
+        switch (cur->pixelFormat) {
+          case VideoMode::kMJPEG:
+            cur = ConvertMJPEGToGray(cur);
+            break;
+          case VideoMode::kYUYV:
+            cur = ConvertYUYVToGray(cur);
+            break;
+          case VideoMode::kUYVY:
+            cur = ConvertUYVYToGray(cur);
+            break;
+          case VideoMode::kBGR:
+            cur = ConvertBGRToGray(cur);
+            break;
+          case VideoMode::kY16:
+            cur = ConvertY16ToGray(cur);
+            break;
+          default:
+            return nullptr;
         }
-      } else if (cur->pixelFormat == VideoMode::kY16) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else if (Image* newImage = GetExistingImage(cur->width, cur->height,
-                                                      VideoMode::kGray)) {
-          cur = ConvertGrayToBGR(newImage);
+        break;
+      case VideoMode::kMJPEG:
+        if (cur->pixelFormat == VideoMode::kBGR) {
+          cur = ConvertBGRToMJPEG(cur, jpegQuality);
         } else {
-          cur = ConvertGrayToBGR(ConvertY16ToGray(cur));
+          cur = ConvertGrayToMJPEG(cur, jpegQuality);
         }
-      }
-      return ConvertBGRToBGRA(cur);
-    case VideoMode::kYUYV:
-    case VideoMode::kUYVY:
-    default:
-      return nullptr;  // Unsupported
+        break;
+      case VideoMode::kRGB565:
+        cur = ConvertBGRToRGB565(cur);
+        break;
+      case VideoMode::kY16:
+        cur = ConvertGrayToY16(cur);
+        break;
+      case VideoMode::kBGRA:
+        cur = ConvertBGRToBGRA(cur);
+        break;
+      default:
+        return nullptr;
+    }
+    if (!cur) {
+      return nullptr;
+    }
   }
+  return cur;
+}
 
-  // Compress if destination is JPEG
-  if (pixelFormat == VideoMode::kMJPEG) {
-    cur = ConvertBGRToMJPEG(cur, defaultJpegQuality);
+Image* Frame::ResizeImage(Image* image, int width, int height) {
+  // Allocate an image
+  auto newImage = m_impl->source.AllocImage(
+      image->pixelFormat, width, height,
+      width * height * (image->size() / (image->width * image->height)));
+
+  // Resize; Y16 is a single 16-bit channel
+  if (image->pixelFormat == VideoMode::kY16) {
+    cv::Mat newMat{height, width, CV_16UC1, newImage->data()};
+    cv::resize(cv::Mat{image->height, image->width, CV_16UC1, image->data()},
+               newMat, newMat.size(), 0, 0);
+  } else {
+    cv::Mat newMat = newImage->AsMat();
+    cv::resize(image->AsMat(), newMat, newMat.size(), 0, 0);
   }
 
-  return cur;
+  // Save the result
+  Image* rv = newImage.release();
+  m_impl->images.push_back(rv);
+  return rv;
+}
+
+void Frame::RecordConversions(int cacheHits, int conversions) {
+  if (cacheHits != 0) {
+    m_impl->source.m_telemetry.RecordSourceConversionCacheHits(m_impl->source,
+                                                               cacheHits);
+  }
+  if (conversions != 0) {
+    m_impl->source.m_telemetry.RecordSourceConversions(m_impl->source,
+                                                       conversions);
+  }
 }
 
 Image* Frame::ConvertMJPEGToBGR(Image* image) {
@@ -437,7 +628,8 @@ Image* Frame::ConvertYUYVToBGR(Image* image) {
                                 image->width * image->height * 3);
 
   // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_YUV2BGR_YUYV);
+  GetPixelConverters().yuyvToBGR(image->bytes(), newImage->bytes(),
+                                 image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -459,7 +651,8 @@ Image* Frame::ConvertYUYVToGray(Image* image) {
                                 image->width * image->height);
 
   // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_YUV2GRAY_YUYV);
+  GetPixelConverters().yuyvToGray(image->bytes(), newImage->bytes(),
+                                  image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -481,7 +674,8 @@ Image* Frame::ConvertUYVYToBGR(Image* image) {
                                 image->width * image->height * 3);
 
   // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_YUV2BGR_UYVY);
+  GetPixelConverters().uyvyToBGR(image->bytes(), newImage->bytes(),
+                                 image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -503,7 +697,8 @@ Image* Frame::ConvertUYVYToGray(Image* image) {
                                 image->width * image->height);
 
   // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_YUV2GRAY_UYVY);
+  GetPixelConverters().uyvyToGray(image->bytes(), newImage->bytes(),
+                                  image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -525,7 +720,8 @@ Image* Frame::ConvertBGRToRGB565(Image* image) {
                                 image->width * image->height * 2);
 
   // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_RGB2BGR565);
+  GetPixelConverters().bgrToRGB565(image->bytes(), newImage->bytes(),
+                                   image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -547,7 +743,8 @@ Image* Frame::ConvertRGB565ToBGR(Image* image) {
                                 image->width * image->height * 3);
 
   // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_BGR5652RGB);
+  GetPixelConverters().rgb565ToBGR(image->bytes(), newImage->bytes(),
+                                   image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -611,25 +808,23 @@ Image* Frame::ConvertBGRToMJPEG(Image* image, int quality) {
   }
   std::scoped_lock lock(m_impl->mutex);
 
-  // Allocate a JPEG image.  We don't actually know what the resulting size
-  // will be; while the destination will automatically grow, doing so will
-  // cause an extra malloc, so we don't want to be too conservative here.
-  // Per Wikipedia, Q=100 on a sample image results in 8.25 bits per pixel,
-  // this is a little bit more conservative in assuming 50% space savings over
-  // the equivalent BGR image.
-  auto newImage =
-      m_impl->source.AllocImage(VideoMode::kMJPEG, image->width, image->height,
-                                image->width * image->height * 1.5);
-
-  // Compress
+  // Compress into a scratch buffer (as the size isn't known in advance),
+  // then copy into an image of the right size.  The scratch buffer is kept
+  // with the frame so its allocation is reused.
   if (m_impl->compressionParams.empty()) {
     m_impl->compressionParams.push_back(cv::IMWRITE_JPEG_QUALITY);
     m_impl->compressionParams.push_back(quality);
   } else {
     m_impl->compressionParams[1] = quality;
   }
-  cv::imencode(".jpg", image->AsMat(), newImage->vec(),
+  cv::imencode(".jpg", image->AsMat(), m_impl->encodeBuffer,
                m_impl->compressionParams);
+  auto newImage =
+      m_impl->source.AllocImage(VideoMode::kMJPEG, image->width, image->height,
+                                m_impl->encodeBuffer.size());
+  std::memcpy(newImage->data(), m_impl->encodeBuffer.data(),
+              m_impl->encodeBuffer.size());
+  newImage->jpegQuality = quality;
 
   // Save the result
   Image* rv = newImage.release();
@@ -646,25 +841,23 @@ Image* Frame::ConvertGrayToMJPEG(Image* image, int quality) {
   }
   std::scoped_lock lock(m_impl->mutex);
 
-  // Allocate a JPEG image.  We don't actually know what the resulting size
-  // will be; while the destination will automatically grow, doing so will
-  // cause an extra malloc, so we don't want to be too conservative here.
-  // Per Wikipedia, Q=100 on a sample image results in 8.25 bits per pixel,
-  // this is a little bit more conservative in assuming 25% space savings over
-  // the equivalent grayscale image.
-  auto newImage =
-      m_impl->source.AllocImage(VideoMode::kMJPEG, image->width, image->height,
-                                image->width * image->height * 0.75);
-
-  // Compress
+  // Compress into a scratch buffer (as the size isn't known in advance),
+  // then copy into an image of the right size.  The scratch buffer is kept
+  // with the frame so its allocation is reused.
   if (m_impl->compressionParams.empty()) {
     m_impl->compressionParams.push_back(cv::IMWRITE_JPEG_QUALITY);
     m_impl->compressionParams.push_back(quality);
   } else {
     m_impl->compressionParams[1] = quality;
   }
-  cv::imencode(".jpg", image->AsMat(), newImage->vec(),
+  cv::imencode(".jpg", image->AsMat(), m_impl->encodeBuffer,
                m_impl->compressionParams);
+  auto newImage =
+      m_impl->source.AllocImage(VideoMode::kMJPEG, image->width, image->height,
+                                m_impl->encodeBuffer.size());
+  std::memcpy(newImage->data(), m_impl->encodeBuffer.data(),
+              m_impl->encodeBuffer.size());
+  newImage->jpegQuality = quality;
 
   // Save the result
   Image* rv = newImage.release();
@@ -683,7 +876,8 @@ Image* Frame::ConvertGrayToY16(Image* image) {
                                 image->width * image->height * 2);
 
   // Convert with linear scaling
-  image->AsMat().convertTo(newImage->AsMat(), CV_16U, 256);
+  GetPixelConverters().grayToY16(image->bytes(), newImage->bytes(),
+                                 image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -745,42 +939,54 @@ Image* Frame::GetImageImpl(int width, int height,
     return nullptr;
   }
   std::scoped_lock lock(m_impl->mutex);
-  Image* cur = GetNearestImage(width, height, pixelFormat, requiredJpegQuality);
-  if (!cur || cur->Is(width, height, pixelFormat, requiredJpegQuality)) {
-    return cur;
+  ImageSpec spec{width, height, pixelFormat, requiredJpegQuality,
+                 defaultJpegQuality};
+  Plan plan;
+  if (!PlanImage(spec, nullptr, &plan)) {
+    return nullptr;
   }
+  RecordConversions(IsCacheHit(plan) ? 1 : 0,
+                    static_cast<int>(plan.steps.size()));
+  return ExecutePlan(spec, plan);
+}
 
-  WPI_DEBUG4(Instance::GetInstance().logger,
-             "converting image from {}x{} type {} to {}x{} type {}", cur->width,
-             cur->height, static_cast<int>(cur->pixelFormat), width, height,
-             static_cast<int>(pixelFormat));
-
-  // If the source image is a JPEG, we need to decode it before we can do
-  // anything else with it.  Note that if the destination format is JPEG, we
-  // still need to do this (unless the width/height/compression were the same,
-  // in which case we already returned the existing JPEG above).
-  if (cur->pixelFormat == VideoMode::kMJPEG) {
-    cur = ConvertMJPEGToBGR(cur);
+void Frame::PrepareImages(std::span<const ImageSpec> specs) {
+  if (!m_impl) {
+    return;
   }
-
-  // Resize
-  if (!cur->Is(width, height)) {
-    // Allocate an image.
-    auto newImage = m_impl->source.AllocImage(
-        cur->pixelFormat, width, height,
-        width * height * (cur->size() / (cur->width * cur->height)));
-
-    // Resize
-    cv::Mat newMat = newImage->AsMat();
-    cv::resize(cur->AsMat(), newMat, newMat.size(), 0, 0);
-
-    // Save the result
-    cur = newImage.release();
-    m_impl->images.push_back(cur);
+  std::scoped_lock lock(m_impl->mutex);
+  wpi::SmallVector<const ImageSpec*, 4> remaining;
+  for (auto&& spec : specs) {
+    remaining.push_back(&spec);
+  }
+
+  // Create the cheapest image first, as its intermediate images may then
+  // reduce the cost of the others (e.g. a decoded JPEG shared by two
+  // different resolutions).  Costs are replanned after each image.
+  int cacheHits = 0;
+  int conversions = 0;
+  Plan plan;
+  Plan best;
+  while (!remaining.empty()) {
+    auto bestIt = remaining.end();
+    for (auto it = remaining.begin(); it != remaining.end(); ++it) {
+      if (PlanImage(**it, nullptr, &plan) &&
+          (bestIt == remaining.end() || plan.cost < best.cost)) {
+        bestIt = it;
+        std::swap(plan, best);
+      }
+    }
+    if (bestIt == remaining.end()) {
+      break;  // none of the remaining images are possible
+    }
+    if (IsCacheHit(best)) {
+      ++cacheHits;
+    } else if (ExecutePlan(**bestIt, best)) {
+      conversions += best.steps.size();
+    }
+    remaining.erase(bestIt);
   }
-
-  // Convert to output format
-  return ConvertImpl(cur, pixelFormat, requiredJpegQuality, defaultJpegQuality);
+  RecordConversions(cacheHits, conversions);
 }
 
 bool Frame::GetCv(cv::Mat& image, int width, int height,
@@ -7,6 +7,7 @@
 
 #include <atomic>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -32,6 +33,15 @@ class Frame {
  public:
   using Time = uint64_t;
 
+  // Image requested from a frame; see PrepareImages()
+  struct ImageSpec {
+    int width;
+    int height;
+    VideoMode::PixelFormat pixelFormat;
+    int requiredJpegQuality{-1};
+    int defaultJpegQuality{80};
+  };
+
  private:
   struct Impl {
     explicit Impl(SourceImpl& source_) : source(source_) {}
@@ -44,6 +54,7 @@ class Frame {
     std::string error;
     wpi::SmallVector<Image*, 4> images;
     std::vector<int> compressionParams;
+    std::vector<uchar> encodeBuffer;
   };
 
  public:
@@ -230,6 +241,11 @@ class Frame {
                         defaultQuality);
   }
 
+  // Creates several images at once (e.g. for multiple sinks), sharing
+  // intermediate images between them.  The images can then be retrieved
+  // with GetImage() or GetImageMJPEG() without further conversion.
+  void PrepareImages(std::span<const ImageSpec> specs);
+
   bool GetCv(cv::Mat& image, VideoMode::PixelFormat pixelFormat) {
     return GetCv(image, GetOriginalWidth(), GetOriginalHeight(), pixelFormat);
   }
@@ -237,6 +253,31 @@ class Frame {
              VideoMode::PixelFormat pixelFormat);
 
  private:
+  // Conversion plan: a sequence of images to create, starting from an
+  // existing image.  Each step is a pixel format conversion or a resize.
+  struct PlanStep {
+    VideoMode::PixelFormat pixelFormat;
+    int width;
+    int height;
+  };
+  struct Plan {
+    Image* start{nullptr};
+    double cost{0};
+    wpi::SmallVector<PlanStep, 4> steps;
+  };
+
+  // Finds the cheapest plan for an image.  If source is non-null, only it and
+  // other images of the same size are considered as starting points.
+  bool PlanImage(const ImageSpec& spec, Image* source, Plan* plan) const;
+  Image* ExecutePlan(const ImageSpec& spec, const Plan& plan);
+  Image* ResizeImage(Image* image, int width, int height);
+  // True if the plan uses an image created by an earlier conversion, rather
+  // than passing through the original image
+  bool IsCacheHit(const Plan& plan) const {
+    return plan.steps.empty() && plan.start != m_impl->images[0];
+  }
+  void RecordConversions(int cacheHits, int conversions);
+
   Image* ConvertImpl(Image* image, VideoMode::PixelFormat pixelFormat,
                      int requiredJpegQuality, int defaultJpegQuality);
   Image* GetImageImpl(int width, int height, VideoMode::PixelFormat pixelFormat,
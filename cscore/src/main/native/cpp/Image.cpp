@@ -0,0 +1,71 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "Image.h"
+
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+using namespace cs;
+
+// Buffers at least this large are mapped directly (rather than coming from
+// the heap) so they can be backed by transparent huge pages; a 640x480 BGR
+// image spans hundreds of 4 KB pages.
+static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+static uchar* AllocBuffer(size_t capacity, bool* mapped) {
+#ifdef __linux__
+  if (capacity >= kHugePageSize) {
+    void* ptr = mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+      madvise(ptr, capacity, MADV_HUGEPAGE);
+#endif
+      *mapped = true;
+      return static_cast<uchar*>(ptr);
+    }
+  }
+#endif
+  *mapped = false;
+  return static_cast<uchar*>(
+      ::operator new(capacity, std::align_val_t{Image::kAlignment}));
+}
+
+static void FreeBuffer(uchar* data, size_t capacity, bool mapped) {
+#ifdef __linux__
+  if (mapped) {
+    munmap(data, capacity);
+    return;
+  }
+#endif
+  ::operator delete(data, std::align_val_t{Image::kAlignment});
+}
+
+Image::Image(size_t capacity)
+    : m_capacity{(capacity + kAlignment - 1) & ~(kAlignment - 1)} {
+  m_data = AllocBuffer(m_capacity, &m_mapped);
+}
+
+Image::~Image() {
+  FreeBuffer(m_data, m_capacity, m_mapped);
+}
+
+void Image::resize(size_t size) {
+  if (size > m_capacity) {
+    size_t capacity = (size + kAlignment - 1) & ~(kAlignment - 1);
+    bool mapped;
+    uchar* data = AllocBuffer(capacity, &mapped);
+    std::memcpy(data, m_data, m_size);
+    FreeBuffer(m_data, m_capacity, m_mapped);
+    m_data = data;
+    m_capacity = capacity;
+    m_mapped = mapped;
+  }
+  m_size = size;
+}
@@ -5,13 +5,13 @@
 #ifndef CSCORE_IMAGE_H_
 #define CSCORE_IMAGE_H_
 
+#include <stddef.h>
+
 #include <string_view>
-#include <vector>
 
 #include <opencv2/core/core.hpp>
 
 #include "cscore_cpp.h"
-#include "default_init_allocator.h"
 
 namespace cs {
 
@@ -21,14 +21,11 @@ class Image {
   friend class Frame;
 
  public:
-#ifndef __linux__
-  explicit Image(size_t capacity) { m_data.reserve(capacity); }
-#else
-  explicit Image(size_t capacity)
-      : m_data{capacity, default_init_allocator<uchar>{}} {
-    m_data.resize(0);
-  }
-#endif
+  // Image data is aligned for SIMD access
+  static constexpr size_t kAlignment = 64;
+
+  explicit Image(size_t capacity);
+  ~Image();
 
   Image(const Image&) = delete;
   Image& operator=(const Image&) = delete;
@@ -38,18 +35,18 @@ class Image {
     return str();
   }
   std::string_view str() const { return {data(), size()}; }
-  size_t capacity() const { return m_data.capacity(); }
-  const char* data() const {
-    return reinterpret_cast<const char*>(m_data.data());
-  }
-  char* data() { return reinterpret_cast<char*>(m_data.data()); }
-  size_t size() const { return m_data.size(); }
+  size_t capacity() const { return m_capacity; }
+  const char* data() const { return reinterpret_cast<const char*>(m_data); }
+  char* data() { return reinterpret_cast<char*>(m_data); }
+  size_t size() const { return m_size; }
 
-  const std::vector<uchar>& vec() const { return m_data; }
-  std::vector<uchar>& vec() { return m_data; }
+  const uchar* bytes() const { return m_data; }
+  uchar* bytes() { return m_data; }
 
-  void resize(size_t size) { m_data.resize(size); }
-  void SetSize(size_t size) { m_data.resize(size); }
+  // Sets the size of the image data; reallocates (preserving existing data)
+  // if the size is larger than the capacity
+  void resize(size_t size);
+  void SetSize(size_t size) { resize(size); }
 
   cv::Mat AsMat() {
     int type;
@@ -72,7 +69,7 @@ class Image {
         type = CV_8UC1;
         break;
     }
-    return cv::Mat{height, width, type, m_data.data()};
+    return cv::Mat{height, width, type, m_data};
   }
 
   int GetStride() const {
@@ -94,7 +91,9 @@ class Image {
     }
   }
 
-  cv::_InputArray AsInputArray() { return cv::_InputArray{m_data}; }
+  cv::_InputArray AsInputArray() {
+    return cv::_InputArray{m_data, static_cast<int>(m_size)};
+  }
 
   bool Is(int width_, int height_) {
     return width == width_ && height == height_;
@@ -120,7 +119,10 @@ class Image {
   bool IsSmaller(const Image& oth) { return !IsLarger(oth); }
 
  private:
-  std::vector<uchar> m_data;
+  uchar* m_data;
+  size_t m_capacity;
+  size_t m_size{0};
+  bool m_mapped{false};
 
  public:
   VideoMode::PixelFormat pixelFormat{VideoMode::kUnknown};
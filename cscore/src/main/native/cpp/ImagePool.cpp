@@ -0,0 +1,91 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ImagePool.h"
+
+#include <bit>
+#include <utility>
+
+using namespace cs;
+
+static constexpr int kMinCapacityBits =
+    std::bit_width(ImagePool::kMinCapacity) - 1;
+
+size_t ImagePool::GetSizeClass(size_t size) {
+  if (size <= kMinCapacity) {
+    return 0;
+  }
+  // smallest power of 2 at least as large as size
+  int bits = std::bit_width(size - 1);
+  // use 1.5 * 2^(bits - 1) if it's large enough
+  size_t sizeClass = 2 * (bits - kMinCapacityBits);
+  if (size <= (size_t{3} << (bits - 2))) {
+    --sizeClass;
+  }
+  return sizeClass;
+}
+
+size_t ImagePool::GetClassCapacity(size_t sizeClass) {
+  // even classes are powers of 2, odd are 1.5 * the previous power of 2
+  if (sizeClass % 2 == 0) {
+    return kMinCapacity << (sizeClass / 2);
+  } else {
+    return (kMinCapacity * 3 / 2) << (sizeClass / 2);
+  }
+}
+
+std::unique_ptr<Image> ImagePool::Alloc(size_t size) {
+  size_t sizeClass = GetSizeClass(size);
+  if (sizeClass >= kNumClasses) {
+    ++m_allocations;
+    return std::make_unique<Image>(size);
+  }
+
+  // also accept an image from the next larger class rather than allocating
+  for (size_t i = sizeClass; i < sizeClass + 2 && i < kNumClasses; ++i) {
+    auto& idle = m_idle[i];
+    if (!idle.empty()) {
+      auto image = std::move(idle.back());
+      idle.pop_back();
+      --m_numIdle;
+      ++m_reuses;
+      return image;
+    }
+  }
+
+  ++m_allocations;
+  return std::make_unique<Image>(GetClassCapacity(sizeClass));
+}
+
+void ImagePool::Release(std::unique_ptr<Image> image) {
+  // find the largest class that fits in the capacity (the capacity will be
+  // exactly a class size unless the image was resized)
+  size_t capacity = image->capacity();
+  if (capacity < kMinCapacity || m_numIdle >= kMaxIdle) {
+    return;
+  }
+  size_t sizeClass = GetSizeClass(capacity);
+  if (GetClassCapacity(sizeClass) > capacity) {
+    --sizeClass;
+  }
+  if (sizeClass >= kNumClasses) {
+    return;
+  }
+  m_idle[sizeClass].emplace_back(std::move(image));
+  ++m_numIdle;
+}
+
+void ImagePool::Clear() {
+  for (auto&& idle : m_idle) {
+    idle.clear();
+  }
+  m_numIdle = 0;
+}
+
+void ImagePool::TakeStats(int* allocations, int* reuses) {
+  *allocations = m_allocations;
+  *reuses = m_reuses;
+  m_allocations = 0;
+  m_reuses = 0;
+}
@@ -0,0 +1,60 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_IMAGEPOOL_H_
+#define CSCORE_IMAGEPOOL_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Image.h"
+
+namespace cs {
+
+// Pool of images, bucketed by size class.  Capacities are rounded up to the
+// next size class (powers of 2 and 1.5 times powers of 2), so images can be
+// reused even when the size varies from frame to frame (e.g. JPEG data),
+// and lookup is constant time.  Once the pool is warmed up, steady-state
+// capture performs no heap allocations.
+//
+// Not thread-safe; callers must provide synchronization.
+class ImagePool {
+ public:
+  // Smallest size class
+  static constexpr size_t kMinCapacity = 4096;
+  // Largest size class is 1.5 * 2^(kNumClasses / 2 + 11) (192 MB); larger
+  // images are not pooled
+  static constexpr size_t kNumClasses = 32;
+  // Maximum number of idle images kept in the pool
+  static constexpr size_t kMaxIdle = 32;
+
+  // Gets an image with a capacity of at least size bytes
+  std::unique_ptr<Image> Alloc(size_t size);
+
+  // Returns an image to the pool
+  void Release(std::unique_ptr<Image> image);
+
+  // Frees all idle images
+  void Clear();
+
+  // Gets the number of images allocated from the heap and reused from the
+  // pool since the last call
+  void TakeStats(int* allocations, int* reuses);
+
+  static size_t GetSizeClass(size_t size);
+  static size_t GetClassCapacity(size_t sizeClass);
+
+ private:
+  std::array<std::vector<std::unique_ptr<Image>>, kNumClasses> m_idle;
+  size_t m_numIdle{0};
+  int m_allocations{0};
+  int m_reuses{0};
+};
+
+}  // namespace cs
+
+#endif  // CSCORE_IMAGEPOOL_H_
@@ -4,19 +4,24 @@
 
 #include "MjpegServerImpl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <wpi/SmallString.h>
+#include <wpi/SmallVector.h>
 #include <wpi/StringExtras.h>
 #include <wpi/fmt/raw_ostream.h>
 #include <wpi/print.h>
+#include <wpi/raw_ostream.h>
 #include <wpinet/HttpUtil.h>
-#include <wpinet/TCPAcceptor.h>
-#include <wpinet/raw_socket_istream.h>
-#include <wpinet/raw_socket_ostream.h>
+#include <wpinet/raw_uv_ostream.h>
+#include <wpinet/uv/Tcp.h>
+#include <wpinet/uv/Work.h>
+#include <wpinet/uv/util.h>
 
 #include "Instance.h"
 #include "JpegUtil.h"
@@ -75,25 +80,35 @@ static const char* startRootPage =
     "<div class=\"settings\">\n";
 static const char* endRootPage = "</div></body></html>";
 
-class MjpegServerImpl::ConnThread : public wpi::SafeThread {
- public:
-  explicit ConnThread(std::string_view name, wpi::Logger& logger)
-      : m_name(name), m_logger(logger) {}
+// Maximum number of simultaneous client streams
+static constexpr int kMaxStreams = 10;
+
+// Maximum size of a HTTP request (including headers)
+static constexpr size_t kMaxRequestSize = 16384;
 
-  void Main() override;
+// A client connection.  All functions are called on the event loop thread,
+// except BuildResponse(), which is called on a worker thread.
+class MjpegServerImpl::Connection
+    : public std::enable_shared_from_this<Connection> {
+ public:
+  Connection(MjpegServerImpl& server, wpi::uv::Tcp& stream);
 
   bool ProcessCommand(wpi::raw_ostream& os, SourceImpl& source,
                       std::string_view parameters, bool respond);
   void SendJSON(wpi::raw_ostream& os, SourceImpl& source, bool header);
   void SendHTMLHeadTitle(wpi::raw_ostream& os) const;
   void SendHTML(wpi::raw_ostream& os, SourceImpl& source, bool header);
-  void SendStream(wpi::raw_socket_ostream& os);
   void ProcessRequest();
 
-  std::unique_ptr<wpi::NetworkStream> m_stream;
-  std::shared_ptr<SourceImpl> m_source;
-  bool m_streaming = false;
-  bool m_noStreaming = false;
+  // Queues a stream frame for sending.  If a frame is already being written,
+  // this replaces any frame waiting behind it, so a slow client only ever
+  // gets the latest frame.
+  void SendFrame(std::shared_ptr<const std::string> frame);
+  // Sends a keep-alive if nothing is being written.
+  void SendKeepAlive(const std::shared_ptr<const std::string>& keepAlive);
+
+  void Close();
+
   int m_width = 0;
   int m_height = 0;
   int m_compression = -1;
@@ -101,31 +116,86 @@ class MjpegServerImpl::ConnThread : public wpi::SafeThread {
   int m_fps = 0;
 
  private:
+  MjpegServerImpl& m_server;
+  wpi::uv::Tcp& m_stream;
   std::string m_name;
   wpi::Logger& m_logger;
 
+  // request is accumulated (without '\r') until an empty line is received
+  std::string m_request;
+  size_t m_lineStart = 0;
+  bool m_gotRequest = false;
+
+  // set while streaming
+  std::shared_ptr<StreamGroup> m_group;
+  bool m_writing = false;
+  std::shared_ptr<const std::string> m_pendingFrame;
+
+  // set once the stream handle is closed, after which it must not be used
+  bool m_closed = false;
+
+  enum RequestKind {
+    kCommand,
+    kStream,
+    kGetSettings,
+    kGetSourceConfig,
+    kRootPage
+  };
+
   std::string_view GetName() { return m_name; }
 
-  std::shared_ptr<SourceImpl> GetSource() {
-    std::scoped_lock lock(m_mutex);
-    return m_source;
-  }
+  void ProcessData(std::string_view data);
+  // Commands and settings requests may block on the source (e.g. camera
+  // property changes), so the response is built on a worker thread to avoid
+  // stalling other clients' streams.  Returns true if the request should
+  // start a stream.
+  bool BuildResponse(RequestKind kind, std::string_view parameters,
+                     wpi::SmallVectorImpl<wpi::uv::Buffer>& bufs);
+  void FinishRequest(wpi::SmallVectorImpl<wpi::uv::Buffer>& bufs, bool stream);
+  bool StartStream(wpi::raw_ostream& os);
+  void StopStream();
+  void Send(std::span<const wpi::uv::Buffer> bufs, bool closeAfter);
+};
 
-  void StartStream() {
-    std::scoped_lock lock(m_mutex);
-    if (m_source) {
-      m_source->EnableSink();
+// All streaming connections with the same settings.  Each frame is converted
+// and encoded once per group, and the resulting buffer is shared by all of
+// the group's connections.
+struct MjpegServerImpl::StreamGroup {
+  explicit StreamGroup(const Connection& conn)
+      : width{conn.m_width},
+        height{conn.m_height},
+        compression{conn.m_compression},
+        defaultCompression{conn.m_defaultCompression},
+        fps{conn.m_fps} {
+    if (fps != 0) {
+      timePerFrame = 1000000.0 / fps;
+    }
+    if (averagePeriod < timePerFrame) {
+      averagePeriod = timePerFrame * 10;
     }
-    m_streaming = true;
   }
 
-  void StopStream() {
-    std::scoped_lock lock(m_mutex);
-    if (m_source) {
-      m_source->DisableSink();
-    }
-    m_streaming = false;
+  bool Matches(const Connection& conn) const {
+    return width == conn.m_width && height == conn.m_height &&
+           compression == conn.m_compression &&
+           defaultCompression == conn.m_defaultCompression && fps == conn.m_fps;
   }
+
+  // stream settings; never changed
+  const int width;
+  const int height;
+  const int compression;
+  const int defaultCompression;
+  const int fps;
+
+  // frame rate limiting; only used by the frame thread
+  Frame::Time lastFrameTime = 0;
+  Frame::Time timePerFrame = 0;
+  Frame::Time averageFrameTime = 0;
+  Frame::Time averagePeriod = 1000000;  // 1 second window
+
+  // only used by the loop thread
+  std::vector<Connection*> connections;
 };
 
 // Standard header to send along with other header information like mimetype.
@@ -195,7 +265,7 @@ static void SendError(wpi::raw_ostream& os, int code,
 }
 
 // Perform a command specified by HTTP GET parameters.
-bool MjpegServerImpl::ConnThread::ProcessCommand(wpi::raw_ostream& os,
+bool MjpegServerImpl::Connection::ProcessCommand(wpi::raw_ostream& os,
                                                  SourceImpl& source,
                                                  std::string_view parameters,
                                                  bool respond) {
@@ -334,14 +404,14 @@ bool MjpegServerImpl::ConnThread::ProcessCommand(wpi::raw_ostream& os,
   return true;
 }
 
-void MjpegServerImpl::ConnThread::SendHTMLHeadTitle(
+void MjpegServerImpl::Connection::SendHTMLHeadTitle(
     wpi::raw_ostream& os) const {
   os << "<html><head><title>" << m_name << " CameraServer</title>"
      << "<meta charset=\"UTF-8\">";
 }
 
 // Send the root html file with controls for all the settable properties.
-void MjpegServerImpl::ConnThread::SendHTML(wpi::raw_ostream& os,
+void MjpegServerImpl::Connection::SendHTML(wpi::raw_ostream& os,
                                            SourceImpl& source, bool header) {
   if (header) {
     SendHeader(os, 200, "OK", "text/html");
@@ -482,7 +552,7 @@ void MjpegServerImpl::ConnThread::SendHTML(wpi::raw_ostream& os,
 }
 
 // Send a JSON file which is contains information about the source parameters.
-void MjpegServerImpl::ConnThread::SendJSON(wpi::raw_ostream& os,
+void MjpegServerImpl::Connection::SendJSON(wpi::raw_ostream& os,
                                            SourceImpl& source, bool header) {
   if (header) {
     SendHeader(os, 200, "OK", "application/json");
@@ -599,12 +669,10 @@ void MjpegServerImpl::ConnThread::SendJSON(wpi::raw_ostream& os,
 
 MjpegServerImpl::MjpegServerImpl(std::string_view name, wpi::Logger& logger,
                                  Notifier& notifier, Telemetry& telemetry,
-                                 std::string_view listenAddress, int port,
-                                 std::unique_ptr<wpi::NetworkAcceptor> acceptor)
+                                 std::string_view listenAddress, int port)
     : SinkImpl{name, logger, notifier, telemetry},
       m_listenAddress(listenAddress),
-      m_port(port),
-      m_acceptor{std::move(acceptor)} {
+      m_port(port) {
   m_active = true;
 
   SetDescription(fmt::format("HTTP Server on port {}", port));
@@ -628,7 +696,8 @@ MjpegServerImpl::MjpegServerImpl(std::string_view name, wpi::Logger& logger,
     return std::make_unique<PropertyImpl>("fps", CS_PROP_INTEGER, 1, 0, 0);
   });
 
-  m_serverThread = std::thread(&MjpegServerImpl::ServerThreadMain, this);
+  m_loopRunner.ExecSync([this](wpi::uv::Loop& loop) { StartServer(loop); });
+  m_frameThread = std::thread(&MjpegServerImpl::FrameThreadMain, this);
 }
 
 MjpegServerImpl::~MjpegServerImpl() {
@@ -638,173 +707,152 @@ MjpegServerImpl::~MjpegServerImpl() {
 void MjpegServerImpl::Stop() {
   m_active = false;
 
-  // wake up server thread by shutting down the socket
-  m_acceptor->shutdown();
-
-  // join server thread
-  if (m_serverThread.joinable()) {
-    m_serverThread.join();
-  }
-
-  // close streams
-  for (auto& connThread : m_connThreads) {
-    if (auto thr = connThread.GetThread()) {
-      if (thr->m_stream) {
-        thr->m_stream->close();
-      }
-    }
-    connThread.Stop();
+  // wake up frame thread
+  {
+    std::scoped_lock lock(m_mutex);
+    m_frameCond.notify_all();
   }
-
-  // wake up connection threads by forcing an empty frame to be sent
   if (auto source = GetSource()) {
     source->Wakeup();
   }
-}
 
-// Send HTTP response and a stream of JPG-frames
-void MjpegServerImpl::ConnThread::SendStream(wpi::raw_socket_ostream& os) {
-  if (m_noStreaming) {
-    SERROR("Too many simultaneous client streams");
-    SendError(os, 503, "Too many simultaneous streams");
-    return;
+  // join frame thread
+  if (m_frameThread.joinable()) {
+    m_frameThread.join();
   }
 
-  os.SetUnbuffered();
-
-  wpi::SmallString<256> header;
-  wpi::raw_svector_ostream oss{header};
-
-  SendHeader(oss, 200, "OK", "multipart/x-mixed-replace;boundary=" BOUNDARY);
-  os << oss.str();
+  // close the server and all connections
+  m_loopRunner.Stop();
+}
 
-  SDEBUG("Headers send, sending stream now");
+MjpegServerImpl::Connection::Connection(MjpegServerImpl& server,
+                                        wpi::uv::Tcp& stream)
+    : m_server{server},
+      m_stream{stream},
+      m_name{server.GetName()},
+      m_logger{server.m_logger} {
+  stream.data.connect([this](wpi::uv::Buffer& buf, size_t size) {
+    ProcessData({buf.base, size});
+  });
+  stream.end.connect([this] { Close(); });
+  stream.error.connect([this](wpi::uv::Error) { Close(); });
+  // the handle may also be closed by the loop shutting down
+  stream.closed.connect([this] {
+    m_closed = true;
+    StopStream();
+  });
+  stream.StartRead();
+}
 
-  Frame::Time lastFrameTime = 0;
-  Frame::Time timePerFrame = 0;
-  if (m_fps != 0) {
-    timePerFrame = 1000000.0 / m_fps;
+void MjpegServerImpl::Connection::ProcessData(std::string_view data) {
+  if (m_gotRequest) {
+    return;  // ignore anything after the request
   }
-  Frame::Time averageFrameTime = 0;
-  Frame::Time averagePeriod = 1000000;  // 1 second window
-  if (averagePeriod < timePerFrame) {
-    averagePeriod = timePerFrame * 10;
-  }
-
-  StartStream();
-  while (m_active && !os.has_error()) {
-    auto source = GetSource();
-    if (!source) {
-      // Source disconnected; sleep so we don't consume all processor time.
-      os << "\r\n";  // Keep connection alive
-      std::this_thread::sleep_for(std::chrono::milliseconds(200));
-      continue;
-    }
-    SDEBUG4("waiting for frame");
-    Frame frame = source->GetNextFrame(0.225);  // blocks
-    if (!m_active) {
-      break;
-    }
-    if (!frame) {
-      // Bad frame; sleep for 20 ms so we don't consume all processor time.
-      os << "\r\n";  // Keep connection alive
-      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  for (char c : data) {
+    if (c == '\r') {
       continue;
     }
-
-    auto thisFrameTime = frame.GetTime();
-    if (thisFrameTime != 0 && timePerFrame != 0 && lastFrameTime != 0) {
-      Frame::Time deltaTime = thisFrameTime - lastFrameTime;
-
-      // drop frame if it is early compared to the desired frame rate AND
-      // the current average is higher than the desired average
-      if (deltaTime < timePerFrame && averageFrameTime < timePerFrame) {
-        // sleep for 1 ms so we don't consume all processor time
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        continue;
-      }
-
-      // update average
-      if (averageFrameTime != 0) {
-        averageFrameTime =
-            averageFrameTime * (averagePeriod - timePerFrame) / averagePeriod +
-            deltaTime * timePerFrame / averagePeriod;
-      } else {
-        averageFrameTime = deltaTime;
+    m_request.push_back(c);
+    if (c == '\n') {
+      // The end of the request is marked by a single, empty line
+      if (m_lineStart == m_request.size() - 1) {
+        m_gotRequest = true;
+        ProcessRequest();
+        return;
       }
+      m_lineStart = m_request.size();
     }
+  }
+  if (m_request.size() > kMaxRequestSize) {
+    SDEBUG("HTTP request too long");
+    Close();
+  }
+}
 
-    int width = m_width != 0 ? m_width : frame.GetOriginalWidth();
-    int height = m_height != 0 ? m_height : frame.GetOriginalHeight();
-    Image* image = frame.GetImageMJPEG(
-        width, height, m_compression,
-        m_compression == -1 ? m_defaultCompression : m_compression);
-    if (!image) {
-      // Shouldn't happen, but just in case...
-      std::this_thread::sleep_for(std::chrono::milliseconds(20));
-      continue;
+void MjpegServerImpl::Connection::Send(std::span<const wpi::uv::Buffer> bufs,
+                                       bool closeAfter) {
+  m_stream.Write(bufs, [self = shared_from_this(), closeAfter](
+                           auto bufs, wpi::uv::Error) {
+    for (auto&& buf : bufs) {
+      buf.Deallocate();
     }
-
-    const char* data = image->data();
-    size_t size = image->size();
-    bool addDHT = false;
-    size_t locSOF = size;
-    switch (image->pixelFormat) {
-      case VideoMode::kMJPEG:
-        // Determine if we need to add DHT to it, and allocate enough space
-        // for adding it if required.
-        addDHT = JpegNeedsDHT(data, &size, &locSOF);
-        break;
-      case VideoMode::kUYVY:
-      case VideoMode::kRGB565:
-      case VideoMode::kYUYV:
-      case VideoMode::kY16:
-      default:
-        // Bad frame; sleep for 10 ms so we don't consume all processor time.
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        continue;
+    if (closeAfter) {
+      self->Close();
     }
+  });
+}
 
-    SDEBUG4("sending frame size={} addDHT={}", size, addDHT);
-
-    // print the individual mimetype and the length
-    // sending the content-length fixes random stream disruption observed
-    // with firefox
-    lastFrameTime = thisFrameTime;
-    double timestamp = lastFrameTime / 1000000.0;
-    header.clear();
-    oss << "\r\n--" BOUNDARY "\r\n"
-        << "Content-Type: image/jpeg\r\n";
-    wpi::print(oss, "Content-Length: {}\r\n", size);
-    wpi::print(oss, "X-Timestamp: {}\r\n", timestamp);
-    oss << "\r\n";
-    os << oss.str();
-    if (addDHT) {
-      // Insert DHT data immediately before SOF
-      os << std::string_view(data, locSOF);
-      os << JpegGetDHT();
-      os << std::string_view(data + locSOF, image->size() - locSOF);
-    } else {
-      os << std::string_view(data, size);
-    }
-    // os.flush();
-  }
+void MjpegServerImpl::Connection::Close() {
   StopStream();
+  if (!m_stream.IsClosing()) {
+    m_stream.Close();
+  }
 }
 
-void MjpegServerImpl::ConnThread::ProcessRequest() {
-  wpi::raw_socket_istream is{*m_stream};
-  wpi::raw_socket_ostream os{*m_stream, true};
+// Send HTTP response header for a stream of JPG-frames and join the
+// matching stream group; returns false (with an error response) if too many
+// clients are streaming.
+bool MjpegServerImpl::Connection::StartStream(wpi::raw_ostream& os) {
+  m_group = m_server.AddStream(*this);
+  if (!m_group) {
+    SERROR("Too many simultaneous client streams");
+    SendError(os, 503, "Too many simultaneous streams");
+    return false;
+  }
 
-  // Read the request string from the stream
-  wpi::SmallString<128> reqBuf;
-  std::string_view req = is.getline(reqBuf, 4096);
-  if (is.has_error()) {
-    SDEBUG("error getting request string");
+  SendHeader(os, 200, "OK", "multipart/x-mixed-replace;boundary=" BOUNDARY);
+
+  SDEBUG("Headers send, sending stream now");
+  return true;
+}
+
+void MjpegServerImpl::Connection::StopStream() {
+  if (auto group = std::move(m_group)) {
+    m_server.RemoveStream(*this, *group);
+  }
+  m_pendingFrame.reset();
+}
+
+void MjpegServerImpl::Connection::SendFrame(
+    std::shared_ptr<const std::string> frame) {
+  if (!m_group) {
     return;
   }
+  if (m_writing) {
+    // drop any older frame that hasn't been started yet
+    m_pendingFrame = std::move(frame);
+    return;
+  }
+  m_writing = true;
+  // the buffer is shared with other connections and only freed when the
+  // last write completes, so it doesn't need to be copied
+  m_stream.Write({wpi::uv::Buffer{*frame}},
+                 [self = shared_from_this(), frame](auto, wpi::uv::Error err) {
+                   self->m_writing = false;
+                   if (err) {
+                     return;  // error handler will close the connection
+                   }
+                   if (auto next = std::move(self->m_pendingFrame)) {
+                     self->SendFrame(std::move(next));
+                   }
+                 });
+}
+
+void MjpegServerImpl::Connection::SendKeepAlive(
+    const std::shared_ptr<const std::string>& keepAlive) {
+  if (!m_writing) {
+    SendFrame(keepAlive);
+  }
+}
+
+void MjpegServerImpl::Connection::ProcessRequest() {
+  wpi::SmallVector<wpi::uv::Buffer, 4> bufs;
+  wpi::raw_uv_ostream os{bufs, 4096};
+
+  // The request string is the first line
+  std::string_view req = wpi::substr(m_request, 0, m_request.find('\n') + 1);
 
-  enum { kCommand, kStream, kGetSettings, kGetSourceConfig, kRootPage } kind;
+  RequestKind kind;
   std::string_view parameters;
   size_t pos;
 
@@ -843,6 +891,7 @@ void MjpegServerImpl::ConnThread::ProcessRequest() {
   } else {
     SDEBUG("HTTP request resource not found");
     SendError(os, 404, "Resource not found");
+    Send(os.bufs(), true);
     return;
   }
 
@@ -853,31 +902,41 @@ void MjpegServerImpl::ConnThread::ProcessRequest() {
   parameters = wpi::substr(parameters, 0, pos);
   SDEBUG("command parameters: \"{}\"", parameters);
 
-  // Read the rest of the HTTP request.
-  // The end of the request is marked by a single, empty line
-  wpi::SmallString<128> lineBuf;
-  for (;;) {
-    if (wpi::starts_with(is.getline(lineBuf, 4096), "\n")) {
-      break;
-    }
-    if (is.has_error()) {
-      return;
-    }
-  }
+  // Build the response on a worker thread, then send it from the loop
+  struct Response {
+    wpi::SmallVector<wpi::uv::Buffer, 4> bufs;
+    bool stream = false;
+  };
+  auto response = std::make_shared<Response>();
+  wpi::uv::QueueWork(
+      m_stream.GetLoopRef(),
+      [self = shared_from_this(), kind, parameters = std::string{parameters},
+       response] {
+        response->stream =
+            self->BuildResponse(kind, parameters, response->bufs);
+      },
+      [self = shared_from_this(), response] {
+        self->FinishRequest(response->bufs, response->stream);
+      });
+  m_request.clear();
+  m_request.shrink_to_fit();
+}
 
-  // Send response
+bool MjpegServerImpl::Connection::BuildResponse(
+    RequestKind kind, std::string_view parameters,
+    wpi::SmallVectorImpl<wpi::uv::Buffer>& bufs) {
+  wpi::raw_uv_ostream os{bufs, 4096};
   switch (kind) {
     case kStream:
-      if (auto source = GetSource()) {
+      if (auto source = m_server.GetSource()) {
         SDEBUG("request for stream {}", source->GetName());
         if (!ProcessCommand(os, *source, parameters, false)) {
-          return;
+          return false;
         }
       }
-      SendStream(os);
-      break;
+      return true;
     case kCommand:
-      if (auto source = GetSource()) {
+      if (auto source = m_server.GetSource()) {
         ProcessCommand(os, *source, parameters, true);
       } else {
         SendHeader(os, 200, "OK", "text/plain");
@@ -887,7 +946,7 @@ void MjpegServerImpl::ConnThread::ProcessRequest() {
       break;
     case kGetSettings:
       SDEBUG("request for JSON file");
-      if (auto source = GetSource()) {
+      if (auto source = m_server.GetSource()) {
         SendJSON(os, *source, true);
       } else {
         SendError(os, 404, "Resource not found");
@@ -895,11 +954,10 @@ void MjpegServerImpl::ConnThread::ProcessRequest() {
       break;
     case kGetSourceConfig:
       SDEBUG("request for JSON file");
-      if (auto source = GetSource()) {
+      if (auto source = m_server.GetSource()) {
         SendHeader(os, 200, "OK", "application/json");
         CS_Status status = CS_OK;
         os << source->GetConfigJson(&status);
-        os.flush();
       } else {
         SendError(os, 404, "Resource not found");
       }
@@ -907,7 +965,7 @@ void MjpegServerImpl::ConnThread::ProcessRequest() {
     case kRootPage:
       SDEBUG("request for root page");
       SendHeader(os, 200, "OK", "text/html");
-      if (auto source = GetSource()) {
+      if (auto source = m_server.GetSource()) {
         SendHTML(os, *source, false);
       } else {
         SendHTMLHeadTitle(os);
@@ -915,103 +973,286 @@ void MjpegServerImpl::ConnThread::ProcessRequest() {
       }
       break;
   }
-
-  SDEBUG("leaving HTTP client thread");
+  return false;
 }
 
-// worker thread for clients that connected to this server
-void MjpegServerImpl::ConnThread::Main() {
-  std::unique_lock lock(m_mutex);
-  while (m_active) {
-    while (!m_stream) {
-      m_cond.wait(lock);
-      if (!m_active) {
-        return;
-      }
+void MjpegServerImpl::Connection::FinishRequest(
+    wpi::SmallVectorImpl<wpi::uv::Buffer>& bufs, bool stream) {
+  if (m_closed || m_stream.IsClosing()) {
+    for (auto&& buf : bufs) {
+      buf.Deallocate();
     }
-    lock.unlock();
-    ProcessRequest();
-    lock.lock();
-    m_stream = nullptr;
+    return;
+  }
+
+  bool streaming = false;
+  if (stream) {
+    wpi::raw_uv_ostream os{bufs, 4096};
+    streaming = StartStream(os);
   }
+
+  // close after sending unless we're streaming
+  Send(bufs, !streaming);
 }
 
-// Main server thread
-void MjpegServerImpl::ServerThreadMain() {
-  if (m_acceptor->start() != 0) {
-    m_active = false;
+void MjpegServerImpl::StartServer(wpi::uv::Loop& loop) {
+  m_server = wpi::uv::Tcp::Create(loop);
+  if (!m_server) {
+    SERROR("could not create server");
     return;
   }
+  m_server->error.connect([this](wpi::uv::Error err) {
+    SERROR("server error: {}", err.str());
+  });
+  m_server->Bind(m_listenAddress, m_port);
+  m_server->connection.connect([this] { Accept(); });
 
   SDEBUG("waiting for clients to connect");
+  m_server->Listen();
+}
+
+void MjpegServerImpl::Accept() {
+  auto tcp = m_server->Accept();
+  if (!tcp) {
+    return;
+  }
+  tcp->SetNoDelay(true);
+
+  std::string peerIP;
+  unsigned int peerPort = 0;
+  if (wpi::uv::AddrToName(tcp->GetPeer(), &peerIP, &peerPort) == 0) {
+    SDEBUG("client connection from {}", peerIP);
+  }
+
+  auto conn = std::make_shared<Connection>(*this, *tcp);
+  {
+    std::scoped_lock lock(m_mutex);
+    conn->m_width = GetProperty(m_widthProp)->value;
+    conn->m_height = GetProperty(m_heightProp)->value;
+    conn->m_compression = GetProperty(m_compressionProp)->value;
+    conn->m_defaultCompression = GetProperty(m_defaultCompressionProp)->value;
+    conn->m_fps = GetProperty(m_fpsProp)->value;
+  }
+  tcp->SetData(conn);
+}
+
+std::shared_ptr<MjpegServerImpl::StreamGroup> MjpegServerImpl::AddStream(
+    Connection& conn) {
+  std::scoped_lock lock(m_mutex);
+  if (m_numStreams >= kMaxStreams) {
+    return nullptr;
+  }
+  ++m_numStreams;
+  if (m_streamSource) {
+    m_streamSource->EnableSink();
+  }
+
+  auto it =
+      std::find_if(m_groups.begin(), m_groups.end(),
+                   [&](const auto& group) { return group->Matches(conn); });
+  if (it == m_groups.end()) {
+    it = m_groups.emplace(m_groups.end(), std::make_shared<StreamGroup>(conn));
+    m_frameCond.notify_all();
+  }
+  (*it)->connections.emplace_back(&conn);
+  return *it;
+}
+
+void MjpegServerImpl::RemoveStream(Connection& conn, StreamGroup& group) {
+  std::scoped_lock lock(m_mutex);
+  std::erase(group.connections, &conn);
+  if (group.connections.empty()) {
+    std::erase_if(m_groups, [&](const auto& g) { return g.get() == &group; });
+  }
+  --m_numStreams;
+  if (m_streamSource) {
+    m_streamSource->DisableSink();
+  }
+}
+
+// Main frame thread
+void MjpegServerImpl::FrameThreadMain() {
+  std::vector<std::shared_ptr<StreamGroup>> groups;
+  std::vector<std::shared_ptr<StreamGroup>> wanted;
+  std::vector<Frame::ImageSpec> specs;
   while (m_active) {
-    auto stream = m_acceptor->accept();
-    if (!stream) {
-      m_active = false;
-      return;
+    {
+      std::unique_lock lock(m_mutex);
+      m_frameCond.wait(lock, [&] { return !m_active || !m_groups.empty(); });
+      if (!m_active) {
+        break;
+      }
+      groups = m_groups;
     }
+
+    auto source = GetSource();
+    if (!source) {
+      // Source disconnected; sleep so we don't consume all processor time.
+      SendKeepAlive(groups);
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      continue;
+    }
+    SDEBUG4("waiting for frame");
+    Frame frame = source->GetNextFrame(0.225);  // blocks
     if (!m_active) {
-      return;
+      break;
+    }
+    if (!frame) {
+      // Bad frame; sleep for 20 ms so we don't consume all processor time.
+      SendKeepAlive(groups);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      continue;
+    }
+
+    // Convert for all groups at once, so groups with different settings
+    // share intermediate images (e.g. the decoded camera image)
+    wanted.clear();
+    specs.clear();
+    for (auto&& group : groups) {
+      if (WantsFrame(*group, frame.GetTime())) {
+        wanted.emplace_back(group);
+        specs.emplace_back(GetImageSpec(*group, frame));
+      }
+    }
+    frame.PrepareImages(specs);
+
+    for (size_t i = 0; i < wanted.size(); ++i) {
+      if (auto data = EncodeFrame(*wanted[i], frame, specs[i])) {
+        m_loopRunner.ExecAsync(
+            [group = wanted[i], data = std::move(data)](wpi::uv::Loop&) {
+              for (auto conn : group->connections) {
+                conn->SendFrame(data);
+              }
+            });
+      }
     }
+  }
 
-    SDEBUG("client connection from {}", stream->getPeerIP());
+  SDEBUG("leaving frame thread");
+}
 
-    auto source = GetSource();
+// Returns false if the frame should be skipped to keep the stream group at
+// its requested frame rate.
+bool MjpegServerImpl::WantsFrame(StreamGroup& group, Frame::Time time) {
+  if (time != 0 && group.timePerFrame != 0 && group.lastFrameTime != 0) {
+    Frame::Time deltaTime = time - group.lastFrameTime;
 
-    std::scoped_lock lock(m_mutex);
-    // Find unoccupied worker thread, or create one if necessary
-    auto it = std::find_if(m_connThreads.begin(), m_connThreads.end(),
-                           [](const wpi::SafeThreadOwner<ConnThread>& owner) {
-                             auto thr = owner.GetThread();
-                             return !thr || !thr->m_stream;
-                           });
-    if (it == m_connThreads.end()) {
-      m_connThreads.emplace_back();
-      it = std::prev(m_connThreads.end());
+    // drop frame if it is early compared to the desired frame rate AND
+    // the current average is higher than the desired average
+    if (deltaTime < group.timePerFrame &&
+        group.averageFrameTime < group.timePerFrame) {
+      return false;
+    }
+
+    // update average
+    if (group.averageFrameTime != 0) {
+      group.averageFrameTime = group.averageFrameTime *
+                                   (group.averagePeriod - group.timePerFrame) /
+                                   group.averagePeriod +
+                               deltaTime * group.timePerFrame /
+                                   group.averagePeriod;
+    } else {
+      group.averageFrameTime = deltaTime;
     }
+  }
+  return true;
+}
+
+Frame::ImageSpec MjpegServerImpl::GetImageSpec(const StreamGroup& group,
+                                               const Frame& frame) {
+  return {
+      group.width != 0 ? group.width : frame.GetOriginalWidth(),
+      group.height != 0 ? group.height : frame.GetOriginalHeight(),
+      VideoMode::kMJPEG, group.compression,
+      group.compression == -1 ? group.defaultCompression : group.compression};
+}
 
-    // Start it if not already started
-    it->Start(GetName(), m_logger);
-
-    auto nstreams =
-        std::count_if(m_connThreads.begin(), m_connThreads.end(),
-                      [](const wpi::SafeThreadOwner<ConnThread>& owner) {
-                        auto thr = owner.GetThread();
-                        return thr && thr->m_streaming;
-                      });
-
-    // Hand off connection to it
-    auto thr = it->GetThread();
-    thr->m_stream = std::move(stream);
-    thr->m_source = source;
-    thr->m_noStreaming = nstreams >= 10;
-    thr->m_width = GetProperty(m_widthProp)->value;
-    thr->m_height = GetProperty(m_heightProp)->value;
-    thr->m_compression = GetProperty(m_compressionProp)->value;
-    thr->m_defaultCompression = GetProperty(m_defaultCompressionProp)->value;
-    thr->m_fps = GetProperty(m_fpsProp)->value;
-    thr->m_cond.notify_one();
+// Converts a frame for a stream group; returns the complete multipart
+// section (header and JPEG data), or nullptr on error.
+std::shared_ptr<const std::string> MjpegServerImpl::EncodeFrame(
+    StreamGroup& group, Frame& frame, const Frame::ImageSpec& spec) {
+  Image* image =
+      frame.GetImageMJPEG(spec.width, spec.height, spec.requiredJpegQuality,
+                          spec.defaultJpegQuality);
+  if (!image) {
+    // Shouldn't happen, but just in case...
+    return nullptr;
+  }
+
+  const char* data = image->data();
+  size_t size = image->size();
+  bool addDHT = false;
+  size_t locSOF = size;
+  switch (image->pixelFormat) {
+    case VideoMode::kMJPEG:
+      // Determine if we need to add DHT to it, and allocate enough space
+      // for adding it if required.
+      addDHT = JpegNeedsDHT(data, &size, &locSOF);
+      break;
+    case VideoMode::kUYVY:
+    case VideoMode::kRGB565:
+    case VideoMode::kYUYV:
+    case VideoMode::kY16:
+    default:
+      // Bad frame
+      return nullptr;
+  }
+
+  SDEBUG4("sending frame size={} addDHT={}", size, addDHT);
+
+  // print the individual mimetype and the length
+  // sending the content-length fixes random stream disruption observed
+  // with firefox
+  group.lastFrameTime = frame.GetTime();
+  double timestamp = group.lastFrameTime / 1000000.0;
+  auto buf = std::make_shared<std::string>();
+  buf->reserve(size + 128);
+  {
+    wpi::raw_string_ostream os{*buf};
+    os << "\r\n--" BOUNDARY "\r\n"
+       << "Content-Type: image/jpeg\r\n";
+    wpi::print(os, "Content-Length: {}\r\n", size);
+    wpi::print(os, "X-Timestamp: {}\r\n", timestamp);
+    os << "\r\n";
+    if (addDHT) {
+      // Insert DHT data immediately before SOF
+      os << std::string_view(data, locSOF);
+      os << JpegGetDHT();
+      os << std::string_view(data + locSOF, image->size() - locSOF);
+    } else {
+      os << std::string_view(data, size);
+    }
   }
+  return buf;
+}
 
-  SDEBUG("leaving server thread");
+void MjpegServerImpl::SendKeepAlive(
+    std::span<const std::shared_ptr<StreamGroup>> groups) {
+  static const auto keepAlive = std::make_shared<const std::string>("\r\n");
+  for (auto&& group : groups) {
+    m_loopRunner.ExecAsync([group](wpi::uv::Loop&) {
+      for (auto conn : group->connections) {
+        conn->SendKeepAlive(keepAlive);
+      }
+    });
+  }
 }
 
 void MjpegServerImpl::SetSourceImpl(std::shared_ptr<SourceImpl> source) {
   std::scoped_lock lock(m_mutex);
-  for (auto& connThread : m_connThreads) {
-    if (auto thr = connThread.GetThread()) {
-      if (thr->m_source != source) {
-        bool streaming = thr->m_streaming;
-        if (thr->m_source && streaming) {
-          thr->m_source->DisableSink();
-        }
-        thr->m_source = source;
-        if (source && streaming) {
-          thr->m_source->EnableSink();
-        }
-      }
+  if (m_streamSource == source) {
+    return;
+  }
+  // move the per-stream sink enables to the new source
+  for (int i = 0; i < m_numStreams; ++i) {
+    if (m_streamSource) {
+      m_streamSource->DisableSink();
+    }
+    if (source) {
+      source->EnableSink();
     }
   }
+  m_streamSource = std::move(source);
 }
 
 namespace cs {
@@ -1021,10 +1262,8 @@ CS_Sink CreateMjpegServer(std::string_view name, std::string_view listenAddress,
   auto& inst = Instance::GetInstance();
   return inst.CreateSink(
       CS_SINK_MJPEG,
-      std::make_shared<MjpegServerImpl>(
-          name, inst.logger, inst.notifier, inst.telemetry, listenAddress, port,
-          std::unique_ptr<wpi::NetworkAcceptor>(
-              new wpi::TCPAcceptor(port, listenAddress, inst.logger))));
+      std::make_shared<MjpegServerImpl>(name, inst.logger, inst.notifier,
+                                        inst.telemetry, listenAddress, port));
 }
 
 std::string GetMjpegServerListenAddress(CS_Sink sink, CS_Status* status) {
@@ -7,21 +7,22 @@
 
 #include <atomic>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <vector>
 
-#include <wpi/SafeThread.h>
-#include <wpi/SmallVector.h>
-#include <wpi/raw_istream.h>
-#include <wpi/raw_ostream.h>
-#include <wpinet/NetworkAcceptor.h>
-#include <wpinet/NetworkStream.h>
-#include <wpinet/raw_socket_ostream.h>
+#include <wpi/condition_variable.h>
+#include <wpinet/EventLoopRunner.h>
 
 #include "SinkImpl.h"
 
+namespace wpi::uv {
+class Loop;
+class Tcp;
+}  // namespace wpi::uv
+
 namespace cs {
 
 class SourceImpl;
@@ -30,8 +31,7 @@ class MjpegServerImpl : public SinkImpl {
  public:
   MjpegServerImpl(std::string_view name, wpi::Logger& logger,
                   Notifier& notifier, Telemetry& telemetry,
-                  std::string_view listenAddress, int port,
-                  std::unique_ptr<wpi::NetworkAcceptor> acceptor);
+                  std::string_view listenAddress, int port);
   ~MjpegServerImpl() override;
 
   void Stop();
@@ -41,19 +41,43 @@ class MjpegServerImpl : public SinkImpl {
  private:
   void SetSourceImpl(std::shared_ptr<SourceImpl> source) override;
 
-  void ServerThreadMain();
+  class Connection;
+  struct StreamGroup;
+
+  // Called on the event loop thread
+  void StartServer(wpi::uv::Loop& loop);
+  void Accept();
+  std::shared_ptr<StreamGroup> AddStream(Connection& conn);
+  void RemoveStream(Connection& conn, StreamGroup& group);
 
-  class ConnThread;
+  // Called on the frame thread
+  void FrameThreadMain();
+  bool WantsFrame(StreamGroup& group, Frame::Time time);
+  Frame::ImageSpec GetImageSpec(const StreamGroup& group, const Frame& frame);
+  std::shared_ptr<const std::string> EncodeFrame(StreamGroup& group,
+                                                 Frame& frame,
+                                                 const Frame::ImageSpec& spec);
+  void SendKeepAlive(std::span<const std::shared_ptr<StreamGroup>> groups);
 
   // Never changed, so not protected by mutex
   std::string m_listenAddress;
   int m_port;
 
-  std::unique_ptr<wpi::NetworkAcceptor> m_acceptor;
   std::atomic_bool m_active;  // set to false to terminate threads
-  std::thread m_serverThread;
 
-  std::vector<wpi::SafeThreadOwner<ConnThread>> m_connThreads;
+  // All connections are handled on this loop
+  wpi::EventLoopRunner m_loopRunner;
+  std::shared_ptr<wpi::uv::Tcp> m_server;  // only used on the loop thread
+
+  // Waits for frames from the source and encodes them for each stream group
+  std::thread m_frameThread;
+  wpi::condition_variable m_frameCond;
+
+  // Protected by m_mutex
+  std::vector<std::shared_ptr<StreamGroup>> m_groups;
+  int m_numStreams = 0;
+  // source that has been enabled once for each stream
+  std::shared_ptr<SourceImpl> m_streamSource;
 
   // property indices
   int m_widthProp;
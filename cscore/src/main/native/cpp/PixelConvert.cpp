@@ -0,0 +1,608 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "PixelConvert.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define CS_PIXELCONVERT_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CS_TARGET_SSSE3
+#define CS_TARGET_AVX2
+#else
+#define CS_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define CS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#define CS_PIXELCONVERT_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace cs;
+
+// YUV to RGB conversion (BT.601 limited range):
+//   R = 1.164(Y - 16) + 1.596(V - 128)
+//   G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128)
+//   B = 1.164(Y - 16) + 2.018(U - 128)
+//
+// This is computed in 16-bit fixed point so that every implementation gives
+// exactly the same result: inputs are scaled by 2^7, multiplied by Q15
+// coefficients (scaled by 1/4 to fit) with a rounding high multiply (the
+// semantics of SSSE3 pmulhrsw and NEON vqrdmulh), giving Q5 results that are
+// rounded and saturated to 8 bits.
+static constexpr int16_t kCY = 9535;    // 1.164 / 4 * 2^15
+static constexpr int16_t kCUB = 16531;  // 2.018 / 4 * 2^15
+static constexpr int16_t kCUG = -3203;  // -0.391 / 4 * 2^15
+static constexpr int16_t kCVG = -6660;  // -0.813 / 4 * 2^15
+static constexpr int16_t kCVR = 13074;  // 1.596 / 4 * 2^15
+
+namespace {
+
+//
+// Scalar
+//
+
+inline int MulHRS(int a, int b) {
+  return (a * b + 0x4000) >> 15;
+}
+
+inline uint8_t RoundQ5(int x) {
+  return std::clamp((x + 16) >> 5, 0, 255);
+}
+
+// yIdx is the offset of the first Y in each 4-byte pixel pair, uIdx the
+// offset of U (V is always 2 after U)
+template <int yIdx, int uIdx>
+void YUV422ToBGRScalar(const uint8_t* src, uint8_t* dst, size_t numPixels) {
+  for (size_t i = 0; i < numPixels; i += 2, src += 4, dst += 6) {
+    int u = (src[uIdx] - 128) << 7;
+    int v = (src[uIdx + 2] - 128) << 7;
+    int cb = MulHRS(u, kCUB);
+    int cg = MulHRS(u, kCUG) + MulHRS(v, kCVG);
+    int cr = MulHRS(v, kCVR);
+    for (int j = 0; j < 2; ++j) {
+      int y = MulHRS((std::max)(src[yIdx + j * 2] - 16, 0) << 7, kCY);
+      dst[j * 3 + 0] = RoundQ5(y + cb);
+      dst[j * 3 + 1] = RoundQ5(y + cg);
+      dst[j * 3 + 2] = RoundQ5(y + cr);
+    }
+  }
+}
+
+template <int yIdx>
+void YUV422ToGrayScalar(const uint8_t* src, uint8_t* dst, size_t numPixels) {
+  for (size_t i = 0; i < numPixels; ++i) {
+    dst[i] = src[i * 2 + yIdx];
+  }
+}
+
+void BGRToRGB565Scalar(const uint8_t* src, uint8_t* dst, size_t numPixels) {
+  for (size_t i = 0; i < numPixels; ++i, src += 3, dst += 2) {
+    unsigned int v =
+        (src[2] >> 3) | ((src[1] & 0xfc) << 3) | ((src[0] & 0xf8) << 8);
+    dst[0] = v & 0xff;
+    dst[1] = v >> 8;
+  }
+}
+
+void RGB565ToBGRScalar(const uint8_t* src, uint8_t* dst, size_t numPixels) {
+  for (size_t i = 0; i < numPixels; ++i, src += 2, dst += 3) {
+    unsigned int v = src[0] | (src[1] << 8);
+    dst[0] = (v >> 8) & 0xf8;
+    dst[1] = (v >> 3) & 0xfc;
+    dst[2] = (v << 3) & 0xf8;
+  }
+}
+
+void GrayToY16Scalar(const uint8_t* src, uint8_t* dst, size_t numPixels) {
+  for (size_t i = 0; i < numPixels; ++i) {
+    dst[i * 2] = 0;
+    dst[i * 2 + 1] = src[i];
+  }
+}
+
+constexpr PixelConverters kScalarConverters{
+    YUV422ToBGRScalar<0, 1>, YUV422ToBGRScalar<1, 0>,
+    YUV422ToGrayScalar<0>,   YUV422ToGrayScalar<1>,
+    BGRToRGB565Scalar,       RGB565ToBGRScalar,
+    GrayToY16Scalar};
+
+#ifdef CS_PIXELCONVERT_X86
+
+//
+// SSSE3
+//
+
+// Splits 16 packed 3-byte pixels into 3 planes
+CS_TARGET_SSSE3 inline void Deinterleave3(const uint8_t* src, __m128i* c0,
+                                          __m128i* c1, __m128i* c2) {
+  __m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  __m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+  __m128i in2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+  *c0 = _mm_or_si128(
+      _mm_or_si128(
+          _mm_shuffle_epi8(in0, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1,
+                                              -1, -1, -1, -1, -1, -1, -1)),
+          _mm_shuffle_epi8(in1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8,
+                                              11, 14, -1, -1, -1, -1, -1))),
+      _mm_shuffle_epi8(in2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          -1, -1, 1, 4, 7, 10, 13)));
+  *c1 = _mm_or_si128(
+      _mm_or_si128(
+          _mm_shuffle_epi8(in0, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1,
+                                              -1, -1, -1, -1, -1, -1, -1)),
+          _mm_shuffle_epi8(in1, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9,
+                                              12, 15, -1, -1, -1, -1, -1))),
+      _mm_shuffle_epi8(in2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          -1, -1, 2, 5, 8, 11, 14)));
+  *c2 = _mm_or_si128(
+      _mm_or_si128(
+          _mm_shuffle_epi8(in0, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1,
+                                              -1, -1, -1, -1, -1, -1, -1)),
+          _mm_shuffle_epi8(in1, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10,
+                                              13, -1, -1, -1, -1, -1, -1))),
+      _mm_shuffle_epi8(in2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          -1, 0, 3, 6, 9, 12, 15)));
+}
+
+// Combines 3 planes of 16 pixels into 16 packed 3-byte pixels
+CS_TARGET_SSSE3 inline void Interleave3(__m128i c0, __m128i c1, __m128i c2,
+                                        uint8_t* dst) {
+  __m128i out0 = _mm_or_si128(
+      _mm_or_si128(
+          _mm_shuffle_epi8(c0, _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1,
+                                             3, -1, -1, 4, -1, -1, 5)),
+          _mm_shuffle_epi8(c1, _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1,
+                                             -1, 3, -1, -1, 4, -1, -1))),
+      _mm_shuffle_epi8(c2, _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1,
+                                         -1, 3, -1, -1, 4, -1)));
+  __m128i out1 = _mm_or_si128(
+      _mm_or_si128(
+          _mm_shuffle_epi8(c0, _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8,
+                                             -1, -1, 9, -1, -1, 10, -1)),
+          _mm_shuffle_epi8(c1, _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1,
+                                             8, -1, -1, 9, -1, -1, 10))),
+      _mm_shuffle_epi8(c2, _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1,
+                                         8, -1, -1, 9, -1, -1)));
+  __m128i out2 = _mm_or_si128(
+      _mm_or_si128(
+          _mm_shuffle_epi8(c0, _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13,
+                                             -1, -1, 14, -1, -1, 15, -1, -1)),
+          _mm_shuffle_epi8(c1, _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1,
+                                             13, -1, -1, 14, -1, -1, 15, -1))),
+      _mm_shuffle_epi8(c2, _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1,
+                                         13, -1, -1, 14, -1, -1, 15)));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), out0);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), out1);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), out2);
+}
+
+// Converts 8 pixels; y, u, and v are 16-bit per pixel
+CS_TARGET_SSSE3 inline void YUVToBGR8(__m128i y, __m128i u, __m128i v,
+                                      __m128i* b, __m128i* g, __m128i* r) {
+  y = _mm_slli_epi16(_mm_max_epi16(_mm_sub_epi16(y, _mm_set1_epi16(16)),
+                                   _mm_setzero_si128()),
+                     7);
+  u = _mm_slli_epi16(_mm_sub_epi16(u, _mm_set1_epi16(128)), 7);
+  v = _mm_slli_epi16(_mm_sub_epi16(v, _mm_set1_epi16(128)), 7);
+  __m128i ys = _mm_mulhrs_epi16(y, _mm_set1_epi16(kCY));
+  __m128i cb = _mm_mulhrs_epi16(u, _mm_set1_epi16(kCUB));
+  __m128i cg = _mm_add_epi16(_mm_mulhrs_epi16(u, _mm_set1_epi16(kCUG)),
+                             _mm_mulhrs_epi16(v, _mm_set1_epi16(kCVG)));
+  __m128i cr = _mm_mulhrs_epi16(v, _mm_set1_epi16(kCVR));
+  __m128i round = _mm_set1_epi16(16);
+  *b = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(ys, cb), round), 5);
+  *g = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(ys, cg), round), 5);
+  *r = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(ys, cr), round), 5);
+}
+
+// Splits 8 YUV 4:2:2 pixels into 16-bit y, u, v (u and v duplicated)
+template <bool uyvy>
+CS_TARGET_SSSE3 inline void SplitYUV422(__m128i in, __m128i* y, __m128i* u,
+                                        __m128i* v) {
+  __m128i lo = _mm_and_si128(in, _mm_set1_epi16(0xff));
+  __m128i hi = _mm_srli_epi16(in, 8);
+  *y = uyvy ? hi : lo;
+  __m128i uv = uyvy ? lo : hi;
+  *u = _mm_shuffle_epi8(
+      uv, _mm_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13));
+  *v = _mm_shuffle_epi8(uv, _mm_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10,
+                                          11, 14, 15, 14, 15));
+}
+
+template <bool uyvy>
+CS_TARGET_SSSE3 void YUV422ToBGRSSSE3(const uint8_t* src, uint8_t* dst,
+                                      size_t numPixels) {
+  size_t i = 0;
+  for (; i + 16 <= numPixels; i += 16, src += 32, dst += 48) {
+    __m128i y, u, v, b0, g0, r0, b1, g1, r1;
+    SplitYUV422<uyvy>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)),
+                      &y, &u, &v);
+    YUVToBGR8(y, u, v, &b0, &g0, &r0);
+    SplitYUV422<uyvy>(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16)), &y, &u,
+        &v);
+    YUVToBGR8(y, u, v, &b1, &g1, &r1);
+    Interleave3(_mm_packus_epi16(b0, b1), _mm_packus_epi16(g0, g1),
+                _mm_packus_epi16(r0, r1), dst);
+  }
+  YUV422ToBGRScalar<uyvy ? 1 : 0, uyvy ? 0 : 1>(src, dst, numPixels - i);
+}
+
+template <bool uyvy>
+CS_TARGET_SSSE3 void YUV422ToGraySSSE3(const uint8_t* src, uint8_t* dst,
+                                       size_t numPixels) {
+  size_t i = 0;
+  for (; i + 16 <= numPixels; i += 16, src += 32, dst += 16) {
+    __m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+    if constexpr (uyvy) {
+      in0 = _mm_srli_epi16(in0, 8);
+      in1 = _mm_srli_epi16(in1, 8);
+    } else {
+      in0 = _mm_and_si128(in0, _mm_set1_epi16(0xff));
+      in1 = _mm_and_si128(in1, _mm_set1_epi16(0xff));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_packus_epi16(in0, in1));
+  }
+  YUV422ToGrayScalar<uyvy ? 1 : 0>(src, dst, numPixels - i);
+}
+
+CS_TARGET_SSSE3 void BGRToRGB565SSSE3(const uint8_t* src, uint8_t* dst,
+                                      size_t numPixels) {
+  size_t i = 0;
+  __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= numPixels; i += 16, src += 48, dst += 32) {
+    __m128i b, g, r;
+    Deinterleave3(src, &b, &g, &r);
+    b = _mm_and_si128(b, _mm_set1_epi8(static_cast<char>(0xf8)));
+    g = _mm_and_si128(g, _mm_set1_epi8(static_cast<char>(0xfc)));
+    r = _mm_srli_epi16(_mm_and_si128(r, _mm_set1_epi8(static_cast<char>(0xf8))),
+                       3);
+    // r is in the low byte, b in the high byte, g spans both
+    __m128i lo = _mm_or_si128(_mm_unpacklo_epi8(r, b),
+                              _mm_slli_epi16(_mm_unpacklo_epi8(g, zero), 3));
+    __m128i hi = _mm_or_si128(_mm_unpackhi_epi8(r, b),
+                              _mm_slli_epi16(_mm_unpackhi_epi8(g, zero), 3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), hi);
+  }
+  BGRToRGB565Scalar(src, dst, numPixels - i);
+}
+
+CS_TARGET_SSSE3 void RGB565ToBGRSSSE3(const uint8_t* src, uint8_t* dst,
+                                      size_t numPixels) {
+  size_t i = 0;
+  for (; i + 16 <= numPixels; i += 16, src += 32, dst += 48) {
+    __m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+    __m128i maskB = _mm_set1_epi16(0xf8);
+    __m128i maskG = _mm_set1_epi16(0xfc);
+    __m128i b = _mm_packus_epi16(_mm_and_si128(_mm_srli_epi16(in0, 8), maskB),
+                                 _mm_and_si128(_mm_srli_epi16(in1, 8), maskB));
+    __m128i g = _mm_packus_epi16(_mm_and_si128(_mm_srli_epi16(in0, 3), maskG),
+                                 _mm_and_si128(_mm_srli_epi16(in1, 3), maskG));
+    __m128i r = _mm_packus_epi16(_mm_and_si128(_mm_slli_epi16(in0, 3), maskB),
+                                 _mm_and_si128(_mm_slli_epi16(in1, 3), maskB));
+    Interleave3(b, g, r, dst);
+  }
+  RGB565ToBGRScalar(src, dst, numPixels - i);
+}
+
+CS_TARGET_SSSE3 void GrayToY16SSSE3(const uint8_t* src, uint8_t* dst,
+                                    size_t numPixels) {
+  size_t i = 0;
+  __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= numPixels; i += 16, src += 16, dst += 32) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_unpacklo_epi8(zero, in));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16),
+                     _mm_unpackhi_epi8(zero, in));
+  }
+  GrayToY16Scalar(src, dst, numPixels - i);
+}
+
+constexpr PixelConverters kSSSE3Converters{
+    YUV422ToBGRSSSE3<false>,  YUV422ToBGRSSSE3<true>,
+    YUV422ToGraySSSE3<false>, YUV422ToGraySSSE3<true>,
+    BGRToRGB565SSSE3,         RGB565ToBGRSSSE3,
+    GrayToY16SSSE3};
+
+//
+// AVX2
+//
+
+// Converts 16 pixels; y, u, and v are 16-bit per pixel
+CS_TARGET_AVX2 inline void YUVToBGR16(__m256i y, __m256i u, __m256i v,
+                                      __m256i* b, __m256i* g, __m256i* r) {
+  y = _mm256_slli_epi16(
+      _mm256_max_epi16(_mm256_sub_epi16(y, _mm256_set1_epi16(16)),
+                       _mm256_setzero_si256()),
+      7);
+  u = _mm256_slli_epi16(_mm256_sub_epi16(u, _mm256_set1_epi16(128)), 7);
+  v = _mm256_slli_epi16(_mm256_sub_epi16(v, _mm256_set1_epi16(128)), 7);
+  __m256i ys = _mm256_mulhrs_epi16(y, _mm256_set1_epi16(kCY));
+  __m256i cb = _mm256_mulhrs_epi16(u, _mm256_set1_epi16(kCUB));
+  __m256i cg =
+      _mm256_add_epi16(_mm256_mulhrs_epi16(u, _mm256_set1_epi16(kCUG)),
+                       _mm256_mulhrs_epi16(v, _mm256_set1_epi16(kCVG)));
+  __m256i cr = _mm256_mulhrs_epi16(v, _mm256_set1_epi16(kCVR));
+  __m256i round = _mm256_set1_epi16(16);
+  *b = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(ys, cb), round), 5);
+  *g = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(ys, cg), round), 5);
+  *r = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(ys, cr), round), 5);
+}
+
+// Splits 16 YUV 4:2:2 pixels into 16-bit y, u, v (u and v duplicated)
+template <bool uyvy>
+CS_TARGET_AVX2 inline void SplitYUV422(__m256i in, __m256i* y, __m256i* u,
+                                       __m256i* v) {
+  __m256i lo = _mm256_and_si256(in, _mm256_set1_epi16(0xff));
+  __m256i hi = _mm256_srli_epi16(in, 8);
+  *y = uyvy ? hi : lo;
+  __m256i uv = uyvy ? lo : hi;
+  *u = _mm256_shuffle_epi8(
+      uv, _mm256_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13,
+                           0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13));
+  *v = _mm256_shuffle_epi8(
+      uv,
+      _mm256_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15,
+                       2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15));
+}
+
+// Packs two sets of 16 16-bit values into 32 8-bit values, in order
+CS_TARGET_AVX2 inline __m256i PackUS(__m256i a, __m256i b) {
+  return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8);
+}
+
+template <bool uyvy>
+CS_TARGET_AVX2 void YUV422ToBGRAVX2(const uint8_t* src, uint8_t* dst,
+                                    size_t numPixels) {
+  size_t i = 0;
+  for (; i + 32 <= numPixels; i += 32, src += 64, dst += 96) {
+    __m256i y, u, v, b0, g0, r0, b1, g1, r1;
+    SplitYUV422<uyvy>(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), &y, &u, &v);
+    YUVToBGR16(y, u, v, &b0, &g0, &r0);
+    SplitYUV422<uyvy>(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32)), &y, &u,
+        &v);
+    YUVToBGR16(y, u, v, &b1, &g1, &r1);
+    __m256i b = PackUS(b0, b1);
+    __m256i g = PackUS(g0, g1);
+    __m256i r = PackUS(r0, r1);
+    Interleave3(_mm256_castsi256_si128(b), _mm256_castsi256_si128(g),
+                _mm256_castsi256_si128(r), dst);
+    Interleave3(_mm256_extracti128_si256(b, 1), _mm256_extracti128_si256(g, 1),
+                _mm256_extracti128_si256(r, 1), dst + 48);
+  }
+  YUV422ToBGRSSSE3<uyvy>(src, dst, numPixels - i);
+}
+
+template <bool uyvy>
+CS_TARGET_AVX2 void YUV422ToGrayAVX2(const uint8_t* src, uint8_t* dst,
+                                     size_t numPixels) {
+  size_t i = 0;
+  for (; i + 32 <= numPixels; i += 32, src += 64, dst += 32) {
+    __m256i in0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    __m256i in1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+    if constexpr (uyvy) {
+      in0 = _mm256_srli_epi16(in0, 8);
+      in1 = _mm256_srli_epi16(in1, 8);
+    } else {
+      in0 = _mm256_and_si256(in0, _mm256_set1_epi16(0xff));
+      in1 = _mm256_and_si256(in1, _mm256_set1_epi16(0xff));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), PackUS(in0, in1));
+  }
+  YUV422ToGraySSSE3<uyvy>(src, dst, numPixels - i);
+}
+
+CS_TARGET_AVX2 void GrayToY16AVX2(const uint8_t* src, uint8_t* dst,
+                                  size_t numPixels) {
+  size_t i = 0;
+  __m256i zero = _mm256_setzero_si256();
+  for (; i + 32 <= numPixels; i += 32, src += 32, dst += 64) {
+    __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    // unpack works within 128-bit lanes, so fix up the order afterwards
+    __m256i lo = _mm256_unpacklo_epi8(zero, in);
+    __m256i hi = _mm256_unpackhi_epi8(zero, in);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                        _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32),
+                        _mm256_permute2x128_si256(lo, hi, 0x31));
+  }
+  GrayToY16SSSE3(src, dst, numPixels - i);
+}
+
+// The RGB565 conversions are dominated by the 3-byte (de)interleave, which
+// doesn't benefit from 256-bit registers, so use the SSSE3 versions.
+constexpr PixelConverters kAVX2Converters{
+    YUV422ToBGRAVX2<false>,  YUV422ToBGRAVX2<true>,
+    YUV422ToGrayAVX2<false>, YUV422ToGrayAVX2<true>,
+    BGRToRGB565SSSE3,        RGB565ToBGRSSSE3,
+    GrayToY16AVX2};
+
+struct CpuFeatures {
+  bool ssse3 = false;
+  bool avx2 = false;
+};
+
+CpuFeatures DetectCpuFeatures() {
+  CpuFeatures features;
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0);
+  int maxLeaf = info[0];
+  __cpuid(info, 1);
+  features.ssse3 = (info[2] & (1 << 9)) != 0;
+  // AVX2 also requires the OS to save YMM state
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 6) == 6) {
+    __cpuidex(info, 7, 0);
+    features.avx2 = (info[1] & (1 << 5)) != 0;
+  }
+#else
+  __builtin_cpu_init();
+  features.ssse3 = __builtin_cpu_supports("ssse3");
+  features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+  return features;
+}
+
+#endif  // CS_PIXELCONVERT_X86
+
+#ifdef CS_PIXELCONVERT_NEON
+
+//
+// NEON
+//
+
+// Converts 8 pixels from the scaled luma and chroma terms
+inline void YUVToBGR8(int16x8_t ys, int16x8_t cb, int16x8_t cg, int16x8_t cr,
+                      uint8x8_t* b, uint8x8_t* g, uint8x8_t* r) {
+  *b = vqrshrun_n_s16(vaddq_s16(ys, cb), 5);
+  *g = vqrshrun_n_s16(vaddq_s16(ys, cg), 5);
+  *r = vqrshrun_n_s16(vaddq_s16(ys, cr), 5);
+}
+
+inline int16x8_t ScaleY(uint8x8_t y) {
+  int16x8_t y16 = vreinterpretq_s16_u16(vmovl_u8(vqsub_u8(y, vdup_n_u8(16))));
+  return vqrdmulhq_n_s16(vshlq_n_s16(y16, 7), kCY);
+}
+
+inline int16x8_t ScaleUV(uint8x8_t uv) {
+  return vshlq_n_s16(
+      vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(uv)), vdupq_n_s16(128)), 7);
+}
+
+template <bool uyvy>
+void YUV422ToBGRNEON(const uint8_t* src, uint8_t* dst, size_t numPixels) {
+  size_t i = 0;
+  for (; i + 16 <= numPixels; i += 16, src += 32, dst += 48) {
+    // even Y, U, odd Y, V (or U, even Y, V, odd Y)
+    uint8x8x4_t in = vld4_u8(src);
+    uint8x8_t yEven = uyvy ? in.val[1] : in.val[0];
+    uint8x8_t yOdd = uyvy ? in.val[3] : in.val[2];
+    int16x8_t u = ScaleUV(uyvy ? in.val[0] : in.val[1]);
+    int16x8_t v = ScaleUV(uyvy ? in.val[2] : in.val[3]);
+    int16x8_t cb = vqrdmulhq_n_s16(u, kCUB);
+    int16x8_t cg =
+        vaddq_s16(vqrdmulhq_n_s16(u, kCUG), vqrdmulhq_n_s16(v, kCVG));
+    int16x8_t cr = vqrdmulhq_n_s16(v, kCVR);
+    uint8x8_t bEven, gEven, rEven, bOdd, gOdd, rOdd;
+    YUVToBGR8(ScaleY(yEven), cb, cg, cr, &bEven, &gEven, &rEven);
+    YUVToBGR8(ScaleY(yOdd), cb, cg, cr, &bOdd, &gOdd, &rOdd);
+    uint8x8x2_t b = vzip_u8(bEven, bOdd);
+    uint8x8x2_t g = vzip_u8(gEven, gOdd);
+    uint8x8x2_t r = vzip_u8(rEven, rOdd);
+    uint8x16x3_t out;
+    out.val[0] = vcombine_u8(b.val[0], b.val[1]);
+    out.val[1] = vcombine_u8(g.val[0], g.val[1]);
+    out.val[2] = vcombine_u8(r.val[0], r.val[1]);
+    vst3q_u8(dst, out);
+  }
+  YUV422ToBGRScalar<uyvy ? 1 : 0, uyvy ? 0 : 1>(src, dst, numPixels - i);
+}
+
+template <bool uyvy>
+void YUV422ToGrayNEON(const uint8_t* src, uint8_t* dst, size_t numPixels) {
+  size_t i = 0;
+  for (; i + 16 <= numPixels; i += 16, src += 32, dst += 16) {
+    uint8x16x2_t in = vld2q_u8(src);
+    vst1q_u8(dst, uyvy ? in.val[1] : in.val[0]);
+  }
+  YUV422ToGrayScalar<uyvy ? 1 : 0>(src, dst, numPixels - i);
+}
+
+void BGRToRGB565NEON(const uint8_t* src, uint8_t* dst, size_t numPixels) {
+  size_t i = 0;
+  for (; i + 8 <= numPixels; i += 8, src += 24, dst += 16) {
+    uint8x8x3_t in = vld3_u8(src);
+    uint16x8_t out = vmovl_u8(vshr_n_u8(in.val[2], 3));
+    out = vorrq_u16(out, vshll_n_u8(vand_u8(in.val[1], vdup_n_u8(0xfc)), 3));
+    out = vorrq_u16(out, vshll_n_u8(vand_u8(in.val[0], vdup_n_u8(0xf8)), 8));
+    vst1q_u8(dst, vreinterpretq_u8_u16(out));
+  }
+  BGRToRGB565Scalar(src, dst, numPixels - i);
+}
+
+void RGB565ToBGRNEON(const uint8_t* src, uint8_t* dst, size_t numPixels) {
+  size_t i = 0;
+  for (; i + 8 <= numPixels; i += 8, src += 16, dst += 24) {
+    uint16x8_t in = vreinterpretq_u16_u8(vld1q_u8(src));
+    uint8x8x3_t out;
+    out.val[0] = vand_u8(vshrn_n_u16(in, 8), vdup_n_u8(0xf8));
+    out.val[1] = vand_u8(vshrn_n_u16(in, 3), vdup_n_u8(0xfc));
+    out.val[2] = vand_u8(vmovn_u16(vshlq_n_u16(in, 3)), vdup_n_u8(0xf8));
+    vst3_u8(dst, out);
+  }
+  RGB565ToBGRScalar(src, dst, numPixels - i);
+}
+
+void GrayToY16NEON(const uint8_t* src, uint8_t* dst, size_t numPixels) {
+  size_t i = 0;
+  for (; i + 16 <= numPixels; i += 16, src += 16, dst += 32) {
+    uint8x16_t in = vld1q_u8(src);
+    vst1q_u8(dst, vreinterpretq_u8_u16(vshll_n_u8(vget_low_u8(in), 8)));
+    vst1q_u8(dst + 16, vreinterpretq_u8_u16(vshll_n_u8(vget_high_u8(in), 8)));
+  }
+  GrayToY16Scalar(src, dst, numPixels - i);
+}
+
+constexpr PixelConverters kNEONConverters{
+    YUV422ToBGRNEON<false>,  YUV422ToBGRNEON<true>,
+    YUV422ToGrayNEON<false>, YUV422ToGrayNEON<true>,
+    BGRToRGB565NEON,         RGB565ToBGRNEON,
+    GrayToY16NEON};
+
+#endif  // CS_PIXELCONVERT_NEON
+
+}  // namespace
+
+const PixelConverters* cs::GetPixelConverters(PixelConvertIsa isa) {
+#ifdef CS_PIXELCONVERT_X86
+  static const CpuFeatures features = DetectCpuFeatures();
+#endif
+  switch (isa) {
+    case PixelConvertIsa::kScalar:
+      return &kScalarConverters;
+#ifdef CS_PIXELCONVERT_X86
+    case PixelConvertIsa::kSSSE3:
+      return features.ssse3 ? &kSSSE3Converters : nullptr;
+    case PixelConvertIsa::kAVX2:
+      return features.avx2 && features.ssse3 ? &kAVX2Converters : nullptr;
+#endif
+#ifdef CS_PIXELCONVERT_NEON
+    case PixelConvertIsa::kNEON:
+      return &kNEONConverters;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+const PixelConverters& cs::GetPixelConverters() {
+  static const PixelConverters* converters = [] {
+    for (auto isa : {PixelConvertIsa::kAVX2, PixelConvertIsa::kSSSE3,
+                     PixelConvertIsa::kNEON}) {
+      if (auto rv = GetPixelConverters(isa)) {
+        return rv;
+      }
+    }
+    return &kScalarConverters;
+  }();
+  return *converters;
+}
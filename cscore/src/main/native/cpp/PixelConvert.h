@@ -0,0 +1,47 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_PIXELCONVERT_H_
+#define CSCORE_PIXELCONVERT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace cs {
+
+// Pixel format conversion kernels.  All images are tightly packed (no row
+// padding), so each kernel converts a run of numPixels pixels.  YUYV and UYVY
+// kernels require numPixels to be even.
+//
+// Each kernel has SIMD implementations (SSSE3/AVX2 on x86, NEON on ARM) as
+// well as a portable scalar fallback; the best implementation supported by
+// the CPU is selected at runtime.  All implementations of a kernel produce
+// identical results.
+struct PixelConverters {
+  // YUV 4:2:2 (BT.601 limited range) to BGR
+  void (*yuyvToBGR)(const uint8_t* src, uint8_t* dst, size_t numPixels);
+  void (*uyvyToBGR)(const uint8_t* src, uint8_t* dst, size_t numPixels);
+  // Extract luma
+  void (*yuyvToGray)(const uint8_t* src, uint8_t* dst, size_t numPixels);
+  void (*uyvyToGray)(const uint8_t* src, uint8_t* dst, size_t numPixels);
+  // BGR to/from RGB565 (little endian; red in the low 5 bits)
+  void (*bgrToRGB565)(const uint8_t* src, uint8_t* dst, size_t numPixels);
+  void (*rgb565ToBGR)(const uint8_t* src, uint8_t* dst, size_t numPixels);
+  // Gray to Y16 (linear scaling by 256)
+  void (*grayToY16)(const uint8_t* src, uint8_t* dst, size_t numPixels);
+};
+
+enum class PixelConvertIsa { kScalar, kSSSE3, kAVX2, kNEON };
+
+// Gets the converters for a specific instruction set.  Returns nullptr if
+// the instruction set isn't supported by this build or CPU.  Kernels without
+// a dedicated implementation for the instruction set use the next best one.
+const PixelConverters* GetPixelConverters(PixelConvertIsa isa);
+
+// Gets the best converters supported by the CPU.
+const PixelConverters& GetPixelConverters();
+
+}  // namespace cs
+
+#endif  // CSCORE_PIXELCONVERT_H_
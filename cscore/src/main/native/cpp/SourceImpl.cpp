@@ -21,8 +21,6 @@
 
 using namespace cs;
 
-static constexpr size_t kMaxImagesAvail = 32;
-
 SourceImpl::SourceImpl(std::string_view name, wpi::Logger& logger,
                        Notifier& notifier, Telemetry& telemetry)
     : m_logger(logger),
@@ -39,8 +37,10 @@ SourceImpl::~SourceImpl() {
   // Set a flag so ReleaseFrame() doesn't re-add them to m_framesAvail.
   // Put in a block so we destroy before the destructor ends.
   {
+    std::scoped_lock lock{m_poolMutex};
     m_destroyFrames = true;
     auto frames = std::move(m_framesAvail);
+    m_imagePool.Clear();
   }
   // Everything else can clean up itself.
 }
@@ -432,26 +432,7 @@ std::unique_ptr<Image> SourceImpl::AllocImage(
   std::unique_ptr<Image> image;
   {
     std::scoped_lock lock{m_poolMutex};
-    // find the smallest existing frame that is at least big enough.
-    int found = -1;
-    for (size_t i = 0; i < m_imagesAvail.size(); ++i) {
-      // is it big enough?
-      if (m_imagesAvail[i] && m_imagesAvail[i]->capacity() >= size) {
-        // is it smaller than the last found?
-        if (found < 0 ||
-            m_imagesAvail[i]->capacity() < m_imagesAvail[found]->capacity()) {
-          // yes, update
-          found = i;
-        }
-      }
-    }
-
-    // if nothing found, allocate a new buffer
-    if (found < 0) {
-      image = std::make_unique<Image>(size);
-    } else {
-      image = std::move(m_imagesAvail[found]);
-    }
+    image = m_imagePool.Alloc(size);
   }
 
   // Initialize image
@@ -459,6 +440,7 @@ std::unique_ptr<Image> SourceImpl::AllocImage(
   image->pixelFormat = pixelFormat;
   image->width = width;
   image->height = height;
+  image->jpegQuality = -1;
 
   return image;
 }
@@ -490,6 +472,13 @@ void SourceImpl::PutFrame(std::unique_ptr<Image> image, Frame::Time time,
   // Update telemetry
   m_telemetry.RecordSourceFrames(*this, 1);
   m_telemetry.RecordSourceBytes(*this, static_cast<int>(image->size()));
+  int allocations, reuses;
+  {
+    std::scoped_lock lock{m_poolMutex};
+    m_imagePool.TakeStats(&allocations, &reuses);
+  }
+  m_telemetry.RecordSourceImageAllocations(*this, allocations);
+  m_telemetry.RecordSourceImagePoolReuses(*this, reuses);
 
   // Update frame
   {
@@ -550,25 +539,7 @@ void SourceImpl::ReleaseImage(std::unique_ptr<Image> image) {
   if (m_destroyFrames) {
     return;
   }
-  // Return the frame to the pool.  First try to find an empty slot, otherwise
-  // add it to the end.
-  auto it = std::find(m_imagesAvail.begin(), m_imagesAvail.end(), nullptr);
-  if (it != m_imagesAvail.end()) {
-    *it = std::move(image);
-  } else if (m_imagesAvail.size() > kMaxImagesAvail) {
-    // Replace smallest buffer; don't need to check for null because the above
-    // find would have found it.
-    auto it2 = std::min_element(
-        m_imagesAvail.begin(), m_imagesAvail.end(),
-        [](const std::unique_ptr<Image>& a, const std::unique_ptr<Image>& b) {
-          return a->capacity() < b->capacity();
-        });
-    if ((*it2)->capacity() < image->capacity()) {
-      *it2 = std::move(image);
-    }
-  } else {
-    m_imagesAvail.emplace_back(std::move(image));
-  }
+  m_imagePool.Release(std::move(image));
 }
 
 std::unique_ptr<Frame::Impl> SourceImpl::AllocFrameImpl() {
@@ -21,6 +21,7 @@
 #include "Frame.h"
 #include "Handle.h"
 #include "Image.h"
+#include "ImagePool.h"
 #include "PropertyContainer.h"
 #include "cscore_cpp.h"
 
@@ -183,7 +184,7 @@ class SourceImpl : public PropertyContainer {
   // Pool of frames/images to reduce malloc traffic.
   wpi::mutex m_poolMutex;
   std::vector<std::unique_ptr<Frame::Impl>> m_framesAvail;
-  std::vector<std::unique_ptr<Image>> m_imagesAvail;
+  ImagePool m_imagePool;
 
   std::atomic_bool m_connected{false};
 
@@ -130,24 +130,54 @@ double Telemetry::GetAverageValue(CS_Handle handle, CS_TelemetryKind kind,
   return thr->GetValue(handle, kind, status) / thr->m_elapsed;
 }
 
-void Telemetry::RecordSourceBytes(const SourceImpl& source, int quantity) {
+int64_t Telemetry::GetCurrentValue(CS_Handle handle, CS_TelemetryKind kind) {
   auto thr = m_owner.GetThread();
   if (!thr) {
-    return;
+    return 0;
   }
-  auto handleData = Instance::GetInstance().FindSource(source);
-  thr->m_current[std::pair{Handle{handleData.first, Handle::kSource},
-                           static_cast<int>(CS_SOURCE_BYTES_RECEIVED)}] +=
-      quantity;
+  auto it = thr->m_current.find(std::pair{handle, static_cast<int>(kind)});
+  return it == thr->m_current.end() ? 0 : it->getSecond();
+}
+
+void Telemetry::RecordSourceBytes(const SourceImpl& source, int quantity) {
+  RecordSource(source, CS_SOURCE_BYTES_RECEIVED, quantity);
 }
 
 void Telemetry::RecordSourceFrames(const SourceImpl& source, int quantity) {
+  RecordSource(source, CS_SOURCE_FRAMES_RECEIVED, quantity);
+}
+
+void Telemetry::RecordSourceConversions(const SourceImpl& source,
+                                        int quantity) {
+  RecordSource(source, CS_SOURCE_CONVERSIONS, quantity);
+}
+
+void Telemetry::RecordSourceConversionCacheHits(const SourceImpl& source,
+                                                int quantity) {
+  RecordSource(source, CS_SOURCE_CONVERSION_CACHE_HITS, quantity);
+}
+
+void Telemetry::RecordSourceImageAllocations(const SourceImpl& source,
+                                             int quantity) {
+  if (quantity != 0) {
+    RecordSource(source, CS_SOURCE_IMAGE_ALLOCATIONS, quantity);
+  }
+}
+
+void Telemetry::RecordSourceImagePoolReuses(const SourceImpl& source,
+                                            int quantity) {
+  if (quantity != 0) {
+    RecordSource(source, CS_SOURCE_IMAGE_POOL_REUSES, quantity);
+  }
+}
+
+void Telemetry::RecordSource(const SourceImpl& source, CS_TelemetryKind kind,
+                             int quantity) {
   auto thr = m_owner.GetThread();
   if (!thr) {
     return;
   }
   auto handleData = Instance::GetInstance().FindSource(source);
   thr->m_current[std::pair{Handle{handleData.first, Handle::kSource},
-                           static_cast<int>(CS_SOURCE_FRAMES_RECEIVED)}] +=
-      quantity;
+                           static_cast<int>(kind)}] += quantity;
 }
@@ -31,11 +31,22 @@ class Telemetry {
   double GetAverageValue(CS_Handle handle, CS_TelemetryKind kind,
                          CS_Status* status);
 
+  // Total recorded so far in the current period, which isn't visible through
+  // GetValue() until the period ends
+  int64_t GetCurrentValue(CS_Handle handle, CS_TelemetryKind kind);
+
   // Telemetry events
   void RecordSourceBytes(const SourceImpl& source, int quantity);
   void RecordSourceFrames(const SourceImpl& source, int quantity);
+  void RecordSourceConversions(const SourceImpl& source, int quantity);
+  void RecordSourceConversionCacheHits(const SourceImpl& source, int quantity);
+  void RecordSourceImageAllocations(const SourceImpl& source, int quantity);
+  void RecordSourceImagePoolReuses(const SourceImpl& source, int quantity);
 
  private:
+  void RecordSource(const SourceImpl& source, CS_TelemetryKind kind,
+                    int quantity);
+
   Notifier& m_notifier;
 
   class Thread;
@@ -170,7 +170,15 @@ enum CS_EventKind {
  */
 enum CS_TelemetryKind {
   CS_SOURCE_BYTES_RECEIVED = 1,
-  CS_SOURCE_FRAMES_RECEIVED = 2
+  CS_SOURCE_FRAMES_RECEIVED = 2,
+  /** Images created by pixel format conversion or resizing */
+  CS_SOURCE_CONVERSIONS = 3,
+  /** Image requests satisfied by a previously converted image */
+  CS_SOURCE_CONVERSION_CACHE_HITS = 4,
+  /** Image buffers allocated from the heap */
+  CS_SOURCE_IMAGE_ALLOCATIONS = 5,
+  /** Image buffers reused from the source's pool */
+  CS_SOURCE_IMAGE_POOL_REUSES = 6
 };
 
 /** Connection strategy */
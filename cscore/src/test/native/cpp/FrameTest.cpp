@@ -0,0 +1,247 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "Frame.h"  // NOLINT(build/include_order)
+
+#include <stdint.h>
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Instance.h"
+#include "SourceImpl.h"
+#include "Telemetry.h"
+#include "cscore_raw.h"
+
+namespace cs {
+
+class FrameTest : public ::testing::Test {
+ protected:
+  struct Counts {
+    int64_t conversions = 0;
+    int64_t cacheHits = 0;
+  };
+
+  // Conversions are counted by telemetry. With the default period, the
+  // counts aren't reset while a test runs.
+  FrameTest()
+      : m_raw{"frametest", VideoMode{VideoMode::kBGR, 64, 48, 30}},
+        m_source{Instance::GetInstance().GetSource(m_raw.GetHandle())->source} {
+    Instance::GetInstance().telemetry.Start();
+  }
+
+  ~FrameTest() override { Instance::GetInstance().telemetry.Stop(); }
+
+  // Creates a frame with one image, filled by repeating the pixel (or, for
+  // YUYV, the pixel pair)
+  Frame MakeFrame(VideoMode::PixelFormat pixelFormat, int width, int height,
+                  std::span<const uint8_t> pixel);
+
+  // Runs func and returns the conversions it made
+  Counts CountConversions(std::function<void()> func);
+
+  RawSource m_raw;
+  std::shared_ptr<SourceImpl> m_source;
+};
+
+static const uint8_t kBGRRed[] = {0, 0, 255};
+static const uint8_t kYUYVRed[] = {81, 90, 81, 240};
+
+// Checks every pixel of the image is close to the expected pixel
+static void ExpectPixels(Image* image, std::span<const uint8_t> pixel) {
+  ASSERT_NE(image, nullptr);
+  ASSERT_EQ(image->size(), image->width * image->height * pixel.size());
+  for (size_t i = 0; i < image->size(); ++i) {
+    EXPECT_NEAR(image->bytes()[i], pixel[i % pixel.size()], 2) << "i=" << i;
+  }
+}
+
+static size_t CountImages(const Frame& frame) {
+  size_t count = 0;
+  while (frame.GetExistingImage(count)) {
+    ++count;
+  }
+  return count;
+}
+
+Frame FrameTest::MakeFrame(VideoMode::PixelFormat pixelFormat, int width,
+                           int height, std::span<const uint8_t> pixel) {
+  int pixelsPerPattern = pixelFormat == VideoMode::kYUYV ? 2 : 1;
+  size_t size = width * height / pixelsPerPattern * pixel.size();
+  auto image = m_source->AllocImage(pixelFormat, width, height, size);
+  for (size_t i = 0; i < size; i += pixel.size()) {
+    std::memcpy(image->bytes() + i, pixel.data(), pixel.size());
+  }
+  return Frame{*m_source, std::move(image), 0, WPI_TIMESRC_UNKNOWN};
+}
+
+FrameTest::Counts FrameTest::CountConversions(std::function<void()> func) {
+  auto& telemetry = Instance::GetInstance().telemetry;
+  auto count = [&] {
+    return Counts{
+        telemetry.GetCurrentValue(m_raw.GetHandle(), CS_SOURCE_CONVERSIONS),
+        telemetry.GetCurrentValue(m_raw.GetHandle(),
+                                  CS_SOURCE_CONVERSION_CACHE_HITS)};
+  };
+  Counts before = count();
+  func();
+  Counts after = count();
+  return {after.conversions - before.conversions,
+          after.cacheHits - before.cacheHits};
+}
+
+TEST_F(FrameTest, RawSource) {
+  std::vector<uint8_t> data(4 * 2 * 3);
+  for (size_t i = 0; i < data.size(); i += 3) {
+    std::memcpy(&data[i], kBGRRed, 3);
+  }
+  WPI_RawFrame raw{};
+  raw.data = data.data();
+  raw.capacity = data.size();
+  raw.size = data.size();
+  raw.pixelFormat = WPI_PIXFMT_BGR;
+  raw.width = 4;
+  raw.height = 2;
+  raw.stride = 4 * 3;
+  CS_Status status = 0;
+  PutSourceFrame(m_raw.GetHandle(), raw, &status);
+  ASSERT_EQ(status, 0);
+
+  Frame frame = m_source->GetCurFrame();
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(frame.GetOriginalPixelFormat(), VideoMode::kBGR);
+  ExpectPixels(frame.GetImage(4, 2, VideoMode::kBGR), kBGRRed);
+  ExpectPixels(frame.GetImage(4, 2, VideoMode::kGray),
+               std::vector<uint8_t>{76});
+}
+
+TEST_F(FrameTest, ConvertBGR) {
+  Frame frame = MakeFrame(VideoMode::kBGR, 4, 2, kBGRRed);
+  ExpectPixels(frame.GetImage(4, 2, VideoMode::kGray),
+               std::vector<uint8_t>{76});
+  ExpectPixels(frame.GetImage(4, 2, VideoMode::kBGRA),
+               std::vector<uint8_t>{0, 0, 255, 255});
+
+  Image* jpeg = frame.GetImageMJPEG(4, 2, 80);
+  ASSERT_NE(jpeg, nullptr);
+  EXPECT_EQ(jpeg->pixelFormat, VideoMode::kMJPEG);
+  EXPECT_EQ(jpeg->jpegQuality, 80);
+  EXPECT_GT(jpeg->size(), 0u);
+}
+
+TEST_F(FrameTest, ConvertYUYV) {
+  Frame frame = MakeFrame(VideoMode::kYUYV, 4, 2, kYUYVRed);
+  ExpectPixels(frame.GetImage(4, 2, VideoMode::kBGR), kBGRRed);
+}
+
+TEST_F(FrameTest, ConvertYUYVToGrayDirectly) {
+  Frame frame = MakeFrame(VideoMode::kYUYV, 4, 2, kYUYVRed);
+  Counts counts = CountConversions([&] {
+    ExpectPixels(frame.GetImage(4, 2, VideoMode::kGray),
+                 std::vector<uint8_t>{81});
+  });
+  EXPECT_EQ(counts.conversions, 1);
+  EXPECT_EQ(frame.GetExistingImage(4, 2, VideoMode::kBGR), nullptr);
+}
+
+TEST_F(FrameTest, ConvertGray) {
+  // with no color image available, gray can be converted to color
+  Frame frame = MakeFrame(VideoMode::kGray, 4, 2, std::vector<uint8_t>{100});
+  ExpectPixels(frame.GetImage(4, 2, VideoMode::kBGR),
+               std::vector<uint8_t>{100, 100, 100});
+}
+
+TEST_F(FrameTest, CacheHit) {
+  Frame frame = MakeFrame(VideoMode::kBGR, 4, 2, kBGRRed);
+  Image* first = nullptr;
+  Image* second = nullptr;
+  Counts counts = CountConversions([&] {
+    first = frame.GetImage(4, 2, VideoMode::kGray);
+    second = frame.GetImage(4, 2, VideoMode::kGray);
+    // passing through the original image isn't a cache hit
+    frame.GetImage(4, 2, VideoMode::kBGR);
+  });
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(counts.conversions, 1);
+  EXPECT_EQ(counts.cacheHits, 1);
+  EXPECT_EQ(CountImages(frame), 2u);
+}
+
+TEST_F(FrameTest, JpegQualityReencodes) {
+  Frame frame = MakeFrame(VideoMode::kBGR, 16, 16, kBGRRed);
+  Image* low = nullptr;
+  Image* high = nullptr;
+  Image* close = nullptr;
+  Counts counts = CountConversions([&] {
+    low = frame.GetImageMJPEG(16, 16, 50);
+    high = frame.GetImageMJPEG(16, 16, 90);
+    // within 5 of an existing image is close enough
+    close = frame.GetImageMJPEG(16, 16, 53);
+  });
+  ASSERT_NE(low, nullptr);
+  ASSERT_NE(high, nullptr);
+  EXPECT_NE(low, high);
+  EXPECT_EQ(low->jpegQuality, 50);
+  EXPECT_EQ(high->jpegQuality, 90);
+  EXPECT_EQ(close, low);
+  EXPECT_EQ(counts.conversions, 2);
+  EXPECT_EQ(counts.cacheHits, 1);
+}
+
+TEST_F(FrameTest, ResizeBeforeConvert) {
+  // shrinking first is cheaper than converting the full size image
+  Frame frame = MakeFrame(VideoMode::kBGR, 64, 48, kBGRRed);
+  Counts counts = CountConversions([&] {
+    ExpectPixels(frame.GetImage(16, 12, VideoMode::kGray),
+                 std::vector<uint8_t>{76});
+  });
+  EXPECT_EQ(counts.conversions, 2);
+  EXPECT_NE(frame.GetExistingImage(16, 12, VideoMode::kBGR), nullptr);
+  EXPECT_EQ(frame.GetExistingImage(64, 48, VideoMode::kGray), nullptr);
+}
+
+TEST_F(FrameTest, GrayNotUpgradedToColor) {
+  Frame frame = MakeFrame(VideoMode::kBGR, 64, 48, kBGRRed);
+  ASSERT_NE(frame.GetImage(64, 48, VideoMode::kGray), nullptr);
+
+  // resizing the gray image and converting it to color would be cheaper,
+  // but would lose the color
+  ExpectPixels(frame.GetImage(16, 12, VideoMode::kBGR), kBGRRed);
+  EXPECT_EQ(frame.GetExistingImage(16, 12, VideoMode::kGray), nullptr);
+}
+
+TEST_F(FrameTest, PrepareImagesSharesIntermediates) {
+  Frame frame = MakeFrame(VideoMode::kYUYV, 64, 48, kYUYVRed);
+  const Frame::ImageSpec specs[] = {{32, 24, VideoMode::kMJPEG, 50},
+                                    {32, 24, VideoMode::kBGR}};
+
+  // YUYV can't be resized, so both images need the full size BGR image, and
+  // the JPEG is encoded from the resized BGR image
+  Counts counts = CountConversions([&] { frame.PrepareImages(specs); });
+  EXPECT_EQ(counts.conversions, 3);
+  EXPECT_EQ(CountImages(frame), 4u);
+  EXPECT_NE(frame.GetExistingImage(64, 48, VideoMode::kBGR), nullptr);
+
+  // the sinks then get the prepared images without converting
+  Image* jpeg = nullptr;
+  Image* bgr = nullptr;
+  counts = CountConversions([&] {
+    jpeg = frame.GetImageMJPEG(32, 24, 50);
+    bgr = frame.GetImage(32, 24, VideoMode::kBGR);
+  });
+  EXPECT_EQ(counts.conversions, 0);
+  EXPECT_EQ(counts.cacheHits, 2);
+  ASSERT_NE(jpeg, nullptr);
+  EXPECT_EQ(jpeg->jpegQuality, 50);
+  ExpectPixels(bgr, kBGRRed);
+  EXPECT_EQ(CountImages(frame), 4u);
+}
+
+}  // namespace cs
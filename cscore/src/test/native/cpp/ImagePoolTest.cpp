@@ -0,0 +1,90 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ImagePool.h"  // NOLINT(build/include_order)
+
+#include <stdint.h>
+
+#include <memory>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+namespace cs {
+
+TEST(ImagePoolTest, SizeClass) {
+  EXPECT_EQ(ImagePool::GetSizeClass(0), 0u);
+  EXPECT_EQ(ImagePool::GetSizeClass(4096), 0u);
+  EXPECT_EQ(ImagePool::GetSizeClass(4097), 1u);
+  EXPECT_EQ(ImagePool::GetSizeClass(6144), 1u);
+  EXPECT_EQ(ImagePool::GetSizeClass(6145), 2u);
+  EXPECT_EQ(ImagePool::GetSizeClass(8192), 2u);
+  for (size_t size : {1000u, 5000u, 640u * 480 * 2, 640u * 480 * 3,
+                      1920u * 1080 * 3}) {
+    size_t sizeClass = ImagePool::GetSizeClass(size);
+    EXPECT_GE(ImagePool::GetClassCapacity(sizeClass), size);
+    if (sizeClass > 0) {
+      EXPECT_LT(ImagePool::GetClassCapacity(sizeClass - 1), size);
+    }
+  }
+}
+
+TEST(ImagePoolTest, Aligned) {
+  ImagePool pool;
+  for (size_t size : {10u, 5000u, 640u * 480 * 3, 1920u * 1080 * 3}) {
+    auto image = pool.Alloc(size);
+    EXPECT_GE(image->capacity(), size);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(image->data()) % Image::kAlignment,
+              0u);
+  }
+}
+
+TEST(ImagePoolTest, Reuse) {
+  ImagePool pool;
+  int allocations, reuses;
+
+  auto image = pool.Alloc(640 * 480 * 3);
+  Image* ptr = image.get();
+  pool.Release(std::move(image));
+
+  // same class
+  image = pool.Alloc(640 * 480 * 3 - 100);
+  EXPECT_EQ(image.get(), ptr);
+  pool.Release(std::move(image));
+
+  // smaller class, but next larger class is available
+  image = pool.Alloc(640 * 480 * 2);
+  EXPECT_EQ(image.get(), ptr);
+  pool.TakeStats(&allocations, &reuses);
+  EXPECT_EQ(allocations, 1);
+  EXPECT_EQ(reuses, 2);
+
+  // different class
+  auto image2 = pool.Alloc(100);
+  EXPECT_NE(image2.get(), ptr);
+  pool.TakeStats(&allocations, &reuses);
+  EXPECT_EQ(allocations, 1);
+  EXPECT_EQ(reuses, 0);
+}
+
+TEST(ImagePoolTest, ResizePreservesData) {
+  ImagePool pool;
+  auto image = pool.Alloc(10);
+  image->SetSize(3);
+  image->data()[0] = 1;
+  image->data()[1] = 2;
+  image->data()[2] = 3;
+  image->SetSize(100000);
+  EXPECT_GE(image->capacity(), 100000u);
+  EXPECT_EQ(image->data()[0], 1);
+  EXPECT_EQ(image->data()[1], 2);
+  EXPECT_EQ(image->data()[2], 3);
+  // released to the class that fits its new capacity
+  Image* ptr = image.get();
+  pool.Release(std::move(image));
+  image = pool.Alloc(65536);
+  EXPECT_EQ(image.get(), ptr);
+}
+
+}  // namespace cs
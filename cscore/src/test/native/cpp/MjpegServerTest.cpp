@@ -0,0 +1,169 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <opencv2/core/core.hpp>
+#include <wpi/Logger.h>
+#include <wpi/SmallString.h>
+#include <wpi/StringExtras.h>
+#include <wpinet/HttpUtil.h>
+#include <wpinet/TCPConnector.h>
+
+#include "JpegUtil.h"
+#include "cscore_cv.h"
+
+namespace cs {
+
+static constexpr int kPort = 11891;
+static constexpr int kWidth = 640;
+static constexpr int kHeight = 480;
+
+class MjpegServerTest : public ::testing::Test {
+ protected:
+  MjpegServerTest();
+  ~MjpegServerTest() override;
+
+  // Connects a client and requests a stream; returns nullptr on error
+  std::unique_ptr<wpi::HttpConnection> Connect(std::string* boundary);
+
+  wpi::Logger m_logger;
+  CvSource m_source{"source", VideoMode::kBGR, kWidth, kHeight, 30};
+  MjpegServer m_server{"server", kPort};
+  std::atomic_bool m_active{true};
+  std::thread m_thread;
+};
+
+MjpegServerTest::MjpegServerTest() {
+  m_server.SetSource(m_source);
+
+  // Noise compresses poorly, so the frames are large enough to fill a
+  // client's socket buffers quickly if it doesn't read them
+  cv::Mat image{kHeight, kWidth, CV_8UC3};
+  std::mt19937 gen{1234};
+  for (size_t i = 0; i < image.total() * image.elemSize(); ++i) {
+    image.data[i] = gen();
+  }
+  m_thread = std::thread([this, image]() mutable {
+    while (m_active) {
+      m_source.PutFrame(image);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  });
+}
+
+MjpegServerTest::~MjpegServerTest() {
+  m_active = false;
+  m_thread.join();
+}
+
+std::unique_ptr<wpi::HttpConnection> MjpegServerTest::Connect(
+    std::string* boundary) {
+  auto stream = wpi::TCPConnector::connect("127.0.0.1", kPort, m_logger, 1);
+  if (!stream) {
+    return nullptr;
+  }
+  auto conn = std::make_unique<wpi::HttpConnection>(std::move(stream), 1);
+
+  bool error = false;
+  std::string errorMsg;
+  wpi::HttpLocation location{
+      fmt::format("http://127.0.0.1:{}/stream.mjpg", kPort), &error,
+      &errorMsg};
+  std::string warn;
+  if (error || !conn->Handshake(wpi::HttpRequest{location}, &warn)) {
+    return nullptr;
+  }
+
+  auto [mediaType, parameter] = wpi::split(conn->contentType.str(), ';');
+  auto [key, value] = wpi::split(parameter, '=');
+  if (mediaType != "multipart/x-mixed-replace" || key != "boundary") {
+    return nullptr;
+  }
+  *boundary = value;
+  return conn;
+}
+
+// Reads the next image from a stream; returns an empty string on error
+static std::string ReadFrame(wpi::HttpConnection& conn,
+                             std::string_view boundary) {
+  if (!wpi::FindMultipartBoundary(conn.is, boundary, nullptr)) {
+    return {};
+  }
+
+  // skip the \r\n after the boundary
+  char eol[2];
+  conn.is.read(eol, 2);
+
+  wpi::SmallString<64> contentType;
+  wpi::SmallString<64> contentLength;
+  if (!wpi::ParseHttpHeaders(conn.is, &contentType, &contentLength) ||
+      contentType.str() != "image/jpeg") {
+    return {};
+  }
+  auto size = wpi::parse_integer<size_t>(contentLength, 10);
+  if (!size) {
+    return {};
+  }
+  std::string image(size.value(), '\0');
+  conn.is.read(image.data(), image.size());
+  if (conn.is.has_error()) {
+    return {};
+  }
+  return image;
+}
+
+static void ExpectJpeg(std::string_view image) {
+  ASSERT_TRUE(IsJpeg(image));
+  int width, height;
+  ASSERT_TRUE(GetJpegSize(image, &width, &height));
+  EXPECT_EQ(width, kWidth);
+  EXPECT_EQ(height, kHeight);
+}
+
+TEST_F(MjpegServerTest, MultipleClients) {
+  std::string boundary1;
+  auto client1 = Connect(&boundary1);
+  ASSERT_TRUE(client1);
+  std::string boundary2;
+  auto client2 = Connect(&boundary2);
+  ASSERT_TRUE(client2);
+
+  // both clients are sent the same frames
+  for (int i = 0; i < 3; ++i) {
+    ExpectJpeg(ReadFrame(*client1, boundary1));
+    ExpectJpeg(ReadFrame(*client2, boundary2));
+  }
+}
+
+TEST_F(MjpegServerTest, SlowClient) {
+  std::string slowBoundary;
+  auto slow = Connect(&slowBoundary);
+  ASSERT_TRUE(slow);
+  std::string fastBoundary;
+  auto fast = Connect(&fastBoundary);
+  ASSERT_TRUE(fast);
+
+  // The slow client doesn't read while the fast client reads many more
+  // frames than fit in its socket buffers.  Reads time out after a second,
+  // so this fails if the server waits for the slow client.
+  for (int i = 0; i < 40; ++i) {
+    ExpectJpeg(ReadFrame(*fast, fastBoundary));
+  }
+
+  // The slow client still gets complete frames once it reads
+  for (int i = 0; i < 3; ++i) {
+    ExpectJpeg(ReadFrame(*slow, slowBoundary));
+  }
+}
+
+}  // namespace cs
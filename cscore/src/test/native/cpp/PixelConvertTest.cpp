@@ -0,0 +1,136 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "PixelConvert.h"  // NOLINT(build/include_order)
+
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace cs {
+
+using Kernel = void (*PixelConverters::*)(const uint8_t*, uint8_t*, size_t);
+
+struct KernelInfo {
+  const char* name;
+  Kernel kernel;
+  size_t srcBytes;  // per pixel
+  size_t dstBytes;  // per pixel
+};
+
+static const KernelInfo kKernels[] = {
+    {"yuyvToBGR", &PixelConverters::yuyvToBGR, 2, 3},
+    {"uyvyToBGR", &PixelConverters::uyvyToBGR, 2, 3},
+    {"yuyvToGray", &PixelConverters::yuyvToGray, 2, 1},
+    {"uyvyToGray", &PixelConverters::uyvyToGray, 2, 1},
+    {"bgrToRGB565", &PixelConverters::bgrToRGB565, 3, 2},
+    {"rgb565ToBGR", &PixelConverters::rgb565ToBGR, 2, 3},
+    {"grayToY16", &PixelConverters::grayToY16, 1, 2},
+};
+
+static std::vector<uint8_t> Convert(const PixelConverters& converters,
+                                    const KernelInfo& info,
+                                    const std::vector<uint8_t>& src) {
+  size_t numPixels = src.size() / info.srcBytes;
+  // extra byte to detect overruns
+  std::vector<uint8_t> dst(numPixels * info.dstBytes + 1, 0xa5);
+  (converters.*info.kernel)(src.data(), dst.data(), numPixels);
+  EXPECT_EQ(dst.back(), 0xa5) << info.name << " wrote past end";
+  dst.pop_back();
+  return dst;
+}
+
+class PixelConvertTest : public ::testing::TestWithParam<PixelConvertIsa> {};
+
+TEST_P(PixelConvertTest, MatchesScalar) {
+  auto converters = GetPixelConverters(GetParam());
+  if (!converters) {
+    GTEST_SKIP() << "not supported";
+  }
+  auto& scalar = *GetPixelConverters(PixelConvertIsa::kScalar);
+  std::mt19937 gen{1234};
+  std::uniform_int_distribution<int> dist{0, 255};
+  // sizes on both sides of the SIMD block sizes, to exercise the tails
+  for (size_t numPixels : {0, 2, 6, 8, 14, 16, 18, 30, 32, 34, 62, 64, 66,
+                           96, 100, 640 * 3 + 2}) {
+    for (auto&& info : kKernels) {
+      std::vector<uint8_t> src(numPixels * info.srcBytes);
+      for (auto&& b : src) {
+        b = dist(gen);
+      }
+      EXPECT_EQ(Convert(*converters, info, src), Convert(scalar, info, src))
+          << info.name << " numPixels=" << numPixels;
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(PixelConvertTests, PixelConvertTest,
+                         ::testing::Values(PixelConvertIsa::kScalar,
+                                           PixelConvertIsa::kSSSE3,
+                                           PixelConvertIsa::kAVX2,
+                                           PixelConvertIsa::kNEON));
+
+TEST(PixelConvertScalarTest, YUYVToBGR) {
+  auto& scalar = *GetPixelConverters(PixelConvertIsa::kScalar);
+  // black, white, (nearly) pure red, blue
+  std::vector<uint8_t> src{16, 128, 16, 128, 235, 128, 235, 128,
+                           81, 90,  81, 240, 41,  240, 41,  110};
+  std::vector<uint8_t> dst(8 * 3);
+  scalar.yuyvToBGR(src.data(), dst.data(), 8);
+  std::vector<int> expected{0,   0, 0,   0,   0, 0,   255, 255,
+                            255, 255, 255, 255, 0, 0,   255, 0,
+                            0,   255, 255, 0, 0,   255, 0, 0};
+  for (size_t i = 0; i < dst.size(); ++i) {
+    EXPECT_NEAR(dst[i], expected[i], 2) << "i=" << i;
+  }
+
+  // UYVY is the same with the bytes in a different order
+  std::vector<uint8_t> uyvy(src.size());
+  for (size_t i = 0; i < src.size(); i += 2) {
+    uyvy[i] = src[i + 1];
+    uyvy[i + 1] = src[i];
+  }
+  std::vector<uint8_t> dst2(8 * 3);
+  scalar.uyvyToBGR(uyvy.data(), dst2.data(), 8);
+  EXPECT_EQ(dst, dst2);
+}
+
+TEST(PixelConvertScalarTest, YUYVToGray) {
+  auto& scalar = *GetPixelConverters(PixelConvertIsa::kScalar);
+  std::vector<uint8_t> src{1, 2, 3, 4};
+  std::vector<uint8_t> dst(2);
+  scalar.yuyvToGray(src.data(), dst.data(), 2);
+  EXPECT_EQ(dst, (std::vector<uint8_t>{1, 3}));
+  scalar.uyvyToGray(src.data(), dst.data(), 2);
+  EXPECT_EQ(dst, (std::vector<uint8_t>{2, 4}));
+}
+
+TEST(PixelConvertScalarTest, RGB565) {
+  auto& scalar = *GetPixelConverters(PixelConvertIsa::kScalar);
+  // red in the low bits, blue in the high bits
+  std::vector<uint8_t> bgr{0x00, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00,
+                           0x00};
+  std::vector<uint8_t> rgb565(3 * 2);
+  scalar.bgrToRGB565(bgr.data(), rgb565.data(), 3);
+  EXPECT_EQ(rgb565, (std::vector<uint8_t>{0x1f, 0x00, 0xe0, 0x07, 0x00, 0xf8}));
+
+  // round trip drops the low bits
+  std::vector<uint8_t> bgr2(3 * 3);
+  scalar.rgb565ToBGR(rgb565.data(), bgr2.data(), 3);
+  EXPECT_EQ(bgr2, (std::vector<uint8_t>{0x00, 0x00, 0xf8, 0x00, 0xfc, 0x00,
+                                        0xf8, 0x00, 0x00}));
+}
+
+TEST(PixelConvertScalarTest, GrayToY16) {
+  auto& scalar = *GetPixelConverters(PixelConvertIsa::kScalar);
+  std::vector<uint8_t> src{0x12, 0xff};
+  std::vector<uint8_t> dst(4);
+  scalar.grayToY16(src.data(), dst.data(), 2);
+  EXPECT_EQ(dst, (std::vector<uint8_t>{0x00, 0x12, 0x00, 0xff}));
+}
+
+}  // namespace cs
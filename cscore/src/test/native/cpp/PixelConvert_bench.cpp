@@ -0,0 +1,83 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "PixelConvert.h"  // NOLINT(build/include_order)
+
+#include <stdint.h>
+
+#include <chrono>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wpi/print.h>
+
+namespace cs {
+
+using Kernel = void (*PixelConverters::*)(const uint8_t*, uint8_t*, size_t);
+
+TEST(PixelConvertTest, Benchmark) {
+  using std::chrono::duration_cast;
+  using std::chrono::high_resolution_clock;
+  using std::chrono::microseconds;
+
+  // 640x480, as from a typical USB camera
+  static constexpr size_t kNumPixels = 640 * 480;
+  static constexpr int kIterations = 100;
+
+  static const struct {
+    const char* name;
+    Kernel kernel;
+  } kernels[] = {
+      {"YUYV->BGR", &PixelConverters::yuyvToBGR},
+      {"UYVY->BGR", &PixelConverters::uyvyToBGR},
+      {"YUYV->Gray", &PixelConverters::yuyvToGray},
+      {"UYVY->Gray", &PixelConverters::uyvyToGray},
+      {"BGR->RGB565", &PixelConverters::bgrToRGB565},
+      {"RGB565->BGR", &PixelConverters::rgb565ToBGR},
+      {"Gray->Y16", &PixelConverters::grayToY16},
+  };
+  static const struct {
+    const char* name;
+    PixelConvertIsa isa;
+  } isas[] = {
+      {"scalar", PixelConvertIsa::kScalar},
+      {"SSSE3", PixelConvertIsa::kSSSE3},
+      {"AVX2", PixelConvertIsa::kAVX2},
+      {"NEON", PixelConvertIsa::kNEON},
+  };
+
+  // big enough for any source or destination format
+  std::vector<uint8_t> src(kNumPixels * 3);
+  std::vector<uint8_t> dst(kNumPixels * 3);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = i * 7;
+  }
+
+  for (auto&& kernel : kernels) {
+    double scalarTime = 0;
+    for (auto&& isa : isas) {
+      auto converters = GetPixelConverters(isa.isa);
+      if (!converters) {
+        continue;
+      }
+      auto func = converters->*kernel.kernel;
+      func(src.data(), dst.data(), kNumPixels);  // warmup
+      auto start = high_resolution_clock::now();
+      for (int i = 0; i < kIterations; ++i) {
+        func(src.data(), dst.data(), kNumPixels);
+      }
+      auto stop = high_resolution_clock::now();
+      double time =
+          duration_cast<microseconds>(stop - start).count() /
+          static_cast<double>(kIterations);
+      if (isa.isa == PixelConvertIsa::kScalar) {
+        scalarTime = time;
+      }
+      wpi::print("{:<12} {:<6} {:8.1f} us/frame ({:.1f}x)\n", kernel.name,
+                 isa.name, time, time > 0 ? scalarTime / time : 0.0);
+    }
+  }
+}
+
+}  // namespace cs
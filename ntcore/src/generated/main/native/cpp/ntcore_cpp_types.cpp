@@ -78,6 +78,17 @@ static inline std::vector<Timestamped<typename TypeInfo<T>::Value>> ReadQueue(
   }
 }
 
+template <typename T>
+static inline void ReadQueue(
+    NT_Handle subentry,
+    std::vector<Timestamped<typename TypeInfo<T>::Value>>& buf) {
+  if (auto ii = InstanceImpl::Get(Handle{subentry}.GetInst())) {
+    ii->localStorage.ReadQueue<T>(subentry, buf);
+  } else {
+    buf.clear();
+  }
+}
+
 template <typename T>
 static inline typename ValuesType<T>::Vector ReadQueueValues(
     NT_Handle subentry) {
@@ -111,6 +122,10 @@ std::vector<TimestampedBoolean> ReadQueueBoolean(NT_Handle subentry) {
   return ReadQueue<bool>(subentry);
 }
 
+void ReadQueueBoolean(NT_Handle subentry, std::vector<TimestampedBoolean>& buf) {
+  ReadQueue<bool>(subentry, buf);
+}
+
 std::vector<int> ReadQueueValuesBoolean(NT_Handle subentry) {
   return ReadQueueValues<bool>(subentry);
 }
@@ -137,6 +152,10 @@ std::vector<TimestampedInteger> ReadQueueInteger(NT_Handle subentry) {
   return ReadQueue<int64_t>(subentry);
 }
 
+void ReadQueueInteger(NT_Handle subentry, std::vector<TimestampedInteger>& buf) {
+  ReadQueue<int64_t>(subentry, buf);
+}
+
 std::vector<int64_t> ReadQueueValuesInteger(NT_Handle subentry) {
   return ReadQueueValues<int64_t>(subentry);
 }
@@ -163,6 +182,10 @@ std::vector<TimestampedFloat> ReadQueueFloat(NT_Handle subentry) {
   return ReadQueue<float>(subentry);
 }
 
+void ReadQueueFloat(NT_Handle subentry, std::vector<TimestampedFloat>& buf) {
+  ReadQueue<float>(subentry, buf);
+}
+
 std::vector<float> ReadQueueValuesFloat(NT_Handle subentry) {
   return ReadQueueValues<float>(subentry);
 }
@@ -189,6 +212,10 @@ std::vector<TimestampedDouble> ReadQueueDouble(NT_Handle subentry) {
   return ReadQueue<double>(subentry);
 }
 
+void ReadQueueDouble(NT_Handle subentry, std::vector<TimestampedDouble>& buf) {
+  ReadQueue<double>(subentry, buf);
+}
+
 std::vector<double> ReadQueueValuesDouble(NT_Handle subentry) {
   return ReadQueueValues<double>(subentry);
 }
@@ -215,6 +242,10 @@ std::vector<TimestampedString> ReadQueueString(NT_Handle subentry) {
   return ReadQueue<std::string>(subentry);
 }
 
+void ReadQueueString(NT_Handle subentry, std::vector<TimestampedString>& buf) {
+  ReadQueue<std::string>(subentry, buf);
+}
+
 std::vector<std::string> ReadQueueValuesString(NT_Handle subentry) {
   return ReadQueueValues<std::string>(subentry);
 }
@@ -255,6 +286,10 @@ std::vector<TimestampedRaw> ReadQueueRaw(NT_Handle subentry) {
   return ReadQueue<uint8_t[]>(subentry);
 }
 
+void ReadQueueRaw(NT_Handle subentry, std::vector<TimestampedRaw>& buf) {
+  ReadQueue<uint8_t[]>(subentry, buf);
+}
+
 std::vector<std::vector<uint8_t>> ReadQueueValuesRaw(NT_Handle subentry) {
   return ReadQueueValues<uint8_t[]>(subentry);
 }
@@ -295,6 +330,10 @@ std::vector<TimestampedBooleanArray> ReadQueueBooleanArray(NT_Handle subentry) {
   return ReadQueue<bool[]>(subentry);
 }
 
+void ReadQueueBooleanArray(NT_Handle subentry, std::vector<TimestampedBooleanArray>& buf) {
+  ReadQueue<bool[]>(subentry, buf);
+}
+
 std::vector<std::vector<int>> ReadQueueValuesBooleanArray(NT_Handle subentry) {
   return ReadQueueValues<bool[]>(subentry);
 }
@@ -335,6 +374,10 @@ std::vector<TimestampedIntegerArray> ReadQueueIntegerArray(NT_Handle subentry) {
   return ReadQueue<int64_t[]>(subentry);
 }
 
+void ReadQueueIntegerArray(NT_Handle subentry, std::vector<TimestampedIntegerArray>& buf) {
+  ReadQueue<int64_t[]>(subentry, buf);
+}
+
 std::vector<std::vector<int64_t>> ReadQueueValuesIntegerArray(NT_Handle subentry) {
   return ReadQueueValues<int64_t[]>(subentry);
 }
@@ -375,6 +418,10 @@ std::vector<TimestampedFloatArray> ReadQueueFloatArray(NT_Handle subentry) {
   return ReadQueue<float[]>(subentry);
 }
 
+void ReadQueueFloatArray(NT_Handle subentry, std::vector<TimestampedFloatArray>& buf) {
+  ReadQueue<float[]>(subentry, buf);
+}
+
 std::vector<std::vector<float>> ReadQueueValuesFloatArray(NT_Handle subentry) {
   return ReadQueueValues<float[]>(subentry);
 }
@@ -415,6 +462,10 @@ std::vector<TimestampedDoubleArray> ReadQueueDoubleArray(NT_Handle subentry) {
   return ReadQueue<double[]>(subentry);
 }
 
+void ReadQueueDoubleArray(NT_Handle subentry, std::vector<TimestampedDoubleArray>& buf) {
+  ReadQueue<double[]>(subentry, buf);
+}
+
 std::vector<std::vector<double>> ReadQueueValuesDoubleArray(NT_Handle subentry) {
   return ReadQueueValues<double[]>(subentry);
 }
@@ -455,6 +506,10 @@ std::vector<TimestampedStringArray> ReadQueueStringArray(NT_Handle subentry) {
   return ReadQueue<std::string[]>(subentry);
 }
 
+void ReadQueueStringArray(NT_Handle subentry, std::vector<TimestampedStringArray>& buf) {
+  ReadQueue<std::string[]>(subentry, buf);
+}
+
 std::vector<std::vector<std::string>> ReadQueueValuesStringArray(NT_Handle subentry) {
   return ReadQueueValues<std::string[]>(subentry);
 }
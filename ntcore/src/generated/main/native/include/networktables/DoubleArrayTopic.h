@@ -165,6 +165,22 @@ class DoubleArraySubscriber : public Subscriber {
     return ::nt::ReadQueueDoubleArray(m_subHandle);
   }
 
+  /**
+   * Get all value changes since the last call to ReadQueue, along with their
+   * timestamps, into a caller-provided buffer. Unlike the other overload,
+   * the buffer's storage is reused, so repeated reads don't need to allocate.
+   *
+   * @note The "poll storage" subscribe option can be used to set the queue
+   *     depth.
+   *
+   * @param buf buffer for timestamped values; its previous contents are
+   *     replaced, and it is left empty if no new changes have been published
+   *     since the previous call.
+   */
+  void ReadQueue(std::vector<TimestampedValueType>& buf) {
+    ::nt::ReadQueueDoubleArray(m_subHandle, buf);
+  }
+
   /**
    * Get the corresponding topic.
    *
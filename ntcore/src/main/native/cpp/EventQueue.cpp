@@ -0,0 +1,45 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "EventQueue.h"
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using namespace nt;
+
+void EventQueue::Push(Event&& event) {
+  if (!m_overflowing.load(std::memory_order_acquire)) {
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) < kRingSize) {
+      m_ring[head % kRingSize] = std::move(event);
+      m_head.store(head + 1, std::memory_order_release);
+      return;
+    }
+  }
+  std::scoped_lock lock{m_mutex};
+  m_overflow.emplace_back(std::move(event));
+  m_overflowing.store(true, std::memory_order_release);
+}
+
+void EventQueue::Drain(std::vector<Event>& events) {
+  events.clear();
+  std::scoped_lock lock{m_mutex};
+  uint64_t tail = m_tail.load(std::memory_order_relaxed);
+  uint64_t head = m_head.load(std::memory_order_acquire);
+  events.reserve(head - tail + m_overflow.size());
+  for (; tail != head; ++tail) {
+    events.emplace_back(std::move(m_ring[tail % kRingSize]));
+  }
+  m_tail.store(head, std::memory_order_release);
+  // anything in the overflow was pushed after everything in the ring
+  if (m_overflowing.load(std::memory_order_relaxed)) {
+    for (auto&& event : m_overflow) {
+      events.emplace_back(std::move(event));
+    }
+    m_overflow.clear();
+    m_overflowing.store(false, std::memory_order_release);
+  }
+}
@@ -0,0 +1,55 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <wpi/spinlock.h>
+
+#include "ntcore_cpp.h"
+
+namespace nt {
+
+// Queue of listener events for a poller.
+//
+// Pushes must be serialized (ListenerStorage only pushes while holding its
+// mutex); readers don't need the listener storage mutex. Events are moved
+// into a fixed ring of reused Event slots without locking. Only if the ring
+// is full (the reader has fallen behind) do events go to an unbounded
+// overflow vector under a spinlock, so events are never dropped. Readers are
+// serialized by the same spinlock.
+class EventQueue {
+ public:
+  static constexpr size_t kRingSize = 512;
+
+  EventQueue() : m_ring{std::make_unique<Event[]>(kRingSize)} {}
+  EventQueue(const EventQueue&) = delete;
+  EventQueue& operator=(const EventQueue&) = delete;
+
+  void Push(Event&& event);
+
+  // Moves all queued events into events, replacing its contents
+  void Drain(std::vector<Event>& events);
+
+ private:
+  std::unique_ptr<Event[]> m_ring;
+  // total number of events pushed to the ring (written only by the producer)
+  alignas(64) std::atomic<uint64_t> m_head{0};
+  // total number of events read from the ring
+  alignas(64) std::atomic<uint64_t> m_tail{0};
+  // true while m_overflow is non-empty; all pushes go to m_overflow while
+  // this is set so that events stay in order
+  std::atomic_bool m_overflowing{false};
+
+  wpi::spinlock m_mutex;
+  std::vector<Event> m_overflow;
+};
+
+}  // namespace nt
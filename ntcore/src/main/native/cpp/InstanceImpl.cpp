@@ -102,17 +102,20 @@ void InstanceImpl::StopLocal() {
 
 void InstanceImpl::StartServer(std::string_view persistFilename,
                                std::string_view listenAddress,
-                               unsigned int port3, unsigned int port4) {
+                               unsigned int port3, unsigned int port4,
+                               unsigned int numShards) {
   std::scoped_lock lock{m_mutex};
   if (networkMode != NT_NET_MODE_NONE) {
     return;
   }
   m_networkServer = std::make_shared<NetworkServer>(
       persistFilename, listenAddress, port3, port4, localStorage,
-      connectionList, logger, [this] {
+      connectionList, logger,
+      [this] {
         std::scoped_lock lock{m_mutex};
         networkMode &= ~NT_NET_MODE_STARTING;
-      });
+      },
+      numShards);
   networkMode = NT_NET_MODE_SERVER | NT_NET_MODE_STARTING;
   listenerStorage.NotifyTimeSync({}, NT_EVENT_TIMESYNC, 0, 0, true);
   m_serverTimeOffset = 0;
@@ -147,7 +150,8 @@ void InstanceImpl::StartClient3(std::string_view identity) {
   networkMode = NT_NET_MODE_CLIENT3;
 }
 
-void InstanceImpl::StartClient4(std::string_view identity) {
+void InstanceImpl::StartClient4(std::string_view identity,
+                                bool sharedMemory) {
   std::scoped_lock lock{m_mutex};
   if (networkMode != NT_NET_MODE_NONE) {
     return;
@@ -165,7 +169,8 @@ void InstanceImpl::StartClient4(std::string_view identity) {
           m_serverTimeOffset.reset();
           m_rtt2 = 0;
         }
-      });
+      },
+      sharedMemory);
   if (!m_servers.empty()) {
     m_networkClient->SetServers(m_servers);
   }
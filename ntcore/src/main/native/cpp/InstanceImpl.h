@@ -46,10 +46,10 @@ class InstanceImpl {
   void StopLocal();
   void StartServer(std::string_view persistFilename,
                    std::string_view listenAddress, unsigned int port3,
-                   unsigned int port4);
+                   unsigned int port4, unsigned int numShards);
   void StopServer();
   void StartClient3(std::string_view identity);
-  void StartClient4(std::string_view identity);
+  void StartClient4(std::string_view identity, bool sharedMemory);
   void StopClient();
   void SetServers(
       std::span<const std::pair<std::string, unsigned int>> servers);
@@ -15,6 +15,8 @@
 using namespace nt;
 
 void ListenerStorage::Thread::Main() {
+  // reused across reads to avoid allocation
+  std::vector<Event> events;
   while (m_active) {
     WPI_Handle signaledBuf[3];
     auto signaled = wpi::WaitForObjects(
@@ -24,7 +26,7 @@ void ListenerStorage::Thread::Main() {
       return;
     }
     // call all the way back out to the C++ API to ensure valid handle
-    auto events = nt::ReadListenerQueue(m_poller);
+    nt::ReadListenerQueue(m_poller, events);
     if (!events.empty()) {
       std::unique_lock lock{m_mutex};
       for (auto&& event : events) {
@@ -85,7 +87,7 @@ void ListenerStorage::Notify(std::span<const NT_Listener> handles,
       for (auto&& [finishEvent, mask] : listener.sources) {
         if ((flags & mask) != 0) {
           for (auto&& info : infos) {
-            listener.poller->queue.emplace_back(listener.handle, flags, *info);
+            listener.poller->queue->Push({listener.handle, flags, *info});
             // finishEvent is never set (see ConnectionList)
           }
         }
@@ -122,11 +124,9 @@ void ListenerStorage::Notify(std::span<const NT_Listener> handles,
       for (auto&& [finishEvent, mask] : listener.sources) {
         if ((flags & mask) != 0) {
           for (auto&& info : infos) {
-            listener.poller->queue.emplace_back(listener.handle, flags, info);
-            if (finishEvent &&
-                !finishEvent(mask, &listener.poller->queue.back())) {
-              listener.poller->queue.pop_back();
-            } else {
+            Event event{listener.handle, flags, info};
+            if (!finishEvent || finishEvent(mask, &event)) {
+              listener.poller->queue->Push(std::move(event));
               ++count;
             }
           }
@@ -165,12 +165,9 @@ void ListenerStorage::Notify(std::span<const NT_Listener> handles,
       int count = 0;
       for (auto&& [finishEvent, mask] : listener.sources) {
         if ((flags & mask) != 0) {
-          listener.poller->queue.emplace_back(listener.handle, flags, topic,
-                                              subentry, value);
-          if (finishEvent &&
-              !finishEvent(mask, &listener.poller->queue.back())) {
-            listener.poller->queue.pop_back();
-          } else {
+          Event event{listener.handle, flags, topic, subentry, value};
+          if (!finishEvent || finishEvent(mask, &event)) {
+            listener.poller->queue->Push(std::move(event));
             ++count;
           }
         }
@@ -207,12 +204,9 @@ void ListenerStorage::Notify(unsigned int flags, unsigned int level,
       int count = 0;
       for (auto&& [finishEvent, mask] : listener->sources) {
         if ((flags & mask) != 0) {
-          listener->poller->queue.emplace_back(listener->handle, flags, level,
-                                               filename, line, message);
-          if (finishEvent &&
-              !finishEvent(mask, &listener->poller->queue.back())) {
-            listener->poller->queue.pop_back();
-          } else {
+          Event event{listener->handle, flags, level, filename, line, message};
+          if (!finishEvent || finishEvent(mask, &event)) {
+            listener->poller->queue->Push(std::move(event));
             ++count;
           }
         }
@@ -238,8 +232,8 @@ void ListenerStorage::NotifyTimeSync(std::span<const NT_Listener> handles,
     if ((flags & listener.eventMask) != 0) {
       for (auto&& [finishEvent, mask] : listener.sources) {
         if ((flags & mask) != 0) {
-          listener.poller->queue.emplace_back(listener.handle, flags,
-                                              serverTimeOffset, rtt2, valid);
+          listener.poller->queue->Push(
+              {listener.handle, flags, serverTimeOffset, rtt2, valid});
           // finishEvent is never set (see InstanceImpl)
         }
       }
@@ -264,7 +258,7 @@ void ListenerStorage::NotifyTimeSync(std::span<const NT_Listener> handles,
 NT_Listener ListenerStorage::AddListener(ListenerCallback callback) {
   std::scoped_lock lock{m_mutex};
   if (!m_thread) {
-    m_thread.Start(m_pollers.Add(m_inst)->handle);
+    m_thread.Start(DoCreateListenerPoller()->handle);
   }
   if (auto thr = m_thread.GetThread()) {
     auto listener = DoAddListener(thr->m_poller);
@@ -292,13 +286,24 @@ NT_Listener ListenerStorage::DoAddListener(NT_ListenerPoller pollerHandle) {
 
 NT_ListenerPoller ListenerStorage::CreateListenerPoller() {
   std::scoped_lock lock{m_mutex};
-  return m_pollers.Add(m_inst)->handle;
+  return DoCreateListenerPoller()->handle;
+}
+
+ListenerStorage::PollerData* ListenerStorage::DoCreateListenerPoller() {
+  auto poller = m_pollers.Add(m_inst);
+  std::scoped_lock lock{m_queuesMutex};
+  m_queues[poller->handle] = poller->queue;
+  return poller;
 }
 
 std::vector<std::pair<NT_Listener, unsigned int>>
 ListenerStorage::DestroyListenerPoller(NT_ListenerPoller pollerHandle) {
   std::scoped_lock lock{m_mutex};
   if (auto poller = m_pollers.Remove(pollerHandle)) {
+    {
+      std::scoped_lock lock{m_queuesMutex};
+      m_queues.erase(pollerHandle);
+    }
     // ensure all listeners that use this poller are removed
     wpi::SmallVector<NT_Listener, 16> toRemove;
     for (auto&& listener : m_listeners) {
@@ -314,13 +319,25 @@ ListenerStorage::DestroyListenerPoller(NT_ListenerPoller pollerHandle) {
 
 std::vector<Event> ListenerStorage::ReadListenerQueue(
     NT_ListenerPoller pollerHandle) {
-  std::scoped_lock lock{m_mutex};
-  if (auto poller = m_pollers.Get(pollerHandle)) {
-    std::vector<Event> rv;
-    rv.swap(poller->queue);
-    return rv;
+  std::vector<Event> rv;
+  ReadListenerQueue(pollerHandle, rv);
+  return rv;
+}
+
+void ListenerStorage::ReadListenerQueue(NT_ListenerPoller pollerHandle,
+                                        std::vector<Event>& events) {
+  std::shared_ptr<EventQueue> queue;
+  {
+    std::scoped_lock lock{m_queuesMutex};
+    auto it = m_queues.find(pollerHandle);
+    if (it != m_queues.end()) {
+      queue = it->second;
+    }
+  }
+  if (queue) {
+    queue->Drain(events);
   } else {
-    return {};
+    events.clear();
   }
 }
 
@@ -349,6 +366,10 @@ bool ListenerStorage::WaitForListenerQueue(double timeout) {
 void ListenerStorage::Reset() {
   std::scoped_lock lock{m_mutex};
   m_pollers.clear();
+  {
+    std::scoped_lock lock2{m_queuesMutex};
+    m_queues.clear();
+  }
   m_listeners.clear();
   m_connListeners.clear();
   m_topicListeners.clear();
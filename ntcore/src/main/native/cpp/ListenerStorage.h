@@ -17,6 +17,7 @@
 #include <wpi/Synchronization.h>
 #include <wpi/mutex.h>
 
+#include "EventQueue.h"
 #include "Handle.h"
 #include "HandleMap.h"
 #include "IListenerStorage.h"
@@ -55,7 +56,10 @@ class ListenerStorage final : public IListenerStorage {
   std::vector<std::pair<NT_Listener, unsigned int>> DestroyListenerPoller(
       NT_ListenerPoller pollerHandle);
 
+  // the ReadListenerQueue functions don't need the storage mutex
   std::vector<Event> ReadListenerQueue(NT_ListenerPoller pollerHandle);
+  void ReadListenerQueue(NT_ListenerPoller pollerHandle,
+                         std::vector<Event>& events);
 
   // returns listener handle and mask for each listener that was destroyed
   [[nodiscard]]
@@ -67,7 +71,10 @@ class ListenerStorage final : public IListenerStorage {
   void Reset();
 
  private:
+  struct PollerData;
+
   // these assume the mutex is already held
+  PollerData* DoCreateListenerPoller();
   NT_Listener DoAddListener(NT_ListenerPoller pollerHandle);
   std::vector<std::pair<NT_Listener, unsigned int>> DoRemoveListeners(
       std::span<const NT_Listener> handles);
@@ -81,10 +88,14 @@ class ListenerStorage final : public IListenerStorage {
     explicit PollerData(NT_ListenerPoller handle) : handle{handle} {}
 
     wpi::SignalObject<NT_ListenerPoller> handle;
-    std::vector<Event> queue;
+    std::shared_ptr<EventQueue> queue = std::make_shared<EventQueue>();
   };
   HandleMap<PollerData, 8> m_pollers;
 
+  // poller queues, for reading without the storage mutex
+  wpi::mutex m_queuesMutex;
+  wpi::DenseMap<NT_ListenerPoller, std::shared_ptr<EventQueue>> m_queues;
+
   struct ListenerData {
     static constexpr auto kType = Handle::kListener;
 
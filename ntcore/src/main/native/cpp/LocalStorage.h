@@ -346,24 +346,34 @@ class LocalStorage final : public net::ILocalStorage {
     }
   }
 
+  // The ReadQueue functions don't need the storage mutex
+
   std::vector<Value> ReadQueueValue(NT_Handle subentry, unsigned int types) {
-    std::scoped_lock lock{m_mutex};
-    auto subscriber = m_impl.GetSubEntry(subentry);
-    if (!subscriber) {
-      return {};
-    }
-    return subscriber->pollStorage.ReadValue(types);
+    std::vector<Value> values;
+    m_impl.ReadPollStorage(subentry, [&](ValueCircularBuffer& storage) {
+      values = storage.ReadValue(types);
+    });
+    return values;
   }
 
   template <ValidType T>
   std::vector<Timestamped<typename TypeInfo<T>::Value>> ReadQueue(
       NT_Handle subentry) {
-    std::scoped_lock lock{m_mutex};
-    auto subscriber = m_impl.GetSubEntry(subentry);
-    if (!subscriber) {
-      return {};
+    std::vector<Timestamped<typename TypeInfo<T>::Value>> values;
+    m_impl.ReadPollStorage(subentry, [&](ValueCircularBuffer& storage) {
+      values = storage.Read<T>();
+    });
+    return values;
+  }
+
+  template <ValidType T>
+  void ReadQueue(NT_Handle subentry,
+                 std::vector<Timestamped<typename TypeInfo<T>::Value>>& buf) {
+    if (!m_impl.ReadPollStorage(subentry, [&](ValueCircularBuffer& storage) {
+          storage.Read<T>(buf);
+        })) {
+      buf.clear();
     }
-    return subscriber->pollStorage.Read<T>();
   }
 
   //
@@ -23,14 +23,13 @@
 #include "IConnectionList.h"
 #include "Log.h"
 #include "net/NetworkInterface.h"
+#include "net/WireDecoder.h"
 
 using namespace nt;
 namespace uv = wpi::uv;
 
 static constexpr uv::Timer::Time kReconnectRate{1000};
 static constexpr uv::Timer::Time kWebsocketHandshakeTimeout{500};
-// use a larger max message size for websockets
-static constexpr size_t kMaxMessageSize = 2 * 1024 * 1024;
 
 NetworkClientBase::NetworkClientBase(int inst, std::string_view id,
                                      net::ILocalStorage& localStorage,
@@ -301,9 +300,11 @@ NetworkClient::NetworkClient(
     int inst, std::string_view id, net::ILocalStorage& localStorage,
     IConnectionList& connList, wpi::Logger& logger,
     std::function<void(int64_t serverTimeOffset, int64_t rtt2, bool valid)>
-        timeSyncUpdated)
+        timeSyncUpdated,
+    bool sharedMemory)
     : NetworkClientBase{inst, id, localStorage, connList, logger},
-      m_timeSyncUpdated{std::move(timeSyncUpdated)} {
+      m_timeSyncUpdated{std::move(timeSyncUpdated)},
+      m_sharedMemory{sharedMemory} {
   m_loopRunner.ExecAsync([this](uv::Loop& loop) {
     m_parallelConnect = wpi::ParallelTcpConnector::Create(
         loop, kReconnectRate, m_logger,
@@ -354,6 +355,7 @@ NetworkClient::~NetworkClient() {
   // must explicitly destroy these on loop
   m_loopRunner.ExecSync([&](auto&) {
     m_clientImpl.reset();
+    m_shmWire.reset();
     m_wire.reset();
   });
   // shut down loop here to avoid race
@@ -384,39 +386,77 @@ void NetworkClient::TcpConnected(uv::Tcp& tcp) {
   }
   wpi::WebSocket::ClientOptions options;
   options.handshakeTimeout = kWebsocketHandshakeTimeout;
+
+  // offer shared memory to a server on the same machine; the server opens it
+  // during the handshake if it supports it
+  std::shared_ptr<net::SharedMemorySegment> shm;
+  std::pair<std::string_view, std::string_view> shmHeader[1];
+  if (m_sharedMemory) {
+    std::string ip;
+    unsigned int port = 0;
+    uv::AddrToName(tcp.GetPeer(), &ip, &port);
+    if (net::IsLoopbackAddress(ip)) {
+      shm = net::SharedMemorySegment::Create();
+      if (shm) {
+        shmHeader[0] = {net::kSharedMemoryHeader, shm->GetName()};
+        options.extraHeaders = shmHeader;
+      }
+    }
+  }
   wpi::SmallString<128> idBuf;
   auto ws = wpi::WebSocket::CreateClient(
       tcp, fmt::format("/nt/{}", wpi::EscapeURI(m_id, idBuf)), "",
-      {"v4.1.networktables.first.wpi.edu", "networktables.first.wpi.edu"},
+      {"v4.1.lz4.networktables.first.wpi.edu",
+       "v4.1.networktables.first.wpi.edu", "networktables.first.wpi.edu"},
       options);
-  ws->SetMaxMessageSize(kMaxMessageSize);
-  ws->open.connect([this, &tcp, ws = ws.get()](std::string_view protocol) {
+  ws->SetMaxMessageSize(net::kMaxMessageSize);
+  ws->open.connect([this, &tcp, ws = ws.get(),
+                    shm = std::move(shm)](std::string_view protocol) {
     if (m_connList.IsConnected()) {
       ws->Terminate(1006, "no longer needed");
       return;
     }
-    WsConnected(*ws, tcp, protocol);
+    WsConnected(*ws, tcp, protocol, shm);
   });
 }
 
-void NetworkClient::WsConnected(wpi::WebSocket& ws, uv::Tcp& tcp,
-                                std::string_view protocol) {
+void NetworkClient::WsConnected(
+    wpi::WebSocket& ws, uv::Tcp& tcp, std::string_view protocol,
+    const std::shared_ptr<net::SharedMemorySegment>& shm) {
   if (m_parallelConnect) {
     m_parallelConnect->Succeeded(tcp);
   }
 
   ConnectionInfo connInfo;
   uv::AddrToName(tcp.GetPeer(), &connInfo.remote_ip, &connInfo.remote_port);
+  // the lz4 variant is v4.1 plus compressed binary values
+  bool compress = protocol == "v4.1.lz4.networktables.first.wpi.edu";
   connInfo.protocol_version =
-      protocol == "v4.1.networktables.first.wpi.edu" ? 0x0401 : 0x0400;
+      compress || protocol == "v4.1.networktables.first.wpi.edu" ? 0x0401
+                                                                 : 0x0400;
+
+  // the server has attached to the segment if it's going to use it; either
+  // way the name is no longer needed
+  bool useShm = false;
+  if (shm) {
+    useShm = shm->IsAttached();
+    shm->Unlink();
+  }
 
-  INFO("CONNECTED NT4 to {} port {}", connInfo.remote_ip, connInfo.remote_port);
+  INFO("CONNECTED NT4 to {} port {}{}", connInfo.remote_ip,
+       connInfo.remote_port, useShm ? " using shared memory" : "");
   m_connHandle = m_connList.AddConnection(connInfo);
 
   m_wire = std::make_shared<net::WebSocketConnection>(
-      ws, connInfo.protocol_version, m_logger);
+      ws, connInfo.protocol_version, m_logger, compress);
+  net::WireConnection* wire = m_wire.get();
+  if (useShm) {
+    m_shmWire = std::make_unique<net::SharedMemoryConnection>(*m_wire, shm,
+                                                              false, m_loop);
+    wire = m_shmWire.get();
+  }
   m_clientImpl = std::make_unique<net::ClientImpl>(
-      m_loop.Now().count(), *m_wire, m_logger, m_timeSyncUpdated,
+      m_loop.Now().count(), *wire, m_logger, m_timeSyncUpdated,
       [this](uint32_t repeatMs) {
         DEBUG4("Setting periodic timer to {}", repeatMs);
         if (m_sendOutgoingTimer &&
@@ -452,6 +492,18 @@ void NetworkClient::WsConnected(wpi::WebSocket& ws, uv::Tcp& tcp,
       m_clientImpl->ProcessIncomingBinary(m_loop.Now().count(), data);
     }
   });
+  if (m_shmWire) {
+    m_shmWire->text.connect([this](std::string_view data) {
+      if (m_clientImpl) {
+        m_clientImpl->ProcessIncomingText(data);
+      }
+    });
+    m_shmWire->binary.connect([this](std::span<const uint8_t> data) {
+      if (m_clientImpl) {
+        m_clientImpl->ProcessIncomingBinary(m_loop.Now().count(), data);
+      }
+    });
+  }
 }
 
 void NetworkClient::ForceDisconnect(std::string_view reason) {
@@ -468,6 +520,7 @@ void NetworkClient::DoDisconnect(std::string_view reason) {
   INFO("DISCONNECTED NT4 connection: {}",
        realReason.empty() ? reason : realReason);
   m_clientImpl.reset();
+  m_shmWire.reset();
   m_wire.reset();
   NetworkClientBase::DoDisconnect(reason);
   m_timeSyncUpdated(0, 0, false);
@@ -24,6 +24,7 @@
 #include "net/ClientImpl.h"
 #include "net/ClientMessageQueue.h"
 #include "net/Message.h"
+#include "net/SharedMemoryConnection.h"
 #include "net/WebSocketConnection.h"
 #include "net3/ClientImpl3.h"
 #include "net3/UvStreamConnection3.h"
@@ -126,7 +127,8 @@ class NetworkClient final : public NetworkClientBase {
       int inst, std::string_view id, net::ILocalStorage& localStorage,
       IConnectionList& connList, wpi::Logger& logger,
       std::function<void(int64_t serverTimeOffset, int64_t rtt2, bool valid)>
-          timeSyncUpdated);
+          timeSyncUpdated,
+      bool sharedMemory);
   ~NetworkClient() final;
 
   void SetServers(
@@ -138,13 +140,16 @@ class NetworkClient final : public NetworkClientBase {
   void HandleLocal();
   void TcpConnected(wpi::uv::Tcp& tcp) final;
   void WsConnected(wpi::WebSocket& ws, wpi::uv::Tcp& tcp,
-                   std::string_view protocol);
+                   std::string_view protocol,
+                   const std::shared_ptr<net::SharedMemorySegment>& shm);
   void ForceDisconnect(std::string_view reason) override;
   void DoDisconnect(std::string_view reason) override;
 
   std::function<void(int64_t serverTimeOffset, int64_t rtt2, bool valid)>
       m_timeSyncUpdated;
+  bool m_sharedMemory;
   std::shared_ptr<net::WebSocketConnection> m_wire;
+  std::unique_ptr<net::SharedMemoryConnection> m_shmWire;
   std::unique_ptr<net::ClientImpl> m_clientImpl;
 };
 
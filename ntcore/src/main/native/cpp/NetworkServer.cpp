@@ -14,8 +14,11 @@
 #include <utility>
 #include <vector>
 
+#include <wpi/DenseMap.h>
 #include <wpi/MemoryBuffer.h>
 #include <wpi/SmallString.h>
+#include <wpi/SmallVector.h>
+#include <wpi/SpscQueue.h>
 #include <wpi/StringExtras.h>
 #include <wpi/fs.h>
 #include <wpi/mutex.h>
@@ -31,6 +34,8 @@
 #include "IConnectionList.h"
 #include "InstanceImpl.h"
 #include "Log.h"
+#include "net/ShardWireConnection.h"
+#include "net/SharedMemoryConnection.h"
 #include "net/WebSocketConnection.h"
 #include "net/WireDecoder.h"
 #include "net/WireEncoder.h"
@@ -39,9 +44,6 @@
 using namespace nt;
 namespace uv = wpi::uv;
 
-// use a larger max message size for websockets
-static constexpr size_t kMaxMessageSize = 2 * 1024 * 1024;
-
 static constexpr size_t kClientProcessMessageCountMax = 16;
 
 class NetworkServer::ServerConnection {
@@ -82,26 +84,131 @@ class NetworkServer::ServerConnection3 : public ServerConnection {
   std::shared_ptr<net3::UvStreamConnection3> m_wire;
 };
 
+// Event sent from a shard I/O loop to the server loop.
+struct NetworkServer::ShardEvent {
+  enum Kind { kOpen, kText, kBinary, kClosed };
+
+  Kind kind = kOpen;
+  int connId = 0;
+  // client name (kOpen), message contents, or close reason (kClosed)
+  std::string data;
+  // kOpen only
+  ConnectionInfo info;
+  bool compress = false;
+  std::shared_ptr<net::ShardConnectionState> state;
+  std::unique_ptr<net::SharedMemorySegment> shm;
+};
+
 class NetworkServer::ServerConnection4 final
     : public ServerConnection,
       public wpi::HttpWebSocketServerConnection<ServerConnection4> {
  public:
   ServerConnection4(std::shared_ptr<uv::Stream> stream, NetworkServer& server,
-                    std::string_view addr, unsigned int port,
+                    Shard* shard, std::string_view addr, unsigned int port,
                     wpi::Logger& logger)
       : ServerConnection{server, addr, port, logger},
         HttpWebSocketServerConnection(
             stream,
-            {"v4.1.networktables.first.wpi.edu", "networktables.first.wpi.edu",
-             "rtt.networktables.first.wpi.edu"}) {
+            {"v4.1.lz4.networktables.first.wpi.edu",
+             "v4.1.networktables.first.wpi.edu", "networktables.first.wpi.edu",
+             "rtt.networktables.first.wpi.edu"}),
+        m_shard{shard} {
     m_info.protocol_version = 0x0400;
+    m_request.header.connect(
+        [this](std::string_view name, std::string_view value) {
+          if (wpi::equals_lower(name, net::kSharedMemoryHeader)) {
+            m_shmName = value;
+          }
+        });
   }
 
+  // called on the shard I/O loop
+  void ProcessCommand(net::ShardCommand& cmd);
+
  private:
   void ProcessRequest() final;
+  bool IsValidWsUpgrade(std::string_view protocol) final;
   void ProcessWsUpgrade() final;
+  void StartShard(std::string_view name);
+  void PostEvent(ShardEvent::Kind kind, std::string_view data);
 
   std::shared_ptr<net::WebSocketConnection> m_wire;
+  bool m_compress = false;
+
+  // only used for clients on the same machine that requested shared memory
+  std::string m_shmName;
+  std::unique_ptr<net::SharedMemorySegment> m_shmSegment;
+  std::unique_ptr<net::SharedMemoryConnection> m_shmWire;
+
+  // only used if the connection runs on a shard I/O loop
+  Shard* m_shard;
+  int m_shardConnId = -1;
+  std::shared_ptr<net::ShardConnectionState> m_shardState;
+};
+
+// Server loop half of an NT4 connection whose socket is owned by a shard I/O
+// loop.
+class NetworkServer::ServerConnection4Shard final : public ServerConnection {
+ public:
+  ServerConnection4Shard(NetworkServer& server, Shard& shard,
+                         ShardEvent& event);
+
+  void ProcessIncomingText(std::string_view data);
+  void ProcessIncomingBinary(std::span<const uint8_t> data);
+  void Closed(std::string_view reason);
+
+ private:
+  net::ShardWireConnection m_wire;
+  std::unique_ptr<net::SharedMemoryConnection> m_shmWire;
+};
+
+// An I/O loop that owns the sockets of a subset of the NT4 clients. Each
+// shard listens on the NT4 port (the OS distributes incoming connections
+// between the listeners) and handles HTTP, WebSocket framing, and socket
+// reads and writes. Storage and fan-out logic stays on the server loop;
+// messages are exchanged with it through a pair of lock-free queues, so each
+// client's messages stay in order.
+class NetworkServer::Shard {
+ public:
+  explicit Shard(NetworkServer& server) : m_server{server} {}
+
+  // called on the server loop
+  void Wakeup() {
+    if (!m_server.m_shutdown) {
+      m_commandsAsync->UnsafeSend();
+    }
+  }
+  void ProcessEvents();
+
+  // called on the I/O loop
+  bool Start(uv::Loop& loop);
+  void Listen() { m_listener->Listen(); }
+  int AddConnection(ServerConnection4* conn) {
+    m_conns[m_nextConnId] = conn;
+    return m_nextConnId++;
+  }
+  void RemoveConnection(int connId) { m_conns.erase(connId); }
+  void PostEvent(ShardEvent&& event) {
+    m_events.enqueue(std::move(event));
+    m_eventsAsync->UnsafeSend();
+  }
+  void ProcessCommands();
+
+  NetworkServer& m_server;
+  net::ShardCommandQueue m_commands;  // server loop -> I/O loop
+  wpi::SpscQueue<ShardEvent> m_events;  // I/O loop -> server loop
+
+  // used only from server loop
+  std::shared_ptr<uv::Async<>> m_eventsAsync;
+  wpi::DenseMap<int, std::shared_ptr<ServerConnection4Shard>> m_clients;
+
+  // used only from I/O loop
+  std::shared_ptr<uv::Async<>> m_commandsAsync;
+  std::shared_ptr<uv::Tcp> m_listener;
+  wpi::DenseMap<int, ServerConnection4*> m_conns;
+  int m_nextConnId = 0;
+
+  wpi::EventLoopRunner m_runner;
 };
 
 void NetworkServer::ServerConnection::SetupOutgoingTimer() {
@@ -213,13 +320,40 @@ void NetworkServer::ServerConnection4::ProcessRequest() {
                  "<body><p>WebSockets must be used to access NetworkTables."
                  "</body></html>");
   } else if (isGET && path == "/nt/persistent.json") {
-    SendResponse(200, "OK", "application/json",
-                 m_server.m_serverImpl.DumpPersistent());
+    if (m_shard) {
+      // storage lives on the server loop
+      m_server.m_loopRunner.ExecAsync(
+          [self = weak_from_this(), shard = m_shard](uv::Loop&) {
+            shard->m_runner.ExecAsync(
+                [self,
+                 data = shard->m_server.m_serverImpl.DumpPersistent()](
+                    uv::Loop&) {
+                  if (auto conn = self.lock()) {
+                    conn->SendResponse(200, "OK", "application/json", data);
+                  }
+                });
+          });
+    } else {
+      SendResponse(200, "OK", "application/json",
+                   m_server.m_serverImpl.DumpPersistent());
+    }
   } else {
     SendError(404, "Resource not found");
   }
 }
 
+bool NetworkServer::ServerConnection4::IsValidWsUpgrade(
+    std::string_view protocol) {
+  // Attach to the client's shared memory segment before accepting the
+  // upgrade, so the client knows whether to use it as soon as the WebSocket
+  // opens.
+  if (!m_shmName.empty() && protocol != "rtt.networktables.first.wpi.edu" &&
+      net::IsLoopbackAddress(m_info.remote_ip)) {
+    m_shmSegment = net::SharedMemorySegment::Open(m_shmName);
+  }
+  return true;
+}
+
 void NetworkServer::ServerConnection4::ProcessWsUpgrade() {
   // get name from URL
   wpi::UrlParser url{m_request.GetUrl(), false};
@@ -243,14 +377,17 @@ void NetworkServer::ServerConnection4::ProcessWsUpgrade() {
     return;
   }
 
-  m_websocket->SetMaxMessageSize(kMaxMessageSize);
+  m_websocket->SetMaxMessageSize(net::kMaxMessageSize);
 
   m_websocket->open.connect([this, name = std::string{name}](
                                 std::string_view protocol) {
+    // the lz4 variant is v4.1 plus compressed binary values
+    m_compress = protocol == "v4.1.lz4.networktables.first.wpi.edu";
     m_info.protocol_version =
-        protocol == "v4.1.networktables.first.wpi.edu" ? 0x0401 : 0x0400;
+        m_compress || protocol == "v4.1.networktables.first.wpi.edu" ? 0x0401
+                                                                     : 0x0400;
     m_wire = std::make_shared<net::WebSocketConnection>(
-        *m_websocket, m_info.protocol_version, m_logger);
+        *m_websocket, m_info.protocol_version, m_logger, m_compress);
 
     if (protocol == "rtt.networktables.first.wpi.edu") {
       INFO("CONNECTED RTT client (from {})", m_connInfo);
@@ -281,12 +418,25 @@ void NetworkServer::ServerConnection4::ProcessWsUpgrade() {
       return;
     }
 
+    if (m_shard) {
+      StartShard(name);
+      return;
+    }
+
+    net::WireConnection* wire = m_wire.get();
+    if (m_shmSegment) {
+      m_shmWire = std::make_unique<net::SharedMemoryConnection>(
+          *m_wire, std::move(m_shmSegment), true, m_server.m_loop);
+      wire = m_shmWire.get();
+    }
+
     // TODO: set local flag appropriately
     std::string dedupName;
     std::tie(dedupName, m_clientId) = m_server.m_serverImpl.AddClient(
-        name, m_connInfo, false, *m_wire,
+        name, m_connInfo, false, *wire,
         [this](uint32_t repeatMs) { UpdateOutgoingTimer(repeatMs); });
-    INFO("CONNECTED NT4 client '{}' (from {})", dedupName, m_connInfo);
+    INFO("CONNECTED NT4 client '{}' (from {}){}", dedupName, m_connInfo,
+         m_shmWire ? " using shared memory" : "");
     m_info.remote_id = dedupName;
     m_server.AddConnection(this, m_info);
     m_websocket->closed.connect([this](uint16_t, std::string_view reason) {
@@ -305,17 +455,247 @@ void NetworkServer::ServerConnection4::ProcessWsUpgrade() {
         m_server.m_idle->Start();
       }
     });
+    if (m_shmWire) {
+      m_shmWire->text.connect([this](std::string_view data) {
+        if (m_server.m_serverImpl.ProcessIncomingText(m_clientId, data)) {
+          m_server.m_idle->Start();
+        }
+      });
+      m_shmWire->binary.connect([this](std::span<const uint8_t> data) {
+        if (m_server.m_serverImpl.ProcessIncomingBinary(m_clientId, data)) {
+          m_server.m_idle->Start();
+        }
+      });
+    }
 
     SetupOutgoingTimer();
   });
 }
 
+void NetworkServer::ServerConnection4::StartShard(std::string_view name) {
+  m_shardState = std::make_shared<net::ShardConnectionState>();
+  m_shardConnId = m_shard->AddConnection(this);
+
+  m_websocket->closed.connect([this](uint16_t, std::string_view reason) {
+    m_shard->RemoveConnection(m_shardConnId);
+    auto realReason = m_wire->GetDisconnectReason();
+    PostEvent(ShardEvent::kClosed, realReason.empty() ? reason : realReason);
+  });
+  m_websocket->text.connect([this](std::string_view data, bool) {
+    PostEvent(ShardEvent::kText, data);
+  });
+  m_websocket->binary.connect([this](std::span<const uint8_t> data, bool) {
+    PostEvent(ShardEvent::kBinary,
+              {reinterpret_cast<const char*>(data.data()), data.size()});
+  });
+  m_websocket->pong.connect([this](auto) {
+    m_shardState->lastReceivedTime.store(m_websocket->GetLastReceivedTime(),
+                                         std::memory_order_relaxed);
+  });
+
+  ShardEvent event;
+  event.kind = ShardEvent::kOpen;
+  event.connId = m_shardConnId;
+  event.data = name;
+  event.info = m_info;
+  event.compress = m_compress;
+  event.state = m_shardState;
+  event.shm = std::move(m_shmSegment);
+  m_shard->PostEvent(std::move(event));
+}
+
+void NetworkServer::ServerConnection4::PostEvent(ShardEvent::Kind kind,
+                                                 std::string_view data) {
+  m_shardState->lastReceivedTime.store(m_websocket->GetLastReceivedTime(),
+                                       std::memory_order_relaxed);
+  ShardEvent event;
+  event.kind = kind;
+  event.connId = m_shardConnId;
+  event.data = data;
+  m_shard->PostEvent(std::move(event));
+}
+
+void NetworkServer::ServerConnection4::ProcessCommand(net::ShardCommand& cmd) {
+  switch (cmd.kind) {
+    case net::ShardCommand::kFrames: {
+      // the payload must stay alive until the write completes
+      auto data = std::make_shared<std::vector<uint8_t>>(std::move(cmd.data));
+      wpi::SmallVector<uv::Buffer, 32> bufs;
+      wpi::SmallVector<wpi::WebSocket::Frame, 32> frames;
+      bufs.reserve(cmd.frames.size());
+      size_t start = 0;
+      for (auto&& frame : cmd.frames) {
+        bufs.emplace_back(data->data() + start, frame.end - start);
+        frames.emplace_back(frame.opcode, std::span{&bufs.back(), 1});
+        start = frame.end;
+      }
+      m_websocket->SendFrames(frames,
+                              [data, state = m_shardState](auto, uv::Error) {
+                                state->pendingBytes.fetch_sub(
+                                    data->size(), std::memory_order_relaxed);
+                              });
+      break;
+    }
+    case net::ShardCommand::kPing:
+      m_wire->SendPing(cmd.time);
+      break;
+    case net::ShardCommand::kStopRead:
+      m_wire->StopRead();
+      break;
+    case net::ShardCommand::kStartRead:
+      m_wire->StartRead();
+      break;
+    case net::ShardCommand::kDisconnect:
+      m_wire->Disconnect(
+          {reinterpret_cast<const char*>(cmd.data.data()), cmd.data.size()});
+      break;
+  }
+}
+
+NetworkServer::ServerConnection4Shard::ServerConnection4Shard(
+    NetworkServer& server, Shard& shard, ShardEvent& event)
+    : ServerConnection{server, event.info.remote_ip, event.info.remote_port,
+                       server.m_logger},
+      m_wire{event.info.protocol_version,
+             event.compress,
+             event.connId,
+             std::move(event.state),
+             shard.m_commands,
+             [&shard] { shard.Wakeup(); }} {
+  m_info.protocol_version = event.info.protocol_version;
+
+  // the shared memory connection lives on the server loop, so it bypasses
+  // the shard entirely except for pings and disconnects
+  net::WireConnection* wire = &m_wire;
+  if (event.shm) {
+    m_shmWire = std::make_unique<net::SharedMemoryConnection>(
+        m_wire, std::move(event.shm), true, server.m_loop);
+    m_shmWire->text.connect(
+        [this](std::string_view data) { ProcessIncomingText(data); });
+    m_shmWire->binary.connect(
+        [this](std::span<const uint8_t> data) { ProcessIncomingBinary(data); });
+    wire = m_shmWire.get();
+  }
+
+  // TODO: set local flag appropriately
+  std::string dedupName;
+  std::tie(dedupName, m_clientId) = m_server.m_serverImpl.AddClient(
+      event.data, m_connInfo, false, *wire,
+      [this](uint32_t repeatMs) { UpdateOutgoingTimer(repeatMs); });
+  INFO("CONNECTED NT4 client '{}' (from {}){}", dedupName, m_connInfo,
+       m_shmWire ? " using shared memory" : "");
+  m_info.remote_id = dedupName;
+  m_server.AddConnection(this, m_info);
+
+  SetupOutgoingTimer();
+}
+
+void NetworkServer::ServerConnection4Shard::ProcessIncomingText(
+    std::string_view data) {
+  if (m_server.m_serverImpl.ProcessIncomingText(m_clientId, data)) {
+    m_server.m_idle->Start();
+  }
+}
+
+void NetworkServer::ServerConnection4Shard::ProcessIncomingBinary(
+    std::span<const uint8_t> data) {
+  if (m_server.m_serverImpl.ProcessIncomingBinary(m_clientId, data)) {
+    m_server.m_idle->Start();
+  }
+}
+
+void NetworkServer::ServerConnection4Shard::Closed(std::string_view reason) {
+  INFO("DISCONNECTED NT4 client '{}' (from {}): {}", m_info.remote_id,
+       m_connInfo, reason);
+  ConnectionClosed();
+}
+
+void NetworkServer::Shard::ProcessEvents() {
+  ShardEvent event;
+  while (m_events.try_dequeue(event)) {
+    if (event.kind == ShardEvent::kOpen) {
+      m_clients[event.connId] =
+          std::make_shared<ServerConnection4Shard>(m_server, *this, event);
+      continue;
+    }
+    auto it = m_clients.find(event.connId);
+    if (it == m_clients.end()) {
+      continue;
+    }
+    switch (event.kind) {
+      case ShardEvent::kText:
+        it->second->ProcessIncomingText(event.data);
+        break;
+      case ShardEvent::kBinary:
+        it->second->ProcessIncomingBinary(
+            {reinterpret_cast<const uint8_t*>(event.data.data()),
+             event.data.size()});
+        break;
+      case ShardEvent::kClosed:
+        it->second->Closed(event.data);
+        // ServerImpl releases the client (which references the connection)
+        // on the next loop iteration, so keep the connection until then
+        uv::Timer::SingleShot(m_server.m_loop, uv::Timer::Time{0},
+                              [conn = std::move(it->second)] {});
+        m_clients.erase(it);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+bool NetworkServer::Shard::Start(uv::Loop& loop) {
+  m_commandsAsync = uv::Async<>::Create(loop);
+  if (!m_commandsAsync) {
+    return false;
+  }
+  m_commandsAsync->wakeup.connect([this] { ProcessCommands(); });
+
+  m_listener = uv::Tcp::Create(loop);
+  if (!m_listener) {
+    return false;
+  }
+  m_listener->error.connect([logger = &m_server.m_logger](uv::Error err) {
+    WPI_INFO(*logger, "NT4 server socket error: {}", err.str());
+  });
+
+  // each shard has its own listener on the same port
+  sockaddr_in addr;
+  int err = uv::NameToAddr(m_server.m_listenAddress, m_server.m_port4, &addr);
+  if (err == 0) {
+    err = uv_tcp_bind(m_listener->GetRaw(),
+                      reinterpret_cast<const sockaddr*>(&addr),
+                      UV_TCP_REUSEPORT);
+  }
+  if (err < 0) {
+    WPI_INFO(m_server.m_logger, "could not bind NT4 I/O loop listener: {}",
+             uv::Error{err}.str());
+    return false;
+  }
+  m_listener->connection.connect([this, srv = m_listener.get()] {
+    m_server.AcceptConnection4(*srv, this);
+  });
+  return true;
+}
+
+void NetworkServer::Shard::ProcessCommands() {
+  net::ShardCommand cmd;
+  while (m_commands.try_dequeue(cmd)) {
+    auto it = m_conns.find(cmd.connId);
+    if (it != m_conns.end()) {
+      it->second->ProcessCommand(cmd);
+    }
+  }
+}
+
 NetworkServer::NetworkServer(std::string_view persistentFilename,
                              std::string_view listenAddress, unsigned int port3,
                              unsigned int port4,
                              net::ILocalStorage& localStorage,
                              IConnectionList& connList, wpi::Logger& logger,
-                             std::function<void()> initDone)
+                             std::function<void()> initDone,
+                             unsigned int numShards)
     : m_localStorage{localStorage},
       m_connList{connList},
       m_logger{logger},
@@ -327,6 +707,9 @@ NetworkServer::NetworkServer(std::string_view persistentFilename,
       m_serverImpl{logger},
       m_localQueue{logger},
       m_loop(*m_loopRunner.GetLoop()) {
+  for (unsigned int i = 0; i < numShards; ++i) {
+    m_shards.emplace_back(std::make_unique<Shard>(*this));
+  }
   m_loopRunner.ExecAsync([=, this](uv::Loop& loop) {
     // connect local storage to server
     m_serverImpl.SetLocal(&m_localStorage, &m_localQueue);
@@ -339,7 +722,12 @@ NetworkServer::NetworkServer(std::string_view persistentFilename,
 }
 
 NetworkServer::~NetworkServer() {
-  m_loopRunner.ExecAsync([this](uv::Loop&) { m_shutdown = true; });
+  m_loopRunner.ExecSync([this](uv::Loop&) { m_shutdown = true; });
+  // stop the I/O loops while the server loop is still running, so it
+  // processes the resulting disconnects
+  for (auto&& shard : m_shards) {
+    shard->m_runner.Stop();
+  }
   m_localStorage.ClearNetwork();
   m_connList.ClearConnections();
 }
@@ -519,7 +907,7 @@ void NetworkServer::Init() {
     tcp3->Listen();
   }
 
-  if (m_port4 != 0) {
+  if (m_port4 != 0 && !StartShards()) {
     auto tcp4 = uv::Tcp::Create(m_loop);
     tcp4->error.connect([logger = &m_logger](uv::Error err) {
       WPI_INFO(*logger, "NT4 server socket error: {}", err.str());
@@ -527,27 +915,8 @@ void NetworkServer::Init() {
     tcp4->Bind(m_listenAddress, m_port4);
 
     // when we get a NT4 connection, accept it and start reading
-    tcp4->connection.connect([this, srv = tcp4.get()] {
-      auto tcp = srv->Accept();
-      if (!tcp) {
-        return;
-      }
-      tcp->SetLogger(&m_logger);
-      tcp->error.connect([logger = &m_logger](uv::Error err) {
-        WPI_INFO(*logger, "NT4 socket error: {}", err.str());
-      });
-      tcp->SetNoDelay(true);
-      std::string peerAddr;
-      unsigned int peerPort = 0;
-      if (uv::AddrToName(tcp->GetPeer(), &peerAddr, &peerPort) == 0) {
-        INFO("Got a NT4 connection from {} port {}", peerAddr, peerPort);
-      } else {
-        INFO("Got a NT4 connection from unknown");
-      }
-      auto conn = std::make_shared<ServerConnection4>(tcp, *this, peerAddr,
-                                                      peerPort, m_logger);
-      tcp->SetData(conn);
-    });
+    tcp4->connection.connect(
+        [this, srv = tcp4.get()] { AcceptConnection4(*srv, nullptr); });
 
     tcp4->Listen();
   }
@@ -559,6 +928,74 @@ void NetworkServer::Init() {
   }
 }
 
+bool NetworkServer::StartShards() {
+  if (m_shards.empty()) {
+    return false;
+  }
+
+  bool ok = true;
+  for (auto&& shard : m_shards) {
+    shard->m_eventsAsync = uv::Async<>::Create(m_loop);
+    if (!shard->m_eventsAsync) {
+      ok = false;
+      break;
+    }
+    shard->m_eventsAsync->wakeup.connect(
+        [shard = shard.get()] { shard->ProcessEvents(); });
+
+    bool started = false;
+    shard->m_runner.ExecSync(
+        [&](uv::Loop& loop) { started = shard->Start(loop); });
+    if (!started) {
+      ok = false;
+      break;
+    }
+  }
+
+  if (!ok) {
+    // fall back to handling all clients on the server loop
+    INFO("could not start NT4 I/O loops, using a single loop");
+    for (auto&& shard : m_shards) {
+      shard->m_runner.Stop();
+      if (shard->m_eventsAsync) {
+        shard->m_eventsAsync->Close();
+      }
+    }
+    m_shards.clear();
+    return false;
+  }
+
+  // only start listening once all the listeners are bound
+  for (auto&& shard : m_shards) {
+    shard->m_runner.ExecAsync(
+        [shard = shard.get()](uv::Loop&) { shard->Listen(); });
+  }
+  INFO("using {} NT4 I/O loops", m_shards.size());
+  return true;
+}
+
+void NetworkServer::AcceptConnection4(uv::Tcp& srv, Shard* shard) {
+  auto tcp = srv.Accept();
+  if (!tcp) {
+    return;
+  }
+  tcp->SetLogger(&m_logger);
+  tcp->error.connect([logger = &m_logger](uv::Error err) {
+    WPI_INFO(*logger, "NT4 socket error: {}", err.str());
+  });
+  tcp->SetNoDelay(true);
+  std::string peerAddr;
+  unsigned int peerPort = 0;
+  if (uv::AddrToName(tcp->GetPeer(), &peerAddr, &peerPort) == 0) {
+    INFO("Got a NT4 connection from {} port {}", peerAddr, peerPort);
+  } else {
+    INFO("Got a NT4 connection from unknown");
+  }
+  auto conn = std::make_shared<ServerConnection4>(tcp, *this, shard, peerAddr,
+                                                  peerPort, m_logger);
+  tcp->SetData(conn);
+}
+
 void NetworkServer::AddConnection(ServerConnection* conn,
                                   const ConnectionInfo& info) {
   std::scoped_lock lock{m_mutex};
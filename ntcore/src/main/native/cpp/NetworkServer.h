@@ -25,6 +25,10 @@ namespace wpi {
 class Logger;
 }  // namespace wpi
 
+namespace wpi::uv {
+class Tcp;
+}  // namespace wpi::uv
+
 namespace nt::net {
 class ILocalStorage;
 }  // namespace nt::net
@@ -39,7 +43,7 @@ class NetworkServer {
                 std::string_view listenAddress, unsigned int port3,
                 unsigned int port4, net::ILocalStorage& localStorage,
                 IConnectionList& connList, wpi::Logger& logger,
-                std::function<void()> initDone);
+                std::function<void()> initDone, unsigned int numShards = 0);
   ~NetworkServer();
 
   void FlushLocal();
@@ -49,11 +53,16 @@ class NetworkServer {
   class ServerConnection;
   class ServerConnection3;
   class ServerConnection4;
+  class ServerConnection4Shard;
+  class Shard;
+  struct ShardEvent;
 
   void ProcessAllLocal();
   void LoadPersistent();
   void SavePersistent(std::string_view filename, std::string_view data);
   void Init();
+  bool StartShards();
+  void AcceptConnection4(wpi::uv::Tcp& srv, Shard* shard);
   void AddConnection(ServerConnection* conn, const ConnectionInfo& info);
   void RemoveConnection(ServerConnection* conn);
 
@@ -92,6 +101,9 @@ class NetworkServer {
 
   Queue m_localQueue;
 
+  // NT4 client I/O loops; empty if all clients are handled on m_loop
+  std::vector<std::unique_ptr<Shard>> m_shards;
+
   wpi::EventLoopRunner m_loopRunner;
   wpi::uv::Loop& m_loop;
 };
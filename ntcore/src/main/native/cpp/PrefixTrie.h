@@ -0,0 +1,194 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace nt {
+
+// Radix tree mapping string keys to values, for prefix matching. Multiple
+// values may be stored under the same key.
+//
+// ForEachWithPrefix() finds all values with keys starting with a prefix (e.g.
+// topics matching a prefix subscription), and ForEachPrefixOf() finds all
+// values with keys that are a prefix of a string (e.g. prefix subscriptions
+// matching a topic). Both cost O(string length + matches) instead of a scan
+// of all keys.
+template <typename T>
+class PrefixTrie {
+ public:
+  void Insert(std::string_view key, T value) {
+    Node* node = &m_root;
+    for (;;) {
+      if (key.empty()) {
+        node->values.emplace_back(std::move(value));
+        return;
+      }
+      auto it = node->FindChild(key[0]);
+      if (it == node->children.end() || (*it)->label[0] != key[0]) {
+        // no child with the same first character
+        auto& child = *node->children.emplace(it, std::make_unique<Node>());
+        child->label = key;
+        child->values.emplace_back(std::move(value));
+        return;
+      }
+      Node* child = it->get();
+      size_t common = CommonPrefixLength(child->label, key);
+      if (common < child->label.size()) {
+        // split the child; the new node gets the common part of the label
+        auto split = std::make_unique<Node>();
+        split->label = child->label.substr(0, common);
+        child->label.erase(0, common);
+        split->children.emplace_back(std::move(*it));
+        *it = std::move(split);
+        child = it->get();
+      }
+      node = child;
+      key.remove_prefix(common);
+    }
+  }
+
+  // Removes one value stored under key; returns false if not found
+  bool Erase(std::string_view key, const T& value) {
+    return EraseImpl(m_root, key, value);
+  }
+
+  void clear() {
+    m_root.values.clear();
+    m_root.children.clear();
+  }
+
+  // Calls func for each value with a key starting with prefix, in key order
+  template <typename F>
+  void ForEachWithPrefix(std::string_view prefix, F&& func) const {
+    const Node* node = &m_root;
+    while (!prefix.empty()) {
+      auto it = node->FindChild(prefix[0]);
+      if (it == node->children.end() || (*it)->label[0] != prefix[0]) {
+        return;
+      }
+      const Node* child = it->get();
+      size_t common = CommonPrefixLength(child->label, prefix);
+      if (common == prefix.size()) {
+        // prefix ends within (or at the end of) this child's label
+        node = child;
+        break;
+      }
+      if (common < child->label.size()) {
+        return;  // mismatch
+      }
+      node = child;
+      prefix.remove_prefix(common);
+    }
+    ForEachValue(*node, func);
+  }
+
+  // Calls func for each value with a key that is a prefix of str (including
+  // keys equal to str), shortest keys first. Values with an empty key are
+  // skipped if includeEmpty is false.
+  template <typename F>
+  void ForEachPrefixOf(std::string_view str, F&& func,
+                       bool includeEmpty = true) const {
+    const Node* node = &m_root;
+    if (includeEmpty) {
+      for (auto&& value : node->values) {
+        func(value);
+      }
+    }
+    while (!str.empty()) {
+      auto it = node->FindChild(str[0]);
+      if (it == node->children.end() || (*it)->label[0] != str[0] ||
+          !str.starts_with((*it)->label)) {
+        return;
+      }
+      node = it->get();
+      str.remove_prefix(node->label.size());
+      for (auto&& value : node->values) {
+        func(value);
+      }
+    }
+  }
+
+ private:
+  struct Node {
+    using Children = std::vector<std::unique_ptr<Node>>;
+
+    // children are sorted by first character of label, and no two children
+    // share a first character
+    typename Children::const_iterator FindChild(char ch) const {
+      return std::lower_bound(
+          children.begin(), children.end(), ch,
+          [](const auto& child, char c) { return child->label[0] < c; });
+    }
+    typename Children::iterator FindChild(char ch) {
+      return std::lower_bound(
+          children.begin(), children.end(), ch,
+          [](const auto& child, char c) { return child->label[0] < c; });
+    }
+
+    std::string label;  // empty only for the root
+    std::vector<T> values;
+    Children children;
+  };
+
+  static size_t CommonPrefixLength(std::string_view a, std::string_view b) {
+    return std::mismatch(a.begin(), a.begin() + (std::min)(a.size(), b.size()),
+                         b.begin())
+               .first -
+           a.begin();
+  }
+
+  template <typename F>
+  static void ForEachValue(const Node& node, F& func) {
+    for (auto&& value : node.values) {
+      func(value);
+    }
+    for (auto&& child : node.children) {
+      ForEachValue(*child, func);
+    }
+  }
+
+  static bool EraseImpl(Node& node, std::string_view key, const T& value) {
+    if (key.empty()) {
+      auto it = std::find(node.values.begin(), node.values.end(), value);
+      if (it == node.values.end()) {
+        return false;
+      }
+      node.values.erase(it);
+      return true;
+    }
+    auto it = node.FindChild(key[0]);
+    if (it == node.children.end() || (*it)->label[0] != key[0] ||
+        !key.starts_with((*it)->label)) {
+      return false;
+    }
+    Node& child = **it;
+    if (!EraseImpl(child, key.substr(child.label.size()), value)) {
+      return false;
+    }
+    // remove or merge the child if it's no longer needed
+    if (child.values.empty()) {
+      if (child.children.empty()) {
+        node.children.erase(it);
+      } else if (child.children.size() == 1) {
+        auto grandchild = std::move(child.children.front());
+        grandchild->label.insert(0, child.label);
+        *it = std::move(grandchild);
+      }
+    }
+    return true;
+  }
+
+  Node m_root;
+};
+
+}  // namespace nt
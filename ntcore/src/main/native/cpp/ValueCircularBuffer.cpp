@@ -4,20 +4,40 @@
 
 #include "ValueCircularBuffer.h"
 
+#include <bit>
 #include <utility>
 #include <vector>
 
 using namespace nt;
 
+ValueCircularBuffer::ValueCircularBuffer(size_t size)
+    : m_size{(std::max)(size, static_cast<size_t>(1))},
+      m_mask{std::bit_ceil(2 * m_size) - 1},
+      m_values{std::make_unique<Value[]>(m_mask + 1)} {}
+
+void ValueCircularBuffer::emplace_back(const Value& value) {
+  uint64_t head = m_head.load(std::memory_order_relaxed);
+  if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+    // full; drop all but the newest m_size - 1 values to make room. A reader
+    // may be in the middle of emptying the ring, so wait for it to finish.
+    std::scoped_lock lock{m_readMutex};
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    uint64_t newTail = head - (m_size - 1);
+    for (; tail < newTail; ++tail) {
+      m_values[tail & m_mask] = Value{};
+    }
+    m_tail.store((std::max)(tail, newTail), std::memory_order_release);
+  }
+  m_values[head & m_mask] = value;
+  m_head.store(head + 1, std::memory_order_release);
+}
+
 std::vector<Value> ValueCircularBuffer::ReadValue(unsigned int types) {
   std::vector<Value> rv;
-  rv.reserve(m_storage.size());
-  for (auto&& val : m_storage) {
-    if (types != 0 && (types & val.type()) == 0) {
-      continue;
+  Consume([&](Value& val) {
+    if (types == 0 || (types & val.type()) != 0) {
+      rv.emplace_back(std::move(val));
     }
-    rv.emplace_back(std::move(val));
-  }
-  m_storage.reset();
+  });
   return rv;
 }
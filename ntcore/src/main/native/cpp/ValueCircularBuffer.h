@@ -4,10 +4,16 @@
 
 #pragma once
 
-#include <utility>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 
-#include <wpi/circular_buffer.h>
+#include <wpi/spinlock.h>
 
 #include "Value_internal.h"
 #include "networktables/NetworkTableValue.h"
@@ -15,35 +21,91 @@
 
 namespace nt {
 
+// Queue of the most recent values for a subscriber.
+//
+// There is a single producer (storage, which calls emplace_back() while
+// holding the storage mutex); readers do not need the storage mutex. Values
+// are kept in a ring with room for twice the queue size, so the producer
+// normally appends without waiting, and a read takes only the newest size
+// values. Only if the ring fills up (nobody has read for a while) does the
+// producer drop old values, which requires briefly excluding readers.
+// Concurrent readers are serialized with a spinlock.
 class ValueCircularBuffer {
  public:
-  explicit ValueCircularBuffer(size_t size) : m_storage{size} {}
+  explicit ValueCircularBuffer(size_t size);
 
-  template <class... Args>
-  void emplace_back(Args&&... args) {
-    m_storage.emplace_back(std::forward<Args...>(args...));
-  }
+  void emplace_back(const Value& value);
 
   std::vector<Value> ReadValue(unsigned int types);
   template <ValidType T>
   std::vector<Timestamped<typename TypeInfo<T>::Value>> Read();
 
+  // Reads into buf, replacing its contents. The storage (including string
+  // and array storage) of existing elements in buf is reused.
+  template <ValidType T>
+  void Read(std::vector<Timestamped<typename TypeInfo<T>::Value>>& buf);
+
  private:
-  wpi::circular_buffer<Value> m_storage;
+  // Calls func for each of the newest (up to) m_size values and empties the
+  // ring.
+  template <typename F>
+  void Consume(F&& func);
+
+  size_t m_size;
+  size_t m_mask;
+  std::unique_ptr<Value[]> m_values;
+
+  // total number of values appended (written only by the producer)
+  alignas(64) std::atomic<uint64_t> m_head{0};
+  // total number of values consumed or dropped
+  alignas(64) std::atomic<uint64_t> m_tail{0};
+  wpi::spinlock m_readMutex;
 };
 
+template <typename F>
+void ValueCircularBuffer::Consume(F&& func) {
+  std::scoped_lock lock{m_readMutex};
+  uint64_t tail = m_tail.load(std::memory_order_relaxed);
+  uint64_t head = m_head.load(std::memory_order_acquire);
+  uint64_t start =
+      head - (std::min)(head - tail, static_cast<uint64_t>(m_size));
+  for (uint64_t pos = tail; pos != head; ++pos) {
+    auto& val = m_values[pos & m_mask];
+    if (pos >= start) {
+      func(val);
+    }
+    val = Value{};
+  }
+  m_tail.store(head, std::memory_order_release);
+}
+
 template <ValidType T>
 std::vector<Timestamped<typename TypeInfo<T>::Value>>
 ValueCircularBuffer::Read() {
   std::vector<Timestamped<typename TypeInfo<T>::Value>> rv;
-  rv.reserve(m_storage.size());
-  for (auto&& val : m_storage) {
+  Consume([&](const Value& val) {
     if (IsNumericConvertibleTo<T>(val) || IsType<T>(val)) {
       rv.emplace_back(GetTimestamped<T, true>(val));
     }
-  }
-  m_storage.reset();
+  });
   return rv;
 }
 
+template <ValidType T>
+void ValueCircularBuffer::Read(
+    std::vector<Timestamped<typename TypeInfo<T>::Value>>& buf) {
+  size_t count = 0;
+  Consume([&](const Value& val) {
+    if (IsNumericConvertibleTo<T>(val) || IsType<T>(val)) {
+      if (count < buf.size()) {
+        AssignTimestamped<T, true>(buf[count], val);
+      } else {
+        buf.emplace_back(GetTimestamped<T, true>(val));
+      }
+      ++count;
+    }
+  });
+  buf.resize(count);
+}
+
 }  // namespace nt
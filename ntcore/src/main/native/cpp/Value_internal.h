@@ -397,6 +397,33 @@ inline typename TypeInfo<T>::SmallRet GetValueCopy(
   }
 }
 
+// Like GetValueCopy, but copies into out, reusing its storage
+template <ValidType T, bool ConvertNumeric>
+inline void AssignValueCopy(typename TypeInfo<T>::Value& out,
+                            const Value& value) {
+  if constexpr (ConvertNumeric && NumericArrayType<T>) {
+    if (value.IsIntegerArray()) {
+      auto arr = value.GetIntegerArray();
+      out.assign(arr.begin(), arr.end());
+    } else if (value.IsFloatArray()) {
+      auto arr = value.GetFloatArray();
+      out.assign(arr.begin(), arr.end());
+    } else if (value.IsDoubleArray()) {
+      auto arr = value.GetDoubleArray();
+      out.assign(arr.begin(), arr.end());
+    } else {
+      out.clear();
+    }
+  } else if constexpr (ArrayType<T> || IsNTType<T, NT_RAW>) {
+    auto arr = GetValueView<T>(value);
+    out.assign(arr.begin(), arr.end());
+  } else if constexpr (IsNTType<T, NT_STRING>) {
+    out.assign(GetValueView<T>(value));
+  } else {
+    out = GetValueCopy<T, ConvertNumeric>(value);
+  }
+}
+
 template <ValidType T, bool ConvertNumeric>
 inline Timestamped<typename TypeInfo<T>::Value> GetTimestamped(
     const Value& value) {
@@ -404,6 +431,14 @@ inline Timestamped<typename TypeInfo<T>::Value> GetTimestamped(
           GetValueCopy<T, ConvertNumeric>(value)};
 }
 
+template <ValidType T, bool ConvertNumeric>
+inline void AssignTimestamped(Timestamped<typename TypeInfo<T>::Value>& out,
+                              const Value& value) {
+  out.time = value.time();
+  out.serverTime = value.server_time();
+  AssignValueCopy<T, ConvertNumeric>(out.value, value);
+}
+
 template <SmallArrayType T, bool ConvertNumeric>
 inline Timestamped<typename TypeInfo<T>::SmallRet> GetTimestamped(
     const Value& value,
@@ -4,7 +4,10 @@
 
 #include "LocalStorageImpl.h"
 
+#include <algorithm>
 #include <memory>
+#include <span>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
@@ -13,6 +16,7 @@
 #include <fmt/ranges.h>
 #include <wpi/DataLog.h>
 #include <wpi/SmallString.h>
+#include <wpi/SmallVector.h>
 #include <wpi/StringExtras.h>
 
 #include "IListenerStorage.h"
@@ -170,16 +174,59 @@ LocalTopic* StorageImpl::GetOrCreateTopic(std::string_view name) {
   // create if it does not already exist
   if (!topic) {
     topic = m_topics.Add(m_inst, name);
+    m_topicIndex.Insert(name, topic);
     // attach multi-subscribers
-    for (auto&& sub : m_multiSubscribers) {
-      if (sub->Matches(name, topic->special)) {
-        topic->multiSubscribers.Add(sub.get());
-      }
+    wpi::SmallVector<LocalMultiSubscriber*, 16> subs;
+    m_multiSubscriberIndex.ForEachPrefixOf(
+        name, [&](LocalMultiSubscriber* sub) { subs.emplace_back(sub); },
+        !topic->special);
+    // a subscriber may match with more than one prefix
+    std::sort(subs.begin(), subs.end(), [](auto a, auto b) {
+      return a->handle.GetHandle() < b->handle.GetHandle();
+    });
+    subs.erase(std::unique(subs.begin(), subs.end()), subs.end());
+    for (auto sub : subs) {
+      topic->multiSubscribers.Add(sub);
     }
   }
   return topic;
 }
 
+void StorageImpl::GetTopicsWithPrefix(
+    std::string_view prefix, wpi::SmallVectorImpl<LocalTopic*>& topics) const {
+  if (prefix.empty()) {
+    for (auto&& topic : m_topics) {
+      topics.emplace_back(topic.get());
+    }
+    return;
+  }
+  size_t start = topics.size();
+  m_topicIndex.ForEachWithPrefix(
+      prefix, [&](LocalTopic* topic) { topics.emplace_back(topic); });
+  std::sort(topics.begin() + start, topics.end(), [](auto a, auto b) {
+    return a->handle.GetHandle() < b->handle.GetHandle();
+  });
+}
+
+void StorageImpl::GetPrefixMatchTopics(
+    std::span<const std::string> prefixes,
+    wpi::SmallVectorImpl<LocalTopic*>& topics) const {
+  size_t start = topics.size();
+  for (auto&& prefix : prefixes) {
+    m_topicIndex.ForEachWithPrefix(prefix, [&](LocalTopic* topic) {
+      if (PrefixMatch(topic->name, prefix, topic->special)) {
+        topics.emplace_back(topic);
+      }
+    });
+  }
+  // a topic may match more than one prefix
+  std::sort(topics.begin() + start, topics.end(), [](auto a, auto b) {
+    return a->handle.GetHandle() < b->handle.GetHandle();
+  });
+  topics.erase(std::unique(topics.begin() + start, topics.end()),
+               topics.end());
+}
+
 //
 // Topic property functions
 //
@@ -418,14 +465,14 @@ LocalMultiSubscriber* StorageImpl::AddMultiSubscriber(
     return nullptr;
   }
   auto subscriber = m_multiSubscribers.Add(m_inst, prefixes, options);
+  for (auto&& prefix : subscriber->prefixes) {
+    m_multiSubscriberIndex.Insert(prefix, subscriber);
+  }
   // subscribe to any already existing topics
-  for (auto&& topic : m_topics) {
-    for (auto&& prefix : prefixes) {
-      if (PrefixMatch(topic->name, prefix, topic->special)) {
-        topic->multiSubscribers.Add(subscriber);
-        break;
-      }
-    }
+  wpi::SmallVector<LocalTopic*, 32> topics;
+  GetPrefixMatchTopics(subscriber->prefixes, topics);
+  for (auto&& topic : topics) {
+    topic->multiSubscribers.Add(subscriber);
   }
   if (m_network && !subscriber->options.hidden) {
     DEBUG4("-> NetworkSubscribe");
@@ -439,7 +486,12 @@ std::unique_ptr<LocalMultiSubscriber> StorageImpl::RemoveMultiSubscriber(
     NT_MultiSubscriber subHandle) {
   auto subscriber = m_multiSubscribers.Remove(subHandle);
   if (subscriber) {
-    for (auto&& topic : m_topics) {
+    for (auto&& prefix : subscriber->prefixes) {
+      m_multiSubscriberIndex.Erase(prefix, subscriber.get());
+    }
+    wpi::SmallVector<LocalTopic*, 32> topics;
+    GetPrefixMatchTopics(subscriber->prefixes, topics);
+    for (auto&& topic : topics) {
       topic->multiSubscribers.Remove(subscriber.get());
     }
     for (auto&& listener : m_listeners) {
@@ -592,11 +644,10 @@ void StorageImpl::AddListenerImpl(NT_Listener listenerHandle,
   wpi::SmallVector<LocalTopic*, 32> topics;
   if ((eventMask & NT_EVENT_IMMEDIATE) != 0 &&
       (eventMask & (NT_EVENT_PUBLISH | NT_EVENT_VALUE_ALL)) != 0) {
-    for (auto&& topic : m_topics) {
-      if (topic->Exists() && subscriber->Matches(topic->name, topic->special)) {
-        topics.emplace_back(topic.get());
-      }
-    }
+    GetPrefixMatchTopics(subscriber->prefixes, topics);
+    topics.erase(std::remove_if(topics.begin(), topics.end(),
+                                [](auto topic) { return !topic->Exists(); }),
+                 topics.end());
   }
 
   if ((eventMask & NT_EVENT_TOPIC) != 0) {
@@ -696,9 +747,10 @@ LocalDataLogger* StorageImpl::StartDataLog(wpi::log::DataLog& log,
 
   // start logging any matching topics
   auto now = nt::Now();
-  for (auto&& topic : m_topics) {
-    if (!PrefixMatch(topic->name, prefix, topic->special) ||
-        topic->type == NT_UNASSIGNED || topic->typeStr.empty()) {
+  wpi::SmallVector<LocalTopic*, 32> topics;
+  GetPrefixMatchTopics({&datalogger->prefix, 1}, topics);
+  for (auto&& topic : topics) {
+    if (topic->type == NT_UNASSIGNED || topic->typeStr.empty()) {
       continue;
     }
     topic->StartStopDataLog(datalogger, now, true);
@@ -715,7 +767,9 @@ void StorageImpl::StopDataLog(NT_DataLogger logger) {
   if (auto datalogger = m_dataloggers.Remove(logger)) {
     // finish any active entries
     auto now = Now();
-    for (auto&& topic : m_topics) {
+    wpi::SmallVector<LocalTopic*, 32> topics;
+    GetPrefixMatchTopics({&datalogger->prefix, 1}, topics);
+    for (auto&& topic : topics) {
       topic->StartStopDataLog(datalogger.get(), now, false);
     }
   }
@@ -765,6 +819,9 @@ void StorageImpl::Reset() {
   m_multiSubscribers.clear();
   m_dataloggers.clear();
   m_nameTopics.clear();
+  m_topicIndex.clear();
+  m_multiSubscriberIndex.clear();
+  m_pollStorage.Clear();
   m_listeners.clear();
   m_topicPrefixListeners.clear();
 }
@@ -844,7 +901,7 @@ void StorageImpl::NotifyValue(LocalTopic* topic, const Value& value,
          (!isNetwork && !subscriber->config.disableLocal)) &&
         (!publisher || (publisher && (subscriber->config.excludePublisher !=
                                       publisher->handle)))) {
-      subscriber->pollStorage.emplace_back(value);
+      subscriber->pollStorage->emplace_back(value);
       subscriber->handle.Set();
       if (!subscriber->valueListeners.empty()) {
         m_listenerStorage.Notify(subscriber->valueListeners, eventFlags,
@@ -990,6 +1047,7 @@ LocalSubscriber* StorageImpl::AddLocalSubscriber(LocalTopic* topic,
   DEBUG4("AddLocalSubscriber({})", topic->name);
   auto subscriber = m_subscribers.Add(m_inst, topic, config);
   topic->localSubscribers.Add(subscriber);
+  SetPollStorage(subscriber->handle, subscriber->pollStorage);
   // set subscriber to active if the type matches
   subscriber->UpdateActive();
   if (topic->Exists() && !subscriber->active) {
@@ -1008,10 +1066,10 @@ LocalSubscriber* StorageImpl::AddLocalSubscriber(LocalTopic* topic,
   // queue current value
   if (subscriber->active) {
     if (!topic->lastValueFromNetwork && !config.disableLocal) {
-      subscriber->pollStorage.emplace_back(topic->lastValue);
+      subscriber->pollStorage->emplace_back(topic->lastValue);
       subscriber->handle.Set();
     } else if (topic->lastValueFromNetwork && !config.disableRemote) {
-      subscriber->pollStorage.emplace_back(topic->lastValueNetwork);
+      subscriber->pollStorage->emplace_back(topic->lastValueNetwork);
       subscriber->handle.Set();
     }
   }
@@ -1024,6 +1082,7 @@ std::unique_ptr<LocalSubscriber> StorageImpl::RemoveLocalSubscriber(
   if (subscriber) {
     auto topic = subscriber->topic;
     topic->localSubscribers.Remove(subscriber.get());
+    SetPollStorage(subHandle, nullptr);
     for (auto&& listener : m_listeners) {
       if (listener.getSecond()->subscriber == subscriber.get()) {
         listener.getSecond()->subscriber = nullptr;
@@ -6,15 +6,22 @@
 
 #include <concepts>
 #include <memory>
+#include <span>
+#include <string>
 #include <string_view>
+#include <utility>
 
 #include <wpi/DenseMap.h>
+#include <wpi/SmallVector.h>
 #include <wpi/StringExtras.h>
 #include <wpi/StringMap.h>
 #include <wpi/Synchronization.h>
 #include <wpi/json.h>
+#include <wpi/mutex.h>
 
 #include "HandleMap.h"
+#include "PrefixTrie.h"
+#include "ValueCircularBuffer.h"
 #include "local/LocalDataLogger.h"
 #include "local/LocalEntry.h"
 #include "local/LocalListener.h"
@@ -22,6 +29,7 @@
 #include "local/LocalPublisher.h"
 #include "local/LocalSubscriber.h"
 #include "local/LocalTopic.h"
+#include "local/PollStorageTable.h"
 #include "ntcore_c.h"
 #include "ntcore_cpp.h"
 
@@ -77,13 +85,12 @@ class StorageImpl {
   template <std::invocable<const LocalTopic&> F>
   void ForEachTopic(std::string_view prefix, unsigned int types,
                     F&& func) const {
-    for (auto&& topic : m_topics) {
+    wpi::SmallVector<LocalTopic*, 32> topics;
+    GetTopicsWithPrefix(prefix, topics);
+    for (auto&& topic : topics) {
       if (!topic->Exists()) {
         continue;
       }
-      if (!wpi::starts_with(topic->name, prefix)) {
-        continue;
-      }
       if (types != 0 && (types & topic->type) == 0) {
         continue;
       }
@@ -94,13 +101,12 @@ class StorageImpl {
   template <std::invocable<const LocalTopic&> F>
   void ForEachTopic(std::string_view prefix,
                     std::span<const std::string_view> types, F&& func) const {
-    for (auto&& topic : m_topics) {
+    wpi::SmallVector<LocalTopic*, 32> topics;
+    GetTopicsWithPrefix(prefix, topics);
+    for (auto&& topic : topics) {
       if (!topic->Exists()) {
         continue;
       }
-      if (!wpi::starts_with(topic->name, prefix)) {
-        continue;
-      }
       if (!types.empty()) {
         bool match = false;
         for (auto&& type : types) {
@@ -211,6 +217,14 @@ class StorageImpl {
     return m_subscribers.Get(handle);
   }
 
+  // Calls func with the poll storage of a subscriber or entry; returns false
+  // if there is none. Unlike the other functions, this may be called without
+  // holding the storage mutex.
+  template <typename F>
+  bool ReadPollStorage(NT_Handle subentryHandle, F&& func) {
+    return m_pollStorage.Read(subentryHandle, std::forward<F>(func));
+  }
+
   //
   // Listener functions
   //
@@ -274,6 +288,7 @@ class StorageImpl {
   LocalEntry* AddEntry(LocalSubscriber* subscriber) {
     auto entry = m_entries.Add(m_inst, subscriber);
     subscriber->topic->entries.Add(entry);
+    SetPollStorage(entry->handle, subscriber->pollStorage);
     return entry;
   }
 
@@ -281,12 +296,27 @@ class StorageImpl {
     auto entry = m_entries.Remove(entryHandle);
     if (entry) {
       entry->topic->entries.Remove(entry.get());
+      SetPollStorage(entryHandle, nullptr);
     }
     return entry;
   }
 
+  void SetPollStorage(NT_Handle subentryHandle,
+                      std::shared_ptr<ValueCircularBuffer> storage) {
+    m_pollStorage.Set(subentryHandle, std::move(storage));
+  }
+
   LocalPublisher* PublishEntry(LocalEntry* entry, NT_Type type);
 
+  // Gets topics with names starting with prefix, in handle order
+  void GetTopicsWithPrefix(std::string_view prefix,
+                           wpi::SmallVectorImpl<LocalTopic*>& topics) const;
+
+  // Gets topics matching any of the prefixes (see PrefixMatch), in handle
+  // order
+  void GetPrefixMatchTopics(std::span<const std::string> prefixes,
+                            wpi::SmallVectorImpl<LocalTopic*>& topics) const;
+
   bool PublishLocalValue(LocalPublisher* publisher, const Value& value,
                          bool force = false);
 
@@ -307,6 +337,13 @@ class StorageImpl {
   // name mappings
   wpi::StringMap<LocalTopic*> m_nameTopics;
 
+  // prefix indexes
+  PrefixTrie<LocalTopic*> m_topicIndex;
+  PrefixTrie<LocalMultiSubscriber*> m_multiSubscriberIndex;
+
+  // subscriber and entry poll storage, for reads without the storage mutex
+  PollStorageTable m_pollStorage;
+
   // listeners
   wpi::DenseMap<NT_Listener, std::unique_ptr<LocalListener>> m_listeners;
 
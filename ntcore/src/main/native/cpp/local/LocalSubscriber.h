@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 
 #include <wpi/Synchronization.h>
@@ -25,7 +26,8 @@ struct LocalSubscriber {
       : handle{handle},
         topic{topic},
         config{std::move(config)},
-        pollStorage{config.pollStorage} {}
+        pollStorage{
+            std::make_shared<ValueCircularBuffer>(config.pollStorage)} {}
 
   void UpdateActive() {
     // for subscribers, unassigned is a wildcard
@@ -43,8 +45,8 @@ struct LocalSubscriber {
   // whether or not the subscriber should actually receive values
   bool active{false};
 
-  // polling storage
-  ValueCircularBuffer pollStorage;
+  // polling storage; shared so it can be read without the storage mutex
+  std::shared_ptr<ValueCircularBuffer> pollStorage;
 
   // value listeners
   VectorSet<NT_Listener> valueListeners;
@@ -0,0 +1,131 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <wpi/spinlock.h>
+
+#include "Handle.h"
+#include "ValueCircularBuffer.h"
+
+namespace nt::local {
+
+// Maps subscriber and entry handles to their poll storage, so readers can
+// find a queue without the storage mutex.
+//
+// Slots are indexed by handle index, in chunks that are allocated as handles
+// are created and not freed until the table is destroyed, so readers reach a
+// slot with one atomic load and no shared lock. Each slot has its own
+// spinlock, held while a reader uses the queue, so the slot's reference keeps
+// the queue alive without readers copying the shared_ptr.
+//
+// Set() and Clear() must be called with the storage mutex held; Read() may be
+// called from any thread.
+class PollStorageTable {
+ public:
+  PollStorageTable() = default;
+  PollStorageTable(const PollStorageTable&) = delete;
+  PollStorageTable& operator=(const PollStorageTable&) = delete;
+
+  ~PollStorageTable() {
+    for (auto& chunks : m_chunks) {
+      for (auto& chunk : chunks) {
+        delete chunk.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Sets (or, if storage is null, removes) the storage for a handle
+  void Set(NT_Handle handle, std::shared_ptr<ValueCircularBuffer> storage) {
+    auto slot = GetSlot(handle, storage != nullptr);
+    if (slot) {
+      std::scoped_lock lock{slot->mutex};
+      // destroy the old storage after unlocking
+      std::swap(slot->storage, storage);
+    }
+  }
+
+  // Removes the storage for all handles
+  void Clear() {
+    for (auto& chunks : m_chunks) {
+      for (auto& chunk : chunks) {
+        if (auto c = chunk.load(std::memory_order_relaxed)) {
+          for (auto& slot : c->slots) {
+            std::shared_ptr<ValueCircularBuffer> storage;
+            std::scoped_lock lock{slot.mutex};
+            std::swap(slot.storage, storage);
+          }
+        }
+      }
+    }
+  }
+
+  // Calls func with the storage for a handle. Returns false (without calling
+  // func) if the handle has no storage.
+  template <typename F>
+  bool Read(NT_Handle handle, F&& func) {
+    auto slot = GetSlot(handle, false);
+    if (!slot) {
+      return false;
+    }
+    std::scoped_lock lock{slot->mutex};
+    if (!slot->storage) {
+      return false;
+    }
+    func(*slot->storage);
+    return true;
+  }
+
+ private:
+  static constexpr unsigned int kChunkBits = 10;
+  static constexpr size_t kChunkSize = size_t{1} << kChunkBits;
+  static constexpr size_t kNumChunks = (Handle::kIndexMax >> kChunkBits) + 1;
+
+  struct Slot {
+    wpi::spinlock mutex;
+    std::shared_ptr<ValueCircularBuffer> storage;
+  };
+
+  struct Chunk {
+    std::array<Slot, kChunkSize> slots;
+  };
+
+  // Gets the slot for a handle, optionally creating its chunk (only with the
+  // storage mutex held)
+  Slot* GetSlot(NT_Handle handle, bool create) {
+    Handle h{handle};
+    size_t type;
+    if (h.IsType(Handle::kSubscriber)) {
+      type = 0;
+    } else if (h.IsType(Handle::kEntry)) {
+      type = 1;
+    } else {
+      return nullptr;
+    }
+    unsigned int index = h.GetIndex();
+    auto& chunk = m_chunks[type][index >> kChunkBits];
+    Chunk* c = chunk.load(std::memory_order_acquire);
+    if (!c) {
+      if (!create) {
+        return nullptr;
+      }
+      c = new Chunk;
+      chunk.store(c, std::memory_order_release);
+    }
+    return &c->slots[index & (kChunkSize - 1)];
+  }
+
+  // subscriber and entry chunks
+  std::array<std::array<std::atomic<Chunk*>, kNumChunks>, 2> m_chunks{};
+};
+
+}  // namespace nt::local
@@ -11,9 +11,11 @@
 #include <numeric>
 #include <span>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <wpi/DenseMap.h>
+#include <wpi/SmallVector.h>
 
 #include "Message.h"
 #include "WireConnection.h"
@@ -91,20 +93,44 @@ class NetworkOutgoingQueue {
 
     // map the handle to the queue
     auto [infoIt, created] = m_idMap.try_emplace(id);
-    if (!created && infoIt->getSecond().queueIndex != queueIndex) {
+    auto& info = infoIt->getSecond();
+    if (!created && info.queueIndex != queueIndex) {
       // need to move any items from old queue to new queue
-      auto& oldMsgs = m_queues[infoIt->getSecond().queueIndex].msgs;
-      auto it =
-          std::stable_partition(oldMsgs.begin(), oldMsgs.end(),
-                                [&](const auto& e) { return e.id != id; });
-      auto& newMsgs = m_queues[queueIndex].msgs;
-      for (auto i = it, end = oldMsgs.end(); i != end; ++i) {
-        newMsgs.emplace_back(std::move(*i));
+      unsigned int oldQueueIndex = info.queueIndex;
+      auto& oldQueue = m_queues[oldQueueIndex];
+      auto& newQueue = m_queues[queueIndex];
+      info.valuePos = -1;
+      bool moved = false;
+      for (auto&& msg : oldQueue.msgs) {
+        if (msg.id != id) {
+          continue;
+        }
+        bool isValue = std::holds_alternative<ValueMsg>(msg.msg.contents);
+        int64_t pos = newQueue.Append(id, std::move(msg.msg));
+        if (isValue) {
+          info.valuePos = pos;
+        }
+        moved = true;
+      }
+      if (moved) {
+        // remove the moved messages, and update the positions of the values
+        // that were after them
+        std::erase_if(oldQueue.msgs,
+                      [&](const auto& msg) { return msg.id == id; });
+        for (size_t i = 0; i < oldQueue.msgs.size(); ++i) {
+          auto& msg = oldQueue.msgs[i];
+          if (std::holds_alternative<ValueMsg>(msg.msg.contents)) {
+            auto it = m_idMap.find(msg.id);
+            if (it != m_idMap.end() &&
+                it->getSecond().queueIndex == oldQueueIndex) {
+              it->getSecond().valuePos = oldQueue.base + i;
+            }
+          }
+        }
       }
-      oldMsgs.erase(it, oldMsgs.end());
     }
 
-    infoIt->getSecond().queueIndex = queueIndex;
+    info.queueIndex = queueIndex;
   }
 
   void EraseId(int id) { m_idMap.erase(id); }
@@ -132,21 +158,19 @@ class NetworkOutgoingQueue {
       case ValueSendMode::kAll: {  // append to outgoing
         auto& info = m_idMap[id];
         auto& queue = m_queues[info.queueIndex];
-        info.valuePos = queue.msgs.size();
-        queue.Append(id, ValueMsg{id, value});
+        info.valuePos = queue.Append(id, ValueMsg{id, value});
         m_totalSize += sizeof(Message) + value.size();
         break;
       }
       case ValueSendMode::kNormal: {
-        // replace, or append if not present
+        // coalesce: replace the queued value in place (found directly via
+        // its position), or append if not present
         auto& info = m_idMap[id];
         auto& queue = m_queues[info.queueIndex];
-        if (info.valuePos != -1 &&
-            static_cast<unsigned int>(info.valuePos) < queue.msgs.size()) {
-          auto& elem = queue.msgs[info.valuePos];
-          if (auto m = std::get_if<ValueMsg>(&elem.msg.contents)) {
+        if (auto elem = queue.Get(info.valuePos)) {
+          if (auto m = std::get_if<ValueMsg>(&elem->msg.contents)) {
             // double-check handle, and only replace if timestamp newer
-            if (elem.id == id &&
+            if (elem->id == id &&
                 (m->value.time() == 0 || value.time() >= m->value.time())) {
               int delta = value.size() - m->value.size();
               m->value = value;
@@ -155,8 +179,7 @@ class NetworkOutgoingQueue {
             }
           }
         }
-        info.valuePos = queue.msgs.size();
-        queue.Append(id, ValueMsg{id, value});
+        info.valuePos = queue.Append(id, ValueMsg{id, value});
         m_totalSize += sizeof(Message) + value.size();
         break;
       }
@@ -196,22 +219,44 @@ class NetworkOutgoingQueue {
       return m_queues[a].nextSendMs < m_queues[b].nextSendMs;
     });
 
+    bool compress = m_wire.IsCompressionEnabled();
     for (unsigned int queueIndex : queues) {
       auto& queue = m_queues[queueIndex];
       auto& msgs = queue.msgs;
-      auto it = msgs.begin();
-      auto end = msgs.end();
+
+      // Consecutive values are encoded together in a single binary write
+      // (which ends up in a single WebSocket frame). Keep track of the
+      // first message index of each write so we know which messages to keep
+      // if some of the writes are not sent.
+      wpi::SmallVector<size_t, 16> writeStarts;
+      wpi::SmallVector<BinaryValue, 64> values;
+      size_t pos = 0;
       int unsent = 0;
-      for (; it != end && unsent == 0; ++it) {
-        if (auto m = std::get_if<ValueMsg>(&it->msg.contents)) {
+      while (pos < msgs.size() && unsent == 0) {
+        auto& msg = msgs[pos];
+        writeStarts.emplace_back(pos);
+        if (std::holds_alternative<ValueMsg>(msg.msg.contents)) {
+          values.clear();
+          size_t batchSize = 0;
+          for (; pos < msgs.size() && batchSize < kMaxBatchSize; ++pos) {
+            auto& vmsg = msgs[pos];
+            if (auto m = std::get_if<ValueMsg>(&vmsg.msg.contents)) {
+              values.emplace_back(
+                  BinaryValue{vmsg.id, GetSendTime(m->value), &m->value});
+              batchSize += m->value.size();
+            } else {
+              break;
+            }
+          }
           unsent = m_wire.WriteBinary(
-              [&](auto& os) { EncodeValue(os, it->id, m->value); });
+              [&](auto& os) { WireEncodeBinary(os, values, compress); });
         } else {
           unsent = m_wire.WriteText([&](auto& os) {
-            if (!WireEncodeText(os, it->msg)) {
+            if (!WireEncodeText(os, msg.msg)) {
               os << "{}";
             }
           });
+          ++pos;
         }
       }
       if (unsent < 0) {
@@ -224,25 +269,20 @@ class NetworkOutgoingQueue {
           return;  // error
         }
       }
-      int delta = it - msgs.begin() - unsent;
-      for (auto&& msg : std::span{msgs}.subspan(0, delta)) {
+      size_t numSent = pos;
+      if (unsent > 0) {
+        numSent = static_cast<size_t>(unsent) >= writeStarts.size()
+                      ? 0
+                      : writeStarts[writeStarts.size() - unsent];
+      }
+      for (auto&& msg : std::span{msgs}.subspan(0, numSent)) {
         if (auto m = std::get_if<ValueMsg>(&msg.msg.contents)) {
           m_totalSize -= sizeof(Message) + m->value.size();
         } else {
           m_totalSize -= sizeof(Message);
         }
       }
-      msgs.erase(msgs.begin(), it - unsent);
-      for (auto&& kv : m_idMap) {
-        auto& info = kv.getSecond();
-        if (info.queueIndex == queueIndex) {
-          if (info.valuePos < delta) {
-            info.valuePos = -1;
-          } else {
-            info.valuePos -= delta;
-          }
-        }
-      }
+      queue.Erase(numSent);
 
       // try to stay on periodic timing, unless it's falling behind current time
       if (unsent == 0) {
@@ -265,7 +305,7 @@ class NetworkOutgoingQueue {
  private:
   using ValueMsg = typename MessageType::ValueMsg;
 
-  void EncodeValue(wpi::raw_ostream& os, int id, const Value& value) {
+  int64_t GetSendTime(const Value& value) const {
     int64_t time = value.time();
     if constexpr (std::same_as<ValueMsg, ClientValueMsg>) {
       if (time != 0) {
@@ -276,7 +316,12 @@ class NetworkOutgoingQueue {
         }
       }
     }
-    WireEncodeBinary(os, id, time, value);
+    return time;
+  }
+
+  void EncodeValue(wpi::raw_ostream& os, int id, const Value& value) {
+    WireEncodeBinary(os, id, GetSendTime(value), value,
+                     m_wire.IsCompressionEnabled());
   }
 
   struct Message {
@@ -288,13 +333,28 @@ class NetworkOutgoingQueue {
     int id;
   };
 
+  // Messages are identified by their absolute position in the queue (the
+  // number of messages ever appended before them), which does not change
+  // when earlier messages are sent and erased.
   struct Queue {
     explicit Queue(uint32_t periodMs) : periodMs{periodMs} {}
     template <typename T>
-    void Append(NT_Handle handle, T&& msg) {
+    int64_t Append(NT_Handle handle, T&& msg) {
       msgs.emplace_back(std::forward<T>(msg), handle);
+      return base + msgs.size() - 1;
+    }
+    Message* Get(int64_t pos) {
+      if (pos < base || pos >= static_cast<int64_t>(base + msgs.size())) {
+        return nullptr;
+      }
+      return &msgs[pos - base];
+    }
+    void Erase(size_t count) {
+      msgs.erase(msgs.begin(), msgs.begin() + count);
+      base += count;
     }
     std::vector<Message> msgs;
+    int64_t base = 0;  // absolute position of msgs[0]
     uint64_t nextSendMs = 0;
     uint32_t periodMs;
   };
@@ -303,7 +363,7 @@ class NetworkOutgoingQueue {
 
   struct HandleInfo {
     unsigned int queueIndex = 0;
-    int valuePos = -1;  // -1 if not in queue
+    int64_t valuePos = -1;  // absolute position in queue, -1 if not in queue
   };
   wpi::DenseMap<int, HandleInfo> m_idMap;
   size_t m_totalSize{0};
@@ -315,6 +375,9 @@ class NetworkOutgoingQueue {
 
   // maximum total size of outgoing queues in bytes (approximate)
   static constexpr size_t kOutgoingLimit = 1024 * 1024;
+
+  // maximum size of values encoded in a single binary write (approximate)
+  static constexpr size_t kMaxBatchSize = 16384;
 };
 
 }  // namespace nt::net
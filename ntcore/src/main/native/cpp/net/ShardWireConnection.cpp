@@ -0,0 +1,148 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ShardWireConnection.h"
+
+#include <utility>
+
+#include <wpi/raw_ostream.h>
+#include <wpi/timestamp.h>
+#include <wpinet/WebSocket.h>
+
+using namespace nt;
+using namespace nt::net;
+
+// these match WebSocketConnection so clients see the same framing
+static constexpr size_t kMTU = 1500 - 40 - 20;
+static constexpr size_t kNewFrameThresholdBytes = kMTU - 10 - 50;
+static constexpr size_t kFlushThresholdFrames = 32;
+static constexpr size_t kFlushThresholdBytes = 16384;
+// don't hand the I/O loop more than this until the socket catches up
+static constexpr size_t kMaxPendingBytes = 4 * kFlushThresholdBytes;
+
+void ShardWireConnection::SendPing(uint64_t time) {
+  ShardCommand cmd;
+  cmd.kind = ShardCommand::kPing;
+  cmd.time = time;
+  Push(std::move(cmd));
+}
+
+bool ShardWireConnection::Ready() const {
+  return m_shared->pendingBytes.load(std::memory_order_relaxed) <
+         kMaxPendingBytes;
+}
+
+void ShardWireConnection::FinishFrame() {
+  if (m_state == kEmpty) {
+    return;
+  }
+  if (m_state == kText) {
+    m_data.push_back(']');
+  }
+  m_frames.emplace_back(ShardCommand::Frame{
+      m_state == kText ? wpi::WebSocket::Frame::kText
+                       : wpi::WebSocket::Frame::kBinary,
+      m_data.size()});
+  m_state = kEmpty;
+}
+
+int ShardWireConnection::Write(
+    State kind, wpi::function_ref<void(wpi::raw_ostream& os)> writer) {
+  bool first = false;
+  if (m_state != kind ||
+      (m_data.size() - m_frameStart) >= kNewFrameThresholdBytes) {
+    // start a new frame
+    FinishFrame();
+    m_state = kind;
+    m_frameStart = m_data.size();
+    first = true;
+  }
+  {
+    wpi::raw_uvector_ostream os{m_data};
+    if (kind == kText) {
+      os << (first ? '[' : ',');
+    }
+    writer(os);
+  }
+  if (m_frames.size() >= kFlushThresholdFrames ||
+      m_data.size() >= kFlushThresholdBytes) {
+    return Flush();
+  }
+  return 0;
+}
+
+int ShardWireConnection::Flush() {
+  m_lastFlushTime = wpi::Now();
+  FinishFrame();
+  if (m_frames.empty()) {
+    return 0;
+  }
+
+  // Always hand the batch to the I/O loop, even if it's over the pending
+  // limit. The writes have already been accepted, and some callers (e.g.
+  // announces) have no way to resend them. Callers check Ready() before
+  // writing, so this overshoots the limit by at most one batch.
+  ShardCommand cmd;
+  cmd.kind = ShardCommand::kFrames;
+  cmd.frames.swap(m_frames);
+  cmd.data.swap(m_data);
+  Push(std::move(cmd));
+  return 0;
+}
+
+void ShardWireConnection::Send(
+    State kind, wpi::function_ref<void(wpi::raw_ostream& os)> writer) {
+  ShardCommand cmd;
+  cmd.kind = ShardCommand::kFrames;
+  {
+    wpi::raw_uvector_ostream os{cmd.data};
+    if (kind == kText) {
+      os << '[';
+    }
+    writer(os);
+    if (kind == kText) {
+      os << ']';
+    }
+  }
+  cmd.frames.emplace_back(ShardCommand::Frame{
+      kind == kText ? wpi::WebSocket::Frame::kText
+                    : wpi::WebSocket::Frame::kBinary,
+      cmd.data.size()});
+  Push(std::move(cmd));
+}
+
+void ShardWireConnection::StopRead() {
+  if (m_readActive) {
+    ShardCommand cmd;
+    cmd.kind = ShardCommand::kStopRead;
+    Push(std::move(cmd));
+    m_readActive = false;
+  }
+}
+
+void ShardWireConnection::StartRead() {
+  if (!m_readActive) {
+    ShardCommand cmd;
+    cmd.kind = ShardCommand::kStartRead;
+    Push(std::move(cmd));
+    m_readActive = true;
+  }
+}
+
+void ShardWireConnection::Disconnect(std::string_view reason) {
+  ShardCommand cmd;
+  cmd.kind = ShardCommand::kDisconnect;
+  cmd.data.assign(reason.begin(), reason.end());
+  Push(std::move(cmd));
+}
+
+void ShardWireConnection::Push(ShardCommand&& cmd) {
+  cmd.connId = m_connId;
+  if (cmd.kind == ShardCommand::kFrames) {
+    m_shared->pendingBytes.fetch_add(cmd.data.size(),
+                                     std::memory_order_relaxed);
+  }
+  m_queue.enqueue(std::move(cmd));
+  m_wakeup();
+}
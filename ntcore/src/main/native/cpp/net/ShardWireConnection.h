@@ -0,0 +1,126 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <wpi/SpscQueue.h>
+#include <wpi/function_ref.h>
+
+#include "WireConnection.h"
+
+namespace nt::net {
+
+// State shared between a ShardWireConnection and the I/O loop that owns the
+// actual socket.
+struct ShardConnectionState {
+  // bytes handed to the I/O loop that have not yet been written to the socket
+  std::atomic<size_t> pendingBytes{0};
+  // last time data was received, updated by the I/O loop
+  std::atomic<uint64_t> lastReceivedTime{0};
+};
+
+// Command sent from the server loop to an I/O loop.
+struct ShardCommand {
+  enum Kind { kFrames, kPing, kStopRead, kStartRead, kDisconnect };
+
+  struct Frame {
+    uint8_t opcode;
+    size_t end;  // end offset into data
+  };
+
+  Kind kind = kFrames;
+  int connId = 0;
+  uint64_t time = 0;           // kPing
+  std::vector<Frame> frames;   // kFrames
+  std::vector<uint8_t> data;   // kFrames payload, kDisconnect reason
+};
+
+using ShardCommandQueue = wpi::SpscQueue<ShardCommand>;
+
+// WireConnection used on the server loop for a client whose WebSocket lives
+// on a separate I/O loop. Messages are encoded into WebSocket frame payloads
+// on the calling thread and handed to the I/O loop through a lock-free queue,
+// so a slow socket only affects the loop that owns it. Commands for a single
+// connection are delivered in order.
+class ShardWireConnection final : public WireConnection {
+ public:
+  ShardWireConnection(unsigned int version, bool compress, int connId,
+                      std::shared_ptr<ShardConnectionState> state,
+                      ShardCommandQueue& queue, std::function<void()> wakeup)
+      : m_shared{std::move(state)},
+        m_queue{queue},
+        m_wakeup{std::move(wakeup)},
+        m_connId{connId},
+        m_version{version},
+        m_compress{compress} {}
+
+  unsigned int GetVersion() const final { return m_version; }
+
+  bool IsCompressionEnabled() const final { return m_compress; }
+
+  void SendPing(uint64_t time) final;
+
+  bool Ready() const final;
+
+  int WriteText(wpi::function_ref<void(wpi::raw_ostream& os)> writer) final {
+    return Write(kText, writer);
+  }
+  int WriteBinary(wpi::function_ref<void(wpi::raw_ostream& os)> writer) final {
+    return Write(kBinary, writer);
+  }
+  int Flush() final;
+
+  void SendText(wpi::function_ref<void(wpi::raw_ostream& os)> writer) final {
+    Send(kText, writer);
+  }
+  void SendBinary(wpi::function_ref<void(wpi::raw_ostream& os)> writer) final {
+    Send(kBinary, writer);
+  }
+
+  uint64_t GetLastFlushTime() const final { return m_lastFlushTime; }
+
+  uint64_t GetLastReceivedTime() const final {
+    return m_shared->lastReceivedTime.load(std::memory_order_relaxed);
+  }
+
+  void StopRead() final;
+  void StartRead() final;
+
+  void Disconnect(std::string_view reason) final;
+
+ private:
+  enum State { kEmpty, kText, kBinary };
+
+  int Write(State kind, wpi::function_ref<void(wpi::raw_ostream& os)> writer);
+  void Send(State kind, wpi::function_ref<void(wpi::raw_ostream& os)> writer);
+  void FinishFrame();
+  void Push(ShardCommand&& cmd);
+
+  std::shared_ptr<ShardConnectionState> m_shared;
+  ShardCommandQueue& m_queue;
+  std::function<void()> m_wakeup;
+  int m_connId;
+
+  // pending batch
+  std::vector<ShardCommand::Frame> m_frames;
+  std::vector<uint8_t> m_data;
+  size_t m_frameStart = 0;
+  State m_state = kEmpty;
+
+  bool m_readActive = true;
+  uint64_t m_lastFlushTime = 0;
+  unsigned int m_version;
+  bool m_compress;
+};
+
+}  // namespace nt::net
@@ -0,0 +1,237 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "SharedMemoryConnection.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <wpi/raw_ostream.h>
+#include <wpi/timestamp.h>
+#include <wpinet/WebSocket.h>
+
+#include "WireDecoder.h"
+
+using namespace nt;
+using namespace nt::net;
+
+// there's no MTU, so frames are only limited by the flush thresholds
+static constexpr size_t kFlushThresholdFrames = 32;
+static constexpr size_t kFlushThresholdBytes = 65536;
+// not ready for more periodic data if the peer is this far behind
+static constexpr size_t kReadyFreeBytes = SharedMemorySegment::kRingSize / 2;
+// how often the wakeup thread checks for shutdown
+static constexpr int kWaitTimeoutMs = 100;
+
+// messages are limited to the WebSocket maximum, so any message fits in an
+// empty ring
+static_assert(SharedMemoryRing::GetRecordSize(kMaxMessageSize) <=
+              SharedMemorySegment::kRingSize);
+
+bool nt::net::IsLoopbackAddress(std::string_view ip) {
+  return ip.starts_with("127.") || ip == "::1" ||
+         ip.starts_with("::ffff:127.");
+}
+
+SharedMemoryConnection::SharedMemoryConnection(
+    WireConnection& control, std::shared_ptr<SharedMemorySegment> segment,
+    bool isServer, wpi::uv::Loop& loop)
+    : m_control{control},
+      m_segment{std::move(segment)},
+      m_outgoing{isServer ? m_segment->GetServerToClient()
+                          : m_segment->GetClientToServer()},
+      m_incoming{isServer ? m_segment->GetClientToServer()
+                          : m_segment->GetServerToClient()},
+      m_wakeup{wpi::uv::Async<>::Create(loop)} {
+  if (!m_wakeup) {
+    return;
+  }
+  m_wakeup->wakeup.connect([this] { ProcessIncoming(); });
+  m_thread = std::thread([this, wakeup = m_wakeup.get()] {
+    // start with a wakeup in case messages arrived before we started
+    uint32_t notified = m_incoming.GetSeq() - 1;
+    while (m_active.load(std::memory_order_relaxed)) {
+      uint32_t seq = m_incoming.GetSeq();
+      if (seq != notified) {
+        notified = seq;
+        wakeup->Send();
+      } else {
+        m_incoming.Wait(seq, kWaitTimeoutMs);
+      }
+    }
+  });
+}
+
+SharedMemoryConnection::~SharedMemoryConnection() {
+  m_active = false;
+  if (m_thread.joinable()) {
+    m_incoming.Wake();
+    m_thread.join();
+  }
+  if (m_wakeup) {
+    m_wakeup->Close();
+  }
+}
+
+bool SharedMemoryConnection::Ready() const {
+  return m_overflow.empty() && m_outgoing.GetFree() >= kReadyFreeBytes;
+}
+
+uint64_t SharedMemoryConnection::GetLastReceivedTime() const {
+  return (std::max)(m_lastReceivedTime, m_control.GetLastReceivedTime());
+}
+
+void SharedMemoryConnection::StartRead() {
+  if (!m_readActive) {
+    m_readActive = true;
+    ProcessIncoming();
+  }
+}
+
+void SharedMemoryConnection::FinishFrame() {
+  if (m_state == kEmpty) {
+    return;
+  }
+  if (m_state == kText) {
+    m_data.push_back(']');
+  }
+  m_frames.back().end = m_data.size();
+  m_state = kEmpty;
+}
+
+int SharedMemoryConnection::Write(
+    State kind, wpi::function_ref<void(wpi::raw_ostream& os)> writer) {
+  bool first = false;
+  if (m_state != kind) {
+    // start a new frame
+    FinishFrame();
+    m_state = kind;
+    m_frames.emplace_back(Frame{kind == kText ? wpi::WebSocket::Frame::kText
+                                              : wpi::WebSocket::Frame::kBinary,
+                                m_data.size(), 0});
+    first = true;
+  }
+  {
+    wpi::raw_uvector_ostream os{m_data};
+    if (kind == kText) {
+      os << (first ? '[' : ',');
+    }
+    writer(os);
+  }
+  ++m_frames.back().count;
+  if (m_frames.size() >= kFlushThresholdFrames ||
+      m_data.size() >= kFlushThresholdBytes) {
+    return Flush();
+  }
+  return 0;
+}
+
+int SharedMemoryConnection::Flush() {
+  m_lastFlushTime = wpi::Now();
+  FinishFrame();
+  // retry anything that didn't fit earlier
+  bool overflowSent = WriteOverflow();
+  if (m_frames.empty()) {
+    return 0;
+  }
+
+  // write as many whole frames as fit; the rest are reported as unsent
+  auto frame = m_frames.begin();
+  if (overflowSent) {
+    size_t start = 0;
+    for (; frame != m_frames.end(); ++frame) {
+      if (RejectTooLarge(frame->end - start)) {
+        m_outgoing.Commit();
+        m_frames.clear();
+        m_data.clear();
+        return UV_EMSGSIZE;
+      }
+      if (!m_outgoing.Write(frame->opcode, std::span{m_data}.subspan(
+                                               start, frame->end - start))) {
+        break;
+      }
+      start = frame->end;
+    }
+    m_outgoing.Commit();
+  }
+  int unsent = 0;
+  for (; frame != m_frames.end(); ++frame) {
+    unsent += frame->count;
+  }
+  m_frames.clear();
+  m_data.clear();
+  return unsent;
+}
+
+void SharedMemoryConnection::Send(
+    State kind, wpi::function_ref<void(wpi::raw_ostream& os)> writer) {
+  std::vector<uint8_t> data;
+  {
+    wpi::raw_uvector_ostream os{data};
+    if (kind == kText) {
+      os << '[';
+    }
+    writer(os);
+    if (kind == kText) {
+      os << ']';
+    }
+  }
+  if (RejectTooLarge(data.size())) {
+    return;
+  }
+  uint8_t opcode = kind == kText ? wpi::WebSocket::Frame::kText
+                                 : wpi::WebSocket::Frame::kBinary;
+  if (WriteOverflow() && m_outgoing.Write(opcode, data)) {
+    m_outgoing.Commit();
+  } else {
+    // keep it until the peer catches up
+    m_overflow.emplace_back(opcode, std::move(data));
+  }
+}
+
+bool SharedMemoryConnection::RejectTooLarge(size_t size) {
+  // The WebSocket peer would close the connection for a message this large,
+  // so do the same rather than queueing something that may never fit in the
+  // ring and would block everything behind it.
+  if (size <= kMaxMessageSize) {
+    return false;
+  }
+  m_control.Disconnect("message too large");
+  return true;
+}
+
+bool SharedMemoryConnection::WriteOverflow() {
+  if (m_overflow.empty()) {
+    return true;
+  }
+  auto it = m_overflow.begin();
+  for (; it != m_overflow.end(); ++it) {
+    if (!m_outgoing.Write(it->first, it->second)) {
+      break;
+    }
+  }
+  m_outgoing.Commit();
+  m_overflow.erase(m_overflow.begin(), it);
+  return m_overflow.empty();
+}
+
+void SharedMemoryConnection::ProcessIncoming() {
+  bool received = false;
+  while (m_readActive &&
+         m_incoming.Read([&](uint8_t opcode, std::span<const uint8_t> data) {
+           received = true;
+           if (opcode == wpi::WebSocket::Frame::kText) {
+             text(std::string_view{reinterpret_cast<const char*>(data.data()),
+                                   data.size()});
+           } else {
+             binary(data);
+           }
+         })) {
+  }
+  if (received) {
+    m_lastReceivedTime = wpi::Now();
+  }
+  // retry anything that didn't fit earlier
+  WriteOverflow();
+}
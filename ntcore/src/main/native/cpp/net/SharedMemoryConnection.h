@@ -0,0 +1,129 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <wpi/Signal.h>
+#include <wpi/function_ref.h>
+#include <wpinet/uv/Async.h>
+
+#include "SharedMemoryRing.h"
+#include "WireConnection.h"
+
+namespace nt::net {
+
+// HTTP header used by the client to pass the segment name to the server
+inline constexpr std::string_view kSharedMemoryHeader = "NT-Shared-Memory";
+
+// True if a peer at this address may be on the same machine
+bool IsLoopbackAddress(std::string_view ip);
+
+// WireConnection for a client and server on the same machine. Messages are
+// exchanged through a SharedMemorySegment instead of the WebSocket, avoiding
+// socket system calls and kernel copies. The WebSocket connection (control)
+// is kept open for connection lifetime, pings, and disconnect handling, and
+// must outlive this object.
+//
+// Incoming messages are delivered on the loop through the text and binary
+// signals, in the same format as WebSocket text and binary frames. A
+// background thread blocks on the incoming ring and wakes the loop when
+// messages arrive.
+//
+// Must be created and destroyed on the loop thread.
+class SharedMemoryConnection final : public WireConnection {
+ public:
+  SharedMemoryConnection(WireConnection& control,
+                         std::shared_ptr<SharedMemorySegment> segment,
+                         bool isServer, wpi::uv::Loop& loop);
+  ~SharedMemoryConnection() override;
+  SharedMemoryConnection(const SharedMemoryConnection&) = delete;
+  SharedMemoryConnection& operator=(const SharedMemoryConnection&) = delete;
+
+  unsigned int GetVersion() const final { return m_control.GetVersion(); }
+
+  void SendPing(uint64_t time) final { m_control.SendPing(time); }
+
+  bool Ready() const final;
+
+  int WriteText(wpi::function_ref<void(wpi::raw_ostream& os)> writer) final {
+    return Write(kText, writer);
+  }
+  int WriteBinary(wpi::function_ref<void(wpi::raw_ostream& os)> writer) final {
+    return Write(kBinary, writer);
+  }
+  int Flush() final;
+
+  void SendText(wpi::function_ref<void(wpi::raw_ostream& os)> writer) final {
+    Send(kText, writer);
+  }
+  void SendBinary(wpi::function_ref<void(wpi::raw_ostream& os)> writer) final {
+    Send(kBinary, writer);
+  }
+
+  uint64_t GetLastFlushTime() const final { return m_lastFlushTime; }
+
+  uint64_t GetLastReceivedTime() const final;
+
+  void StopRead() final { m_readActive = false; }
+  void StartRead() final;
+
+  void Disconnect(std::string_view reason) final {
+    m_control.Disconnect(reason);
+  }
+
+  // Incoming text frame
+  wpi::sig::Signal<std::string_view> text;
+
+  // Incoming binary frame
+  wpi::sig::Signal<std::span<const uint8_t>> binary;
+
+ private:
+  enum State { kEmpty, kText, kBinary };
+
+  int Write(State kind, wpi::function_ref<void(wpi::raw_ostream& os)> writer);
+  void Send(State kind, wpi::function_ref<void(wpi::raw_ostream& os)> writer);
+  void FinishFrame();
+  // disconnects and returns true if a message is too large to send
+  bool RejectTooLarge(size_t size);
+  bool WriteOverflow();
+  void ProcessIncoming();
+
+  WireConnection& m_control;
+  std::shared_ptr<SharedMemorySegment> m_segment;
+  SharedMemoryRing& m_outgoing;
+  SharedMemoryRing& m_incoming;
+
+  // pending batch
+  struct Frame {
+    uint8_t opcode;
+    size_t end;  // end offset into m_data
+    unsigned int count;
+  };
+  std::vector<Frame> m_frames;
+  std::vector<uint8_t> m_data;
+  State m_state = kEmpty;
+
+  // immediate sends that did not fit into the ring; sent before anything else
+  std::vector<std::pair<uint8_t, std::vector<uint8_t>>> m_overflow;
+
+  bool m_readActive = true;
+  uint64_t m_lastFlushTime = 0;
+  uint64_t m_lastReceivedTime = 0;
+
+  std::shared_ptr<wpi::uv::Async<>> m_wakeup;
+  std::atomic_bool m_active{true};
+  std::thread m_thread;
+};
+
+}  // namespace nt::net
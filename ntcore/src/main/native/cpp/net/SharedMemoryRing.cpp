@@ -0,0 +1,274 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "SharedMemoryRing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include <fmt/format.h>
+
+using namespace nt::net;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+static constexpr uint32_t kMagic = 0x4e54534d;  // "NTSM"
+static constexpr uint32_t kLayoutVersion = 1;
+
+struct SharedMemorySegment::Layout {
+  uint32_t magic;
+  uint32_t version;
+  std::atomic<uint32_t> attached;
+  std::atomic<uint32_t> closed;
+  SharedMemoryRingControl clientToServer;
+  SharedMemoryRingControl serverToClient;
+};
+
+// ring data starts on its own page after the layout
+static constexpr size_t kDataOffset = 4096;
+static constexpr size_t kSegmentSize =
+    kDataOffset + 2 * SharedMemorySegment::kRingSize;
+
+#ifdef __linux__
+static void FutexWait(std::atomic<uint32_t>* addr, uint32_t val,
+                      int timeoutMs) {
+  struct timespec ts;
+  ts.tv_sec = timeoutMs / 1000;
+  ts.tv_nsec = (timeoutMs % 1000) * 1000000;
+  // not FUTEX_PRIVATE_FLAG, as the word is shared between processes
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, val, &ts,
+          nullptr, 0);
+}
+
+static void FutexWake(std::atomic<uint32_t>* addr) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, INT32_MAX,
+          nullptr, nullptr, 0);
+}
+#endif
+
+bool SharedMemoryRing::Write(uint8_t opcode, std::span<const uint8_t> data) {
+  if (GetRecordSize(data.size()) > GetFree()) {
+    return false;
+  }
+  uint8_t header[kRecordHeaderSize] = {};
+  uint32_t size = data.size();
+  std::memcpy(header, &size, sizeof(size));
+  header[4] = opcode;
+  CopyIn(m_writePos, header, kRecordHeaderSize);
+  CopyIn(m_writePos + kRecordHeaderSize, data.data(), data.size());
+  m_writePos += GetRecordSize(data.size());
+  return true;
+}
+
+void SharedMemoryRing::Commit() {
+  if (m_writePos == m_control->head.load(std::memory_order_relaxed)) {
+    return;
+  }
+  m_control->head.store(m_writePos, std::memory_order_release);
+  m_control->seq.fetch_add(1, std::memory_order_seq_cst);
+  // only make the syscall if the consumer might be sleeping
+  if (m_control->waiting.load(std::memory_order_seq_cst) != 0) {
+#ifdef __linux__
+    FutexWake(&m_control->seq);
+#endif
+  }
+}
+
+bool SharedMemoryRing::Read(
+    wpi::function_ref<void(uint8_t opcode, std::span<const uint8_t> data)>
+        func) {
+  uint64_t tail = m_control->tail.load(std::memory_order_relaxed);
+  uint64_t head = m_control->head.load(std::memory_order_acquire);
+  if (head == tail) {
+    return false;
+  }
+  uint8_t header[kRecordHeaderSize];
+  CopyOut(tail, header, kRecordHeaderSize);
+  uint32_t size;
+  std::memcpy(&size, header, sizeof(size));
+  size_t recordSize = GetRecordSize(size);
+  if (recordSize > head - tail || head - tail > m_capacity) {
+    // corrupt; drop everything
+    m_control->tail.store(head, std::memory_order_release);
+    return false;
+  }
+
+  size_t start = (tail + kRecordHeaderSize) & (m_capacity - 1);
+  if (start + size <= m_capacity) {
+    // contiguous
+    func(header[4], {m_data + start, size});
+  } else {
+    m_readBuf.resize(size);
+    CopyOut(tail + kRecordHeaderSize, m_readBuf.data(), size);
+    func(header[4], m_readBuf);
+  }
+  m_control->tail.store(tail + recordSize, std::memory_order_release);
+  return true;
+}
+
+void SharedMemoryRing::Wait(uint32_t seq, int timeoutMs) {
+  m_control->waiting.store(1, std::memory_order_seq_cst);
+  if (m_control->seq.load(std::memory_order_seq_cst) == seq) {
+#ifdef __linux__
+    FutexWait(&m_control->seq, seq, timeoutMs);
+#endif
+  }
+  m_control->waiting.store(0, std::memory_order_relaxed);
+}
+
+void SharedMemoryRing::Wake() {
+  m_control->seq.fetch_add(1, std::memory_order_seq_cst);
+#ifdef __linux__
+  FutexWake(&m_control->seq);
+#endif
+}
+
+void SharedMemoryRing::CopyIn(uint64_t pos, const uint8_t* data, size_t len) {
+  size_t start = pos & (m_capacity - 1);
+  size_t first = (std::min)(len, m_capacity - start);
+  std::memcpy(m_data + start, data, first);
+  std::memcpy(m_data, data + first, len - first);
+}
+
+void SharedMemoryRing::CopyOut(uint64_t pos, uint8_t* data, size_t len) const {
+  size_t start = pos & (m_capacity - 1);
+  size_t first = (std::min)(len, m_capacity - start);
+  std::memcpy(data, m_data + start, first);
+  std::memcpy(data + first, m_data, len - first);
+}
+
+SharedMemorySegment::SharedMemorySegment(std::string_view name, void* mem,
+                                         bool owner)
+    : m_name{name},
+      m_layout{static_cast<Layout*>(mem)},
+      m_clientToServer{&m_layout->clientToServer,
+                       static_cast<uint8_t*>(mem) + kDataOffset, kRingSize},
+      m_serverToClient{&m_layout->serverToClient,
+                       static_cast<uint8_t*>(mem) + kDataOffset + kRingSize,
+                       kRingSize},
+      m_owner{owner} {
+  static_assert(sizeof(Layout) <= kDataOffset);
+}
+
+#ifdef __linux__
+std::unique_ptr<SharedMemorySegment> SharedMemorySegment::Create() {
+  static std::atomic<unsigned int> counter{0};
+  std::string name;
+  int fd = -1;
+  for (int i = 0; i < 10 && fd == -1; ++i) {
+    name = fmt::format("/nt-{}-{}", ::getpid(), counter++);
+    fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  }
+  if (fd == -1) {
+    return nullptr;
+  }
+  if (::ftruncate(fd, kSegmentSize) != 0) {
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    return nullptr;
+  }
+  void* mem =
+      ::mmap(nullptr, kSegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mem == MAP_FAILED) {
+    ::shm_unlink(name.c_str());
+    return nullptr;
+  }
+
+  // the new memory is zero-filled, which is a valid initial state for the
+  // atomics
+  auto layout = static_cast<Layout*>(mem);
+  layout->magic = kMagic;
+  layout->version = kLayoutVersion;
+  return std::unique_ptr<SharedMemorySegment>{
+      new SharedMemorySegment{name, mem, true}};
+}
+
+std::unique_ptr<SharedMemorySegment> SharedMemorySegment::Open(
+    std::string_view name) {
+  // only accept names we could have generated
+  if (!name.starts_with("/nt-") || name.size() > 64 ||
+      name.find('/', 1) != std::string_view::npos) {
+    return nullptr;
+  }
+  std::string nameStr{name};
+  int fd = ::shm_open(nameStr.c_str(), O_RDWR, 0);
+  if (fd == -1) {
+    return nullptr;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) != kSegmentSize) {
+    ::close(fd);
+    return nullptr;
+  }
+  void* mem =
+      ::mmap(nullptr, kSegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mem == MAP_FAILED) {
+    return nullptr;
+  }
+  auto layout = static_cast<Layout*>(mem);
+  if (layout->magic != kMagic || layout->version != kLayoutVersion ||
+      layout->attached.exchange(1) != 0) {
+    ::munmap(mem, kSegmentSize);
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemorySegment>{
+      new SharedMemorySegment{name, mem, false}};
+}
+
+SharedMemorySegment::~SharedMemorySegment() {
+  Close();
+  Unlink();
+  ::munmap(m_layout, kSegmentSize);
+}
+
+void SharedMemorySegment::Unlink() {
+  if (m_owner) {
+    ::shm_unlink(m_name.c_str());
+    m_owner = false;
+  }
+}
+#else
+std::unique_ptr<SharedMemorySegment> SharedMemorySegment::Create() {
+  return nullptr;
+}
+
+std::unique_ptr<SharedMemorySegment> SharedMemorySegment::Open(
+    std::string_view name) {
+  return nullptr;
+}
+
+SharedMemorySegment::~SharedMemorySegment() = default;
+
+void SharedMemorySegment::Unlink() {}
+#endif
+
+bool SharedMemorySegment::IsAttached() const {
+  return m_layout->attached.load(std::memory_order_acquire) != 0;
+}
+
+void SharedMemorySegment::Close() {
+  if (m_layout->closed.exchange(1) == 0) {
+    m_clientToServer.Wake();
+    m_serverToClient.Wake();
+  }
+}
+
+bool SharedMemorySegment::IsClosed() const {
+  return m_layout->closed.load(std::memory_order_acquire) != 0;
+}
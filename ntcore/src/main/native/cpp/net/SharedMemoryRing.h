@@ -0,0 +1,159 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <wpi/function_ref.h>
+
+namespace nt::net {
+
+// Control block of a SharedMemoryRing. Lives in shared memory, so it must be
+// standard layout and only contain lock-free atomics.
+struct SharedMemoryRingControl {
+  // total bytes committed by the producer
+  alignas(64) std::atomic<uint64_t> head{0};
+  // incremented on every commit; used as the futex word for wakeups
+  std::atomic<uint32_t> seq{0};
+  // nonzero while the consumer is (about to be) blocked in Wait()
+  std::atomic<uint32_t> waiting{0};
+  // total bytes released by the consumer
+  alignas(64) std::atomic<uint64_t> tail{0};
+};
+
+// Single-producer single-consumer ring of framed messages in memory that may
+// be shared between two processes. Each message is a 8-byte header (size and
+// WebSocket opcode) followed by the payload, padded to 8 bytes.
+//
+// The producer appends messages with Write() and makes them visible to the
+// consumer with Commit(); messages written but not yet committed can be
+// dropped with Discard(). The consumer reads committed messages with Read().
+// Wait() and Wake() provide cross-process blocking (futex based on Linux).
+class SharedMemoryRing {
+ public:
+  static constexpr size_t kRecordHeaderSize = 8;
+
+  // capacity must be a power of 2
+  SharedMemoryRing(SharedMemoryRingControl* control, uint8_t* data,
+                   size_t capacity)
+      : m_control{control}, m_data{data}, m_capacity{capacity} {}
+
+  static constexpr size_t GetRecordSize(size_t size) {
+    return kRecordHeaderSize + ((size + 7) & ~static_cast<size_t>(7));
+  }
+
+  // Producer: space available for more records (including uncommitted ones)
+  size_t GetFree() const {
+    return m_capacity -
+           (m_writePos - m_control->tail.load(std::memory_order_acquire));
+  }
+
+  // Producer: appends a message; returns false if there is not enough space
+  bool Write(uint8_t opcode, std::span<const uint8_t> data);
+
+  // Producer: makes written messages visible to the consumer
+  void Commit();
+
+  // Producer: drops written but uncommitted messages
+  void Discard() {
+    m_writePos = m_control->head.load(std::memory_order_relaxed);
+  }
+
+  // Consumer: true if there are no committed messages to read
+  bool IsEmpty() const {
+    return m_control->head.load(std::memory_order_acquire) ==
+           m_control->tail.load(std::memory_order_relaxed);
+  }
+
+  // Consumer: reads one message, calling func with the opcode and payload.
+  // Returns false if there are no committed messages.
+  bool Read(
+      wpi::function_ref<void(uint8_t opcode, std::span<const uint8_t> data)>
+          func);
+
+  uint32_t GetSeq() const {
+    return m_control->seq.load(std::memory_order_seq_cst);
+  }
+
+  // Blocks until the sequence number is no longer seq, Wake() is called, or
+  // the timeout expires. May return spuriously.
+  void Wait(uint32_t seq, int timeoutMs);
+
+  // Wakes up a thread blocked in Wait()
+  void Wake();
+
+ private:
+  void CopyIn(uint64_t pos, const uint8_t* data, size_t len);
+  void CopyOut(uint64_t pos, uint8_t* data, size_t len) const;
+
+  SharedMemoryRingControl* m_control;
+  uint8_t* m_data;
+  size_t m_capacity;
+
+  // producer: position of the next write (>= head)
+  uint64_t m_writePos = 0;
+  // consumer: used for messages that wrap around the end of the buffer
+  std::vector<uint8_t> m_readBuf;
+};
+
+// A shared memory segment containing one ring in each direction between an
+// NT client and server on the same machine. The client creates the segment
+// (with a unique name) and passes the name to the server during the
+// WebSocket handshake; the server opens it and marks it as attached before
+// accepting the handshake, so by the time the client sees the WebSocket open,
+// it knows whether the server will use the segment.
+//
+// Only supported on Linux; on other platforms Create() and Open() always
+// return nullptr.
+class SharedMemorySegment {
+ public:
+  static constexpr size_t kRingSize = 8 * 1024 * 1024;
+
+  // Creates a new segment with a unique name. Client only.
+  static std::unique_ptr<SharedMemorySegment> Create();
+
+  // Opens an existing segment and marks it as attached. Server only.
+  static std::unique_ptr<SharedMemorySegment> Open(std::string_view name);
+
+  ~SharedMemorySegment();
+  SharedMemorySegment(const SharedMemorySegment&) = delete;
+  SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+  std::string_view GetName() const { return m_name; }
+
+  // Removes the name; the memory stays mapped until both sides close it.
+  void Unlink();
+
+  // True if the server has opened the segment
+  bool IsAttached() const;
+
+  // Marks the segment as closed and wakes up any waiters
+  void Close();
+  bool IsClosed() const;
+
+  SharedMemoryRing& GetClientToServer() { return m_clientToServer; }
+  SharedMemoryRing& GetServerToClient() { return m_serverToClient; }
+
+ private:
+  struct Layout;
+
+  SharedMemorySegment(std::string_view name, void* mem, bool owner);
+
+  std::string m_name;
+  Layout* m_layout;
+  SharedMemoryRing m_clientToServer;
+  SharedMemoryRing m_serverToClient;
+  bool m_owner;
+};
+
+}  // namespace nt::net
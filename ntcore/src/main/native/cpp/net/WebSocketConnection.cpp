@@ -108,8 +108,8 @@ void WebSocketConnection::Stream::write_impl(const char* data, size_t len) {
 
 WebSocketConnection::WebSocketConnection(wpi::WebSocket& ws,
                                          unsigned int version,
-                                         wpi::Logger& logger)
-    : m_ws{ws}, m_logger{logger}, m_version{version} {}
+                                         wpi::Logger& logger, bool compress)
+    : m_ws{ws}, m_logger{logger}, m_version{version}, m_compress{compress} {}
 
 WebSocketConnection::~WebSocketConnection() {
   for (auto&& buf : m_bufs) {
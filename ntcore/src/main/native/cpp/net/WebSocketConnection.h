@@ -27,13 +27,15 @@ class WebSocketConnection final
       public std::enable_shared_from_this<WebSocketConnection> {
  public:
   WebSocketConnection(wpi::WebSocket& ws, unsigned int version,
-                      wpi::Logger& logger);
+                      wpi::Logger& logger, bool compress = false);
   ~WebSocketConnection() override;
   WebSocketConnection(const WebSocketConnection&) = delete;
   WebSocketConnection& operator=(const WebSocketConnection&) = delete;
 
   unsigned int GetVersion() const final { return m_version; }
 
+  bool IsCompressionEnabled() const final { return m_compress; }
+
   void SendPing(uint64_t time) final;
 
   bool Ready() const final { return !m_ws.IsWriteInProgress(); }
@@ -114,6 +116,7 @@ class WebSocketConnection final
   std::string m_reason;
   uint64_t m_lastFlushTime = 0;
   unsigned int m_version;
+  bool m_compress;
 };
 
 }  // namespace nt::net
@@ -22,6 +22,9 @@ class WireConnection {
 
   virtual unsigned int GetVersion() const = 0;
 
+  // True if the peer accepts compressed binary values
+  virtual bool IsCompressionEnabled() const { return false; }
+
   virtual void SendPing(uint64_t time) = 0;
 
   virtual bool Ready() const = 0;
@@ -14,10 +14,12 @@
 #include <wpi/Logger.h>
 #include <wpi/SpanExtras.h>
 #include <wpi/json.h>
+#include <wpi/lz4.h>
 #include <wpi/mpack.h>
 
 #include "Message.h"
 #include "MessageHandler.h"
+#include "WireEncoder.h"
 
 using namespace nt;
 using namespace nt::net;
@@ -474,6 +476,27 @@ void nt::net::WireDecodeText(std::string_view in, ServerMessageHandler& out,
   ::WireDecodeTextImpl(in, out, logger);
 }
 
+// Reads the [size, bin] payload of a compressed string or raw value.
+static bool ReadCompressed(mpack_reader_t* reader, std::vector<uint8_t>* out) {
+  mpack_expect_array_match(reader, 2);
+  uint32_t size = mpack_expect_u32_max(reader, kMaxMessageSize);
+  auto length = mpack_expect_bin(reader);
+  auto data = mpack_read_bytes_inplace(reader, length);
+  if (mpack_reader_error(reader) != mpack_ok) {
+    return false;
+  }
+  mpack_done_bin(reader);
+  mpack_done_array(reader);
+  out->resize(size);
+  auto rv = wpi::Lz4Decompress(
+      {reinterpret_cast<const uint8_t*>(data), length}, *out);
+  if (!rv || *rv != size) {
+    mpack_reader_flag_error(reader, mpack_error_invalid);
+    return false;
+  }
+  return true;
+}
+
 bool nt::net::WireDecodeBinary(std::span<const uint8_t>* in, int* outId,
                                Value* outValue, std::string* error,
                                int64_t localTimeOffset) {
@@ -580,6 +603,23 @@ bool nt::net::WireDecodeBinary(std::span<const uint8_t>* in, int* outId,
       mpack_done_array(&reader);
       break;
     }
+    case 4 | kCompressedTypeFlag: {  // compressed string
+      std::vector<uint8_t> buf;
+      if (!ReadCompressed(&reader, &buf)) {
+        break;
+      }
+      *outValue = Value::MakeString(
+          {reinterpret_cast<const char*>(buf.data()), buf.size()}, 1);
+      break;
+    }
+    case 5 | kCompressedTypeFlag: {  // compressed raw
+      std::vector<uint8_t> buf;
+      if (!ReadCompressed(&reader, &buf)) {
+        break;
+      }
+      *outValue = Value::MakeRaw(std::move(buf), 1);
+      break;
+    }
     case 20: {  // string array
       auto length = mpack_expect_array(&reader);
       std::vector<std::string> arr;
@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 
+#include <cstddef>
 #include <span>
 #include <string>
 #include <string_view>
@@ -23,6 +24,10 @@ namespace nt::net {
 class ClientMessageHandler;
 class ServerMessageHandler;
 
+// maximum size of a WebSocket message; also limits the decompressed size of a
+// compressed value, as that can't be larger than an uncompressed message
+inline constexpr size_t kMaxMessageSize = 2 * 1024 * 1024;
+
 // return true if client pub/sub metadata needs updating
 bool WireDecodeText(std::string_view in, ClientMessageHandler& out,
                     wpi::Logger& logger);
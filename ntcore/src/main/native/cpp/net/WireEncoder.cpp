@@ -5,9 +5,12 @@
 #include "WireEncoder.h"
 
 #include <optional>
+#include <span>
 #include <string>
 
+#include <wpi/SmallVector.h>
 #include <wpi/json.h>
+#include <wpi/lz4.h>
 #include <wpi/mpack.h>
 #include <wpi/raw_ostream.h>
 
@@ -212,103 +215,204 @@ bool nt::net::WireEncodeText(wpi::raw_ostream& os, const ServerMessage& msg) {
   return true;
 }
 
-bool nt::net::WireEncodeBinary(wpi::raw_ostream& os, int id, int64_t time,
-                               const Value& value) {
-  char buf[128];
-  mpack_writer_t writer;
-  mpack_writer_init(&writer, buf, sizeof(buf));
-  mpack_writer_set_context(&writer, &os);
-  mpack_writer_set_flush(
-      &writer, [](mpack_writer_t* writer, const char* buffer, size_t count) {
-        static_cast<wpi::raw_ostream*>(writer->context)->write(buffer, count);
-      });
-  mpack_start_array(&writer, 4);
-  mpack_write_int(&writer, id);
-  mpack_write_int(&writer, time);
+// Writes a compressed string or raw value, returns false if it doesn't
+// compress well enough to be worth it.
+static bool WriteCompressed(mpack_writer_t* writer, int id, int64_t time,
+                            int type, std::span<const uint8_t> data) {
+  wpi::SmallVector<uint8_t, 512> buf;
+  buf.resize_for_overwrite(wpi::Lz4CompressBound(data.size()));
+  size_t size = wpi::Lz4Compress(data, buf);
+  // the array wrapper and length add up to 6 more bytes than plain bin/str
+  if (size == 0 || size + 6 >= data.size()) {
+    return false;
+  }
+  mpack_start_array(writer, 4);
+  mpack_write_int(writer, id);
+  mpack_write_int(writer, time);
+  mpack_write_u8(writer, type | kCompressedTypeFlag);
+  mpack_start_array(writer, 2);
+  mpack_write_u32(writer, data.size());
+  mpack_write_bin(writer, reinterpret_cast<const char*>(buf.data()), size);
+  mpack_finish_array(writer);
+  mpack_finish_array(writer);
+  return true;
+}
+
+static bool WriteBinary(mpack_writer_t* writer, int id, int64_t time,
+                        const Value& value, bool compress) {
+  int type;
   switch (value.type()) {
     case NT_BOOLEAN:
-      mpack_write_u8(&writer, 0);
-      mpack_write_bool(&writer, value.GetBoolean());
+      type = 0;
+      break;
+    case NT_DOUBLE:
+      type = 1;
       break;
     case NT_INTEGER:
-      mpack_write_u8(&writer, 2);
-      mpack_write_int(&writer, value.GetInteger());
+      type = 2;
       break;
     case NT_FLOAT:
-      mpack_write_u8(&writer, 3);
-      mpack_write_float(&writer, value.GetFloat());
+      type = 3;
+      break;
+    case NT_STRING:
+      type = 4;
+      break;
+    case NT_RPC:
+    case NT_RAW:
+      type = 5;
+      break;
+    case NT_BOOLEAN_ARRAY:
+      type = 16;
+      break;
+    case NT_DOUBLE_ARRAY:
+      type = 17;
+      break;
+    case NT_INTEGER_ARRAY:
+      type = 18;
+      break;
+    case NT_FLOAT_ARRAY:
+      type = 19;
+      break;
+    case NT_STRING_ARRAY:
+      type = 20;
+      break;
+    default:
+      return false;
+  }
+
+  if (compress && value.size() >= kCompressMinSize) {
+    if (value.IsString()) {
+      auto v = value.GetString();
+      if (WriteCompressed(
+              writer, id, time, type,
+              {reinterpret_cast<const uint8_t*>(v.data()), v.size()})) {
+        return true;
+      }
+    } else if (value.IsRaw()) {
+      if (WriteCompressed(writer, id, time, type, value.GetRaw())) {
+        return true;
+      }
+    }
+  }
+
+  mpack_start_array(writer, 4);
+  mpack_write_int(writer, id);
+  mpack_write_int(writer, time);
+  mpack_write_u8(writer, type);
+  switch (value.type()) {
+    case NT_BOOLEAN:
+      mpack_write_bool(writer, value.GetBoolean());
+      break;
+    case NT_INTEGER:
+      mpack_write_int(writer, value.GetInteger());
+      break;
+    case NT_FLOAT:
+      mpack_write_float(writer, value.GetFloat());
       break;
     case NT_DOUBLE:
-      mpack_write_u8(&writer, 1);
-      mpack_write_double(&writer, value.GetDouble());
+      mpack_write_double(writer, value.GetDouble());
       break;
     case NT_STRING: {
       auto v = value.GetString();
-      mpack_write_u8(&writer, 4);
-      mpack_write_str(&writer, v.data(), v.size());
+      mpack_write_str(writer, v.data(), v.size());
       break;
     }
     case NT_RPC:
     case NT_RAW: {
       auto v = value.GetRaw();
-      mpack_write_u8(&writer, 5);
-      mpack_write_bin(&writer, reinterpret_cast<const char*>(v.data()),
+      mpack_write_bin(writer, reinterpret_cast<const char*>(v.data()),
                       v.size());
       break;
     }
     case NT_BOOLEAN_ARRAY: {
       auto v = value.GetBooleanArray();
-      mpack_write_u8(&writer, 16);
-      mpack_start_array(&writer, v.size());
+      mpack_start_array(writer, v.size());
       for (auto val : v) {
-        mpack_write_bool(&writer, val);
+        mpack_write_bool(writer, val);
       }
-      mpack_finish_array(&writer);
+      mpack_finish_array(writer);
       break;
     }
     case NT_INTEGER_ARRAY: {
       auto v = value.GetIntegerArray();
-      mpack_write_u8(&writer, 18);
-      mpack_start_array(&writer, v.size());
+      mpack_start_array(writer, v.size());
       for (auto val : v) {
-        mpack_write_int(&writer, val);
+        mpack_write_int(writer, val);
       }
-      mpack_finish_array(&writer);
+      mpack_finish_array(writer);
       break;
     }
     case NT_FLOAT_ARRAY: {
       auto v = value.GetFloatArray();
-      mpack_write_u8(&writer, 19);
-      mpack_start_array(&writer, v.size());
+      mpack_start_array(writer, v.size());
       for (auto val : v) {
-        mpack_write_float(&writer, val);
+        mpack_write_float(writer, val);
       }
-      mpack_finish_array(&writer);
+      mpack_finish_array(writer);
       break;
     }
     case NT_DOUBLE_ARRAY: {
       auto v = value.GetDoubleArray();
-      mpack_write_u8(&writer, 17);
-      mpack_start_array(&writer, v.size());
+      mpack_start_array(writer, v.size());
       for (auto val : v) {
-        mpack_write_double(&writer, val);
+        mpack_write_double(writer, val);
       }
-      mpack_finish_array(&writer);
+      mpack_finish_array(writer);
       break;
     }
     case NT_STRING_ARRAY: {
       auto v = value.GetStringArray();
-      mpack_write_u8(&writer, 20);
-      mpack_start_array(&writer, v.size());
+      mpack_start_array(writer, v.size());
       for (auto&& val : v) {
-        mpack_write_str(&writer, val.data(), val.size());
+        mpack_write_str(writer, val.data(), val.size());
       }
-      mpack_finish_array(&writer);
+      mpack_finish_array(writer);
       break;
     }
     default:
-      return false;
+      break;
+  }
+  mpack_finish_array(writer);
+  return true;
+}
+
+template <size_t Size>
+static void InitWriter(mpack_writer_t* writer, char (&buf)[Size],
+                       wpi::raw_ostream& os) {
+  mpack_writer_init(writer, buf, Size);
+  mpack_writer_set_context(writer, &os);
+  mpack_writer_set_flush(
+      writer, [](mpack_writer_t* writer, const char* buffer, size_t count) {
+        static_cast<wpi::raw_ostream*>(writer->context)->write(buffer, count);
+      });
+}
+
+bool nt::net::WireEncodeBinary(wpi::raw_ostream& os, int id, int64_t time,
+                               const Value& value, bool compress) {
+  char buf[128];
+  mpack_writer_t writer;
+  InitWriter(&writer, buf, os);
+  if (!WriteBinary(&writer, id, time, value, compress)) {
+    return false;
   }
-  mpack_finish_array(&writer);
   return mpack_writer_destroy(&writer) == mpack_ok;
 }
+
+size_t nt::net::WireEncodeBinary(wpi::raw_ostream& os,
+                                 std::span<const BinaryValue> values,
+                                 bool compress) {
+  // use a single writer (and a larger buffer) for the whole batch
+  char buf[1024];
+  mpack_writer_t writer;
+  InitWriter(&writer, buf, os);
+  size_t count = 0;
+  for (auto&& v : values) {
+    if (WriteBinary(&writer, v.id, v.time, *v.value, compress)) {
+      ++count;
+    }
+  }
+  if (mpack_writer_destroy(&writer) != mpack_ok) {
+    return 0;
+  }
+  return count;
+}
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <optional>
 #include <span>
 #include <string>
@@ -54,8 +57,28 @@ void WireEncodePropertiesUpdate(wpi::raw_ostream& os, std::string_view name,
 bool WireEncodeText(wpi::raw_ostream& os, const ClientMessage& msg);
 bool WireEncodeText(wpi::raw_ostream& os, const ServerMessage& msg);
 
+// Compressed binary values (only negotiated with peers that support it) use
+// the regular type code with this flag set, and instead of the value, a
+// 2-element array of the uncompressed size and a bin of the LZ4 block.
+inline constexpr int kCompressedTypeFlag = 0x80;
+
+// Only string and raw values at least this large are compressed
+inline constexpr size_t kCompressMinSize = 256;
+
 // encoder for binary messages
 bool WireEncodeBinary(wpi::raw_ostream& os, int id, int64_t time,
-                      const Value& value);
+                      const Value& value, bool compress = false);
+
+struct BinaryValue {
+  int id;
+  int64_t time;
+  const Value* value;
+};
+
+// Encode multiple binary messages back-to-back in a single MessagePack pass.
+// Returns number of messages written (values of invalid type are skipped)
+size_t WireEncodeBinary(wpi::raw_ostream& os,
+                        std::span<const BinaryValue> values,
+                        bool compress = false);
 
 }  // namespace nt::net
@@ -475,6 +475,14 @@ std::vector<Event> ReadListenerQueue(NT_ListenerPoller poller) {
   }
 }
 
+void ReadListenerQueue(NT_ListenerPoller poller, std::vector<Event>& events) {
+  if (auto ii = InstanceImpl::GetTyped(poller, Handle::kListenerPoller)) {
+    ii->listenerStorage.ReadListenerQueue(poller, events);
+  } else {
+    events.clear();
+  }
+}
+
 void RemoveListener(NT_Listener listener) {
   if (auto ii = InstanceImpl::GetTyped(listener, Handle::kListener)) {
     CleanupListeners(*ii, ii->listenerStorage.RemoveListener(listener));
@@ -634,9 +642,10 @@ void StopLocal(NT_Inst inst) {
 
 void StartServer(NT_Inst inst, std::string_view persist_filename,
                  std::string_view listen_address, unsigned int port3,
-                 unsigned int port4) {
+                 unsigned int port4, unsigned int num_shards) {
   if (auto ii = InstanceImpl::GetTyped(inst, Handle::kInstance)) {
-    ii->StartServer(persist_filename, listen_address, port3, port4);
+    ii->StartServer(persist_filename, listen_address, port3, port4,
+                    num_shards);
   }
 }
 
@@ -652,9 +661,10 @@ void StartClient3(NT_Inst inst, std::string_view identity) {
   }
 }
 
-void StartClient4(NT_Inst inst, std::string_view identity) {
+void StartClient4(NT_Inst inst, std::string_view identity,
+                  bool shared_memory) {
   if (auto ii = InstanceImpl::GetTyped(inst, Handle::kInstance)) {
-    ii->StartClient4(identity);
+    ii->StartClient4(identity, shared_memory);
   }
 }
 
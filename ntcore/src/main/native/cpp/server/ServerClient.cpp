@@ -4,6 +4,7 @@
 
 #include "ServerClient.h"
 
+#include <algorithm>
 #include <utility>
 
 #include <wpi/MessagePack.h>
@@ -49,11 +50,26 @@ std::span<ServerSubscriber*> ServerClient::GetSubscribers(
     std::string_view name, bool special,
     wpi::SmallVectorImpl<ServerSubscriber*>& buf) {
   buf.resize(0);
-  for (auto&& subPair : m_subscribers) {
-    ServerSubscriber* subscriber = subPair.getSecond().get();
-    if (subscriber->Matches(name, special)) {
+  // only subscribers with a topic name that is a prefix of (or equal to) name
+  // can match
+  m_subscriberIndex.ForEachPrefixOf(name, [&](ServerSubscriber* subscriber) {
+    // a subscriber may be indexed under more than one name
+    if (subscriber->Matches(name, special) &&
+        std::find(buf.begin(), buf.end(), subscriber) == buf.end()) {
       buf.emplace_back(subscriber);
     }
-  }
+  });
   return {buf.data(), buf.size()};
 }
+
+void ServerClient::IndexSubscriber(ServerSubscriber* sub) {
+  for (auto&& name : sub->GetTopicNames()) {
+    m_subscriberIndex.Insert(name, sub);
+  }
+}
+
+void ServerClient::UnindexSubscriber(ServerSubscriber* sub) {
+  for (auto&& name : sub->GetTopicNames()) {
+    m_subscriberIndex.Erase(name, sub);
+  }
+}
@@ -15,6 +15,7 @@
 
 #include <wpi/json_fwd.h>
 
+#include "PrefixTrie.h"
 #include "net/NetworkOutgoingQueue.h"
 #include "server/Functions.h"
 #include "server/ServerPublisher.h"
@@ -77,6 +78,10 @@ class ServerClient {
   virtual void UpdatePeriod(TopicClientData& tcd, ServerTopic* topic) {}
 
  protected:
+  // add/remove a subscriber's topic names to/from m_subscriberIndex
+  void IndexSubscriber(ServerSubscriber* sub);
+  void UnindexSubscriber(ServerSubscriber* sub);
+
   std::string m_name;
   std::string m_connInfo;
   bool m_local;  // local to machine
@@ -90,6 +95,8 @@ class ServerClient {
 
   wpi::DenseMap<int, std::unique_ptr<ServerPublisher>> m_publishers;
   wpi::DenseMap<int, std::unique_ptr<ServerSubscriber>> m_subscribers;
+  // subscribers indexed by topic name / prefix
+  PrefixTrie<ServerSubscriber*> m_subscriberIndex;
 
  public:
   // meta topics
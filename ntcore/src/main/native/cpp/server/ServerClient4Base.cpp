@@ -4,6 +4,7 @@
 
 #include "ServerClient4Base.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -92,8 +93,12 @@ void ServerClient4Base::ClientSubscribe(int subuid,
          subuid);
   auto& sub = m_subscribers[subuid];
   bool replace = false;
+  // only topics matched by the old or new subscription can be affected
+  std::vector<ServerTopic*> topics;
   if (sub) {
     // replace subscription
+    m_storage.GetMatchingTopics(*sub, topics);
+    UnindexSubscriber(sub.get());
     sub->Update(topicNames, options);
     replace = true;
   } else {
@@ -101,6 +106,19 @@ void ServerClient4Base::ClientSubscribe(int subuid,
     sub = std::make_unique<ServerSubscriber>(GetName(), topicNames, subuid,
                                              options);
   }
+  IndexSubscriber(sub.get());
+  std::vector<ServerTopic*> newTopics;
+  m_storage.GetMatchingTopics(*sub, newTopics);
+  if (topics.empty()) {
+    topics.swap(newTopics);
+  } else {
+    size_t oldSize = topics.size();
+    topics.insert(topics.end(), newTopics.begin(), newTopics.end());
+    auto idLess = [](auto a, auto b) { return a->id < b->id; };
+    std::inplace_merge(topics.begin(), topics.begin() + oldSize, topics.end(),
+                       idLess);
+    topics.erase(std::unique(topics.begin(), topics.end()), topics.end());
+  }
 
   // update periodic sender (if not local)
   if (!m_local) {
@@ -113,8 +131,8 @@ void ServerClient4Base::ClientSubscribe(int subuid,
   // send announcements in first loop and remember what we want to send in
   // second loop.
   std::vector<ServerTopic*> dataToSend;
-  dataToSend.reserve(m_storage.GetNumTopics());
-  m_storage.ForEachTopic([&](ServerTopic* topic) {
+  dataToSend.reserve(topics.size());
+  for (auto topic : topics) {
     auto tcdIt = topic->clients.find(this);
     bool removed = tcdIt != topic->clients.end() && replace &&
                    tcdIt->second.subscribers.erase(sub.get());
@@ -151,7 +169,7 @@ void ServerClient4Base::ClientSubscribe(int subuid,
         topic->lastValue) {
       dataToSend.emplace_back(topic);
     }
-  });
+  }
 
   for (auto topic : dataToSend) {
     DEBUG4("send last value for {} to client {}", topic->name, m_id);
@@ -168,7 +186,9 @@ void ServerClient4Base::ClientUnsubscribe(int subuid) {
   auto sub = subIt->getSecond().get();
 
   // remove from topics
-  m_storage.ForEachTopic([&](ServerTopic* topic) {
+  std::vector<ServerTopic*> topics;
+  m_storage.GetMatchingTopics(*sub, topics);
+  for (auto topic : topics) {
     auto tcdIt = topic->clients.find(this);
     if (tcdIt != topic->clients.end()) {
       if (tcdIt->second.subscribers.erase(sub)) {
@@ -176,9 +196,10 @@ void ServerClient4Base::ClientUnsubscribe(int subuid) {
         m_storage.UpdateMetaTopicSub(topic);
       }
     }
-  });
+  }
 
   // delete it from client (future value sets will be ignored)
+  UnindexSubscriber(sub);
   m_subscribers.erase(subIt);
 
   // loop over all subscribers to update period
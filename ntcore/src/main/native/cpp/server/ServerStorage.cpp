@@ -4,6 +4,7 @@
 
 #include "ServerStorage.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -17,6 +18,7 @@
 #include "Log.h"
 #include "server/MessagePackWriter.h"
 #include "server/ServerClient.h"
+#include "server/ServerSubscriber.h"
 
 using namespace nt;
 using namespace nt::server;
@@ -42,6 +44,7 @@ ServerTopic* ServerStorage::CreateTopic(ServerClient* client,
     topic = m_topics[id].get();
     topic->id = id;
     topic->special = special;
+    m_topicIndex.Insert(name, topic);
 
     m_sendAnnounce(topic, client);
 
@@ -83,10 +86,31 @@ void ServerStorage::DeleteTopic(ServerTopic* topic) {
   }
 
   // erase the topic
+  m_topicIndex.Erase(topic->name, topic);
   m_nameTopics.erase(topic->name);
   m_topics.erase(topic->id);
 }
 
+void ServerStorage::GetMatchingTopics(const ServerSubscriber& sub,
+                                      std::vector<ServerTopic*>& topics) const {
+  topics.clear();
+  for (auto&& name : sub.GetTopicNames()) {
+    if (sub.GetOptions().prefixMatch) {
+      m_topicIndex.ForEachWithPrefix(name, [&](ServerTopic* topic) {
+        if (sub.Matches(topic->name, topic->special)) {
+          topics.emplace_back(topic);
+        }
+      });
+    } else if (auto topic = GetTopic(name)) {
+      topics.emplace_back(topic);
+    }
+  }
+  // a topic may match more than one name
+  std::sort(topics.begin(), topics.end(),
+            [](auto a, auto b) { return a->id < b->id; });
+  topics.erase(std::unique(topics.begin(), topics.end()), topics.end());
+}
+
 void ServerStorage::SetProperties(ServerClient* client, ServerTopic* topic,
                                   const wpi::json& update) {
   DEBUG4("SetProperties({}, {}, {})", client ? client->GetId() : -1,
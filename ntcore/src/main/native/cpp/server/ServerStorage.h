@@ -8,11 +8,13 @@
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <wpi/StringMap.h>
 #include <wpi/UidVector.h>
 #include <wpi/json_fwd.h>
 
+#include "PrefixTrie.h"
 #include "server/ServerTopic.h"
 
 namespace wpi {
@@ -23,6 +25,7 @@ class raw_ostream;
 namespace nt::server {
 
 class ServerClient;
+class ServerSubscriber;
 
 class ServerStorage final {
  public:
@@ -68,6 +71,10 @@ class ServerStorage final {
     }
   }
 
+  // Gets the topics matching a subscriber, in id order
+  void GetMatchingTopics(const ServerSubscriber& sub,
+                         std::vector<ServerTopic*>& topics) const;
+
   // update meta topic values from data structures
   void UpdateMetaTopicPub(ServerTopic* topic);
   void UpdateMetaTopicSub(ServerTopic* topic);
@@ -89,6 +96,7 @@ class ServerStorage final {
 
   wpi::UidVector<std::unique_ptr<ServerTopic>, 16> m_topics;
   wpi::StringMap<ServerTopic*> m_nameTopics;
+  PrefixTrie<ServerTopic*> m_topicIndex;
   bool m_persistentChanged{false};
 };
 
@@ -41,7 +41,7 @@ static void WriteOptions(mpack_writer_t& w, const PubSubOptionsImpl& options) {
   mpack_finish_map(&w);
 }
 
-bool ServerSubscriber::Matches(std::string_view name, bool special) {
+bool ServerSubscriber::Matches(std::string_view name, bool special) const {
   for (auto&& topicName : m_topicNames) {
     if ((!m_options.prefixMatch && name == topicName) ||
         (m_options.prefixMatch && (!special || !topicName.empty()) &&
@@ -613,12 +613,21 @@ class NetworkTableInstance final {
    *                          address (UTF-8 string, null terminated)
    * @param port3             port to communicate over (NT3)
    * @param port4             port to communicate over (NT4)
+   * @param num_shards        number of additional event loops to spread NT4
+   *                          client socket I/O across, or 0 to handle all
+   *                          clients on the server loop. The loops share the
+   *                          NT4 port using SO_REUSEPORT, so starting another
+   *                          server on the same port won't fail while they
+   *                          are running. Ignored where SO_REUSEPORT isn't
+   *                          supported.
    */
   void StartServer(std::string_view persist_filename = "networktables.json",
                    const char* listen_address = "",
                    unsigned int port3 = kDefaultPort3,
-                   unsigned int port4 = kDefaultPort4) {
-    ::nt::StartServer(m_handle, persist_filename, listen_address, port3, port4);
+                   unsigned int port4 = kDefaultPort4,
+                   unsigned int num_shards = 0) {
+    ::nt::StartServer(m_handle, persist_filename, listen_address, port3, port4,
+                      num_shards);
   }
 
   /**
@@ -640,10 +649,15 @@ class NetworkTableInstance final {
    * Starts a NT4 client.  Use SetServer or SetServerTeam to set the server name
    * and port.
    *
-   * @param identity  network identity to advertise (cannot be empty string)
+   * @param identity      network identity to advertise (cannot be empty
+   *                      string)
+   * @param shared_memory if true, offer a shared memory segment to a server
+   *                      on the same machine to exchange messages through
+   *                      instead of the socket. This creates a segment of
+   *                      about 16 MB per connection.
    */
-  void StartClient4(std::string_view identity) {
-    ::nt::StartClient4(m_handle, identity);
+  void StartClient4(std::string_view identity, bool shared_memory = false) {
+    ::nt::StartClient4(m_handle, identity, shared_memory);
   }
 
   /**
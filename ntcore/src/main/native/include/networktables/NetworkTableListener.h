@@ -395,6 +395,17 @@ class NetworkTableListenerPoller final {
    */
   std::vector<Event> ReadQueue() { return ::nt::ReadListenerQueue(m_handle); }
 
+  /**
+   * Read events into a caller-provided buffer. Unlike the other overload, the
+   * buffer's storage is reused, so repeated reads don't need to allocate.
+   *
+   * @param events Buffer for events since the previous call to ReadQueue();
+   *               its previous contents are replaced
+   */
+  void ReadQueue(std::vector<Event>& events) {
+    ::nt::ReadListenerQueue(m_handle, events);
+  }
+
  private:
   NT_ListenerPoller m_handle{0};
 };
@@ -927,6 +927,18 @@ void DestroyListenerPoller(NT_ListenerPoller poller);
  */
 std::vector<Event> ReadListenerQueue(NT_ListenerPoller poller);
 
+/**
+ * Read notifications into a caller-provided buffer. Unlike the other
+ * overload, the buffer's storage is reused, so repeated reads don't need to
+ * allocate.
+ *
+ * @param poller    poller handle
+ * @param events    buffer for events; its previous contents are replaced, and
+ *                  it is left empty if there have been no events since the
+ *                  last call.
+ */
+void ReadListenerQueue(NT_ListenerPoller poller, std::vector<Event>& events);
+
 /**
  * Removes a listener.
  *
@@ -1059,10 +1071,17 @@ void StopLocal(NT_Inst inst);
  *                          address. (UTF-8 string)
  * @param port3             port to communicate over (NT3)
  * @param port4             port to communicate over (NT4)
+ * @param num_shards        number of additional event loops to spread NT4
+ *                          client socket I/O across, or 0 to handle all
+ *                          clients on the server loop. The loops share the
+ *                          NT4 port using SO_REUSEPORT, so starting another
+ *                          server on the same port won't fail while they are
+ *                          running. Ignored where SO_REUSEPORT isn't
+ *                          supported.
  */
 void StartServer(NT_Inst inst, std::string_view persist_filename,
                  std::string_view listen_address, unsigned int port3,
-                 unsigned int port4);
+                 unsigned int port4, unsigned int num_shards = 0);
 
 /**
  * Stops the server if it is running.
@@ -1084,10 +1103,15 @@ void StartClient3(NT_Inst inst, std::string_view identity);
  * Starts a NT4 client.  Use SetServer or SetServerTeam to set the server name
  * and port.
  *
- * @param inst      instance handle
- * @param identity  network identity to advertise (cannot be empty string)
+ * @param inst          instance handle
+ * @param identity      network identity to advertise (cannot be empty string)
+ * @param shared_memory if true, offer a shared memory segment to a server on
+ *                      the same machine to exchange messages through instead
+ *                      of the socket. This creates a segment of about 16 MB
+ *                      per connection.
  */
-void StartClient4(NT_Inst inst, std::string_view identity);
+void StartClient4(NT_Inst inst, std::string_view identity,
+                  bool shared_memory = false);
 
 /**
  * Stops the client if it is running.
@@ -0,0 +1,86 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <stdint.h>
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "EventQueue.h"
+
+namespace nt {
+
+static Event MakeEvent(int i) {
+  return {0, NT_EVENT_TIMESYNC, i, 0, true};
+}
+
+static int64_t GetIndex(const Event& event) {
+  return event.GetTimeSyncEventData()->serverTimeOffset;
+}
+
+TEST(EventQueueTest, Empty) {
+  EventQueue queue;
+  std::vector<Event> events{MakeEvent(1)};
+  queue.Drain(events);
+  EXPECT_TRUE(events.empty());
+}
+
+TEST(EventQueueTest, Order) {
+  EventQueue queue;
+  std::vector<Event> events;
+  for (int i = 0; i < 10; ++i) {
+    queue.Push(MakeEvent(i));
+  }
+  queue.Drain(events);
+  ASSERT_EQ(events.size(), 10u);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(GetIndex(events[i]), i);
+  }
+  queue.Drain(events);
+  EXPECT_TRUE(events.empty());
+}
+
+TEST(EventQueueTest, Overflow) {
+  // more events than fit in the ring are kept, in order
+  static constexpr int kCount = EventQueue::kRingSize * 2 + 10;
+  EventQueue queue;
+  std::vector<Event> events;
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < kCount; ++i) {
+      queue.Push(MakeEvent(i));
+    }
+    queue.Drain(events);
+    ASSERT_EQ(events.size(), static_cast<size_t>(kCount));
+    for (int i = 0; i < kCount; ++i) {
+      ASSERT_EQ(GetIndex(events[i]), i);
+    }
+  }
+}
+
+TEST(EventQueueTest, Concurrent) {
+  static constexpr int kCount = 100000;
+  EventQueue queue;
+  std::thread producer{[&] {
+    for (int i = 0; i < kCount; ++i) {
+      queue.Push(MakeEvent(i));
+    }
+  }};
+
+  std::vector<Event> events;
+  int64_t expected = 0;
+  while (expected != kCount) {
+    queue.Drain(events);
+    for (auto&& event : events) {
+      ASSERT_EQ(GetIndex(event), expected);
+      ++expected;
+    }
+  }
+  producer.join();
+  queue.Drain(events);
+  EXPECT_TRUE(events.empty());
+}
+
+}  // namespace nt
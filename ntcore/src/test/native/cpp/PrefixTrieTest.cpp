@@ -0,0 +1,116 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "PrefixTrie.h"
+
+namespace nt {
+
+static std::vector<int> WithPrefix(const PrefixTrie<int>& trie,
+                                   std::string_view prefix) {
+  std::vector<int> rv;
+  trie.ForEachWithPrefix(prefix, [&](int v) { rv.emplace_back(v); });
+  return rv;
+}
+
+static std::vector<int> PrefixOf(const PrefixTrie<int>& trie,
+                                 std::string_view str,
+                                 bool includeEmpty = true) {
+  std::vector<int> rv;
+  trie.ForEachPrefixOf(str, [&](int v) { rv.emplace_back(v); }, includeEmpty);
+  return rv;
+}
+
+TEST(PrefixTrieTest, Empty) {
+  PrefixTrie<int> trie;
+  EXPECT_TRUE(WithPrefix(trie, "").empty());
+  EXPECT_TRUE(WithPrefix(trie, "/foo").empty());
+  EXPECT_TRUE(PrefixOf(trie, "/foo").empty());
+  EXPECT_FALSE(trie.Erase("/foo", 1));
+}
+
+TEST(PrefixTrieTest, WithPrefix) {
+  PrefixTrie<int> trie;
+  trie.Insert("/foo/bar", 1);
+  trie.Insert("/foo", 2);
+  trie.Insert("/foo/baz", 3);
+  trie.Insert("/bar", 4);
+  trie.Insert("/foobar", 5);
+
+  EXPECT_EQ(WithPrefix(trie, ""), (std::vector<int>{4, 2, 1, 3, 5}));
+  EXPECT_EQ(WithPrefix(trie, "/foo"), (std::vector<int>{2, 1, 3, 5}));
+  EXPECT_EQ(WithPrefix(trie, "/foo/"), (std::vector<int>{1, 3}));
+  EXPECT_EQ(WithPrefix(trie, "/foo/ba"), (std::vector<int>{1, 3}));
+  EXPECT_EQ(WithPrefix(trie, "/foo/bar"), (std::vector<int>{1}));
+  EXPECT_EQ(WithPrefix(trie, "/fo"), (std::vector<int>{2, 1, 3, 5}));
+  EXPECT_TRUE(WithPrefix(trie, "/foo/bar/").empty());
+  EXPECT_TRUE(WithPrefix(trie, "/fox").empty());
+  EXPECT_TRUE(WithPrefix(trie, "x").empty());
+}
+
+TEST(PrefixTrieTest, PrefixOf) {
+  PrefixTrie<int> trie;
+  trie.Insert("", 0);
+  trie.Insert("/foo/", 1);
+  trie.Insert("/", 2);
+  trie.Insert("/foo/bar", 3);
+  trie.Insert("/foo/barx", 4);
+
+  EXPECT_EQ(PrefixOf(trie, "/foo/bar"), (std::vector<int>{0, 2, 1, 3}));
+  EXPECT_EQ(PrefixOf(trie, "/foo/bar", false), (std::vector<int>{2, 1, 3}));
+  EXPECT_EQ(PrefixOf(trie, "/foo/ba"), (std::vector<int>{0, 2, 1}));
+  EXPECT_EQ(PrefixOf(trie, "/fo"), (std::vector<int>{0, 2}));
+  EXPECT_EQ(PrefixOf(trie, "x"), (std::vector<int>{0}));
+  EXPECT_EQ(PrefixOf(trie, ""), (std::vector<int>{0}));
+}
+
+TEST(PrefixTrieTest, DuplicateKey) {
+  PrefixTrie<int> trie;
+  trie.Insert("/foo", 1);
+  trie.Insert("/foo", 2);
+  trie.Insert("/foo", 1);
+  EXPECT_EQ(WithPrefix(trie, "/foo"), (std::vector<int>{1, 2, 1}));
+  EXPECT_TRUE(trie.Erase("/foo", 1));
+  EXPECT_EQ(WithPrefix(trie, "/foo"), (std::vector<int>{2, 1}));
+  EXPECT_FALSE(trie.Erase("/foo", 3));
+}
+
+TEST(PrefixTrieTest, Erase) {
+  PrefixTrie<int> trie;
+  trie.Insert("/foo/bar", 1);
+  trie.Insert("/foo/baz", 2);
+  trie.Insert("/foo", 3);
+
+  EXPECT_FALSE(trie.Erase("/foo/ba", 1));
+  EXPECT_FALSE(trie.Erase("/foo/bar", 2));
+
+  // erasing the split node merges its remaining child back
+  EXPECT_TRUE(trie.Erase("/foo/bar", 1));
+  EXPECT_EQ(WithPrefix(trie, "/foo/ba"), (std::vector<int>{2}));
+  EXPECT_TRUE(trie.Erase("/foo", 3));
+  EXPECT_EQ(WithPrefix(trie, ""), (std::vector<int>{2}));
+  EXPECT_EQ(PrefixOf(trie, "/foo/baz/x"), (std::vector<int>{2}));
+
+  // re-inserting after merge
+  trie.Insert("/foo/bar", 4);
+  EXPECT_EQ(WithPrefix(trie, "/foo/"), (std::vector<int>{4, 2}));
+  EXPECT_TRUE(trie.Erase("/foo/baz", 2));
+  EXPECT_TRUE(trie.Erase("/foo/bar", 4));
+  EXPECT_TRUE(WithPrefix(trie, "").empty());
+}
+
+TEST(PrefixTrieTest, Clear) {
+  PrefixTrie<int> trie;
+  trie.Insert("", 1);
+  trie.Insert("/foo", 2);
+  trie.clear();
+  EXPECT_TRUE(WithPrefix(trie, "").empty());
+  EXPECT_TRUE(PrefixOf(trie, "/foo").empty());
+}
+
+}  // namespace nt
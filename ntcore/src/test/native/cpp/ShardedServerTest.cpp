@@ -0,0 +1,100 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <functional>
+#include <string_view>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "networktables/DoubleTopic.h"
+#include "networktables/NetworkTableInstance.h"
+
+class ShardedServerTest : public ::testing::Test {
+ public:
+  ShardedServerTest()
+      : m_serverInst{nt::NetworkTableInstance::Create()},
+        m_clientInst{nt::NetworkTableInstance::Create()},
+        m_clientInst2{nt::NetworkTableInstance::Create()} {}
+
+  ~ShardedServerTest() override {
+    nt::NetworkTableInstance::Destroy(m_serverInst);
+    nt::NetworkTableInstance::Destroy(m_clientInst);
+    nt::NetworkTableInstance::Destroy(m_clientInst2);
+  }
+
+  void Connect(nt::NetworkTableInstance client, std::string_view name,
+               unsigned int port);
+
+ protected:
+  nt::NetworkTableInstance m_serverInst;
+  nt::NetworkTableInstance m_clientInst;
+  nt::NetworkTableInstance m_clientInst2;
+};
+
+// waits up to 3 seconds for the condition to become true
+static bool WaitFor(std::function<bool()> cond) {
+  for (int count = 0; count < 300; ++count) {
+    if (cond()) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return cond();
+}
+
+void ShardedServerTest::Connect(nt::NetworkTableInstance client,
+                                std::string_view name, unsigned int port) {
+  client.StartClient4(name);
+  client.SetServer("127.0.0.1", port);
+  ASSERT_TRUE(WaitFor([&] { return client.IsConnected(); }))
+      << "client didn't connect to server";
+}
+
+TEST_F(ShardedServerTest, PubSubRoundTrip) {
+  m_serverInst.StartServer("shardedservertest.json", "127.0.0.1", 0, 10040, 2);
+  Connect(m_clientInst, "client1", 10040);
+  ASSERT_TRUE(
+      WaitFor([&] { return m_serverInst.GetConnections().size() == 1; }));
+
+  // client to server
+  auto serverSub = m_serverInst.GetDoubleTopic("/client").Subscribe(0);
+  auto clientPub = m_clientInst.GetDoubleTopic("/client").Publish();
+  clientPub.Set(1.5);
+  m_clientInst.Flush();
+  EXPECT_TRUE(WaitFor([&] { return serverSub.Get() == 1.5; }));
+
+  // server to client
+  auto clientSub = m_clientInst.GetDoubleTopic("/server").Subscribe(0);
+  auto serverPub = m_serverInst.GetDoubleTopic("/server").Publish();
+  serverPub.Set(2.5);
+  m_serverInst.Flush();
+  EXPECT_TRUE(WaitFor([&] { return clientSub.Get() == 2.5; }));
+
+  // disconnecting removes the client and its publisher from the server
+  m_clientInst.StopClient();
+  EXPECT_TRUE(WaitFor([&] { return m_serverInst.GetConnections().empty(); }));
+  EXPECT_TRUE(WaitFor([&] { return !serverSub.GetTopic().Exists(); }));
+}
+
+TEST_F(ShardedServerTest, MultipleClients) {
+  m_serverInst.StartServer("shardedservertest.json", "127.0.0.1", 0, 10041, 2);
+  Connect(m_clientInst, "client1", 10041);
+  Connect(m_clientInst2, "client2", 10041);
+  ASSERT_TRUE(
+      WaitFor([&] { return m_serverInst.GetConnections().size() == 2; }));
+
+  // values from one client reach the other, whichever loop each is on
+  auto sub = m_clientInst2.GetDoubleTopic("/value").Subscribe(0);
+  auto pub = m_clientInst.GetDoubleTopic("/value").Publish();
+  pub.Set(3.5);
+  m_clientInst.Flush();
+  EXPECT_TRUE(WaitFor([&] { return sub.Get() == 3.5; }));
+
+  m_clientInst2.StopClient();
+  EXPECT_TRUE(
+      WaitFor([&] { return m_serverInst.GetConnections().size() == 1; }));
+  EXPECT_TRUE(m_clientInst.IsConnected());
+}
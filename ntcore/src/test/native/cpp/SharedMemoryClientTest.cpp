@@ -0,0 +1,80 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wpi/StringExtras.h>
+
+#include "networktables/DoubleTopic.h"
+#include "networktables/NetworkTableInstance.h"
+#include "networktables/RawTopic.h"
+
+class SharedMemoryClientTest : public ::testing::Test {
+ public:
+  SharedMemoryClientTest()
+      : m_serverInst{nt::NetworkTableInstance::Create()},
+        m_clientInst{nt::NetworkTableInstance::Create()} {}
+
+  ~SharedMemoryClientTest() override {
+    nt::NetworkTableInstance::Destroy(m_clientInst);
+    nt::NetworkTableInstance::Destroy(m_serverInst);
+  }
+
+ protected:
+  nt::NetworkTableInstance m_serverInst;
+  nt::NetworkTableInstance m_clientInst;
+};
+
+// waits up to 3 seconds for the condition to become true
+static bool WaitFor(std::function<bool()> cond) {
+  for (int count = 0; count < 300; ++count) {
+    if (cond()) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return cond();
+}
+
+TEST_F(SharedMemoryClientTest, PubSubRoundTrip) {
+  m_serverInst.StartServer("sharedmemoryclienttest.json", "127.0.0.1", 0,
+                           10042);
+  std::atomic_bool usingSharedMemory{false};
+  m_clientInst.AddLogger(0, UINT_MAX, [&](auto& event) {
+    if (auto msg = event.GetLogMessage();
+        msg && wpi::contains(msg->message, "using shared memory")) {
+      usingSharedMemory = true;
+    }
+  });
+  m_clientInst.StartClient4("client", true);
+  m_clientInst.SetServer("127.0.0.1", 10042);
+  ASSERT_TRUE(WaitFor([&] { return m_clientInst.IsConnected(); }));
+#ifdef __linux__
+  EXPECT_TRUE(WaitFor([&] { return usingSharedMemory.load(); }));
+#endif
+
+  // client to server
+  auto serverSub = m_serverInst.GetDoubleTopic("/client").Subscribe(0);
+  auto clientPub = m_clientInst.GetDoubleTopic("/client").Publish();
+  clientPub.Set(1.5);
+  m_clientInst.Flush();
+  EXPECT_TRUE(WaitFor([&] { return serverSub.Get() == 1.5; }));
+
+  // server to client, with a value larger than a network frame
+  std::vector<uint8_t> data(100000, 7);
+  auto clientSub = m_clientInst.GetRawTopic("/server").Subscribe("raw", {});
+  auto serverPub = m_serverInst.GetRawTopic("/server").Publish("raw");
+  serverPub.Set(data);
+  m_serverInst.Flush();
+  EXPECT_TRUE(WaitFor([&] { return clientSub.Get() == data; }));
+
+  m_clientInst.StopClient();
+  EXPECT_TRUE(WaitFor([&] { return m_serverInst.GetConnections().empty(); }));
+}
@@ -0,0 +1,128 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <stdint.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ValueCircularBuffer.h"
+
+namespace nt {
+
+TEST(ValueCircularBufferTest, Empty) {
+  ValueCircularBuffer buf{3};
+  EXPECT_TRUE(buf.Read<int64_t>().empty());
+  EXPECT_TRUE(buf.ReadValue(0).empty());
+}
+
+TEST(ValueCircularBufferTest, KeepsNewest) {
+  ValueCircularBuffer buf{3};
+  for (int i = 0; i < 5; ++i) {
+    buf.emplace_back(Value::MakeInteger(i, 10 + i));
+  }
+  auto vals = buf.Read<int64_t>();
+  ASSERT_EQ(vals.size(), 3u);
+  EXPECT_EQ(vals[0].value, 2);
+  EXPECT_EQ(vals[0].time, 12);
+  EXPECT_EQ(vals[2].value, 4);
+  EXPECT_TRUE(buf.Read<int64_t>().empty());
+}
+
+TEST(ValueCircularBufferTest, Overflow) {
+  // many more values than the ring holds without a read
+  ValueCircularBuffer buf{2};
+  for (int i = 0; i < 100; ++i) {
+    buf.emplace_back(Value::MakeInteger(i));
+  }
+  auto vals = buf.Read<int64_t>();
+  ASSERT_EQ(vals.size(), 2u);
+  EXPECT_EQ(vals[0].value, 98);
+  EXPECT_EQ(vals[1].value, 99);
+}
+
+TEST(ValueCircularBufferTest, ReadValueTypes) {
+  ValueCircularBuffer buf{4};
+  buf.emplace_back(Value::MakeInteger(1));
+  buf.emplace_back(Value::MakeString("a"));
+  buf.emplace_back(Value::MakeInteger(2));
+  auto vals = buf.ReadValue(NT_STRING);
+  ASSERT_EQ(vals.size(), 1u);
+  EXPECT_EQ(vals[0].GetString(), "a");
+  // non-matching values are consumed too
+  EXPECT_TRUE(buf.ReadValue(0).empty());
+}
+
+TEST(ValueCircularBufferTest, ReadNumericConvert) {
+  ValueCircularBuffer buf{4};
+  buf.emplace_back(Value::MakeInteger(1));
+  buf.emplace_back(Value::MakeBoolean(true));
+  buf.emplace_back(Value::MakeFloat(2.5));
+  auto vals = buf.Read<double>();
+  ASSERT_EQ(vals.size(), 2u);
+  EXPECT_EQ(vals[0].value, 1.0);
+  EXPECT_EQ(vals[1].value, 2.5);
+}
+
+TEST(ValueCircularBufferTest, ReadIntoBuffer) {
+  ValueCircularBuffer buf{4};
+  std::vector<Timestamped<std::string>> out;
+  out.resize(3);
+  out[0].value.reserve(100);
+  auto data = out[0].value.data();
+
+  buf.emplace_back(Value::MakeString("hello", 5));
+  buf.emplace_back(Value::MakeString("world", 6));
+  buf.Read<std::string>(out);
+  ASSERT_EQ(out.size(), 2u);
+  EXPECT_EQ(out[0].value, "hello");
+  EXPECT_EQ(out[0].time, 5);
+  EXPECT_EQ(out[1].value, "world");
+  // string storage is reused
+  EXPECT_EQ(out[0].value.data(), data);
+
+  buf.Read<std::string>(out);
+  EXPECT_TRUE(out.empty());
+}
+
+TEST(ValueCircularBufferTest, ReadIntoBufferNumericArray) {
+  ValueCircularBuffer buf{4};
+  std::vector<Timestamped<std::vector<double>>> out;
+  buf.emplace_back(Value::MakeIntegerArray({1, 2}));
+  buf.emplace_back(Value::MakeDoubleArray({3.5}));
+  buf.Read<double[]>(out);
+  ASSERT_EQ(out.size(), 2u);
+  EXPECT_EQ(out[0].value, (std::vector<double>{1.0, 2.0}));
+  EXPECT_EQ(out[1].value, (std::vector<double>{3.5}));
+}
+
+TEST(ValueCircularBufferTest, Concurrent) {
+  static constexpr int kCount = 100000;
+  ValueCircularBuffer buf{8};
+  std::thread producer{[&] {
+    for (int i = 0; i < kCount; ++i) {
+      buf.emplace_back(Value::MakeInteger(i));
+    }
+  }};
+
+  // values must be read in order, with no duplicates
+  std::vector<Timestamped<int64_t>> out;
+  int64_t last = -1;
+  while (last != kCount - 1) {
+    buf.Read<int64_t>(out);
+    ASSERT_LE(out.size(), 8u);
+    for (auto&& val : out) {
+      ASSERT_GT(val.value, last);
+      last = val.value;
+    }
+  }
+  producer.join();
+  buf.Read<int64_t>(out);
+  EXPECT_TRUE(out.empty());
+}
+
+}  // namespace nt
@@ -0,0 +1,112 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <stdint.h>
+
+#include <map>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../TestPrinters.h"
+#include "MockWireConnection.h"
+#include "net/Message.h"
+#include "net/NetworkOutgoingQueue.h"
+#include "net/WireDecoder.h"
+#include "networktables/NetworkTableValue.h"
+
+using ::testing::_;
+using ::testing::Return;
+
+namespace nt::net {
+
+class NetworkOutgoingQueueTest : public ::testing::Test {
+ public:
+  NetworkOutgoingQueueTest() {
+    ON_CALL(wire, Ready()).WillByDefault(Return(true));
+    ON_CALL(wire, DoWriteBinary(_))
+        .WillByDefault([this](std::span<const uint8_t> contents) {
+          written.insert(written.end(), contents.begin(), contents.end());
+          return 0;
+        });
+  }
+
+  // Decodes the values written so far; each handle's values are in the
+  // order they were written
+  std::map<int, std::vector<Value>> DecodeWritten();
+
+ protected:
+  ::testing::NiceMock<MockWireConnection> wire;
+  NetworkOutgoingQueue<ClientMessage> queue{wire, false};
+  std::vector<uint8_t> written;
+};
+
+std::map<int, std::vector<Value>> NetworkOutgoingQueueTest::DecodeWritten() {
+  std::map<int, std::vector<Value>> values;
+  std::span<const uint8_t> in{written};
+  while (!in.empty()) {
+    int id;
+    Value value;
+    std::string error;
+    if (!WireDecodeBinary(&in, &id, &value, &error, 0)) {
+      ADD_FAILURE() << "decode error: " << error;
+      break;
+    }
+    values[id].emplace_back(std::move(value));
+  }
+  return values;
+}
+
+TEST_F(NetworkOutgoingQueueTest, CoalesceAfterSetPeriod) {
+  queue.SetPeriod(1, 100);
+  queue.SetPeriod(2, 100);
+  queue.SetPeriod(3, 100);
+  queue.SendValue(1, Value::MakeDouble(1.0, 10), ValueSendMode::kNormal);
+  queue.SendValue(2, Value::MakeDouble(2.0, 10), ValueSendMode::kNormal);
+  queue.SendValue(3, Value::MakeDouble(3.0, 10), ValueSendMode::kNormal);
+
+  // moving handle 1 to another queue removes its value from the old queue,
+  // moving the values after it
+  queue.SetPeriod(1, 20);
+
+  // newer values replace the queued ones, wherever they are now
+  queue.SendValue(1, Value::MakeDouble(4.0, 20), ValueSendMode::kNormal);
+  queue.SendValue(2, Value::MakeDouble(5.0, 20), ValueSendMode::kNormal);
+  queue.SendValue(3, Value::MakeDouble(6.0, 20), ValueSendMode::kNormal);
+
+  queue.SendOutgoing(1000, true);
+  auto values = DecodeWritten();
+  ASSERT_EQ(values.size(), 3u);
+  ASSERT_EQ(values[1].size(), 1u);
+  EXPECT_EQ(values[1][0], Value::MakeDouble(4.0, 20));
+  ASSERT_EQ(values[2].size(), 1u);
+  EXPECT_EQ(values[2][0], Value::MakeDouble(5.0, 20));
+  ASSERT_EQ(values[3].size(), 1u);
+  EXPECT_EQ(values[3][0], Value::MakeDouble(6.0, 20));
+}
+
+TEST_F(NetworkOutgoingQueueTest, SetPeriodKeepsOrder) {
+  queue.SetPeriod(1, 100);
+  queue.SetPeriod(2, 100);
+  queue.SendValue(1, Value::MakeDouble(1.0, 10), ValueSendMode::kAll);
+  queue.SendValue(2, Value::MakeDouble(2.0, 10), ValueSendMode::kAll);
+  queue.SendValue(1, Value::MakeDouble(3.0, 20), ValueSendMode::kAll);
+  queue.SendValue(2, Value::MakeDouble(4.0, 20), ValueSendMode::kAll);
+
+  queue.SetPeriod(1, 20);
+  queue.SendValue(2, Value::MakeDouble(5.0, 30), ValueSendMode::kNormal);
+
+  queue.SendOutgoing(1000, true);
+  auto values = DecodeWritten();
+  EXPECT_EQ(values[1], (std::vector{Value::MakeDouble(1.0, 10),
+                                    Value::MakeDouble(3.0, 20)}));
+  // only the newest queued value is replaced
+  EXPECT_EQ(values[2], (std::vector{Value::MakeDouble(2.0, 10),
+                                    Value::MakeDouble(5.0, 30)}));
+}
+
+}  // namespace nt::net
@@ -0,0 +1,165 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <stdint.h>
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wpinet/uv/Loop.h>
+
+#include "MockWireConnection.h"
+#include "net/SharedMemoryConnection.h"
+#include "net/SharedMemoryRing.h"
+#include "net/WireDecoder.h"
+
+namespace nt {
+
+class SharedMemoryRingTest : public ::testing::Test {
+ protected:
+  std::string ReadOne() {
+    std::string out;
+    if (!consumer.Read([&](uint8_t opcode, std::span<const uint8_t> data) {
+          out += std::to_string(opcode);
+          out += ':';
+          out.append(reinterpret_cast<const char*>(data.data()), data.size());
+        })) {
+      out = "empty";
+    }
+    return out;
+  }
+
+  static std::span<const uint8_t> Bytes(std::string_view str) {
+    return {reinterpret_cast<const uint8_t*>(str.data()), str.size()};
+  }
+
+  net::SharedMemoryRingControl control;
+  std::vector<uint8_t> data = std::vector<uint8_t>(64);
+  net::SharedMemoryRing producer{&control, data.data(), data.size()};
+  net::SharedMemoryRing consumer{&control, data.data(), data.size()};
+};
+
+TEST_F(SharedMemoryRingTest, CommitRequired) {
+  ASSERT_TRUE(producer.Write(1, Bytes("hello")));
+  EXPECT_TRUE(consumer.IsEmpty());
+  EXPECT_EQ(ReadOne(), "empty");
+  producer.Commit();
+  EXPECT_FALSE(consumer.IsEmpty());
+  EXPECT_EQ(ReadOne(), "1:hello");
+  EXPECT_TRUE(consumer.IsEmpty());
+}
+
+TEST_F(SharedMemoryRingTest, Discard) {
+  ASSERT_TRUE(producer.Write(1, Bytes("a")));
+  producer.Commit();
+  ASSERT_TRUE(producer.Write(2, Bytes("b")));
+  producer.Discard();
+  producer.Commit();
+  EXPECT_EQ(ReadOne(), "1:a");
+  EXPECT_EQ(ReadOne(), "empty");
+}
+
+TEST_F(SharedMemoryRingTest, Full) {
+  // each record is 8 bytes header + 16 bytes payload
+  ASSERT_TRUE(producer.Write(2, Bytes("0123456789abcdef")));
+  ASSERT_TRUE(producer.Write(2, Bytes("0123456789abcdef")));
+  EXPECT_EQ(producer.GetFree(), 16u);
+  EXPECT_FALSE(producer.Write(2, Bytes("0123456789abcdef")));
+  producer.Commit();
+  EXPECT_EQ(ReadOne(), "2:0123456789abcdef");
+  EXPECT_EQ(producer.GetFree(), 40u);
+  EXPECT_TRUE(producer.Write(2, Bytes("0123456789abcdef")));
+}
+
+TEST_F(SharedMemoryRingTest, Wraparound) {
+  for (int i = 0; i < 20; ++i) {
+    std::string msg = "message " + std::to_string(i);
+    ASSERT_TRUE(producer.Write(1, Bytes(msg)));
+    producer.Commit();
+    EXPECT_EQ(ReadOne(), "1:" + msg);
+  }
+  EXPECT_TRUE(consumer.IsEmpty());
+}
+
+TEST_F(SharedMemoryRingTest, SeqIncrementsOnCommit) {
+  uint32_t seq = consumer.GetSeq();
+  producer.Commit();  // nothing written
+  EXPECT_EQ(consumer.GetSeq(), seq);
+  ASSERT_TRUE(producer.Write(1, Bytes("x")));
+  producer.Commit();
+  EXPECT_NE(consumer.GetSeq(), seq);
+  // doesn't block as the sequence number changed
+  consumer.Wait(seq, 10000);
+}
+
+#ifdef __linux__
+TEST(SharedMemorySegmentTest, CreateOpen) {
+  auto client = net::SharedMemorySegment::Create();
+  ASSERT_TRUE(client);
+  EXPECT_FALSE(client->IsAttached());
+
+  auto server = net::SharedMemorySegment::Open(client->GetName());
+  ASSERT_TRUE(server);
+  EXPECT_TRUE(client->IsAttached());
+  // can only be attached once
+  EXPECT_FALSE(net::SharedMemorySegment::Open(client->GetName()));
+  client->Unlink();
+
+  std::string_view msg = "hello";
+  ASSERT_TRUE(client->GetClientToServer().Write(
+      2, {reinterpret_cast<const uint8_t*>(msg.data()), msg.size()}));
+  client->GetClientToServer().Commit();
+  std::string out;
+  ASSERT_TRUE(server->GetClientToServer().Read(
+      [&](uint8_t, std::span<const uint8_t> data) {
+        out.assign(reinterpret_cast<const char*>(data.data()), data.size());
+      }));
+  EXPECT_EQ(out, msg);
+
+  EXPECT_FALSE(server->IsClosed());
+  client.reset();
+  EXPECT_TRUE(server->IsClosed());
+}
+
+TEST(SharedMemorySegmentTest, OpenInvalidName) {
+  EXPECT_FALSE(net::SharedMemorySegment::Open("/other"));
+  EXPECT_FALSE(net::SharedMemorySegment::Open("/nt-../x"));
+  EXPECT_FALSE(net::SharedMemorySegment::Open("/nt-does-not-exist"));
+}
+
+TEST(SharedMemoryConnectionTest, RejectTooLarge) {
+  auto loop = wpi::uv::Loop::Create();
+  ASSERT_TRUE(loop);
+  std::shared_ptr<net::SharedMemorySegment> segment =
+      net::SharedMemorySegment::Create();
+  ASSERT_TRUE(segment);
+  segment->Unlink();
+
+  ::testing::StrictMock<net::MockWireConnection> control;
+  EXPECT_CALL(control, Disconnect(::testing::_)).Times(2);
+  net::SharedMemoryConnection conn{control, segment, false, *loop};
+  auto& ring = segment->GetClientToServer();
+
+  std::vector<uint8_t> large(net::kMaxMessageSize + 1);
+  auto writeLarge = [&](wpi::raw_ostream& os) {
+    os << std::span<const uint8_t>{large};
+  };
+
+  // not queued to be retried, so later messages aren't blocked
+  conn.SendBinary(writeLarge);
+  EXPECT_TRUE(ring.IsEmpty());
+  EXPECT_TRUE(conn.Ready());
+  conn.SendText([](auto& os) { os << "{}"; });
+  EXPECT_FALSE(ring.IsEmpty());
+
+  // batched writes report an error instead of being left unsent
+  EXPECT_LT(conn.WriteBinary(writeLarge), 0);
+}
+#endif
+
+}  // namespace nt
@@ -17,6 +17,7 @@
 #include "PubSubOptions.h"
 #include "gmock/gmock-matchers.h"
 #include "net/Message.h"
+#include "net/WireDecoder.h"
 #include "net/WireEncoder.h"
 #include "networktables/NetworkTableValue.h"
 
@@ -286,4 +287,49 @@ TEST_F(WireEncoderBinaryTest, StringArray) {
                                "bye"_us));
 }
 
+TEST_F(WireEncoderBinaryTest, Multiple) {
+  auto v1 = Value::MakeInteger(7);
+  auto v2 = Value::MakeBoolean(true);
+  Value invalid;
+  net::BinaryValue values[] = {{5, 6, &v1}, {1, 2, &invalid}, {3, 4, &v2}};
+  ASSERT_EQ(net::WireEncodeBinary(os, values), 2u);
+  ASSERT_THAT(out, wpi::SpanEq("\x94\x05\x06\x02\x07"
+                               "\x94\x03\x04\x00\xc3"_us));
+}
+
+TEST_F(WireEncoderBinaryTest, CompressedRaw) {
+  std::vector<uint8_t> data(1000, 'a');
+  auto value = Value::MakeRaw(data);
+  ASSERT_TRUE(net::WireEncodeBinary(os, 5, 6, value, true));
+  ASSERT_LT(out.size(), data.size());
+
+  std::span<const uint8_t> in{out};
+  int id;
+  Value decoded;
+  std::string error;
+  ASSERT_TRUE(net::WireDecodeBinary(&in, &id, &decoded, &error, 0));
+  EXPECT_TRUE(in.empty());
+  EXPECT_EQ(id, 5);
+  ASSERT_TRUE(decoded.IsRaw());
+  EXPECT_THAT(decoded.GetRaw(), wpi::SpanEq(std::span<const uint8_t>{data}));
+}
+
+TEST_F(WireEncoderBinaryTest, CompressedTooLarge) {
+  // compressed raw claiming to decompress to one byte more than the maximum
+  // message size
+  auto data = "\x94\x05\x06\xcc\x85\x92\xce\x00\x20\x00\x01\xc4\x01"
+              "a"_us;
+  std::span<const uint8_t> in{data};
+  int id;
+  Value decoded;
+  std::string error;
+  EXPECT_FALSE(net::WireDecodeBinary(&in, &id, &decoded, &error, 0));
+}
+
+TEST_F(WireEncoderBinaryTest, CompressedStringSmall) {
+  // below threshold, sent uncompressed
+  net::WireEncodeBinary(os, 5, 6, Value::MakeString("hello"), true);
+  ASSERT_THAT(out, wpi::SpanEq("\x94\x05\x06\x04\xa5hello"_us));
+}
+
 }  // namespace nt
@@ -0,0 +1,257 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "frc/estimator/InertialPoseEstimator3d.h"
+
+#include <array>
+
+#include <Eigen/Cholesky>
+
+#include "frc/StateSpaceUtil.h"
+#include "frc/geometry/Rotation3d.h"
+#include "frc/geometry/Transform3d.h"
+#include "frc/geometry/Translation3d.h"
+
+using namespace frc;
+
+namespace {
+
+/**
+ * Indices of the error states.
+ */
+class State {
+ public:
+  /// Position in the field frame.
+  static constexpr int kPosition = 0;
+
+  /// Velocity in the field frame.
+  static constexpr int kVelocity = 3;
+
+  /// Rotation error in the robot frame.
+  static constexpr int kRotation = 6;
+
+  /// Gyro bias.
+  static constexpr int kGyroBias = 9;
+
+  /// Accelerometer bias.
+  static constexpr int kAccelBias = 12;
+};
+
+// Standard deviations of the velocity and IMU biases before any measurements
+constexpr double kInitialVelocityStdDev = 1.0;   // m/s
+constexpr double kInitialGyroBiasStdDev = 0.01;  // rad/s
+constexpr double kInitialAccelBiasStdDev = 0.1;  // m/s²
+
+// Gravity in the field frame
+const Eigen::Vector3d kGravity{0.0, 0.0, -9.80665};
+
+/**
+ * Returns the matrix [v]ₓ such that [v]ₓw = v × w.
+ */
+Eigen::Matrix3d Skew(const Eigen::Vector3d& v) {
+  return Eigen::Matrix3d{{0.0, -v.z(), v.y()},  //
+                         {v.z(), 0.0, -v.x()},  //
+                         {-v.y(), v.x(), 0.0}};
+}
+
+}  // namespace
+
+InertialPoseEstimator3d::InertialPoseEstimator3d(
+    const wpi::array<double, 4>& imuStdDevs,
+    const wpi::array<double, 3>& odometryMeasurementStdDevs,
+    const wpi::array<double, 4>& visionMeasurementStdDevs) {
+  // The IMU noise drives the velocity and rotation errors, and the bias random
+  // walks drive the bias errors
+  m_contQ.block<3, 3>(State::kRotation, State::kRotation)
+      .diagonal()
+      .setConstant(imuStdDevs[0] * imuStdDevs[0]);
+  m_contQ.block<3, 3>(State::kGyroBias, State::kGyroBias)
+      .diagonal()
+      .setConstant(imuStdDevs[1] * imuStdDevs[1]);
+  m_contQ.block<3, 3>(State::kVelocity, State::kVelocity)
+      .diagonal()
+      .setConstant(imuStdDevs[2] * imuStdDevs[2]);
+  m_contQ.block<3, 3>(State::kAccelBias, State::kAccelBias)
+      .diagonal()
+      .setConstant(imuStdDevs[3] * imuStdDevs[3]);
+
+  m_odometryR = MakeCovMatrix(odometryMeasurementStdDevs);
+  SetVisionMeasurementStdDevs(visionMeasurementStdDevs);
+
+  m_P.block<3, 3>(State::kVelocity, State::kVelocity)
+      .diagonal()
+      .setConstant(kInitialVelocityStdDev * kInitialVelocityStdDev);
+  m_P.block<3, 3>(State::kGyroBias, State::kGyroBias)
+      .diagonal()
+      .setConstant(kInitialGyroBiasStdDev * kInitialGyroBiasStdDev);
+  m_P.block<3, 3>(State::kAccelBias, State::kAccelBias)
+      .diagonal()
+      .setConstant(kInitialAccelBiasStdDev * kInitialAccelBiasStdDev);
+}
+
+void InertialPoseEstimator3d::SetVisionMeasurementStdDevs(
+    const wpi::array<double, 4>& visionMeasurementStdDevs) {
+  m_visionR = MakeCovMatrix(std::array<double, 6>{
+      visionMeasurementStdDevs[0], visionMeasurementStdDevs[1],
+      visionMeasurementStdDevs[2], visionMeasurementStdDevs[3],
+      visionMeasurementStdDevs[3], visionMeasurementStdDevs[3]});
+}
+
+void InertialPoseEstimator3d::ResetPose(const Pose3d& pose) {
+  m_position = pose.Translation().ToVector();
+  m_orientation = pose.Rotation().GetQuaternion();
+
+  // The pose is known exactly, so it's no longer correlated with the velocity
+  // and biases
+  m_P.block<3, 15>(State::kPosition, 0).setZero();
+  m_P.block<15, 3>(0, State::kPosition).setZero();
+  m_P.block<3, 15>(State::kRotation, 0).setZero();
+  m_P.block<15, 3>(0, State::kRotation).setZero();
+
+  m_imuPose = pose;
+  m_imuPoseBuffer.Clear();
+}
+
+Pose3d InertialPoseEstimator3d::GetEstimatedPosition() const {
+  return Pose3d{Translation3d{m_position}, Rotation3d{m_orientation}};
+}
+
+void InertialPoseEstimator3d::AddImuMeasurement(
+    units::second_t timestamp, const Eigen::Vector3d& angularVelocity,
+    const Eigen::Vector3d& acceleration) {
+  if (!m_lastImuTimestamp) {
+    m_lastImuTimestamp = timestamp;
+    m_imuPoseBuffer.AddSample(timestamp, m_imuPose);
+    return;
+  }
+  double dt = (timestamp - *m_lastImuTimestamp).value();
+  m_lastImuTimestamp = timestamp;
+  if (dt <= 0.0) {
+    return;
+  }
+
+  Eigen::Vector3d omega = angularVelocity - m_gyroBias;
+  Eigen::Vector3d accel = acceleration - m_accelBias;
+  Eigen::Matrix3d R = Rotation3d{m_orientation}.ToMatrix();
+  Pose3d oldPose = GetEstimatedPosition();
+
+  // Propagate the nominal state, holding the measurements constant over the
+  // timestep
+  Eigen::Vector3d fieldAccel = R * accel + kGravity;
+  m_position += m_velocity * dt + 0.5 * fieldAccel * dt * dt;
+  m_velocity += fieldAccel * dt;
+  m_orientation =
+      (m_orientation * Quaternion::FromRotationVector(omega * dt)).Normalize();
+
+  // Continuous error state dynamics (see section 5.3.3 of Solà):
+  //
+  //   δṗ = δv
+  //   δv̇ = −R[a − bₐ]ₓδθ − Rδbₐ
+  //   δθ̇ = −[ω − b_g]ₓδθ − δb_g
+  //   δḃ_g = 0
+  //   δḃₐ = 0
+  Matrixd<15, 15> contA = Matrixd<15, 15>::Zero();
+  contA.block<3, 3>(State::kPosition, State::kVelocity).setIdentity();
+  contA.block<3, 3>(State::kVelocity, State::kRotation) = -R * Skew(accel);
+  contA.block<3, 3>(State::kVelocity, State::kAccelBias) = -R;
+  contA.block<3, 3>(State::kRotation, State::kRotation) = -Skew(omega);
+  contA.block<3, 3>(State::kRotation, State::kGyroBias) =
+      -Eigen::Matrix3d::Identity();
+
+  // IMU samples are close together relative to how fast the error dynamics
+  // change, so truncate the series for A_d = eᴬᵀ and use Q_d ≈ QT instead of
+  // paying for DiscretizeAQ()'s 30x30 matrix exponential every sample
+  Matrixd<15, 15> contAdt = contA * dt;
+  Matrixd<15, 15> discA =
+      Matrixd<15, 15>::Identity() + contAdt + 0.5 * contAdt * contAdt;
+
+  // Pₖ₊₁⁻ = APₖ⁻Aᵀ + Q
+  m_P = discA * m_P * discA.transpose() + m_contQ * dt;
+  m_P = (m_P + m_P.transpose()) / 2.0;
+
+  m_imuPose = m_imuPose + Transform3d{oldPose, GetEstimatedPosition()};
+  m_imuPoseBuffer.AddSample(timestamp, m_imuPose);
+}
+
+void InertialPoseEstimator3d::AddOdometryMeasurement(
+    const ChassisSpeeds& speeds) {
+  Eigen::Matrix3d R = Rotation3d{m_orientation}.ToMatrix();
+
+  // The wheels measure the velocity in the robot frame, v_r = Rᵀv
+  Eigen::Vector3d robotVelocity = R.transpose() * m_velocity;
+  Eigen::Vector3d y{speeds.vx.value(), speeds.vy.value(), 0.0};
+
+  Matrixd<3, 15> H = Matrixd<3, 15>::Zero();
+  H.block<3, 3>(0, State::kVelocity) = R.transpose();
+  H.block<3, 3>(0, State::kRotation) = Skew(robotVelocity);
+
+  Correct<3>(y - robotVelocity, H, m_odometryR);
+}
+
+void InertialPoseEstimator3d::AddVisionMeasurement(
+    const Pose3d& visionRobotPose, units::second_t timestamp) {
+  // Skip measurements that are too old for the IMU pose buffer
+  if (m_imuPoseBuffer.GetSampleBuffer().size() == 0 ||
+      m_imuPoseBuffer.GetSampleBuffer().front().first - kBufferDuration >
+          timestamp) {
+    return;
+  }
+
+  auto imuSample = m_imuPoseBuffer.Sample(timestamp);
+  if (!imuSample) {
+    return;
+  }
+
+  // Move the measurement forward to the current time by the motion measured
+  // since it was taken. The IMU-only pose doesn't include any corrections, so
+  // a correction from one camera doesn't leak into the residual of the next.
+  Pose3d measuredPose = visionRobotPose + (m_imuPose - *imuSample);
+
+  Vectord<6> residual;
+  residual.segment<3>(0) = measuredPose.Translation().ToVector() - m_position;
+  residual.segment<3>(3) =
+      (m_orientation.Inverse() * measuredPose.Rotation().GetQuaternion())
+          .ToRotationVector();
+
+  Matrixd<6, 15> H = Matrixd<6, 15>::Zero();
+  H.block<3, 3>(0, State::kPosition).setIdentity();
+  H.block<3, 3>(3, State::kRotation).setIdentity();
+
+  Correct<6>(residual, H, m_visionR);
+}
+
+void InertialPoseEstimator3d::AddVisionMeasurement(
+    const Pose3d& visionRobotPose, units::second_t timestamp,
+    const wpi::array<double, 4>& visionMeasurementStdDevs) {
+  SetVisionMeasurementStdDevs(visionMeasurementStdDevs);
+  AddVisionMeasurement(visionRobotPose, timestamp);
+}
+
+template <int Rows>
+void InertialPoseEstimator3d::Correct(const Vectord<Rows>& residual,
+                                      const Matrixd<Rows, 15>& H,
+                                      const Matrixd<Rows, Rows>& R) {
+  Matrixd<Rows, Rows> S = H * m_P * H.transpose() + R;
+
+  // K = PHᵀS⁻¹, so Kᵀ = S⁻ᵀHPᵀ = S⁻¹HP since P and S are symmetric
+  Matrixd<15, Rows> K = S.ldlt().solve(H * m_P).transpose();
+
+  Vectord<15> dx = K * residual;
+
+  // Pₖ₊₁⁺ = (I−Kₖ₊₁H)Pₖ₊₁⁻(I−Kₖ₊₁H)ᵀ + Kₖ₊₁RKₖ₊₁ᵀ
+  // Use Joseph form for numerical stability
+  Matrixd<15, 15> IKH = Matrixd<15, 15>::Identity() - K * H;
+  m_P = IKH * m_P * IKH.transpose() + K * R * K.transpose();
+
+  // Move the error into the nominal state. The error state is now zero. The
+  // covariance reset for the rotation error is second order in the correction,
+  // so it's omitted.
+  m_position += dx.segment<3>(State::kPosition);
+  m_velocity += dx.segment<3>(State::kVelocity);
+  m_orientation = (m_orientation * Quaternion::FromRotationVector(
+                                       dx.segment<3>(State::kRotation)))
+                      .Normalize();
+  m_gyroBias += dx.segment<3>(State::kGyroBias);
+  m_accelBias += dx.segment<3>(State::kAccelBias);
+}
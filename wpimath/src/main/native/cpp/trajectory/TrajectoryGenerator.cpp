@@ -4,6 +4,11 @@
 
 #include "frc/trajectory/TrajectoryGenerator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <span>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -31,8 +36,45 @@ Trajectory TrajectoryGenerator::GenerateTrajectory(
     Spline<3>::ControlVector initial,
     const std::vector<Translation2d>& interiorWaypoints,
     Spline<3>::ControlVector end, const TrajectoryConfig& config) {
-  const Transform2d flip{Translation2d{}, 180_deg};
+  Workspace workspace;
+  Trajectory trajectory;
+  GenerateTrajectory(initial, interiorWaypoints, end, config, workspace,
+                     &trajectory);
+  return trajectory;
+}
+
+Trajectory TrajectoryGenerator::GenerateTrajectory(
+    const Pose2d& start, const std::vector<Translation2d>& interiorWaypoints,
+    const Pose2d& end, const TrajectoryConfig& config) {
+  Workspace workspace;
+  Trajectory trajectory;
+  GenerateTrajectory(start, interiorWaypoints, end, config, workspace,
+                     &trajectory);
+  return trajectory;
+}
 
+Trajectory TrajectoryGenerator::GenerateTrajectory(
+    std::vector<Spline<5>::ControlVector> controlVectors,
+    const TrajectoryConfig& config) {
+  Workspace workspace;
+  Trajectory trajectory;
+  GenerateTrajectory(controlVectors, config, workspace, &trajectory);
+  return trajectory;
+}
+
+Trajectory TrajectoryGenerator::GenerateTrajectory(
+    const std::vector<Pose2d>& waypoints, const TrajectoryConfig& config) {
+  Workspace workspace;
+  Trajectory trajectory;
+  GenerateTrajectory(waypoints, config, workspace, &trajectory);
+  return trajectory;
+}
+
+void TrajectoryGenerator::GenerateTrajectory(
+    Spline<3>::ControlVector initial,
+    std::span<const Translation2d> interiorWaypoints,
+    Spline<3>::ControlVector end, const TrajectoryConfig& config,
+    Workspace& workspace, Trajectory* trajectory) {
   // Make theta normal for trajectory generation if path is reversed.
   // Flip the headings.
   if (config.IsReversed()) {
@@ -42,77 +84,70 @@ Trajectory TrajectoryGenerator::GenerateTrajectory(
     end.y[1] *= -1;
   }
 
-  std::vector<frc::SplineParameterizer::PoseWithCurvature> points;
   try {
-    points =
-        SplinePointsFromSplines(SplineHelper::CubicSplinesFromControlVectors(
-            initial, interiorWaypoints, end));
+    SplineHelper::CubicSplinesFromControlVectors(
+        initial, interiorWaypoints, end, &workspace.m_cubicSplines,
+        &workspace.m_splineScratch);
+    SplinePointsFromSplines(workspace.m_cubicSplines,
+                            workspace.m_splineParameterizer,
+                            &workspace.m_points);
   } catch (SplineParameterizer::MalformedSplineException& e) {
     ReportError(e.what());
-    return kDoNothingTrajectory;
+    *trajectory = kDoNothingTrajectory;
+    return;
   }
 
-  // After trajectory generation, flip theta back so it's relative to the
-  // field. Also fix curvature.
-  if (config.IsReversed()) {
-    for (auto& point : points) {
-      point = {point.first + flip, -point.second};
-    }
-  }
-
-  return TrajectoryParameterizer::TimeParameterizeTrajectory(
-      points, config.Constraints(), config.StartVelocity(),
-      config.EndVelocity(), config.MaxVelocity(), config.MaxAcceleration(),
-      config.IsReversed());
+  TimeParameterize(config, workspace, trajectory);
 }
 
-Trajectory TrajectoryGenerator::GenerateTrajectory(
-    const Pose2d& start, const std::vector<Translation2d>& interiorWaypoints,
-    const Pose2d& end, const TrajectoryConfig& config) {
+void TrajectoryGenerator::GenerateTrajectory(
+    const Pose2d& start, std::span<const Translation2d> interiorWaypoints,
+    const Pose2d& end, const TrajectoryConfig& config, Workspace& workspace,
+    Trajectory* trajectory) {
   auto [startCV, endCV] = SplineHelper::CubicControlVectorsFromWaypoints(
       start, interiorWaypoints, end);
-  return GenerateTrajectory(startCV, interiorWaypoints, endCV, config);
+  GenerateTrajectory(startCV, interiorWaypoints, endCV, config, workspace,
+                     trajectory);
 }
 
-Trajectory TrajectoryGenerator::GenerateTrajectory(
-    std::vector<Spline<5>::ControlVector> controlVectors,
-    const TrajectoryConfig& config) {
-  const Transform2d flip{Translation2d{}, 180_deg};
+void TrajectoryGenerator::GenerateTrajectory(
+    std::span<const Spline<5>::ControlVector> controlVectors,
+    const TrajectoryConfig& config, Workspace& workspace,
+    Trajectory* trajectory) {
+  auto& newControlVectors = workspace.m_controlVectors;
+  newControlVectors.assign(controlVectors.begin(), controlVectors.end());
+
   // Make theta normal for trajectory generation if path is reversed.
   if (config.IsReversed()) {
-    for (auto& vector : controlVectors) {
+    for (auto& vector : newControlVectors) {
       // Flip the headings.
       vector.x[1] *= -1;
       vector.y[1] *= -1;
     }
   }
 
-  std::vector<frc::SplineParameterizer::PoseWithCurvature> points;
   try {
-    points = SplinePointsFromSplines(
-        SplineHelper::QuinticSplinesFromControlVectors(controlVectors));
+    SplineHelper::QuinticSplinesFromControlVectors(
+        newControlVectors, &workspace.m_quinticSplines);
+    SplinePointsFromSplines(workspace.m_quinticSplines,
+                            workspace.m_splineParameterizer,
+                            &workspace.m_points);
   } catch (SplineParameterizer::MalformedSplineException& e) {
     ReportError(e.what());
-    return kDoNothingTrajectory;
-  }
-
-  // After trajectory generation, flip theta back so it's relative to the
-  // field. Also fix curvature.
-  if (config.IsReversed()) {
-    for (auto& point : points) {
-      point = {point.first + flip, -point.second};
-    }
+    *trajectory = kDoNothingTrajectory;
+    return;
   }
 
-  return TrajectoryParameterizer::TimeParameterizeTrajectory(
-      points, config.Constraints(), config.StartVelocity(),
-      config.EndVelocity(), config.MaxVelocity(), config.MaxAcceleration(),
-      config.IsReversed());
+  TimeParameterize(config, workspace, trajectory);
 }
 
-Trajectory TrajectoryGenerator::GenerateTrajectory(
-    const std::vector<Pose2d>& waypoints, const TrajectoryConfig& config) {
-  auto newWaypoints = waypoints;
+void TrajectoryGenerator::GenerateTrajectory(std::span<const Pose2d> waypoints,
+                                             const TrajectoryConfig& config,
+                                             Workspace& workspace,
+                                             Trajectory* trajectory) {
+  auto& newWaypoints = workspace.m_waypoints;
+  newWaypoints.assign(waypoints.begin(), waypoints.end());
+
   const Transform2d flip{Translation2d{}, 180_deg};
   if (config.IsReversed()) {
     for (auto& waypoint : newWaypoints) {
@@ -120,27 +155,82 @@ Trajectory TrajectoryGenerator::GenerateTrajectory(
     }
   }
 
-  std::vector<SplineParameterizer::PoseWithCurvature> points;
   try {
-    points = SplinePointsFromSplines(SplineHelper::OptimizeCurvature(
-        SplineHelper::QuinticSplinesFromWaypoints(newWaypoints)));
+    SplineHelper::QuinticSplinesFromWaypoints(newWaypoints,
+                                              &workspace.m_quinticSplines);
+    SplineHelper::OptimizeCurvature(&workspace.m_quinticSplines);
+    SplinePointsFromSplines(workspace.m_quinticSplines,
+                            workspace.m_splineParameterizer,
+                            &workspace.m_points);
   } catch (SplineParameterizer::MalformedSplineException& e) {
     ReportError(e.what());
-    return kDoNothingTrajectory;
+    *trajectory = kDoNothingTrajectory;
+    return;
   }
 
+  TimeParameterize(config, workspace, trajectory);
+}
+
+void TrajectoryGenerator::TimeParameterize(const TrajectoryConfig& config,
+                                           Workspace& workspace,
+                                           Trajectory* trajectory) {
   // After trajectory generation, flip theta back so it's relative to the
   // field. Also fix curvature.
   if (config.IsReversed()) {
-    for (auto& point : points) {
+    const Transform2d flip{Translation2d{}, 180_deg};
+    for (auto& point : workspace.m_points) {
       point = {point.first + flip, -point.second};
     }
   }
 
-  return TrajectoryParameterizer::TimeParameterizeTrajectory(
-      points, config.Constraints(), config.StartVelocity(),
+  TrajectoryParameterizer::TimeParameterizeTrajectory(
+      workspace.m_points, config.Constraints(), config.StartVelocity(),
       config.EndVelocity(), config.MaxVelocity(), config.MaxAcceleration(),
-      config.IsReversed());
+      config.IsReversed(), workspace.m_trajectoryParameterizer, trajectory);
+}
+
+std::vector<Trajectory> TrajectoryGenerator::GenerateTrajectories(
+    std::span<const Request> requests, unsigned int maxThreads) {
+  std::vector<Trajectory> trajectories(requests.size());
+
+  // Each thread takes the next request when it finishes one, and stores the
+  // trajectory at the request's index, so the order is deterministic
+  std::atomic<size_t> nextRequest = 0;
+  auto generate = [&] {
+    Workspace workspace;
+    for (size_t i = nextRequest++; i < requests.size(); i = nextRequest++) {
+      const auto& request = requests[i];
+      if (request.interiorWaypoints) {
+        GenerateTrajectory(request.waypoints.front(),
+                           *request.interiorWaypoints,
+                           request.waypoints.back(), *request.config,
+                           workspace, &trajectories[i]);
+      } else {
+        GenerateTrajectory(request.waypoints, *request.config, workspace,
+                           &trajectories[i]);
+      }
+    }
+  };
+
+  if (maxThreads == 0) {
+    maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  size_t numThreads =
+      std::clamp<size_t>(requests.size(), 1, static_cast<size_t>(maxThreads));
+
+  // The calling thread does its share too. Getting each future rethrows any
+  // exception from its thread.
+  std::vector<std::future<void>> futures;
+  futures.reserve(numThreads - 1);
+  for (size_t i = 1; i < numThreads; ++i) {
+    futures.emplace_back(std::async(std::launch::async, generate));
+  }
+  generate();
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  return trajectories;
 }
 
 void TrajectoryGenerator::SetErrorHandler(
@@ -43,7 +43,24 @@ Trajectory TrajectoryParameterizer::TimeParameterizeTrajectory(
     units::meters_per_second_t endVelocity,
     units::meters_per_second_t maxVelocity,
     units::meters_per_second_squared_t maxAcceleration, bool reversed) {
-  std::vector<ConstrainedState> constrainedStates(points.size());
+  Workspace workspace;
+  Trajectory trajectory;
+  TimeParameterizeTrajectory(points, constraints, startVelocity, endVelocity,
+                             maxVelocity, maxAcceleration, reversed, workspace,
+                             &trajectory);
+  return trajectory;
+}
+
+void TrajectoryParameterizer::TimeParameterizeTrajectory(
+    std::span<const PoseWithCurvature> points,
+    const std::vector<std::unique_ptr<TrajectoryConstraint>>& constraints,
+    units::meters_per_second_t startVelocity,
+    units::meters_per_second_t endVelocity,
+    units::meters_per_second_t maxVelocity,
+    units::meters_per_second_squared_t maxAcceleration, bool reversed,
+    Workspace& workspace, Trajectory* trajectory) {
+  auto& constrainedStates = workspace.m_constrainedStates;
+  constrainedStates.resize(points.size());
 
   ConstrainedState predecessor{points.front(), 0_m, startVelocity,
                                -maxAcceleration, maxAcceleration};
@@ -167,7 +184,8 @@ Trajectory TrajectoryParameterizer::TimeParameterizeTrajectory(
   // Now we can integrate the constrained states forward in time to obtain our
   // trajectory states.
 
-  std::vector<Trajectory::State> states(points.size());
+  auto& states = trajectory->m_states;
+  states.resize(points.size());
   units::second_t t = 0_s;
   units::meter_t s = 0_m;
   units::meters_per_second_t v = 0_mps;
@@ -210,7 +228,7 @@ Trajectory TrajectoryParameterizer::TimeParameterizeTrajectory(
                  state.pose.first, state.pose.second};
   }
 
-  return Trajectory(states);
+  trajectory->m_totalTime = states.back().t;
 }
 
 void TrajectoryParameterizer::EnforceAccelerationLimits(
@@ -4,16 +4,111 @@
 
 #include "frc/trajectory/TrajectoryUtil.h"
 
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <optional>
+#include <span>
 #include <string>
 #include <system_error>
+#include <typeinfo>
+#include <vector>
 
 #include <fmt/format.h>
+#include <wpi/Endian.h>
 #include <wpi/MemoryBuffer.h>
+#include <wpi/fs.h>
 #include <wpi/json.h>
 #include <wpi/raw_ostream.h>
+#include <wpi/xxhash.h>
+
+#include "wpimath/MathShared.h"
 
 using namespace frc;
 
+namespace {
+
+// The binary format is little endian:
+//
+//   magic: 4 bytes, "WTRJ"
+//   version: uint32
+//   key: uint64
+//   trajectory count: uint32
+//   for each trajectory:
+//     state count: uint32
+//     for each state: t, velocity, acceleration, x, y, heading (radians), and
+//       curvature as doubles
+constexpr uint8_t kMagic[] = {'W', 'T', 'R', 'J'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kStateSize = 7 * sizeof(double);
+
+class BinaryWriter {
+ public:
+  explicit BinaryWriter(std::vector<uint8_t>& data) : m_data{data} {}
+
+  void Write32(uint32_t value) {
+    size_t pos = Grow(sizeof(value));
+    wpi::support::endian::write32le(&m_data[pos], value);
+  }
+
+  void Write64(uint64_t value) {
+    size_t pos = Grow(sizeof(value));
+    wpi::support::endian::write64le(&m_data[pos], value);
+  }
+
+  void WriteDouble(double value) { Write64(std::bit_cast<uint64_t>(value)); }
+
+  void WriteBytes(std::span<const uint8_t> bytes) {
+    m_data.insert(m_data.end(), bytes.begin(), bytes.end());
+  }
+
+ private:
+  size_t Grow(size_t size) {
+    size_t pos = m_data.size();
+    m_data.resize(pos + size);
+    return pos;
+  }
+
+  std::vector<uint8_t>& m_data;
+};
+
+class BinaryReader {
+ public:
+  explicit BinaryReader(std::span<const uint8_t> data) : m_data{data} {}
+
+  size_t Remaining() const { return m_data.size() - m_pos; }
+
+  bool Read32(uint32_t* value) {
+    if (Remaining() < sizeof(*value)) {
+      return false;
+    }
+    *value = wpi::support::endian::read32le(&m_data[m_pos]);
+    m_pos += sizeof(*value);
+    return true;
+  }
+
+  bool Read64(uint64_t* value) {
+    if (Remaining() < sizeof(*value)) {
+      return false;
+    }
+    *value = wpi::support::endian::read64le(&m_data[m_pos]);
+    m_pos += sizeof(*value);
+    return true;
+  }
+
+  double ReadDouble() {
+    uint64_t value = 0;
+    Read64(&value);
+    return std::bit_cast<double>(value);
+  }
+
+ private:
+  std::span<const uint8_t> m_data;
+  size_t m_pos = 0;
+};
+
+}  // namespace
+
 void TrajectoryUtil::ToPathweaverJson(const Trajectory& trajectory,
                                       std::string_view path) {
   std::error_code error_code;
@@ -52,3 +147,209 @@ Trajectory TrajectoryUtil::DeserializeTrajectory(std::string_view jsonStr) {
   wpi::json json = wpi::json::parse(jsonStr);
   return Trajectory{json.get<std::vector<Trajectory::State>>()};
 }
+
+uint64_t TrajectoryUtil::HashTrajectoryRequests(
+    std::span<const TrajectoryGenerator::Request> requests) {
+  std::vector<uint8_t> data;
+  BinaryWriter writer{data};
+
+  auto writePose = [&](const Pose2d& pose) {
+    writer.WriteDouble(pose.X().value());
+    writer.WriteDouble(pose.Y().value());
+    writer.WriteDouble(pose.Rotation().Radians().value());
+  };
+
+  writer.Write32(kVersion);
+  writer.Write64(requests.size());
+  for (const auto& request : requests) {
+    writer.Write64(request.waypoints.size());
+    for (const auto& waypoint : request.waypoints) {
+      writePose(waypoint);
+    }
+    writer.Write32(request.interiorWaypoints.has_value());
+    if (request.interiorWaypoints) {
+      writer.Write64(request.interiorWaypoints->size());
+      for (const auto& waypoint : *request.interiorWaypoints) {
+        writer.WriteDouble(waypoint.X().value());
+        writer.WriteDouble(waypoint.Y().value());
+      }
+    }
+
+    const auto& config = *request.config;
+    writer.WriteDouble(config.StartVelocity().value());
+    writer.WriteDouble(config.EndVelocity().value());
+    writer.WriteDouble(config.MaxVelocity().value());
+    writer.WriteDouble(config.MaxAcceleration().value());
+    writer.Write32(config.IsReversed());
+
+    // Constraint parameters aren't accessible, so sample each constraint's
+    // limits at the waypoints, both straight and turning
+    writer.Write64(config.Constraints().size());
+    for (const auto& constraint : config.Constraints()) {
+      std::string_view name = typeid(*constraint).name();
+      writer.Write64(name.size());
+      writer.WriteBytes({reinterpret_cast<const uint8_t*>(name.data()),
+                         name.size()});
+
+      auto writeLimits = [&](const Pose2d& pose) {
+        for (auto curvature :
+             {units::curvature_t{0.0}, units::curvature_t{1.0}}) {
+          writer.WriteDouble(
+              constraint->MaxVelocity(pose, curvature, config.MaxVelocity())
+                  .value());
+          auto minMax = constraint->MinMaxAcceleration(pose, curvature,
+                                                       config.MaxVelocity());
+          writer.WriteDouble(minMax.minAcceleration.value());
+          writer.WriteDouble(minMax.maxAcceleration.value());
+        }
+      };
+      for (const auto& waypoint : request.waypoints) {
+        writeLimits(waypoint);
+      }
+      if (request.interiorWaypoints) {
+        for (const auto& waypoint : *request.interiorWaypoints) {
+          writeLimits(Pose2d{waypoint, Rotation2d{}});
+        }
+      }
+    }
+  }
+
+  return wpi::xxh3_64bits(data);
+}
+
+std::vector<uint8_t> TrajectoryUtil::SerializeTrajectoriesBinary(
+    std::span<const Trajectory> trajectories, uint64_t key) {
+  size_t size = sizeof(kMagic) + sizeof(uint32_t) + sizeof(uint64_t) +
+                sizeof(uint32_t);
+  for (const auto& trajectory : trajectories) {
+    size += sizeof(uint32_t) + trajectory.States().size() * kStateSize;
+  }
+
+  std::vector<uint8_t> data;
+  data.reserve(size);
+  BinaryWriter writer{data};
+
+  writer.WriteBytes(kMagic);
+  writer.Write32(kVersion);
+  writer.Write64(key);
+  writer.Write32(trajectories.size());
+  for (const auto& trajectory : trajectories) {
+    writer.Write32(trajectory.States().size());
+    for (const auto& state : trajectory.States()) {
+      writer.WriteDouble(state.t.value());
+      writer.WriteDouble(state.velocity.value());
+      writer.WriteDouble(state.acceleration.value());
+      writer.WriteDouble(state.pose.X().value());
+      writer.WriteDouble(state.pose.Y().value());
+      writer.WriteDouble(state.pose.Rotation().Radians().value());
+      writer.WriteDouble(state.curvature.value());
+    }
+  }
+
+  return data;
+}
+
+std::optional<std::vector<Trajectory>>
+TrajectoryUtil::DeserializeTrajectoriesBinary(std::span<const uint8_t> data,
+                                              uint64_t key) {
+  if (data.size() < sizeof(kMagic) ||
+      !std::equal(std::begin(kMagic), std::end(kMagic), data.begin())) {
+    return std::nullopt;
+  }
+  BinaryReader reader{data.subspan(sizeof(kMagic))};
+
+  uint32_t version = 0;
+  uint64_t dataKey = 0;
+  uint32_t count = 0;
+  if (!reader.Read32(&version) || version != kVersion ||
+      !reader.Read64(&dataKey) || dataKey != key || !reader.Read32(&count) ||
+      reader.Remaining() / sizeof(uint32_t) < count) {
+    // each trajectory has at least a state count, so this rejects counts
+    // that are too large before reserving space for them
+    return std::nullopt;
+  }
+
+  std::vector<Trajectory> trajectories;
+  trajectories.reserve(count);
+  std::vector<Trajectory::State> states;
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t stateCount = 0;
+    if (!reader.Read32(&stateCount) ||
+        reader.Remaining() / kStateSize < stateCount) {
+      return std::nullopt;
+    }
+
+    states.clear();
+    states.reserve(stateCount);
+    for (uint32_t j = 0; j < stateCount; ++j) {
+      auto& state = states.emplace_back();
+      state.t = units::second_t{reader.ReadDouble()};
+      state.velocity = units::meters_per_second_t{reader.ReadDouble()};
+      state.acceleration =
+          units::meters_per_second_squared_t{reader.ReadDouble()};
+      auto x = units::meter_t{reader.ReadDouble()};
+      auto y = units::meter_t{reader.ReadDouble()};
+      auto heading = units::radian_t{reader.ReadDouble()};
+      state.pose = Pose2d{x, y, heading};
+      state.curvature = units::curvature_t{reader.ReadDouble()};
+    }
+    // Trajectory's constructor rejects empty states, but a default-constructed
+    // trajectory has none
+    if (states.empty()) {
+      trajectories.emplace_back();
+    } else {
+      trajectories.emplace_back(states);
+    }
+  }
+
+  if (reader.Remaining() != 0) {
+    return std::nullopt;
+  }
+  return trajectories;
+}
+
+std::vector<Trajectory> TrajectoryUtil::GenerateTrajectoriesCached(
+    std::span<const TrajectoryGenerator::Request> requests,
+    std::string_view path) {
+  uint64_t key = HashTrajectoryRequests(requests);
+
+  if (auto fileBuffer = wpi::MemoryBuffer::GetFile(path)) {
+    auto trajectories =
+        DeserializeTrajectoriesBinary(fileBuffer.value()->GetBuffer(), key);
+    if (trajectories && trajectories->size() == requests.size()) {
+      return std::move(*trajectories);
+    }
+  }
+
+  auto trajectories = TrajectoryGenerator::GenerateTrajectories(requests);
+
+  // Write to a temporary file first, so an interrupted write can't leave a
+  // truncated cache file behind
+  auto tmpPath = fmt::format("{}.tmp", path);
+  std::error_code error_code;
+  wpi::raw_fd_ostream output{tmpPath, error_code};
+  if (error_code) {
+    wpi::math::MathSharedStore::ReportWarning(
+        "Cannot write trajectory cache file: {}", path);
+    return trajectories;
+  }
+  auto data = SerializeTrajectoriesBinary(trajectories, key);
+  output.write(data.data(), data.size());
+  output.close();
+  if (output.has_error()) {
+    output.clear_error();
+    fs::remove(tmpPath, error_code);
+    wpi::math::MathSharedStore::ReportWarning(
+        "Cannot write trajectory cache file: {}", path);
+    return trajectories;
+  }
+
+  fs::rename(tmpPath, path, error_code);
+  if (error_code) {
+    fs::remove(tmpPath, error_code);
+    wpi::math::MathSharedStore::ReportWarning(
+        "Cannot replace trajectory cache file: {}", path);
+  }
+
+  return trajectories;
+}
@@ -0,0 +1,235 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <optional>
+
+#include <Eigen/Core>
+#include <wpi/SymbolExports.h>
+#include <wpi/array.h>
+
+#include "frc/EigenCore.h"
+#include "frc/geometry/Pose3d.h"
+#include "frc/geometry/Quaternion.h"
+#include "frc/interpolation/TimeInterpolatableBuffer.h"
+#include "frc/kinematics/ChassisSpeeds.h"
+#include "units/time.h"
+
+namespace frc {
+
+/**
+ * This class fuses IMU, wheel odometry, and latency-compensated vision
+ * measurements into a full 3D pose estimate with an error-state (also known as
+ * multiplicative) extended Kalman filter.
+ *
+ * Unlike PoseEstimator3d, which applies a fixed gain to each axis of the vision
+ * pose, this class tracks the full covariance of position, velocity,
+ * orientation, and the gyro and accelerometer biases, so each measurement
+ * corrects every state it's correlated with. The orientation is kept as a
+ * quaternion, and the filter estimates a small rotation error around it, which
+ * avoids the singularities and normalization problems of filtering a
+ * quaternion or Euler angles directly.
+ *
+ * The IMU is assumed to be at the robot's origin and aligned with its axes.
+ *
+ * AddImuMeasurement() should be called for every IMU sample; it predicts the
+ * state forward to the sample's timestamp.
+ *
+ * AddOdometryMeasurement() corrects the estimate with the chassis velocity
+ * measured by the wheels, and can be called at any rate.
+ *
+ * AddVisionMeasurement() can be called as infrequently as you want, for any
+ * number of cameras.
+ *
+ * All of the filter's matrices are fixed size, so updates don't allocate
+ * memory once the pose history has grown to its steady-state size.
+ *
+ * For more on the underlying math, read "Quaternion kinematics for the
+ * error-state Kalman filter" by Joan Solà, https://arxiv.org/abs/1711.02508.
+ */
+class WPILIB_DLLEXPORT InertialPoseEstimator3d {
+ public:
+  /**
+   * Constructs an InertialPoseEstimator3d.
+   *
+   * @param imuStdDevs Standard deviations of the IMU (gyro noise density in
+   *     rad/s/√Hz, gyro bias random walk in rad/s²/√Hz, accelerometer noise
+   *     density in m/s²/√Hz, and accelerometer bias random walk in m/s³/√Hz).
+   *     These can usually be found in the IMU's datasheet.
+   * @param odometryMeasurementStdDevs Standard deviations of the chassis
+   *     velocity measured by the wheels (x velocity in m/s, y velocity in m/s,
+   *     and z velocity in m/s). The wheels can't measure z velocity, so it's
+   *     measured as zero; increase its standard deviation if the robot drives
+   *     over uneven ground.
+   * @param visionMeasurementStdDevs Standard deviations of the vision pose
+   *     measurement (x position in meters, y position in meters, z position in
+   *     meters, and angle in radians). Increase these numbers to trust the
+   *     vision pose measurement less.
+   */
+  InertialPoseEstimator3d(
+      const wpi::array<double, 4>& imuStdDevs,
+      const wpi::array<double, 3>& odometryMeasurementStdDevs,
+      const wpi::array<double, 4>& visionMeasurementStdDevs);
+
+  /**
+   * Sets the pose estimator's trust in vision measurements. This might be used
+   * to change trust in vision measurements after the autonomous period, or to
+   * change trust as distance to a vision target increases.
+   *
+   * @param visionMeasurementStdDevs Standard deviations of the vision pose
+   *     measurement (x position in meters, y position in meters, z position in
+   *     meters, and angle in radians). Increase these numbers to trust the
+   *     vision pose measurement less.
+   */
+  void SetVisionMeasurementStdDevs(
+      const wpi::array<double, 4>& visionMeasurementStdDevs);
+
+  /**
+   * Resets the robot's pose. The velocity and IMU bias estimates are kept.
+   *
+   * @param pose The pose to reset to.
+   */
+  void ResetPose(const Pose3d& pose);
+
+  /**
+   * Gets the estimated robot pose.
+   *
+   * @return The estimated robot pose in meters.
+   */
+  Pose3d GetEstimatedPosition() const;
+
+  /**
+   * Gets the estimated robot velocity in the field frame.
+   *
+   * @return The estimated robot velocity in meters per second.
+   */
+  Eigen::Vector3d GetEstimatedVelocity() const { return m_velocity; }
+
+  /**
+   * Gets the estimated gyro bias, which has already been subtracted from the
+   * angular velocity measurements.
+   *
+   * @return The estimated gyro bias in radians per second.
+   */
+  Eigen::Vector3d GetGyroBias() const { return m_gyroBias; }
+
+  /**
+   * Gets the estimated accelerometer bias, which has already been subtracted
+   * from the acceleration measurements.
+   *
+   * @return The estimated accelerometer bias in meters per second squared.
+   */
+  Eigen::Vector3d GetAccelerometerBias() const { return m_accelBias; }
+
+  /**
+   * Returns the error covariance matrix P. The error states are position,
+   * velocity, rotation error, gyro bias, and accelerometer bias; each has x, y,
+   * and z components. The rotation error is in the robot's frame.
+   */
+  const Matrixd<15, 15>& P() const { return m_P; }
+
+  /**
+   * Predicts the state forward to the time of an IMU sample, using the sample's
+   * measurements. The first sample only records its timestamp.
+   *
+   * @param timestamp The timestamp of the IMU sample.
+   * @param angularVelocity The angular velocity measured by the gyro in the
+   *     robot's frame in radians per second.
+   * @param acceleration The specific force measured by the accelerometer in the
+   *     robot's frame in meters per second squared. This includes gravity, so
+   *     an IMU at rest measures 9.81 m/s² upward.
+   */
+  void AddImuMeasurement(units::second_t timestamp,
+                         const Eigen::Vector3d& angularVelocity,
+                         const Eigen::Vector3d& acceleration);
+
+  /**
+   * Corrects the estimate with the chassis velocity measured by the wheels,
+   * e.g. from Kinematics::ToChassisSpeeds(). The angular velocity is ignored,
+   * since the gyro measures it directly.
+   *
+   * @param speeds The robot-relative chassis velocity.
+   */
+  void AddOdometryMeasurement(const ChassisSpeeds& speeds);
+
+  /**
+   * Adds a vision measurement to the Kalman Filter. This will correct the pose
+   * estimate while still accounting for measurement noise.
+   *
+   * The measurement is moved forward to the current time using the motion the
+   * IMU measured since the timestamp, so measurements from several cameras can
+   * be added in any order.
+   *
+   * @param visionRobotPose The pose of the robot as measured by the vision
+   *     camera.
+   * @param timestamp The timestamp of the vision measurement in seconds, in the
+   *     same time base as the IMU timestamps.
+   */
+  void AddVisionMeasurement(const Pose3d& visionRobotPose,
+                            units::second_t timestamp);
+
+  /**
+   * Adds a vision measurement to the Kalman Filter. This will correct the pose
+   * estimate while still accounting for measurement noise.
+   *
+   * Note that the vision measurement standard deviations passed into this
+   * method will continue to apply to future measurements until a subsequent
+   * call to SetVisionMeasurementStdDevs() or this method.
+   *
+   * @param visionRobotPose The pose of the robot as measured by the vision
+   *     camera.
+   * @param timestamp The timestamp of the vision measurement in seconds, in the
+   *     same time base as the IMU timestamps.
+   * @param visionMeasurementStdDevs Standard deviations of the vision pose
+   *     measurement (x position in meters, y position in meters, z position in
+   *     meters, and angle in radians). Increase these numbers to trust the
+   *     vision pose measurement less.
+   */
+  void AddVisionMeasurement(
+      const Pose3d& visionRobotPose, units::second_t timestamp,
+      const wpi::array<double, 4>& visionMeasurementStdDevs);
+
+ private:
+  /**
+   * Corrects the error state with a measurement residual, then moves the
+   * correction into the nominal state.
+   *
+   * @param residual The measurement minus the measurement predicted by the
+   *     nominal state.
+   * @param H The Jacobian of the measurement with respect to the error state.
+   * @param R The measurement noise covariance matrix.
+   */
+  template <int Rows>
+  void Correct(const Vectord<Rows>& residual, const Matrixd<Rows, 15>& H,
+               const Matrixd<Rows, Rows>& R);
+
+  static constexpr units::second_t kBufferDuration = 1.5_s;
+
+  // Continuous process noise covariance
+  Matrixd<15, 15> m_contQ = Matrixd<15, 15>::Zero();
+  Matrixd<3, 3> m_odometryR = Matrixd<3, 3>::Zero();
+  Matrixd<6, 6> m_visionR = Matrixd<6, 6>::Zero();
+
+  // Nominal state
+  Eigen::Vector3d m_position = Eigen::Vector3d::Zero();
+  Eigen::Vector3d m_velocity = Eigen::Vector3d::Zero();
+  Quaternion m_orientation;
+  Eigen::Vector3d m_gyroBias = Eigen::Vector3d::Zero();
+  Eigen::Vector3d m_accelBias = Eigen::Vector3d::Zero();
+
+  // Error state covariance
+  Matrixd<15, 15> m_P = Matrixd<15, 15>::Zero();
+
+  // Timestamp of the last IMU sample
+  std::optional<units::second_t> m_lastImuTimestamp;
+
+  // The pose integrated from IMU measurements only. Vision measurements are
+  // moved forward in time by the motion between samples of this pose.
+  Pose3d m_imuPose;
+  // Maps timestamps to IMU-only poses
+  TimeInterpolatableBuffer<Pose3d> m_imuPoseBuffer{kBufferDuration};
+};
+
+}  // namespace frc
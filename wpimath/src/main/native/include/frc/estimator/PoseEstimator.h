@@ -4,8 +4,12 @@
 
 #pragma once
 
-#include <map>
+#include <stddef.h>
+
+#include <algorithm>
 #include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 #include <Eigen/Core>
@@ -42,6 +46,29 @@ namespace frc {
 template <typename WheelSpeeds, typename WheelPositions>
 class WPILIB_DLLEXPORT PoseEstimator {
  public:
+  /**
+   * A vision measurement, for adding several measurements at once with
+   * AddVisionMeasurements().
+   */
+  struct VisionMeasurement {
+    /** The pose of the robot as measured by the vision camera. */
+    Pose2d pose;
+
+    /**
+     * The timestamp of the vision measurement in seconds (see
+     * AddVisionMeasurement() for the epoch).
+     */
+    units::second_t timestamp;
+
+    /**
+     * Standard deviations of the vision pose measurement (x position in
+     * meters, y position in meters, and heading in radians). If not set, the
+     * standard deviations set by SetVisionMeasurementStdDevs() are used. Unlike
+     * AddVisionMeasurement(), these only apply to this measurement.
+     */
+    std::optional<wpi::array<double, 3>> stdDevs;
+  };
+
   /**
    * Constructs a PoseEstimator.
    *
@@ -83,21 +110,7 @@ class WPILIB_DLLEXPORT PoseEstimator {
    */
   void SetVisionMeasurementStdDevs(
       const wpi::array<double, 3>& visionMeasurementStdDevs) {
-    wpi::array<double, 3> r{wpi::empty_array};
-    for (size_t i = 0; i < 3; ++i) {
-      r[i] = visionMeasurementStdDevs[i] * visionMeasurementStdDevs[i];
-    }
-
-    // Solve for closed form Kalman gain for continuous Kalman filter with A = 0
-    // and C = I. See wpimath/algorithms.md.
-    for (size_t row = 0; row < 3; ++row) {
-      if (m_q[row] == 0.0) {
-        m_visionK(row, row) = 0.0;
-      } else {
-        m_visionK(row, row) =
-            m_q[row] / (m_q[row] + std::sqrt(m_q[row] * r[row]));
-      }
-    }
+    m_visionK = CalculateVisionK(visionMeasurementStdDevs);
   }
 
   /**
@@ -170,45 +183,16 @@ class WPILIB_DLLEXPORT PoseEstimator {
    * empty).
    */
   std::optional<Pose2d> SampleAt(units::second_t timestamp) const {
-    // Step 0: If there are no odometry updates to sample, skip.
-    if (m_odometryPoseBuffer.GetInternalBuffer().empty()) {
+    // Step 0: Get the pose measured by odometry at the time of the sample. If
+    // there are no odometry updates to sample, skip.
+    auto odometryEstimate = m_odometryPoseBuffer.Sample(timestamp);
+    if (!odometryEstimate) {
       return std::nullopt;
     }
 
-    // Step 1: Make sure timestamp matches the sample from the odometry pose
-    // buffer. (When sampling, the buffer will always use a timestamp
-    // between the first and last timestamps)
-    units::second_t oldestOdometryTimestamp =
-        m_odometryPoseBuffer.GetInternalBuffer().front().first;
-    units::second_t newestOdometryTimestamp =
-        m_odometryPoseBuffer.GetInternalBuffer().back().first;
-    timestamp =
-        std::clamp(timestamp, oldestOdometryTimestamp, newestOdometryTimestamp);
-
-    // Step 2: If there are no applicable vision updates, use the odometry-only
-    // information.
-    if (m_visionUpdates.empty() || timestamp < m_visionUpdates.begin()->first) {
-      return m_odometryPoseBuffer.Sample(timestamp);
-    }
-
-    // Step 3: Get the latest vision update from before or at the timestamp to
-    // sample at.
-    // First, find the iterator past the sample timestamp, then go back one.
-    // Note that upper_bound() won't return begin() because we check begin()
-    // earlier.
-    auto floorIter = m_visionUpdates.upper_bound(timestamp);
-    --floorIter;
-    auto visionUpdate = floorIter->second;
-
-    // Step 4: Get the pose measured by odometry at the time of the sample.
-    auto odometryEstimate = m_odometryPoseBuffer.Sample(timestamp);
-
-    // Step 5: Apply the vision compensation to the odometry pose.
-    // TODO Replace with std::optional::transform() in C++23
-    if (odometryEstimate) {
-      return visionUpdate.Compensate(*odometryEstimate);
-    }
-    return std::nullopt;
+    // Step 1: Apply the latest vision update from before or at the timestamp
+    // to the odometry pose.
+    return CompensateAt(timestamp, *odometryEstimate);
   }
 
   /**
@@ -235,9 +219,8 @@ class WPILIB_DLLEXPORT PoseEstimator {
                             units::second_t timestamp) {
     // Step 0: If this measurement is old enough to be outside the pose buffer's
     // timespan, skip.
-    if (m_odometryPoseBuffer.GetInternalBuffer().empty() ||
-        m_odometryPoseBuffer.GetInternalBuffer().front().first -
-                kBufferDuration >
+    if (m_odometryPoseBuffer.GetSampleBuffer().empty() ||
+        m_odometryPoseBuffer.GetSampleBuffer().front().first - kBufferDuration >
             timestamp) {
       return;
     }
@@ -253,41 +236,14 @@ class WPILIB_DLLEXPORT PoseEstimator {
       return;
     }
 
-    // Step 3: Get the vision-compensated pose estimate at the moment the vision
-    // measurement was made.
-    auto visionSample = SampleAt(timestamp);
+    // Step 3: Record the vision update.
+    ApplyVisionMeasurement(visionRobotPose, timestamp, *odometrySample,
+                           m_visionK);
 
-    if (!visionSample) {
-      return;
-    }
-
-    // Step 4: Measure the twist between the old pose estimate and the vision
-    // pose.
-    auto twist = visionSample.value().Log(visionRobotPose);
-
-    // Step 5: We should not trust the twist entirely, so instead we scale this
-    // twist by a Kalman gain matrix representing how much we trust vision
-    // measurements compared to our current pose.
-    Eigen::Vector3d k_times_twist =
-        m_visionK * Eigen::Vector3d{twist.dx.value(), twist.dy.value(),
-                                    twist.dtheta.value()};
-
-    // Step 6: Convert back to Twist2d.
-    Twist2d scaledTwist{units::meter_t{k_times_twist(0)},
-                        units::meter_t{k_times_twist(1)},
-                        units::radian_t{k_times_twist(2)}};
-
-    // Step 7: Calculate and record the vision update.
-    VisionUpdate visionUpdate{visionSample->Exp(scaledTwist), *odometrySample};
-    m_visionUpdates[timestamp] = visionUpdate;
-
-    // Step 8: Remove later vision measurements. (Matches previous behavior)
-    auto firstAfter = m_visionUpdates.upper_bound(timestamp);
-    m_visionUpdates.erase(firstAfter, m_visionUpdates.end());
-
-    // Step 9: Update latest pose estimate. Since we cleared all updates after
+    // Step 4: Update latest pose estimate. Since we cleared all updates after
     // this vision update, it's guaranteed to be the latest vision update.
-    m_poseEstimate = visionUpdate.Compensate(m_odometry.GetPose());
+    m_poseEstimate =
+        m_visionUpdates.back().second.Compensate(m_odometry.GetPose());
   }
 
   /**
@@ -325,6 +281,68 @@ class WPILIB_DLLEXPORT PoseEstimator {
     AddVisionMeasurement(visionRobotPose, timestamp);
   }
 
+  /**
+   * Adds several vision measurements (e.g. from multiple cameras) to the
+   * Kalman Filter. This has the same result as calling AddVisionMeasurement()
+   * for each measurement in timestamp order, but is faster: the odometry
+   * history is sampled in a single pass, and the latest pose estimate is only
+   * updated once.
+   *
+   * @param measurements The vision measurements, in any order. Measurements
+   *     with the same timestamp are applied in the order given.
+   */
+  void AddVisionMeasurements(std::span<const VisionMeasurement> measurements) {
+    // Step 0: If there are no odometry samples, skip.
+    auto odometryBuffer = m_odometryPoseBuffer.GetSampleBuffer();
+    if (odometryBuffer.empty()) {
+      return;
+    }
+
+    // Step 1: Sort the measurements by timestamp, skipping those old enough
+    // to be outside the pose buffer's timespan.
+    units::second_t oldestTimestamp =
+        odometryBuffer.front().first - kBufferDuration;
+    m_batchOrder.clear();
+    for (size_t i = 0; i < measurements.size(); ++i) {
+      if (measurements[i].timestamp >= oldestTimestamp) {
+        m_batchOrder.emplace_back(i);
+      }
+    }
+    if (m_batchOrder.empty()) {
+      return;
+    }
+    std::stable_sort(m_batchOrder.begin(), m_batchOrder.end(),
+                     [&](size_t a, size_t b) {
+                       return measurements[a].timestamp <
+                              measurements[b].timestamp;
+                     });
+
+    // Step 2: Clean up any old entries
+    CleanUpVisionUpdates();
+
+    // Step 3: Get the poses measured by odometry at the moments the vision
+    // measurements were made.
+    m_batchTimes.clear();
+    for (size_t i : m_batchOrder) {
+      m_batchTimes.emplace_back(measurements[i].timestamp);
+    }
+    m_batchOdometryPoses.resize(m_batchOrder.size());
+    m_odometryPoseBuffer.Sample(m_batchTimes, m_batchOdometryPoses);
+
+    // Step 4: Record the vision updates in order.
+    for (size_t i = 0; i < m_batchOrder.size(); ++i) {
+      auto& measurement = measurements[m_batchOrder[i]];
+      ApplyVisionMeasurement(
+          measurement.pose, measurement.timestamp, m_batchOdometryPoses[i],
+          measurement.stdDevs ? CalculateVisionK(*measurement.stdDevs)
+                              : m_visionK);
+    }
+
+    // Step 5: Update latest pose estimate.
+    m_poseEstimate =
+        m_visionUpdates.back().second.Compensate(m_odometry.GetPose());
+  }
+
   /**
    * Updates the pose estimator with wheel encoder and gyro information. This
    * should be called every loop.
@@ -360,7 +378,7 @@ class WPILIB_DLLEXPORT PoseEstimator {
     if (m_visionUpdates.empty()) {
       m_poseEstimate = odometryEstimate;
     } else {
-      auto visionUpdate = m_visionUpdates.rbegin()->second;
+      auto& visionUpdate = m_visionUpdates.back().second;
       m_poseEstimate = visionUpdate.Compensate(odometryEstimate);
     }
 
@@ -373,13 +391,13 @@ class WPILIB_DLLEXPORT PoseEstimator {
    */
   void CleanUpVisionUpdates() {
     // Step 0: If there are no odometry samples, skip.
-    if (m_odometryPoseBuffer.GetInternalBuffer().empty()) {
+    if (m_odometryPoseBuffer.GetSampleBuffer().empty()) {
       return;
     }
 
     // Step 1: Find the oldest timestamp that needs a vision update.
     units::second_t oldestOdometryTimestamp =
-        m_odometryPoseBuffer.GetInternalBuffer().front().first;
+        m_odometryPoseBuffer.GetSampleBuffer().front().first;
 
     // Step 2: If there are no vision updates before that timestamp, skip.
     if (m_visionUpdates.empty() ||
@@ -393,13 +411,115 @@ class WPILIB_DLLEXPORT PoseEstimator {
     // back one. Note that upper_bound() won't return begin() because we check
     // begin() earlier.
     auto newestNeededVisionUpdate =
-        m_visionUpdates.upper_bound(oldestOdometryTimestamp);
+        UpperBoundVisionUpdate(oldestOdometryTimestamp);
     --newestNeededVisionUpdate;
 
     // Step 4: Remove all entries strictly before the newest timestamp we need.
     m_visionUpdates.erase(m_visionUpdates.begin(), newestNeededVisionUpdate);
   }
 
+  /**
+   * Calculates the Kalman gain for vision measurements.
+   *
+   * @param visionMeasurementStdDevs Standard deviations of the vision pose
+   *     measurement.
+   */
+  Eigen::Matrix3d CalculateVisionK(
+      const wpi::array<double, 3>& visionMeasurementStdDevs) const {
+    wpi::array<double, 3> r{wpi::empty_array};
+    for (size_t i = 0; i < 3; ++i) {
+      r[i] = visionMeasurementStdDevs[i] * visionMeasurementStdDevs[i];
+    }
+
+    // Solve for closed form Kalman gain for continuous Kalman filter with A = 0
+    // and C = I. See wpimath/algorithms.md.
+    Eigen::Matrix3d visionK = Eigen::Matrix3d::Zero();
+    for (size_t row = 0; row < 3; ++row) {
+      if (m_q[row] == 0.0) {
+        visionK(row, row) = 0.0;
+      } else {
+        visionK(row, row) =
+            m_q[row] / (m_q[row] + std::sqrt(m_q[row] * r[row]));
+      }
+    }
+    return visionK;
+  }
+
+  /**
+   * Records the vision update for a vision measurement, removing any later
+   * vision updates.
+   *
+   * @param visionRobotPose The pose of the robot as measured by the vision
+   *     camera.
+   * @param timestamp The timestamp of the vision measurement.
+   * @param odometrySample The odometry pose at the timestamp.
+   * @param visionK The Kalman gain for the measurement.
+   */
+  void ApplyVisionMeasurement(const Pose2d& visionRobotPose,
+                              units::second_t timestamp,
+                              const Pose2d& odometrySample,
+                              const Eigen::Matrix3d& visionK) {
+    // Step 1: Get the vision-compensated pose estimate at the moment the vision
+    // measurement was made.
+    Pose2d visionSample = CompensateAt(timestamp, odometrySample);
+
+    // Step 2: Measure the twist between the old pose estimate and the vision
+    // pose.
+    auto twist = visionSample.Log(visionRobotPose);
+
+    // Step 3: We should not trust the twist entirely, so instead we scale this
+    // twist by a Kalman gain matrix representing how much we trust vision
+    // measurements compared to our current pose.
+    Eigen::Vector3d k_times_twist =
+        visionK * Eigen::Vector3d{twist.dx.value(), twist.dy.value(),
+                                  twist.dtheta.value()};
+
+    // Step 4: Convert back to Twist2d.
+    Twist2d scaledTwist{units::meter_t{k_times_twist(0)},
+                        units::meter_t{k_times_twist(1)},
+                        units::radian_t{k_times_twist(2)}};
+
+    // Step 5: Record the vision update, replacing any update with the same
+    // timestamp and removing later vision updates. (Matches previous behavior)
+    auto firstNotBefore = std::lower_bound(
+        m_visionUpdates.begin(), m_visionUpdates.end(), timestamp,
+        [](const auto& update, auto t) { return update.first < t; });
+    m_visionUpdates.erase(firstNotBefore, m_visionUpdates.end());
+    m_visionUpdates.emplace_back(
+        timestamp, VisionUpdate{visionSample.Exp(scaledTwist), odometrySample});
+  }
+
+  /**
+   * Applies the latest vision update from before or at a timestamp to an
+   * odometry pose. The timestamp is clamped to the odometry pose buffer's
+   * timespan.
+   *
+   * @param timestamp The timestamp.
+   * @param odometryPose The odometry pose at the timestamp.
+   */
+  Pose2d CompensateAt(units::second_t timestamp,
+                      const Pose2d& odometryPose) const {
+    // Step 0: Make sure timestamp matches the sample from the odometry pose
+    // buffer. (When sampling, the buffer will always use a timestamp
+    // between the first and last timestamps)
+    auto odometryBuffer = m_odometryPoseBuffer.GetSampleBuffer();
+    if (odometryBuffer.size() > 0) {
+      timestamp = std::clamp(timestamp, odometryBuffer.front().first,
+                             odometryBuffer.back().first);
+    }
+
+    // Step 1: If there are no applicable vision updates, use the odometry-only
+    // information.
+    auto floorIter = UpperBoundVisionUpdate(timestamp);
+    if (floorIter == m_visionUpdates.begin()) {
+      return odometryPose;
+    }
+
+    // Step 2: Apply the latest vision update from before or at the timestamp.
+    --floorIter;
+    return floorIter->second.Compensate(odometryPose);
+  }
+
   struct VisionUpdate {
     // The vision-compensated pose estimate
     Pose2d visionPose;
@@ -421,6 +541,27 @@ class WPILIB_DLLEXPORT PoseEstimator {
     }
   };
 
+  using VisionUpdates = std::vector<std::pair<units::second_t, VisionUpdate>>;
+
+  /**
+   * Returns the first vision update after a timestamp.
+   *
+   * @param timestamp The timestamp.
+   */
+  typename VisionUpdates::iterator UpperBoundVisionUpdate(
+      units::second_t timestamp) {
+    return std::upper_bound(
+        m_visionUpdates.begin(), m_visionUpdates.end(), timestamp,
+        [](auto t, const auto& update) { return t < update.first; });
+  }
+
+  typename VisionUpdates::const_iterator UpperBoundVisionUpdate(
+      units::second_t timestamp) const {
+    return std::upper_bound(
+        m_visionUpdates.begin(), m_visionUpdates.end(), timestamp,
+        [](auto t, const auto& update) { return t < update.first; });
+  }
+
   static constexpr units::second_t kBufferDuration = 1.5_s;
 
   Odometry<WheelSpeeds, WheelPositions>& m_odometry;
@@ -429,10 +570,15 @@ class WPILIB_DLLEXPORT PoseEstimator {
 
   // Maps timestamps to odometry-only pose estimates
   TimeInterpolatableBuffer<Pose2d> m_odometryPoseBuffer{kBufferDuration};
-  // Maps timestamps to vision updates
+  // Vision updates, sorted by timestamp
   // Always contains one entry before the oldest entry in m_odometryPoseBuffer,
   // unless there have been no vision measurements after the last reset
-  std::map<units::second_t, VisionUpdate> m_visionUpdates;
+  VisionUpdates m_visionUpdates;
+
+  // Scratch space for AddVisionMeasurements()
+  std::vector<size_t> m_batchOrder;
+  std::vector<units::second_t> m_batchTimes;
+  std::vector<Pose2d> m_batchOdometryPoses;
 
   Pose2d m_poseEstimate;
 };
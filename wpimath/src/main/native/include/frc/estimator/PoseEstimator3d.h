@@ -180,7 +180,7 @@ class WPILIB_DLLEXPORT PoseEstimator3d {
    */
   std::optional<Pose3d> SampleAt(units::second_t timestamp) const {
     // Step 0: If there are no odometry updates to sample, skip.
-    if (m_odometryPoseBuffer.GetInternalBuffer().empty()) {
+    if (m_odometryPoseBuffer.GetSampleBuffer().empty()) {
       return std::nullopt;
     }
 
@@ -188,9 +188,9 @@ class WPILIB_DLLEXPORT PoseEstimator3d {
     // buffer. (When sampling, the buffer will always use a timestamp
     // between the first and last timestamps)
     units::second_t oldestOdometryTimestamp =
-        m_odometryPoseBuffer.GetInternalBuffer().front().first;
+        m_odometryPoseBuffer.GetSampleBuffer().front().first;
     units::second_t newestOdometryTimestamp =
-        m_odometryPoseBuffer.GetInternalBuffer().back().first;
+        m_odometryPoseBuffer.GetSampleBuffer().back().first;
     timestamp =
         std::clamp(timestamp, oldestOdometryTimestamp, newestOdometryTimestamp);
 
@@ -244,9 +244,8 @@ class WPILIB_DLLEXPORT PoseEstimator3d {
                             units::second_t timestamp) {
     // Step 0: If this measurement is old enough to be outside the pose buffer's
     // timespan, skip.
-    if (m_odometryPoseBuffer.GetInternalBuffer().empty() ||
-        m_odometryPoseBuffer.GetInternalBuffer().front().first -
-                kBufferDuration >
+    if (m_odometryPoseBuffer.GetSampleBuffer().empty() ||
+        m_odometryPoseBuffer.GetSampleBuffer().front().first - kBufferDuration >
             timestamp) {
       return;
     }
@@ -384,13 +383,13 @@ class WPILIB_DLLEXPORT PoseEstimator3d {
    */
   void CleanUpVisionUpdates() {
     // Step 0: If there are no odometry samples, skip.
-    if (m_odometryPoseBuffer.GetInternalBuffer().empty()) {
+    if (m_odometryPoseBuffer.GetSampleBuffer().empty()) {
       return;
     }
 
     // Step 1: Find the oldest timestamp that needs a vision update.
     units::second_t oldestOdometryTimestamp =
-        m_odometryPoseBuffer.GetInternalBuffer().front().first;
+        m_odometryPoseBuffer.GetSampleBuffer().front().first;
 
     // Step 2: If there are no vision updates before that timestamp, skip.
     if (m_visionUpdates.empty() ||
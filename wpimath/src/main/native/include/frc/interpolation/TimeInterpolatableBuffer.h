@@ -4,9 +4,13 @@
 
 #pragma once
 
+#include <stddef.h>
+
 #include <algorithm>
+#include <concepts>
 #include <functional>
 #include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -18,6 +22,56 @@
 
 namespace frc {
 
+namespace detail {
+
+/**
+ * The default interpolation function for TimeInterpolatableBuffer, which uses
+ * wpi::Lerp.
+ */
+template <typename T>
+struct TimeInterpolatableBufferLerp {
+  T operator()(const T& start, const T& end, double t) const {
+    return wpi::Lerp(start, end, t);
+  }
+};
+
+/**
+ * Pose2ds are interpolated with the pose exponential.
+ */
+template <>
+struct TimeInterpolatableBufferLerp<Pose2d> {
+  Pose2d operator()(const Pose2d& start, const Pose2d& end, double t) const {
+    if (t < 0) {
+      return start;
+    } else if (t >= 1) {
+      return end;
+    } else {
+      Twist2d twist = start.Log(end);
+      Twist2d scaledTwist = twist * t;
+      return start.Exp(scaledTwist);
+    }
+  }
+};
+
+/**
+ * The default interpolator for TimeInterpolatableBuffer. Uses
+ * TimeInterpolatableBufferLerp unless it was given a function by the
+ * deprecated std::function constructor.
+ */
+template <typename T>
+struct TimeInterpolatableBufferDefault {
+  std::function<T(const T&, const T&, double)> func;
+
+  T operator()(const T& start, const T& end, double t) const {
+    if (func) {
+      return func(start, end, t);
+    }
+    return TimeInterpolatableBufferLerp<T>{}(start, end, t);
+  }
+};
+
+}  // namespace detail
+
 /**
  * The TimeInterpolatableBuffer provides an easy way to estimate past
  * measurements. One application might be in conjunction with the
@@ -28,32 +82,43 @@ namespace frc {
  * When sampling this buffer, a user-provided function or wpi::Lerp can be
  * used. For Pose2ds, we use Twists.
  *
+ * Samples are kept in time order in a vector, and old samples are removed
+ * from the front in batches, so adding samples in time order and discarding
+ * old samples take amortized constant time. Once the vector has grown to hold
+ * the history, adding samples doesn't allocate memory.
+ *
  * @tparam T The type stored in this buffer.
+ * @tparam Interpolator The type of the function used to interpolate between
+ *   values; callable as T(const T& start, const T& end, double t). To use a
+ *   lambda, use decltype.
  */
-template <typename T>
+template <typename T,
+          typename Interpolator = detail::TimeInterpolatableBufferDefault<T>>
 class TimeInterpolatableBuffer {
  public:
   /**
-   * Create a new TimeInterpolatableBuffer.
+   * Create a new TimeInterpolatableBuffer. By default, the interpolation
+   * function is wpi::Lerp except for Pose2d, which uses the pose exponential.
    *
    * @param historySize  The history size of the buffer.
    * @param func The function used to interpolate between values.
    */
-  TimeInterpolatableBuffer(units::second_t historySize,
-                           std::function<T(const T&, const T&, double)> func)
-      : m_historySize(historySize), m_interpolatingFunc(func) {}
+  explicit TimeInterpolatableBuffer(units::second_t historySize,
+                                    Interpolator func = {})
+      : m_historySize(historySize), m_interpolatingFunc(std::move(func)) {}
 
   /**
-   * Create a new TimeInterpolatableBuffer. By default, the interpolation
-   * function is wpi::Lerp except for Pose2d, which uses the pose exponential.
+   * Create a new TimeInterpolatableBuffer.
    *
    * @param historySize  The history size of the buffer.
+   * @param func The function used to interpolate between values.
    */
-  explicit TimeInterpolatableBuffer(units::second_t historySize)
-      : m_historySize(historySize),
-        m_interpolatingFunc([](const T& start, const T& end, double t) {
-          return wpi::Lerp(start, end, t);
-        }) {}
+  [[deprecated("Use the Interpolator template parameter instead.")]]
+  TimeInterpolatableBuffer(units::second_t historySize,
+                           std::function<T(const T&, const T&, double)> func)
+    requires std::same_as<Interpolator,
+                          detail::TimeInterpolatableBufferDefault<T>>
+      : m_historySize(historySize), m_interpolatingFunc{std::move(func)} {}
 
   /**
    * Add a sample to the buffer.
@@ -62,35 +127,37 @@ class TimeInterpolatableBuffer {
    * @param sample The sample object.
    */
   void AddSample(units::second_t time, T sample) {
-    // Add the new state into the vector
-    if (m_pastSnapshots.size() == 0 || time > m_pastSnapshots.back().first) {
-      m_pastSnapshots.emplace_back(time, sample);
+    // Remove samples that are too old. Their slots are only reclaimed by
+    // Compact(), so move the samples out to release what they hold now.
+    while (m_front < m_samples.size() &&
+           time - m_samples[m_front].first > m_historySize) {
+      [[maybe_unused]] T removed = std::move(m_samples[m_front].second);
+      ++m_front;
+    }
+    Compact();
+
+    // Add the new state into the buffer
+    if (m_front == m_samples.size() || time > m_samples.back().first) {
+      m_samples.emplace_back(time, std::move(sample));
     } else {
-      auto first_after = std::upper_bound(
-          m_pastSnapshots.begin(), m_pastSnapshots.end(), time,
+      auto firstAfter = std::upper_bound(
+          m_samples.begin() + m_front, m_samples.end(), time,
           [](auto t, const auto& pair) { return t < pair.first; });
-
-      if (first_after == m_pastSnapshots.begin()) {
-        // All entries come after the sample
-        m_pastSnapshots.insert(first_after, std::pair{time, sample});
-      } else if (auto last_not_greater_than = first_after - 1;
-                 last_not_greater_than == m_pastSnapshots.begin() ||
-                 last_not_greater_than->first < time) {
-        // Some entries come before the sample, but none are recorded with the
-        // same time
-        m_pastSnapshots.insert(first_after, std::pair{time, sample});
-      } else {
+      if (firstAfter != m_samples.begin() + m_front &&
+          (firstAfter - 1)->first == time) {
         // An entry exists with the same recorded time
-        last_not_greater_than->second = sample;
+        (firstAfter - 1)->second = std::move(sample);
+      } else {
+        m_samples.emplace(firstAfter, time, std::move(sample));
       }
     }
-    while (time - m_pastSnapshots[0].first > m_historySize) {
-      m_pastSnapshots.erase(m_pastSnapshots.begin());
-    }
   }
 
   /** Clear all old samples. */
-  void Clear() { m_pastSnapshots.clear(); }
+  void Clear() {
+    m_samples.clear();
+    m_front = 0;
+  }
 
   /**
    * Sample the buffer at the given time. If the buffer is empty, an empty
@@ -99,77 +166,115 @@ class TimeInterpolatableBuffer {
    * @param time The time at which to sample the buffer.
    */
   std::optional<T> Sample(units::second_t time) const {
-    if (m_pastSnapshots.empty()) {
+    auto snapshots = GetSampleBuffer();
+    if (snapshots.empty()) {
       return {};
     }
 
     // We will perform a binary search to find the index of the element in the
-    // vector that has a timestamp that is equal to or greater than the vision
+    // buffer that has a timestamp that is equal to or greater than the vision
     // measurement timestamp.
 
-    if (time <= m_pastSnapshots.front().first) {
-      return m_pastSnapshots.front().second;
-    }
-    if (time > m_pastSnapshots.back().first) {
-      return m_pastSnapshots.back().second;
+    if (time <= snapshots.front().first) {
+      return snapshots.front().second;
     }
-    if (m_pastSnapshots.size() < 2) {
-      return m_pastSnapshots[0].second;
+    if (time > snapshots.back().first) {
+      return snapshots.back().second;
     }
 
-    // Get the iterator which has a key no less than the requested key.
-    auto upper_bound = std::lower_bound(
-        m_pastSnapshots.begin(), m_pastSnapshots.end(), time,
-        [](const auto& pair, auto t) { return t > pair.first; });
+    // The front is before time and the back is at or after it, so the upper
+    // sample is in [1, size - 1]
+    auto upper = std::lower_bound(
+        snapshots.begin(), snapshots.end(), time,
+        [](const auto& pair, auto t) { return pair.first < t; });
+    return Interpolate(*(upper - 1), *upper, time);
+  }
 
-    if (upper_bound == m_pastSnapshots.begin()) {
-      return upper_bound->second;
+  /**
+   * Sample the buffer at each of the given times, which must be in increasing
+   * order. This is faster than calling Sample() for each time, as the buffer
+   * is searched once for all of the times.
+   *
+   * @param times The times at which to sample the buffer.
+   * @param samples Where to store the sample for each time; must be the same
+   *   size as times.
+   * @return False if the buffer is empty (samples is left unchanged).
+   */
+  bool Sample(std::span<const units::second_t> times,
+              std::span<T> samples) const {
+    auto snapshots = GetSampleBuffer();
+    if (snapshots.empty()) {
+      return false;
     }
+    size_t upper = 0;
+    for (size_t i = 0; i < times.size(); ++i) {
+      units::second_t time = times[i];
+      if (time <= snapshots.front().first) {
+        samples[i] = snapshots.front().second;
+        continue;
+      }
+      if (time > snapshots.back().first) {
+        samples[i] = snapshots.back().second;
+        continue;
+      }
+      // times are increasing, so continue the search from the last time
+      while (snapshots[upper].first < time) {
+        ++upper;
+      }
+      samples[i] = Interpolate(snapshots[upper - 1], snapshots[upper], time);
+    }
+    return true;
+  }
 
-    auto lower_bound = upper_bound - 1;
-
-    double t = ((time - lower_bound->first) /
-                (upper_bound->first - lower_bound->first));
-
-    return m_interpolatingFunc(lower_bound->second, upper_bound->second, t);
+  /**
+   * Grant access to the samples, oldest first. Used in Pose Estimation to
+   * replay odometry inputs stored within this buffer. The span is invalidated
+   * by adding samples.
+   */
+  std::span<std::pair<units::second_t, T>> GetSampleBuffer() {
+    return std::span{m_samples}.subspan(m_front);
   }
 
   /**
-   * Grant access to the internal sample buffer. Used in Pose Estimation to
-   * replay odometry inputs stored within this buffer.
+   * Grant access to the samples, oldest first. The span is invalidated by
+   * adding samples.
    */
-  std::vector<std::pair<units::second_t, T>>& GetInternalBuffer() {
-    return m_pastSnapshots;
+  std::span<const std::pair<units::second_t, T>> GetSampleBuffer() const {
+    return std::span{m_samples}.subspan(m_front);
   }
 
   /**
-   * Grant access to the internal sample buffer.
+   * Returns a copy of the samples, oldest first.
    */
-  const std::vector<std::pair<units::second_t, T>>& GetInternalBuffer() const {
-    return m_pastSnapshots;
+  [[deprecated("Use GetSampleBuffer() instead.")]]
+  const std::vector<std::pair<units::second_t, T>> GetInternalBuffer() const {
+    auto snapshots = GetSampleBuffer();
+    return {snapshots.begin(), snapshots.end()};
   }
 
  private:
+  // Erases the removed samples from the front of the vector once they take up
+  // at least half of it, so each sample is moved at most once on average
+  void Compact() {
+    if (m_front > 0 && m_front >= m_samples.size() - m_front) {
+      m_samples.erase(m_samples.begin(), m_samples.begin() + m_front);
+      m_front = 0;
+    }
+  }
+
+  // Interpolates between two samples
+  T Interpolate(const std::pair<units::second_t, T>& lower,
+                const std::pair<units::second_t, T>& upper,
+                units::second_t time) const {
+    double t = ((time - lower.first) / (upper.first - lower.first));
+    return m_interpolatingFunc(lower.second, upper.second, t);
+  }
+
   units::second_t m_historySize;
-  std::vector<std::pair<units::second_t, T>> m_pastSnapshots;
-  std::function<T(const T&, const T&, double)> m_interpolatingFunc;
+  // Samples in time order; those before m_front have been removed
+  std::vector<std::pair<units::second_t, T>> m_samples;
+  size_t m_front = 0;
+  Interpolator m_interpolatingFunc;
 };
 
-// Template specialization to ensure that Pose2d uses pose exponential
-template <>
-inline TimeInterpolatableBuffer<Pose2d>::TimeInterpolatableBuffer(
-    units::second_t historySize)
-    : m_historySize(historySize),
-      m_interpolatingFunc([](const Pose2d& start, const Pose2d& end, double t) {
-        if (t < 0) {
-          return start;
-        } else if (t >= 1) {
-          return end;
-        } else {
-          Twist2d twist = start.Log(end);
-          Twist2d scaledTwist = twist * t;
-          return start.Exp(scaledTwist);
-        }
-      }) {}
-
 }  // namespace frc
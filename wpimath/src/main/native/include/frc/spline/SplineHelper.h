@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <span>
 #include <vector>
 
 #include <wpi/SymbolExports.h>
@@ -33,6 +34,23 @@ class WPILIB_DLLEXPORT SplineHelper {
   CubicControlVectorsFromWaypoints(
       const Pose2d& start, const std::vector<Translation2d>& interiorWaypoints,
       const Pose2d& end) {
+    return CubicControlVectorsFromWaypoints(
+        start, std::span<const Translation2d>{interiorWaypoints}, end);
+  }
+
+  /**
+   * Returns 2 cubic control vectors from a set of exterior waypoints and
+   * interior translations.
+   *
+   * @param start             The starting pose.
+   * @param interiorWaypoints The interior waypoints.
+   * @param end               The ending pose.
+   * @return 2 cubic control vectors.
+   */
+  static wpi::array<Spline<3>::ControlVector, 2>
+  CubicControlVectorsFromWaypoints(
+      const Pose2d& start, std::span<const Translation2d> interiorWaypoints,
+      const Pose2d& end) {
     double scalar;
     if (interiorWaypoints.empty()) {
       scalar = 1.2 * start.Translation().Distance(end.Translation()).value();
@@ -58,7 +76,22 @@ class WPILIB_DLLEXPORT SplineHelper {
   static std::vector<QuinticHermiteSpline> QuinticSplinesFromWaypoints(
       const std::vector<Pose2d>& waypoints) {
     std::vector<QuinticHermiteSpline> splines;
-    splines.reserve(waypoints.size() - 1);
+    QuinticSplinesFromWaypoints(waypoints, &splines);
+    return splines;
+  }
+
+  /**
+   * Computes quintic splines from a set of waypoints. The vector of splines is
+   * reused, so this doesn't allocate memory once it has grown large enough.
+   *
+   * @param waypoints The waypoints
+   * @param splines Where to store the quintic splines.
+   */
+  static void QuinticSplinesFromWaypoints(
+      std::span<const Pose2d> waypoints,
+      std::vector<QuinticHermiteSpline>* splines) {
+    splines->clear();
+    splines->reserve(waypoints.size() - 1);
     for (size_t i = 0; i < waypoints.size() - 1; ++i) {
       auto& p0 = waypoints[i];
       auto& p1 = waypoints[i + 1];
@@ -69,10 +102,9 @@ class WPILIB_DLLEXPORT SplineHelper {
 
       auto controlVectorA = QuinticControlVector(scalar, p0);
       auto controlVectorB = QuinticControlVector(scalar, p1);
-      splines.emplace_back(controlVectorA.x, controlVectorB.x, controlVectorA.y,
-                           controlVectorB.y);
+      splines->emplace_back(controlVectorA.x, controlVectorB.x,
+                            controlVectorA.y, controlVectorB.y);
     }
-    return splines;
   }
 
   /**
@@ -97,6 +129,34 @@ class WPILIB_DLLEXPORT SplineHelper {
       std::vector<Translation2d> waypoints,
       const Spline<3>::ControlVector& end) {
     std::vector<CubicHermiteSpline> splines;
+    std::vector<double> scratch;
+    CubicSplinesFromControlVectors(start, waypoints, end, &splines, &scratch);
+    return splines;
+  }
+
+  /**
+   * Computes a set of cubic splines corresponding to the provided control
+   * vectors. The user is free to set the direction of the start and end
+   * point. The directions for the middle waypoints are determined
+   * automatically to ensure continuous curvature throughout the path.
+   *
+   * The vectors of splines and intermediate values are reused, so this doesn't
+   * allocate memory once they have grown large enough.
+   *
+   * @param start The starting control vector.
+   * @param waypoints The middle waypoints. This can be left blank if you
+   * only wish to create a path with two waypoints.
+   * @param end The ending control vector.
+   * @param splines Where to store the cubic hermite splines that interpolate
+   * through the provided waypoints.
+   * @param scratch Storage for intermediate values.
+   */
+  static void CubicSplinesFromControlVectors(
+      const Spline<3>::ControlVector& start,
+      std::span<const Translation2d> waypoints,
+      const Spline<3>::ControlVector& end,
+      std::vector<CubicHermiteSpline>* splines, std::vector<double>* scratch) {
+    splines->clear();
 
     wpi::array<double, 2> xInitial = start.x;
     wpi::array<double, 2> yInitial = start.y;
@@ -104,11 +164,26 @@ class WPILIB_DLLEXPORT SplineHelper {
     wpi::array<double, 2> yFinal = end.y;
 
     if (waypoints.size() > 1) {
-      waypoints.emplace(waypoints.begin(),
-                        Translation2d{units::meter_t{xInitial[0]},
-                                      units::meter_t{yInitial[0]}});
-      waypoints.emplace_back(
-          Translation2d{units::meter_t{xFinal[0]}, units::meter_t{yFinal[0]}});
+      // All of the waypoints, including the start and end
+      size_t numPoints = waypoints.size() + 2;
+      auto X = [&](size_t i) {
+        if (i == 0) {
+          return xInitial[0];
+        } else if (i == numPoints - 1) {
+          return xFinal[0];
+        } else {
+          return waypoints[i - 1].X().value();
+        }
+      };
+      auto Y = [&](size_t i) {
+        if (i == 0) {
+          return yInitial[0];
+        } else if (i == numPoints - 1) {
+          return yFinal[0];
+        } else {
+          return waypoints[i - 1].Y().value();
+        }
+      };
 
       // Populate tridiagonal system for clamped cubic
       /* See:
@@ -116,70 +191,63 @@ class WPILIB_DLLEXPORT SplineHelper {
       /undervisningsmateriale/chap7alecture.pdf
       */
 
+      size_t N = waypoints.size();
+      scratch->resize(9 * N + 4);
+      std::span<double> storage{*scratch};
+
       // Above-diagonal of tridiagonal matrix, zero-padded
-      std::vector<double> a;
+      std::span<double> a = storage.subspan(0, N);
       // Diagonal of tridiagonal matrix
-      std::vector<double> b(waypoints.size() - 2, 4.0);
+      std::span<double> b = storage.subspan(N, N);
       // Below-diagonal of tridiagonal matrix, zero-padded
-      std::vector<double> c;
+      std::span<double> c = storage.subspan(2 * N, N);
       // rhs vectors
-      std::vector<double> dx, dy;
-      // solution vectors
-      std::vector<double> fx(waypoints.size() - 2, 0.0),
-          fy(waypoints.size() - 2, 0.0);
-
-      // populate above-diagonal and below-diagonal vectors
-      a.emplace_back(0);
-      for (size_t i = 0; i < waypoints.size() - 3; ++i) {
-        a.emplace_back(1);
-        c.emplace_back(1);
+      std::span<double> dx = storage.subspan(3 * N, N);
+      std::span<double> dy = storage.subspan(4 * N, N);
+      // Temporary vectors for the Thomas algorithm
+      std::span<double> cStar = storage.subspan(5 * N, N);
+      std::span<double> dStar = storage.subspan(6 * N, N);
+      // solution vectors, with room for the start and end derivatives
+      std::span<double> fx = storage.subspan(7 * N, N + 2);
+      std::span<double> fy = storage.subspan(8 * N + 2, N + 2);
+
+      // populate above-diagonal, diagonal, and below-diagonal vectors
+      for (size_t i = 0; i < N; ++i) {
+        a[i] = i == 0 ? 0.0 : 1.0;
+        b[i] = 4.0;
+        c[i] = i == N - 1 ? 0.0 : 1.0;
       }
-      c.emplace_back(0);
 
       // populate rhs vectors
-      dx.emplace_back(
-          3 * (waypoints[2].X().value() - waypoints[0].X().value()) -
-          xInitial[1]);
-      dy.emplace_back(
-          3 * (waypoints[2].Y().value() - waypoints[0].Y().value()) -
-          yInitial[1]);
-      if (waypoints.size() > 4) {
-        for (size_t i = 1; i <= waypoints.size() - 4; ++i) {
-          // dx and dy represent the derivatives of the internal waypoints. The
-          // derivative of the second internal waypoint should involve the third
-          // and first internal waypoint, which have indices of 1 and 3 in the
-          // waypoints list (which contains ALL waypoints).
-          dx.emplace_back(
-              3 * (waypoints[i + 2].X().value() - waypoints[i].X().value()));
-          dy.emplace_back(
-              3 * (waypoints[i + 2].Y().value() - waypoints[i].Y().value()));
-        }
+      dx[0] = 3 * (X(2) - X(0)) - xInitial[1];
+      dy[0] = 3 * (Y(2) - Y(0)) - yInitial[1];
+      for (size_t i = 1; i < N - 1; ++i) {
+        // dx and dy represent the derivatives of the internal waypoints. The
+        // derivative of the second internal waypoint should involve the third
+        // and first internal waypoint, which have indices of 1 and 3 in the
+        // list of ALL waypoints.
+        dx[i] = 3 * (X(i + 2) - X(i));
+        dy[i] = 3 * (Y(i + 2) - Y(i));
       }
-      dx.emplace_back(3 * (waypoints[waypoints.size() - 1].X().value() -
-                           waypoints[waypoints.size() - 3].X().value()) -
-                      xFinal[1]);
-      dy.emplace_back(3 * (waypoints[waypoints.size() - 1].Y().value() -
-                           waypoints[waypoints.size() - 3].Y().value()) -
-                      yFinal[1]);
+      dx[N - 1] = 3 * (X(numPoints - 1) - X(numPoints - 3)) - xFinal[1];
+      dy[N - 1] = 3 * (Y(numPoints - 1) - Y(numPoints - 3)) - yFinal[1];
 
       // Compute solution to tridiagonal system
-      ThomasAlgorithm(a, b, c, dx, &fx);
-      ThomasAlgorithm(a, b, c, dy, &fy);
+      ThomasAlgorithm(a, b, c, dx, fx.subspan(1, N), cStar, dStar);
+      ThomasAlgorithm(a, b, c, dy, fy.subspan(1, N), cStar, dStar);
 
-      fx.emplace(fx.begin(), xInitial[1]);
-      fx.emplace_back(xFinal[1]);
-      fy.emplace(fy.begin(), yInitial[1]);
-      fy.emplace_back(yFinal[1]);
+      fx[0] = xInitial[1];
+      fx[N + 1] = xFinal[1];
+      fy[0] = yInitial[1];
+      fy[N + 1] = yFinal[1];
 
+      splines->reserve(fx.size() - 1);
       for (size_t i = 0; i < fx.size() - 1; ++i) {
         // Create the spline.
-        const CubicHermiteSpline spline{
-            {waypoints[i].X().value(), fx[i]},
-            {waypoints[i + 1].X().value(), fx[i + 1]},
-            {waypoints[i].Y().value(), fy[i]},
-            {waypoints[i + 1].Y().value(), fy[i + 1]}};
-
-        splines.push_back(spline);
+        splines->emplace_back(wpi::array<double, 2>{X(i), fx[i]},
+                              wpi::array<double, 2>{X(i + 1), fx[i + 1]},
+                              wpi::array<double, 2>{Y(i), fy[i]},
+                              wpi::array<double, 2>{Y(i + 1), fy[i + 1]});
       }
     } else if (waypoints.size() == 1) {
       const double xDeriv =
@@ -190,18 +258,15 @@ class WPILIB_DLLEXPORT SplineHelper {
       wpi::array<double, 2> midXControlVector{waypoints[0].X().value(), xDeriv};
       wpi::array<double, 2> midYControlVector{waypoints[0].Y().value(), yDeriv};
 
-      splines.emplace_back(xInitial, midXControlVector, yInitial,
-                           midYControlVector);
-      splines.emplace_back(midXControlVector, xFinal, midYControlVector,
-                           yFinal);
+      splines->emplace_back(xInitial, midXControlVector, yInitial,
+                            midYControlVector);
+      splines->emplace_back(midXControlVector, xFinal, midYControlVector,
+                            yFinal);
 
     } else {
       // Create the spline.
-      const CubicHermiteSpline spline{xInitial, xFinal, yInitial, yFinal};
-      splines.push_back(spline);
+      splines->emplace_back(xInitial, xFinal, yInitial, yFinal);
     }
-
-    return splines;
   }
 
   /**
@@ -216,14 +281,32 @@ class WPILIB_DLLEXPORT SplineHelper {
   static std::vector<QuinticHermiteSpline> QuinticSplinesFromControlVectors(
       const std::vector<Spline<5>::ControlVector>& controlVectors) {
     std::vector<QuinticHermiteSpline> splines;
+    QuinticSplinesFromControlVectors(controlVectors, &splines);
+    return splines;
+  }
+
+  /**
+   * Computes a set of quintic splines corresponding to the provided control
+   * vectors. The user is free to set the direction of all waypoints. Continuous
+   * curvature is guaranteed throughout the path. The vector of splines is
+   * reused, so this doesn't allocate memory once it has grown large enough.
+   *
+   * @param controlVectors The control vectors.
+   * @param splines Where to store the quintic hermite splines that interpolate
+   * through the provided waypoints.
+   */
+  static void QuinticSplinesFromControlVectors(
+      std::span<const Spline<5>::ControlVector> controlVectors,
+      std::vector<QuinticHermiteSpline>* splines) {
+    splines->clear();
+    splines->reserve(controlVectors.size() - 1);
     for (size_t i = 0; i < controlVectors.size() - 1; ++i) {
       auto& xInitial = controlVectors[i].x;
       auto& yInitial = controlVectors[i].y;
       auto& xFinal = controlVectors[i + 1].x;
       auto& yFinal = controlVectors[i + 1].y;
-      splines.emplace_back(xInitial, xFinal, yInitial, yFinal);
+      splines->emplace_back(xInitial, xFinal, yInitial, yFinal);
     }
-    return splines;
   }
 
   /**
@@ -236,10 +319,24 @@ class WPILIB_DLLEXPORT SplineHelper {
    */
   static std::vector<QuinticHermiteSpline> OptimizeCurvature(
       const std::vector<QuinticHermiteSpline>& splines) {
+    std::vector<QuinticHermiteSpline> optimizedSplines = splines;
+    OptimizeCurvature(&optimizedSplines);
+    return optimizedSplines;
+  }
+
+  /**
+   * Optimizes the curvature of 2 or more quintic splines at knot points.
+   * Overall, this reduces the integral of the absolute value of the second
+   * derivative across the set of splines.
+   *
+   * @param splines A vector of un-optimized quintic splines, which is replaced
+   * with the optimized splines.
+   */
+  static void OptimizeCurvature(std::vector<QuinticHermiteSpline>* splines) {
     // If there's only one spline in the vector, we can't optimize anything so
     // just return that.
-    if (splines.size() < 2) {
-      return splines;
+    if (splines->size() < 2) {
+      return;
     }
 
     // Implements Section 4.1.2 of
@@ -251,19 +348,18 @@ class WPILIB_DLLEXPORT SplineHelper {
     // of those cubic splines and then use a weighted average for the second
     // derivatives of the quintic splines.
 
-    std::vector<QuinticHermiteSpline> optimizedSplines;
-    optimizedSplines.reserve(splines.size());
-    optimizedSplines.push_back(splines[0]);
-
-    for (size_t i = 0; i < splines.size() - 1; ++i) {
-      const auto& a = splines[i];
-      const auto& b = splines[i + 1];
+    // The splines are replaced as we go, so keep the initial control vector
+    // of the next spline from before it was replaced.
+    Spline<5>::ControlVector aInitial = (*splines)[0].GetInitialControlVector();
 
+    for (size_t i = 0; i < splines->size() - 1; ++i) {
       // Get the control vectors that created the quintic splines above.
-      const auto& aInitial = a.GetInitialControlVector();
-      const auto& aFinal = a.GetFinalControlVector();
-      const auto& bInitial = b.GetInitialControlVector();
-      const auto& bFinal = b.GetFinalControlVector();
+      const Spline<5>::ControlVector aFinal =
+          (*splines)[i].GetFinalControlVector();
+      const Spline<5>::ControlVector bInitial =
+          (*splines)[i + 1].GetInitialControlVector();
+      const Spline<5>::ControlVector bFinal =
+          (*splines)[i + 1].GetFinalControlVector();
 
       // Create cubic splines with the same control vectors.
       auto Trim = [](const wpi::array<double, 3>& a) {
@@ -296,17 +392,17 @@ class WPILIB_DLLEXPORT SplineHelper {
       double ddy = alpha * ddyA + beta * ddyB;
 
       // Create new splines.
-      optimizedSplines[i] = {aInitial.x,
-                             {aFinal.x[0], aFinal.x[1], ddx},
-                             aInitial.y,
-                             {aFinal.y[0], aFinal.y[1], ddy}};
-      optimizedSplines.push_back({{bInitial.x[0], bInitial.x[1], ddx},
-                                  bFinal.x,
-                                  {bInitial.y[0], bInitial.y[1], ddy},
-                                  bFinal.y});
+      (*splines)[i] = {aInitial.x,
+                       {aFinal.x[0], aFinal.x[1], ddx},
+                       aInitial.y,
+                       {aFinal.y[0], aFinal.y[1], ddy}};
+      (*splines)[i + 1] = {{bInitial.x[0], bInitial.x[1], ddx},
+                           bFinal.x,
+                           {bInitial.y[0], bInitial.y[1], ddy},
+                           bFinal.y};
+
+      aInitial = bInitial;
     }
-
-    return optimizedSplines;
   }
 
  private:
@@ -329,24 +425,18 @@ class WPILIB_DLLEXPORT SplineHelper {
    * @param b the values of A on the diagonal
    * @param c the values of A below the diagonal
    * @param d the vector on the rhs
-   * @param solutionVector the unknown (solution) vector, modified in-place
+   * @param f the unknown (solution) vector, modified in-place
+   * @param c_star temporary storage the same size as d
+   * @param d_star temporary storage the same size as d
    */
-  static void ThomasAlgorithm(const std::vector<double>& a,
-                              const std::vector<double>& b,
-                              const std::vector<double>& c,
-                              const std::vector<double>& d,
-                              std::vector<double>* solutionVector) {
-    auto& f = *solutionVector;
+  static void ThomasAlgorithm(std::span<const double> a,
+                              std::span<const double> b,
+                              std::span<const double> c,
+                              std::span<const double> d, std::span<double> f,
+                              std::span<double> c_star,
+                              std::span<double> d_star) {
     size_t N = d.size();
 
-    // Create the temporary vectors
-    // Note that this is inefficient as it is possible to call
-    // this function many times. A better implementation would
-    // pass these temporary matrices by non-const reference to
-    // save excess allocation and deallocation
-    std::vector<double> c_star(N, 0.0);
-    std::vector<double> d_star(N, 0.0);
-
     // This updates the coefficients in the first row
     // Note that we should be checking for division by zero here
     c_star[0] = c[0] / b[0];
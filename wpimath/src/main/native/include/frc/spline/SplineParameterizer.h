@@ -28,7 +28,6 @@
 
 #pragma once
 
-#include <stack>
 #include <string>
 #include <utility>
 #include <vector>
@@ -55,6 +54,28 @@ class WPILIB_DLLEXPORT SplineParameterizer {
         : runtime_error(what_arg) {}
   };
 
+  /**
+   * An interval of the internal spline parameter that hasn't been checked
+   * against the tolerances yet.
+   */
+  struct StackContents {
+    /// The start of the interval.
+    double t0;
+    /// The end of the interval.
+    double t1;
+  };
+
+  /**
+   * Storage that can be reused between calls to Parameterize(). Once it has
+   * grown large enough, parameterizing a spline doesn't allocate memory.
+   */
+  class Workspace {
+   private:
+    friend class SplineParameterizer;
+
+    std::vector<StackContents> m_stack;
+  };
+
   /**
    * Parametrizes the spline. This method breaks up the spline into various
    * arcs until their dx, dy, and dtheta are within specific tolerances.
@@ -72,10 +93,6 @@ class WPILIB_DLLEXPORT SplineParameterizer {
   static std::vector<PoseWithCurvature> Parameterize(const Spline<Dim>& spline,
                                                      double t0 = 0.0,
                                                      double t1 = 1.0) {
-    constexpr const char* kMalformedSplineExceptionMsg =
-        "Could not parameterize a malformed spline. This means that you "
-        "probably had two or more adjacent waypoints that were very close "
-        "together with headings in opposing directions.";
     std::vector<PoseWithCurvature> splinePoints;
 
     // The parameterization does not add the initial point. Let's add that.
@@ -85,16 +102,42 @@ class WPILIB_DLLEXPORT SplineParameterizer {
       throw MalformedSplineException(kMalformedSplineExceptionMsg);
     }
 
+    Workspace workspace;
+    Parameterize(spline, workspace, &splinePoints, t0, t1);
+    return splinePoints;
+  }
+
+  /**
+   * Parametrizes the spline. This method breaks up the spline into various
+   * arcs until their dx, dy, and dtheta are within specific tolerances.
+   *
+   * Unlike the version that returns a vector, this appends the points to an
+   * existing vector, and doesn't add the initial point. It doesn't allocate
+   * memory once the workspace and the vector of points have grown large enough.
+   *
+   * @param spline The spline to parameterize.
+   * @param workspace Storage for intermediate values.
+   * @param splinePoints The vector to append the points on the spline to.
+   * @param t0 Starting internal spline parameter. It is recommended to leave
+   * this as default.
+   * @param t1 Ending internal spline parameter. It is recommended to leave this
+   * as default.
+   */
+  template <int Dim>
+  static void Parameterize(const Spline<Dim>& spline, Workspace& workspace,
+                           std::vector<PoseWithCurvature>* splinePoints,
+                           double t0 = 0.0, double t1 = 1.0) {
     // We use an "explicit stack" to simulate recursion, instead of a recursive
     // function call This give us greater control, instead of a stack overflow
-    std::stack<StackContents> stack;
-    stack.emplace(StackContents{t0, t1});
+    auto& stack = workspace.m_stack;
+    stack.clear();
+    stack.emplace_back(StackContents{t0, t1});
 
     int iterations = 0;
 
     while (!stack.empty()) {
-      auto current = stack.top();
-      stack.pop();
+      auto current = stack.back();
+      stack.pop_back();
 
       auto start = spline.GetPoint(current.t0);
       if (!start) {
@@ -111,18 +154,18 @@ class WPILIB_DLLEXPORT SplineParameterizer {
       if (units::math::abs(twist.dy) > kMaxDy ||
           units::math::abs(twist.dx) > kMaxDx ||
           units::math::abs(twist.dtheta) > kMaxDtheta) {
-        stack.emplace(StackContents{(current.t0 + current.t1) / 2, current.t1});
-        stack.emplace(StackContents{current.t0, (current.t0 + current.t1) / 2});
+        stack.emplace_back(
+            StackContents{(current.t0 + current.t1) / 2, current.t1});
+        stack.emplace_back(
+            StackContents{current.t0, (current.t0 + current.t1) / 2});
       } else {
-        splinePoints.push_back(end.value());
+        splinePoints->push_back(end.value());
       }
 
       if (iterations++ >= kMaxIterations) {
         throw MalformedSplineException(kMalformedSplineExceptionMsg);
       }
     }
-
-    return splinePoints;
   }
 
  private:
@@ -131,10 +174,10 @@ class WPILIB_DLLEXPORT SplineParameterizer {
   static inline constexpr units::meter_t kMaxDy = 0.05_in;
   static inline constexpr units::radian_t kMaxDtheta = 0.0872_rad;
 
-  struct StackContents {
-    double t0;
-    double t1;
-  };
+  static constexpr const char* kMalformedSplineExceptionMsg =
+      "Could not parameterize a malformed spline. This means that you "
+      "probably had two or more adjacent waypoints that were very close "
+      "together with headings in opposing directions.";
 
   /**
    * A malformed spline does not actually explode the LIFO stack size. Instead,
@@ -262,6 +262,8 @@ class WPILIB_DLLEXPORT Trajectory {
  private:
   std::vector<State> m_states;
   units::second_t m_totalTime = 0_s;
+
+  friend class TrajectoryParameterizer;
 };
 
 WPILIB_DLLEXPORT
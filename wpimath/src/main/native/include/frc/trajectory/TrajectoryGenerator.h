@@ -6,14 +6,19 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 
 #include <wpi/SymbolExports.h>
 
+#include "frc/spline/CubicHermiteSpline.h"
+#include "frc/spline/QuinticHermiteSpline.h"
 #include "frc/spline/SplineParameterizer.h"
 #include "frc/trajectory/Trajectory.h"
 #include "frc/trajectory/TrajectoryConfig.h"
+#include "frc/trajectory/TrajectoryParameterizer.h"
 #include "frc/trajectory/constraint/DifferentialDriveKinematicsConstraint.h"
 #include "frc/trajectory/constraint/TrajectoryConstraint.h"
 
@@ -25,6 +30,27 @@ class WPILIB_DLLEXPORT TrajectoryGenerator {
  public:
   using PoseWithCurvature = std::pair<Pose2d, units::curvature_t>;
 
+  /**
+   * Storage that can be reused between trajectory generations. Once it has
+   * grown large enough, generating a trajectory with it doesn't allocate
+   * memory, so trajectories can be regenerated in the robot loop.
+   *
+   * A workspace may only be used by one thread at a time.
+   */
+  class Workspace {
+   private:
+    friend class TrajectoryGenerator;
+
+    std::vector<Pose2d> m_waypoints;
+    std::vector<Spline<5>::ControlVector> m_controlVectors;
+    std::vector<CubicHermiteSpline> m_cubicSplines;
+    std::vector<QuinticHermiteSpline> m_quinticSplines;
+    std::vector<double> m_splineScratch;
+    std::vector<PoseWithCurvature> m_points;
+    SplineParameterizer::Workspace m_splineParameterizer;
+    TrajectoryParameterizer::Workspace m_trajectoryParameterizer;
+  };
+
   /**
    * Generates a trajectory from the given control vectors and config. This
    * method uses clamped cubic splines -- a method in which the exterior control
@@ -84,6 +110,156 @@ class WPILIB_DLLEXPORT TrajectoryGenerator {
   static Trajectory GenerateTrajectory(const std::vector<Pose2d>& waypoints,
                                        const TrajectoryConfig& config);
 
+  /**
+   * Generates a trajectory from the given control vectors and config. This
+   * method uses clamped cubic splines -- a method in which the exterior control
+   * vectors and interior waypoints are provided. The headings are automatically
+   * determined at the interior points to ensure continuous curvature.
+   *
+   * This doesn't allocate memory once the workspace and trajectory have grown
+   * large enough.
+   *
+   * @param initial           The initial control vector.
+   * @param interiorWaypoints The interior waypoints.
+   * @param end               The ending control vector.
+   * @param config            The configuration for the trajectory.
+   * @param workspace         Storage for intermediate values.
+   * @param trajectory        Where to store the generated trajectory.
+   */
+  static void GenerateTrajectory(
+      Spline<3>::ControlVector initial,
+      std::span<const Translation2d> interiorWaypoints,
+      Spline<3>::ControlVector end, const TrajectoryConfig& config,
+      Workspace& workspace, Trajectory* trajectory);
+
+  /**
+   * Generates a trajectory from the given waypoints and config. This method
+   * uses clamped cubic splines -- a method in which the initial pose, final
+   * pose, and interior waypoints are provided.  The headings are automatically
+   * determined at the interior points to ensure continuous curvature.
+   *
+   * This doesn't allocate memory once the workspace and trajectory have grown
+   * large enough.
+   *
+   * @param start             The starting pose.
+   * @param interiorWaypoints The interior waypoints.
+   * @param end               The ending pose.
+   * @param config            The configuration for the trajectory.
+   * @param workspace         Storage for intermediate values.
+   * @param trajectory        Where to store the generated trajectory.
+   */
+  static void GenerateTrajectory(
+      const Pose2d& start, std::span<const Translation2d> interiorWaypoints,
+      const Pose2d& end, const TrajectoryConfig& config, Workspace& workspace,
+      Trajectory* trajectory);
+
+  /**
+   * Generates a trajectory from the given quintic control vectors and config.
+   * This method uses quintic hermite splines -- therefore, all points must be
+   * represented by control vectors. Continuous curvature is guaranteed in this
+   * method.
+   *
+   * This doesn't allocate memory once the workspace and trajectory have grown
+   * large enough.
+   *
+   * @param controlVectors List of quintic control vectors.
+   * @param config         The configuration for the trajectory.
+   * @param workspace      Storage for intermediate values.
+   * @param trajectory     Where to store the generated trajectory.
+   */
+  static void GenerateTrajectory(
+      std::span<const Spline<5>::ControlVector> controlVectors,
+      const TrajectoryConfig& config, Workspace& workspace,
+      Trajectory* trajectory);
+
+  /**
+   * Generates a trajectory from the given waypoints and config. This method
+   * uses quintic hermite splines -- therefore, all points must be represented
+   * by Pose2d objects. Continuous curvature is guaranteed in this method.
+   *
+   * This doesn't allocate memory once the workspace and trajectory have grown
+   * large enough.
+   *
+   * @param waypoints  List of waypoints.
+   * @param config     The configuration for the trajectory.
+   * @param workspace  Storage for intermediate values.
+   * @param trajectory Where to store the generated trajectory.
+   */
+  static void GenerateTrajectory(std::span<const Pose2d> waypoints,
+                                 const TrajectoryConfig& config,
+                                 Workspace& workspace, Trajectory* trajectory);
+
+  /**
+   * The waypoints and configuration of one trajectory generated by
+   * GenerateTrajectories().
+   */
+  struct Request {
+    /**
+     * Constructs a request for a trajectory through the given waypoints, using
+     * quintic hermite splines.
+     *
+     * @param waypoints List of waypoints.
+     * @param config    The configuration for the trajectory. It must outlive
+     *                  the request.
+     */
+    Request(std::vector<Pose2d> waypoints, const TrajectoryConfig& config)
+        : waypoints(std::move(waypoints)), config(&config) {}
+
+    /**
+     * Constructs a request for a trajectory from the start pose to the end
+     * pose through the interior waypoints, using clamped cubic splines.
+     *
+     * @param start             The starting pose.
+     * @param interiorWaypoints The interior waypoints.
+     * @param end               The ending pose.
+     * @param config            The configuration for the trajectory. It must
+     *                          outlive the request.
+     */
+    Request(const Pose2d& start, std::vector<Translation2d> interiorWaypoints,
+            const Pose2d& end, const TrajectoryConfig& config)
+        : waypoints{start, end},
+          interiorWaypoints(std::move(interiorWaypoints)),
+          config(&config) {}
+
+    // The config is referenced, not copied, so it can't be a temporary
+    Request(std::vector<Pose2d> waypoints, TrajectoryConfig&& config) = delete;
+    Request(const Pose2d& start, std::vector<Translation2d> interiorWaypoints,
+            const Pose2d& end, TrajectoryConfig&& config) = delete;
+
+    /// The waypoints, or the start and end poses of a clamped cubic
+    /// trajectory.
+    std::vector<Pose2d> waypoints;
+
+    /// The interior waypoints of a clamped cubic trajectory, or empty for a
+    /// quintic trajectory.
+    std::optional<std::vector<Translation2d>> interiorWaypoints;
+
+    /// The configuration for the trajectory.
+    const TrajectoryConfig* config;
+  };
+
+  /**
+   * Generates a trajectory for each request in parallel. This is faster than
+   * generating them one at a time when many trajectories are needed at once,
+   * e.g. for every autonomous routine at startup.
+   *
+   * The requests are split among the threads as they finish, so the work is
+   * balanced even when some trajectories take longer than others. The result
+   * doesn't depend on the number of threads.
+   *
+   * The trajectory constraints are called from several threads at once, so
+   * custom constraints must be safe to call concurrently. All of the
+   * constraints in WPILib are.
+   *
+   * @param requests   The waypoints and configuration of each trajectory.
+   * @param maxThreads The maximum number of threads to use, including the
+   *                   calling thread. If 0, one thread per hardware thread is
+   *                   used.
+   * @return The generated trajectories, in the same order as the requests.
+   */
+  static std::vector<Trajectory> GenerateTrajectories(
+      std::span<const Request> requests, unsigned int maxThreads = 0);
+
   /**
    * Generate spline points from a vector of splines by parameterizing the
    * splines.
@@ -95,23 +271,39 @@ class WPILIB_DLLEXPORT TrajectoryGenerator {
   template <typename Spline>
   static std::vector<PoseWithCurvature> SplinePointsFromSplines(
       const std::vector<Spline>& splines) {
-    // Create the vector of spline points.
     std::vector<PoseWithCurvature> splinePoints;
+    SplineParameterizer::Workspace workspace;
+    SplinePointsFromSplines(splines, workspace, &splinePoints);
+    return splinePoints;
+  }
+
+  /**
+   * Generate spline points from a vector of splines by parameterizing the
+   * splines. This doesn't allocate memory once the workspace and vector of
+   * spline points have grown large enough.
+   *
+   * @param splines The splines to parameterize.
+   * @param workspace Storage for intermediate values.
+   * @param splinePoints Where to store the spline points for use in time
+   * parameterization of a trajectory.
+   */
+  template <typename Spline>
+  static void SplinePointsFromSplines(
+      const std::vector<Spline>& splines,
+      SplineParameterizer::Workspace& workspace,
+      std::vector<PoseWithCurvature>* splinePoints) {
+    splinePoints->clear();
 
     // Add the first point to the vector.
-    splinePoints.push_back(splines.front().GetPoint(0.0).value());
+    splinePoints->push_back(splines.front().GetPoint(0.0).value());
 
     // Iterate through the vector and parameterize each spline, adding the
-    // parameterized points to the final vector.
+    // parameterized points to the final vector. The initial point of each
+    // spline isn't added because it's a duplicate of the last point from the
+    // previous spline.
     for (auto&& spline : splines) {
-      auto points = SplineParameterizer::Parameterize(spline);
-      // Append the array of poses to the vector. We are removing the first
-      // point because it's a duplicate of the last point from the previous
-      // spline.
-      splinePoints.insert(std::end(splinePoints), std::begin(points) + 1,
-                          std::end(points));
+      SplineParameterizer::Parameterize(spline, workspace, splinePoints);
     }
-    return splinePoints;
   }
 
   /**
@@ -124,6 +316,13 @@ class WPILIB_DLLEXPORT TrajectoryGenerator {
  private:
   static void ReportError(const char* error);
 
+  /**
+   * Flips the workspace's spline points back if the trajectory is reversed,
+   * then parameterizes them by time.
+   */
+  static void TimeParameterize(const TrajectoryConfig& config,
+                               Workspace& workspace, Trajectory* trajectory);
+
   static const Trajectory kDoNothingTrajectory;
   static std::function<void(const char*)> s_errorFunc;
 };
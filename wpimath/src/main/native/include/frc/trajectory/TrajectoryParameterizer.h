@@ -29,6 +29,7 @@
 #pragma once
 
 #include <memory>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -73,8 +74,6 @@ class WPILIB_DLLEXPORT TrajectoryParameterizer {
       units::meters_per_second_squared_t maxAcceleration, bool reversed);
 
  private:
-  constexpr static double kEpsilon = 1E-6;
-
   /**
    * Represents a constrained state that is used when time parameterizing a
    * trajectory. Each state has the pose, curvature, distance from the start of
@@ -88,6 +87,51 @@ class WPILIB_DLLEXPORT TrajectoryParameterizer {
     units::meters_per_second_squared_t maxAcceleration = 0_mps_sq;
   };
 
+ public:
+  /**
+   * Storage that can be reused between calls to TimeParameterizeTrajectory().
+   * Once it has grown large enough, parameterizing a trajectory doesn't
+   * allocate memory.
+   */
+  class Workspace {
+   private:
+    friend class TrajectoryParameterizer;
+
+    std::vector<ConstrainedState> m_constrainedStates;
+  };
+
+  /**
+   * Parameterize the trajectory by time. This is where the velocity profile is
+   * generated.
+   *
+   * Unlike the version that returns a trajectory, this replaces the states of
+   * an existing trajectory, and doesn't allocate memory once the workspace and
+   * the trajectory have grown large enough.
+   *
+   * @param points Reference to the spline points.
+   * @param constraints A vector of various velocity and acceleration
+   * constraints.
+   * @param startVelocity The start velocity for the trajectory.
+   * @param endVelocity The end velocity for the trajectory.
+   * @param maxVelocity The max velocity for the trajectory.
+   * @param maxAcceleration The max acceleration for the trajectory.
+   * @param reversed Whether the robot should move backwards. Note that the
+   * robot will still move from a -> b -> ... -> z as defined in the waypoints.
+   * @param workspace Storage for intermediate values.
+   * @param trajectory Where to store the trajectory.
+   */
+  static void TimeParameterizeTrajectory(
+      std::span<const PoseWithCurvature> points,
+      const std::vector<std::unique_ptr<TrajectoryConstraint>>& constraints,
+      units::meters_per_second_t startVelocity,
+      units::meters_per_second_t endVelocity,
+      units::meters_per_second_t maxVelocity,
+      units::meters_per_second_squared_t maxAcceleration, bool reversed,
+      Workspace& workspace, Trajectory* trajectory);
+
+ private:
+  constexpr static double kEpsilon = 1E-6;
+
   /**
    * Enforces acceleration limits as defined by the constraints. This function
    * is used when time parameterizing a trajectory.
@@ -4,12 +4,18 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <wpi/SymbolExports.h>
 
 #include "frc/trajectory/Trajectory.h"
+#include "frc/trajectory/TrajectoryGenerator.h"
 
 namespace frc {
 /**
@@ -54,6 +60,69 @@ class WPILIB_DLLEXPORT TrajectoryUtil {
    */
   static Trajectory DeserializeTrajectory(std::string_view jsonStr);
 
+  /**
+   * Hashes the inputs of trajectory generation requests, for checking whether
+   * cached trajectories are still valid.
+   *
+   * Constraints are identified by their type and by the limits they impose at
+   * each waypoint, since their parameters aren't accessible. A change to a
+   * constraint that doesn't affect its limits at any waypoint (e.g. moving a
+   * region that contains no waypoints) isn't detected.
+   *
+   * Constraint type names come from the compiler, so the hash (and a cache
+   * keyed by it) is only valid for the same build of the program.
+   *
+   * @param requests The waypoints and configuration of each trajectory.
+   *
+   * @return A hash of the requests.
+   */
+  static uint64_t HashTrajectoryRequests(
+      std::span<const TrajectoryGenerator::Request> requests);
+
+  /**
+   * Serializes trajectories to a compact binary format.
+   *
+   * @param trajectories The trajectories to serialize.
+   * @param key A key identifying the inputs the trajectories were generated
+   *     from, e.g. from HashTrajectoryRequests().
+   *
+   * @return The serialized trajectories.
+   */
+  static std::vector<uint8_t> SerializeTrajectoriesBinary(
+      std::span<const Trajectory> trajectories, uint64_t key);
+
+  /**
+   * Deserializes trajectories serialized by SerializeTrajectoriesBinary().
+   *
+   * @param data The serialized trajectories.
+   * @param key The key the trajectories must have been serialized with.
+   *
+   * @return The trajectories, or empty if the data is malformed or has a
+   *     different key.
+   */
+  static std::optional<std::vector<Trajectory>> DeserializeTrajectoriesBinary(
+      std::span<const uint8_t> data, uint64_t key);
+
+  /**
+   * Generates trajectories in parallel with
+   * TrajectoryGenerator::GenerateTrajectories(), or loads them from a cache
+   * file if they were already generated from the same requests.
+   *
+   * If the cache file is missing, malformed, or was generated from different
+   * requests, the trajectories are generated and the cache file is replaced.
+   * Failing to write the cache file is reported as a warning. The cache is
+   * only valid for the same build of the program (see
+   * HashTrajectoryRequests()); other builds regenerate it.
+   *
+   * @param requests The waypoints and configuration of each trajectory.
+   * @param path The path of the cache file.
+   *
+   * @return The trajectories, in the same order as the requests.
+   */
+  static std::vector<Trajectory> GenerateTrajectoriesCached(
+      std::span<const TrajectoryGenerator::Request> requests,
+      std::string_view path);
+
  private:
   // Usage reporting for PathWeaver Trajectory instances
   inline static int pathWeaverTrajectoryInstances = 0;
@@ -2,8 +2,10 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <algorithm>
 #include <limits>
 #include <numbers>
+#include <optional>
 #include <random>
 #include <tuple>
 #include <utility>
@@ -425,3 +427,70 @@ TEST(DifferentialDrivePoseEstimatorTest, TestReset) {
   EXPECT_DOUBLE_EQ(
       0, estimator.GetEstimatedPosition().Rotation().Radians().value());
 }
+
+TEST(DifferentialDrivePoseEstimatorTest, TestAddVisionMeasurements) {
+  // Adding a batch of vision measurements is the same as adding them one at a
+  // time in timestamp order
+  frc::DifferentialDriveKinematics kinematics{1_m};
+  frc::DifferentialDrivePoseEstimator sequential{
+      kinematics,      frc::Rotation2d{}, 0_m, 0_m, frc::Pose2d{},
+      {0.1, 0.1, 0.1}, {0.45, 0.45, 0.45}};
+  frc::DifferentialDrivePoseEstimator batched{
+      kinematics,      frc::Rotation2d{}, 0_m, 0_m, frc::Pose2d{},
+      {0.1, 0.1, 0.1}, {0.45, 0.45, 0.45}};
+
+  std::default_random_engine generator;
+  std::normal_distribution<double> distribution(0.0, 1.0);
+
+  units::second_t time = 0_s;
+  units::meter_t left = 0_m;
+  units::meter_t right = 0_m;
+  for (int loop = 0; loop < 100; ++loop) {
+    time += 20_ms;
+    left += 0.04_m;
+    right += 0.05_m;
+    sequential.UpdateWithTime(time, frc::Rotation2d{}, left, right);
+    batched.UpdateWithTime(time, frc::Rotation2d{}, left, right);
+
+    // Several cameras with different latencies, out of timestamp order
+    std::vector<frc::DifferentialDrivePoseEstimator::VisionMeasurement>
+        measurements;
+    for (auto latency : {60_ms, 10_ms, 35_ms, 10_ms}) {
+      auto pose = sequential.GetEstimatedPosition();
+      measurements.push_back(
+          {frc::Pose2d{pose.X() + units::meter_t{distribution(generator)},
+                       pose.Y() + units::meter_t{distribution(generator)},
+                       pose.Rotation() +
+                           frc::Rotation2d{units::radian_t{
+                               0.1 * distribution(generator)}}},
+           time - latency,
+           latency == 35_ms
+               ? std::optional{wpi::array<double, 3>{1.0, 1.0, 1.0}}
+               : std::nullopt});
+    }
+
+    auto sorted = measurements;
+    std::stable_sort(
+        sorted.begin(), sorted.end(),
+        [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; });
+    for (auto&& measurement : sorted) {
+      if (measurement.stdDevs) {
+        // the batch API doesn't change the default standard deviations
+        sequential.AddVisionMeasurement(measurement.pose, measurement.timestamp,
+                                        *measurement.stdDevs);
+        sequential.SetVisionMeasurementStdDevs({0.45, 0.45, 0.45});
+      } else {
+        sequential.AddVisionMeasurement(measurement.pose,
+                                        measurement.timestamp);
+      }
+    }
+    batched.AddVisionMeasurements(measurements);
+
+    auto expected = sequential.GetEstimatedPosition();
+    auto actual = batched.GetEstimatedPosition();
+    EXPECT_NEAR(expected.X().value(), actual.X().value(), 1e-9);
+    EXPECT_NEAR(expected.Y().value(), actual.Y().value(), 1e-9);
+    EXPECT_NEAR(expected.Rotation().Radians().value(),
+                actual.Rotation().Radians().value(), 1e-9);
+  }
+}
@@ -0,0 +1,109 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "frc/estimator/InertialPoseEstimator3d.h"
+#include "frc/geometry/Pose3d.h"
+
+namespace {
+
+// The robot drives counterclockwise around a circle at a constant speed
+constexpr double kSpeed = 1.0;               // m/s
+constexpr double kRadius = 2.0;              // m
+constexpr double kOmega = kSpeed / kRadius;  // rad/s
+
+frc::Pose3d TruePose(units::second_t t) {
+  double heading = kOmega * t.value();
+  return frc::Pose3d{
+      units::meter_t{kRadius * std::sin(heading)},
+      units::meter_t{kRadius * (1.0 - std::cos(heading))}, 0_m,
+      frc::Rotation3d{0_rad, 0_rad, units::radian_t{heading}}};
+}
+
+}  // namespace
+
+TEST(InertialPoseEstimator3dTest, Stationary) {
+  frc::InertialPoseEstimator3d estimator{
+      {0.005, 0.0001, 0.05, 0.001}, {0.05, 0.05, 0.05}, {0.1, 0.1, 0.1, 0.1}};
+
+  frc::Pose3d pose{1_m, 2_m, 0_m, frc::Rotation3d{0_rad, 0_rad, 1_rad}};
+  estimator.ResetPose(pose);
+
+  for (int i = 0; i <= 400; ++i) {
+    estimator.AddImuMeasurement(i * 5_ms, Eigen::Vector3d::Zero(),
+                                Eigen::Vector3d{0.0, 0.0, 9.80665});
+    estimator.AddOdometryMeasurement(frc::ChassisSpeeds{});
+  }
+
+  auto estimate = estimator.GetEstimatedPosition();
+  EXPECT_NEAR(0.0, (estimate - pose).Translation().Norm().value(), 1e-9);
+  EXPECT_NEAR(0.0, (estimate - pose).Rotation().Angle().value(), 1e-9);
+  EXPECT_NEAR(0.0, estimator.GetEstimatedVelocity().norm(), 1e-9);
+}
+
+TEST(InertialPoseEstimator3dTest, FollowCircle) {
+  frc::InertialPoseEstimator3d estimator{
+      {0.005, 0.0001, 0.05, 0.001}, {0.05, 0.05, 0.05}, {0.1, 0.1, 0.1, 0.1}};
+
+  estimator.ResetPose(TruePose(0_s));
+
+  std::default_random_engine generator;
+  std::normal_distribution<double> distribution(0.0, 1.0);
+
+  const Eigen::Vector3d gyroBias{0.001, -0.002, 0.02};
+  constexpr units::second_t kImuPeriod = 5_ms;
+  constexpr int kVisionPeriod = 20;   // IMU samples
+  constexpr int kVisionLatency = 10;  // IMU samples
+
+  // In the robot frame, the robot accelerates toward the center of the circle
+  // (left), and the accelerometer measures gravity as upward acceleration
+  const Eigen::Vector3d acceleration{0.0, kSpeed * kOmega, 9.80665};
+
+  for (int i = 0; i <= 2000; ++i) {
+    units::second_t t = i * kImuPeriod;
+
+    Eigen::Vector3d angularVelocity{0.0, 0.0, kOmega};
+    Eigen::Vector3d measuredAcceleration = acceleration;
+    for (int j = 0; j < 3; ++j) {
+      angularVelocity(j) += gyroBias(j) + 0.002 * distribution(generator);
+      measuredAcceleration(j) += 0.02 * distribution(generator);
+    }
+    estimator.AddImuMeasurement(t, angularVelocity, measuredAcceleration);
+
+    estimator.AddOdometryMeasurement(frc::ChassisSpeeds{
+        units::meters_per_second_t{kSpeed + 0.02 * distribution(generator)},
+        units::meters_per_second_t{0.02 * distribution(generator)},
+        0_rad_per_s});
+
+    // Two cameras see the robot at the same time, and the measurements arrive
+    // later
+    if (i >= kVisionLatency && (i - kVisionLatency) % kVisionPeriod == 0) {
+      units::second_t timestamp = t - kVisionLatency * kImuPeriod;
+      for (int camera = 0; camera < 2; ++camera) {
+        estimator.AddVisionMeasurement(
+            TruePose(timestamp) +
+                frc::Transform3d{
+                    units::meter_t{0.05 * distribution(generator)},
+                    units::meter_t{0.05 * distribution(generator)},
+                    units::meter_t{0.05 * distribution(generator)},
+                    frc::Rotation3d{
+                        units::radian_t{0.02 * distribution(generator)},
+                        units::radian_t{0.02 * distribution(generator)},
+                        units::radian_t{0.02 * distribution(generator)}}},
+            timestamp);
+      }
+    }
+  }
+
+  auto error = estimator.GetEstimatedPosition() - TruePose(10_s);
+  EXPECT_LT(error.Translation().Norm().value(), 0.05);
+  EXPECT_LT(error.Rotation().Angle().value(), 0.02);
+
+  // The yaw rate bias is observable from vision and odometry
+  EXPECT_NEAR(gyroBias.z(), estimator.GetGyroBias().z(), 0.005);
+}
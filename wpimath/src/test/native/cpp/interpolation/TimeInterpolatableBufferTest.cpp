@@ -3,8 +3,12 @@
 // the WPILib BSD license file in the root directory of this project.
 
 #include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
+#include <wpi/deprecated.h>
 
 #include "frc/geometry/Pose2d.h"
 #include "frc/geometry/Rotation2d.h"
@@ -59,3 +63,111 @@ TEST(TimeInterpolatableBufferTest, Pose2d) {
   EXPECT_TRUE(std::abs(sample.Y().value() - (1.0 / std::sqrt(2.0))) < 0.01);
   EXPECT_TRUE(std::abs(sample.Rotation().Degrees().value() - 45.0) < 0.01);
 }
+
+TEST(TimeInterpolatableBufferTest, History) {
+  frc::TimeInterpolatableBuffer<double> buffer{1_s};
+
+  // The buffer grows to hold the history, then old samples are discarded
+  for (int i = 0; i <= 1000; ++i) {
+    buffer.AddSample(i * 10_ms, i);
+  }
+  EXPECT_EQ(buffer.GetSampleBuffer().size(), 101u);
+  EXPECT_EQ(buffer.GetSampleBuffer().front().first, 9_s);
+  EXPECT_EQ(buffer.Sample(0_s).value(), 900);
+  EXPECT_DOUBLE_EQ(buffer.Sample(9.505_s).value(), 950.5);
+}
+
+TEST(TimeInterpolatableBufferTest, OutOfOrder) {
+  frc::TimeInterpolatableBuffer<double> buffer{10_s};
+
+  // Interleave the samples so most are inserted in the middle
+  for (int i = 0; i < 100; i += 2) {
+    buffer.AddSample(i * 10_ms, i);
+  }
+  for (int i = 99; i > 0; i -= 2) {
+    buffer.AddSample(i * 10_ms, i);
+  }
+  auto snapshots = buffer.GetSampleBuffer();
+  ASSERT_EQ(snapshots.size(), 100u);
+  for (size_t i = 0; i < snapshots.size(); ++i) {
+    EXPECT_EQ(snapshots[i].first, i * 10_ms);
+    EXPECT_EQ(snapshots[i].second, i);
+  }
+}
+
+TEST(TimeInterpolatableBufferTest, SampleMultiple) {
+  frc::TimeInterpolatableBuffer<frc::Pose2d> buffer{10_s};
+
+  std::vector<units::second_t> times{-1_s, 0_s, 0.25_s, 0.5_s,
+                                     0.5_s, 1.2_s, 2_s, 3_s};
+  std::vector<frc::Pose2d> samples(times.size());
+  EXPECT_FALSE(buffer.Sample(times, samples));
+
+  buffer.AddSample(0_s, frc::Pose2d{0_m, 0_m, 90_deg});
+  buffer.AddSample(1_s, frc::Pose2d{1_m, 1_m, 0_deg});
+  buffer.AddSample(1.5_s, frc::Pose2d{2_m, 1_m, 0_deg});
+  buffer.AddSample(2_s, frc::Pose2d{2_m, 2_m, 45_deg});
+  ASSERT_TRUE(buffer.Sample(times, samples));
+  for (size_t i = 0; i < times.size(); ++i) {
+    EXPECT_EQ(samples[i], buffer.Sample(times[i]).value());
+  }
+}
+
+TEST(TimeInterpolatableBufferTest, CustomInterpolator) {
+  // Interpolates to the nearest sample
+  struct Nearest {
+    double operator()(double start, double end, double t) const {
+      return t < 0.5 ? start : end;
+    }
+  };
+  frc::TimeInterpolatableBuffer<double, Nearest> buffer{10_s};
+
+  buffer.AddSample(0_s, 0);
+  buffer.AddSample(1_s, 1);
+  EXPECT_EQ(buffer.Sample(0.4_s).value(), 0);
+  EXPECT_EQ(buffer.Sample(0.6_s).value(), 1);
+}
+
+TEST(TimeInterpolatableBufferTest, NoDefaultConstructor) {
+  // Holds a reference count, so the test can tell when samples are destroyed
+  struct Sample {
+    explicit Sample(std::shared_ptr<int> value) : value{std::move(value)} {}
+    std::shared_ptr<int> value;
+  };
+  struct Nearest {
+    Sample operator()(const Sample& start, const Sample& end, double t) const {
+      return t < 0.5 ? start : end;
+    }
+  };
+  frc::TimeInterpolatableBuffer<Sample, Nearest> buffer{1_s};
+
+  auto first = std::make_shared<int>(0);
+  auto second = std::make_shared<int>(1);
+  buffer.AddSample(0_s, Sample{first});
+  buffer.AddSample(1_s, Sample{second});
+  EXPECT_EQ(buffer.Sample(0.4_s)->value, first);
+  EXPECT_EQ(buffer.Sample(0.6_s)->value, second);
+  EXPECT_EQ(first.use_count(), 2);
+
+  // Removing a sample releases it right away
+  buffer.AddSample(1.5_s, Sample{std::make_shared<int>(2)});
+  EXPECT_EQ(first.use_count(), 1);
+  EXPECT_EQ(buffer.GetSampleBuffer().size(), 2u);
+  EXPECT_EQ(buffer.Sample(0_s)->value, second);
+}
+
+WPI_IGNORE_DEPRECATED
+TEST(TimeInterpolatableBufferTest, FunctionInterpolator) {
+  // Lambdas can still be passed as a std::function
+  frc::TimeInterpolatableBuffer<double> buffer{
+      10_s, [](double start, double end, double t) {
+        return t < 0.5 ? start : end;
+      }};
+
+  buffer.AddSample(0_s, 0);
+  buffer.AddSample(1_s, 1);
+  EXPECT_EQ(buffer.Sample(0.4_s).value(), 0);
+  EXPECT_EQ(buffer.Sample(0.6_s).value(), 1);
+  EXPECT_FALSE(buffer.GetSampleBuffer().empty());
+}
+WPI_UNIGNORE_DEPRECATED
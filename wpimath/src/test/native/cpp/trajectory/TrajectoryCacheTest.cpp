@@ -0,0 +1,119 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wpi/fs.h>
+#include <wpi/raw_ostream.h>
+
+#include "frc/trajectory/TrajectoryConfig.h"
+#include "frc/trajectory/TrajectoryGenerator.h"
+#include "frc/trajectory/TrajectoryUtil.h"
+#include "frc/trajectory/constraint/CentripetalAccelerationConstraint.h"
+#include "trajectory/TestTrajectory.h"
+
+using namespace frc;
+
+// Requests reference their config, so temporaries aren't allowed
+static_assert(!std::is_constructible_v<TrajectoryGenerator::Request,
+                                       std::vector<Pose2d>, TrajectoryConfig>);
+static_assert(
+    !std::is_constructible_v<TrajectoryGenerator::Request, Pose2d,
+                             std::vector<Translation2d>, Pose2d,
+                             TrajectoryConfig>);
+static_assert(std::is_constructible_v<TrajectoryGenerator::Request,
+                                      std::vector<Pose2d>, TrajectoryConfig&>);
+
+TEST(TrajectoryCacheTest, DeserializeMatches) {
+  TrajectoryConfig config{12_fps, 12_fps_sq};
+  std::vector<Trajectory> trajectories{TestTrajectory::GetTrajectory(config),
+                                       Trajectory{}};
+
+  auto data = TrajectoryUtil::SerializeTrajectoriesBinary(trajectories, 42);
+  auto deserialized = TrajectoryUtil::DeserializeTrajectoriesBinary(data, 42);
+  ASSERT_TRUE(deserialized);
+  EXPECT_EQ(trajectories, *deserialized);
+
+  // Wrong key
+  EXPECT_FALSE(TrajectoryUtil::DeserializeTrajectoriesBinary(data, 43));
+
+  // Truncated
+  data.pop_back();
+  EXPECT_FALSE(TrajectoryUtil::DeserializeTrajectoriesBinary(data, 42));
+  EXPECT_FALSE(TrajectoryUtil::DeserializeTrajectoriesBinary({}, 42));
+
+  // Trajectory count larger than the data; the count is the last field of
+  // the header
+  auto header = TrajectoryUtil::SerializeTrajectoriesBinary({}, 42);
+  std::fill(header.end() - 4, header.end(), 0xff);
+  EXPECT_FALSE(TrajectoryUtil::DeserializeTrajectoriesBinary(header, 42));
+}
+
+TEST(TrajectoryCacheTest, HashDetectsChanges) {
+  std::vector<Pose2d> waypoints{{0_m, 0_m, 0_deg}, {3_m, 1_m, 45_deg}};
+
+  auto hash = [&](units::meters_per_second_squared_t maxCentripetal,
+                  const std::vector<Pose2d>& waypoints) {
+    TrajectoryConfig config{3_mps, 2_mps_sq};
+    config.AddConstraint(CentripetalAccelerationConstraint{maxCentripetal});
+    std::vector<TrajectoryGenerator::Request> requests;
+    requests.emplace_back(waypoints, config);
+    return TrajectoryUtil::HashTrajectoryRequests(requests);
+  };
+
+  EXPECT_EQ(hash(1_mps_sq, waypoints), hash(1_mps_sq, waypoints));
+  EXPECT_NE(hash(1_mps_sq, waypoints), hash(2_mps_sq, waypoints));
+
+  auto movedWaypoints = waypoints;
+  movedWaypoints[1] = Pose2d{3_m, 1.01_m, 45_deg};
+  EXPECT_NE(hash(1_mps_sq, waypoints), hash(1_mps_sq, movedWaypoints));
+}
+
+TEST(TrajectoryCacheTest, GenerateTrajectoriesCached) {
+  TrajectoryConfig config{3_mps, 2_mps_sq};
+  std::vector<TrajectoryGenerator::Request> requests;
+  requests.emplace_back(
+      std::vector<Pose2d>{{0_m, 0_m, 0_deg}, {3_m, 1_m, 45_deg}}, config);
+  requests.emplace_back(Pose2d{0_m, 0_m, 0_deg},
+                        std::vector<Translation2d>{{1_m, 0.5_m}},
+                        Pose2d{3_m, 1_m, 30_deg}, config);
+
+  std::string path =
+      (fs::temp_directory_path() / "TrajectoryCacheTest.bin").string();
+  fs::remove(path);
+
+  auto generated = TrajectoryUtil::GenerateTrajectoriesCached(requests, path);
+  EXPECT_EQ(TrajectoryGenerator::GenerateTrajectories(requests), generated);
+  ASSERT_TRUE(fs::exists(path));
+  EXPECT_FALSE(fs::exists(path + ".tmp"));
+
+  auto cached = TrajectoryUtil::GenerateTrajectoriesCached(requests, path);
+  EXPECT_EQ(generated, cached);
+
+  // Trajectories are loaded from the cache file instead of being generated
+  {
+    std::vector<Trajectory> placeholders(2);
+    auto data = TrajectoryUtil::SerializeTrajectoriesBinary(
+        placeholders, TrajectoryUtil::HashTrajectoryRequests(requests));
+    std::error_code ec;
+    wpi::raw_fd_ostream output{path, ec};
+    ASSERT_FALSE(ec);
+    output.write(data.data(), data.size());
+  }
+  EXPECT_EQ(std::vector<Trajectory>(2),
+            TrajectoryUtil::GenerateTrajectoriesCached(requests, path));
+
+  // Changed requests regenerate the trajectories
+  requests.pop_back();
+  auto regenerated = TrajectoryUtil::GenerateTrajectoriesCached(requests, path);
+  ASSERT_EQ(1u, regenerated.size());
+  EXPECT_EQ(generated[0], regenerated[0]);
+
+  fs::remove(path);
+}
@@ -2,6 +2,7 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <span>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -55,3 +56,86 @@ TEST(TrajectoryGenerationTest, CurvatureOptimization) {
     EXPECT_NE(0, t.States()[i].curvature.value());
   }
 }
+
+TEST(TrajectoryGenerationTest, ReuseWorkspace) {
+  TrajectoryGenerator::Workspace workspace;
+  Trajectory trajectory;
+
+  const std::vector<Pose2d> waypoints{
+      {1_m, 0_m, 90_deg}, {0_m, 1_m, 180_deg}, {-1_m, 0_m, 270_deg}};
+  const Pose2d start{1.54_ft, 23.23_ft, 180_deg};
+  const Pose2d end{23.7_ft, 6.8_ft, -160_deg};
+  const std::vector<Translation2d> interiorWaypoints{
+      {-11.46_ft, 23.23_ft}, {-17.96_ft, 18.23_ft}, {-10_ft, 10_ft}};
+
+  for (bool reversed : {false, true}) {
+    TrajectoryConfig config{12_fps, 12_fps_sq};
+    config.SetReversed(reversed);
+    config.AddConstraint(CentripetalAccelerationConstraint{8_fps_sq});
+
+    TrajectoryGenerator::GenerateTrajectory(waypoints, config, workspace,
+                                            &trajectory);
+    EXPECT_EQ(TrajectoryGenerator::GenerateTrajectory(waypoints, config),
+              trajectory);
+
+    TrajectoryGenerator::GenerateTrajectory(start, interiorWaypoints, end,
+                                            config, workspace, &trajectory);
+    EXPECT_EQ(TrajectoryGenerator::GenerateTrajectory(start, interiorWaypoints,
+                                                      end, config),
+              trajectory);
+
+    TrajectoryGenerator::GenerateTrajectory(
+        start, std::span{interiorWaypoints}.first(1), end, config, workspace,
+        &trajectory);
+    EXPECT_EQ(TrajectoryGenerator::GenerateTrajectory(
+                  start, std::vector{interiorWaypoints.front()}, end, config),
+              trajectory);
+  }
+
+  // Malformed splines still return the do-nothing trajectory
+  TrajectoryGenerator::GenerateTrajectory(
+      std::vector<Pose2d>{Pose2d{0_m, 0_m, 0_deg}, Pose2d{1_m, 0_m, 180_deg}},
+      TrajectoryConfig(12_fps, 12_fps_sq), workspace, &trajectory);
+  ASSERT_EQ(trajectory.States().size(), 1u);
+  ASSERT_EQ(trajectory.TotalTime(), 0_s);
+}
+
+TEST(TrajectoryGenerationTest, GenerateTrajectoriesInParallel) {
+  TrajectoryConfig config{3_mps, 2_mps_sq};
+  config.AddConstraint(CentripetalAccelerationConstraint{1.5_mps_sq});
+  TrajectoryConfig reversedConfig{2_mps, 1_mps_sq};
+  reversedConfig.SetReversed(true);
+
+  std::vector<TrajectoryGenerator::Request> requests;
+  for (int i = 0; i < 10; ++i) {
+    auto offset = units::meter_t{0.5 * i};
+    requests.emplace_back(
+        std::vector<Pose2d>{{0_m, 0_m, 0_deg},
+                            {2_m, 1_m + offset, 45_deg},
+                            {4_m + offset, 0_m, -30_deg}},
+        i % 2 == 0 ? config : reversedConfig);
+    requests.emplace_back(Pose2d{0_m, 0_m, 0_deg},
+                          std::vector<Translation2d>{{1_m, offset}},
+                          Pose2d{3_m, 1_m, 30_deg}, config);
+  }
+
+  auto single = TrajectoryGenerator::GenerateTrajectories(requests, 1);
+  auto parallel = TrajectoryGenerator::GenerateTrajectories(requests, 4);
+  ASSERT_EQ(requests.size(), single.size());
+  ASSERT_EQ(requests.size(), parallel.size());
+
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const auto& request = requests[i];
+    auto expected =
+        request.interiorWaypoints
+            ? TrajectoryGenerator::GenerateTrajectory(
+                  request.waypoints.front(), *request.interiorWaypoints,
+                  request.waypoints.back(), *request.config)
+            : TrajectoryGenerator::GenerateTrajectory(request.waypoints,
+                                                      *request.config);
+    EXPECT_EQ(expected, single[i]);
+    EXPECT_EQ(expected, parallel[i]);
+  }
+
+  EXPECT_TRUE(TrajectoryGenerator::GenerateTrajectories({}).empty());
+}
@@ -33,6 +33,9 @@ int main(int argc, const char** argv) {
   }
 
   wpi::DenseMap<int, wpi::log::StartRecordData> entries;
+  // previous values of delta-encoded entries
+  wpi::DenseMap<int, std::vector<int64_t>> deltaInts;
+  wpi::DenseMap<int, std::vector<double>> deltaDoubles;
   for (auto&& record : reader) {
     if (record.IsStart()) {
       wpi::log::StartRecordData data;
@@ -44,6 +47,8 @@ int main(int argc, const char** argv) {
           wpi::print("...DUPLICATE entry ID, overriding\n");
         }
         entries[data.entry] = data;
+        deltaInts.erase(data.entry);
+        deltaDoubles.erase(data.entry);
       } else {
         wpi::print("Start(INVALID)\n");
       }
@@ -154,6 +159,20 @@ int main(int argc, const char** argv) {
         } else {
           wpi::print("  invalid\n");
         }
+      } else if (entry->second.type == "delta:int64[]") {
+        auto& val = deltaInts[record.GetEntry()];
+        if (record.GetDeltaIntegerArray(&val)) {
+          wpi::print("  {}\n", fmt::join(val, ", "));
+        } else {
+          wpi::print("  invalid\n");
+        }
+      } else if (entry->second.type == "delta:double[]") {
+        auto& val = deltaDoubles[record.GetEntry()];
+        if (record.GetDeltaDoubleArray(&val)) {
+          wpi::print("  {}\n", fmt::join(val, ", "));
+        } else {
+          wpi::print("  invalid\n");
+        }
       } else if (entry->second.type == "string[]") {
         std::vector<std::string_view> val;
         if (record.GetStringArray(&val)) {
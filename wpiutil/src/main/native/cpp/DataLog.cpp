@@ -5,10 +5,12 @@
 #include "wpi/DataLog.h"
 
 #include <algorithm>
+#include <atomic>
 #include <bit>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <iterator>
 #include <string>
 #include <utility>
 #include <vector>
@@ -16,13 +18,12 @@
 #include "wpi/Endian.h"
 #include "wpi/Logger.h"
 #include "wpi/SmallString.h"
+#include "wpi/lz4.h"
 #include "wpi/print.h"
 #include "wpi/timestamp.h"
 
 using namespace wpi::log;
 
-static constexpr size_t kRecordMaxHeaderSize = 17;
-
 static void DefaultLog(unsigned int level, const char* file, unsigned int line,
                        const char* msg) {
   if (level > wpi::WPI_LOG_INFO) {
@@ -63,6 +64,70 @@ static unsigned int WriteRecordHeader(uint8_t* buf, uint32_t entry,
   return buf - origbuf;
 }
 
+// number of delta-encoded records between keyframes
+static constexpr unsigned int kDeltaKeyframeInterval = 50;
+
+static void WriteUleb128(wpi::SmallVectorImpl<uint8_t>& out, uint64_t val) {
+  do {
+    uint8_t byte = val & 0x7f;
+    val >>= 7;
+    if (val != 0) {
+      byte |= 0x80;
+    }
+    out.push_back(byte);
+  } while (val != 0);
+}
+
+static void WriteIntegerDelta(wpi::SmallVectorImpl<uint8_t>& out, uint64_t val,
+                              uint64_t prev) {
+  uint64_t delta = val - prev;
+  // ZigZag encode so small negative differences are also short
+  WriteUleb128(out, (delta << 1) ^ (0 - (delta >> 63)));
+}
+
+static void WriteDoubleDelta(wpi::SmallVectorImpl<uint8_t>& out, uint64_t val,
+                             uint64_t prev) {
+  uint64_t x = val ^ prev;
+  if (x == 0) {
+    out.push_back(0x80);
+    return;
+  }
+  unsigned int leading = std::countl_zero(x) / 8;
+  unsigned int trailing = std::countr_zero(x) / 8;
+  out.push_back((leading << 4) | trailing);
+  x >>= trailing * 8;
+  for (unsigned int i = leading + trailing; i < 8; ++i) {
+    out.push_back(x & 0xff);
+    x >>= 8;
+  }
+}
+
+void wpi::log::impl::AppendCompressedHeader(std::vector<uint8_t>* out) {
+  out->insert(out->end(), kCompressedMagic.begin(), kCompressedMagic.end());
+  out->resize(out->size() + 2);
+  wpi::support::endian::write16le(out->data() + out->size() - 2,
+                                  kCompressedVersion);
+}
+
+void wpi::log::impl::AppendCompressedBlock(std::span<const uint8_t> data,
+                                           std::vector<uint8_t>* out) {
+  size_t start = out->size();
+  out->resize(start + kCompressedBlockHeaderSize +
+              wpi::Lz4CompressBound(data.size()));
+  uint8_t* header = out->data() + start;
+  size_t size = wpi::Lz4Compress(
+      data, std::span{header + kCompressedBlockHeaderSize,
+                      out->size() - start - kCompressedBlockHeaderSize});
+  if (size == 0 || size >= data.size()) {
+    // incompressible; store as-is
+    size = data.size();
+    std::memcpy(header + kCompressedBlockHeaderSize, data.data(), size);
+  }
+  wpi::support::endian::write32le(header, size);
+  wpi::support::endian::write32le(header + 4, data.size());
+  out->resize(start + kCompressedBlockHeaderSize + size);
+}
+
 void DataLog::StartFile() {
   std::scoped_lock lock{m_mutex};
   if (m_active) {
@@ -81,6 +146,11 @@ void DataLog::StartFile() {
   support::endian::write32le(buf + 8, m_extraHeader.size());
   std::memcpy(buf + 12, m_extraHeader.data(), m_extraHeader.size());
 
+  // Delta-encoded entries must start over with a keyframe
+  for (auto&& entryInfo2 : m_entryIds) {
+    entryInfo2.second.deltaRemaining = 0;
+  }
+
   // Existing start and schema data records
   for (auto&& entryInfo : m_entries) {
     AppendStartRecord(entryInfo.second.id, entryInfo.first,
@@ -102,6 +172,7 @@ void DataLog::StartFile() {
 }
 
 void DataLog::FlushBufs(std::vector<Buffer>* writeBufs) {
+  DrainShards();
   std::scoped_lock lock{m_mutex};
   writeBufs->swap(m_outgoing);
   DoReleaseBufs(&m_outgoing);
@@ -225,6 +296,8 @@ void DataLog::Finish(int entry, int64_t timestamp) {
   if (entry <= 0) {
     return;
   }
+  // make sure previously appended data records are written before the finish
+  DrainShards();
   std::scoped_lock lock{m_mutex};
   auto& entryInfo2 = m_entryIds[entry];
   if (entryInfo2.count == 0) {
@@ -248,6 +321,7 @@ void DataLog::SetMetadata(int entry, std::string_view metadata,
   if (entry <= 0) {
     return;
   }
+  DrainShards();
   std::scoped_lock lock{m_mutex};
   m_entryIds[entry].metadata = metadata;
   if (!m_active) {
@@ -259,53 +333,110 @@ void DataLog::SetMetadata(int entry, std::string_view metadata,
   AppendStringImpl(metadata);
 }
 
-uint8_t* DataLog::Reserve(size_t size) {
-  assert(size <= kBlockSize);
-  if (m_outgoing.empty() || size > m_outgoing.back().GetRemaining()) {
+DataLog::Shard& DataLog::GetShard() {
+  // threads are assigned to shards round-robin on first use
+  static std::atomic<unsigned int> nextShard{0};
+  thread_local unsigned int shard = nextShard++ % kNumShards;
+  return m_shards[shard];
+}
+
+void DataLog::DrainShards() {
+  for (auto&& shard : m_shards) {
+    std::scoped_lock lock{shard.mutex};
+    if (shard.bufs.empty()) {
+      continue;
+    }
+    // not ReleaseShard(), as the buffers are about to be flushed anyway, and
+    // BufferHalfFull() may lock the writer mutex the flushing caller holds
+    std::scoped_lock lock2{m_mutex};
+    std::move(shard.bufs.begin(), shard.bufs.end(),
+              std::back_inserter(m_outgoing));
+    shard.bufs.clear();
+  }
+}
+
+void DataLog::ReleaseShard(Shard& shard) {
+  for (auto&& buf : shard.bufs) {
+    m_outgoing.emplace_back(std::move(buf));
     if (m_outgoing.size() == kMaxBufferCount / 2) {
       [[unlikely]] BufferHalfFull();
     }
-    if (m_free.empty()) {
-      if (m_outgoing.size() >= kMaxBufferCount) {
-        [[unlikely]]
-        if (BufferFull()) {
-          m_paused = true;
-        }
+  }
+  shard.bufs.clear();
+}
+
+DataLog::Buffer DataLog::AllocBuffer() {
+  if (m_free.empty()) {
+    if (m_outgoing.size() >= kMaxBufferCount) {
+      [[unlikely]]
+      if (BufferFull()) {
+        m_paused = true;
       }
-      m_outgoing.emplace_back();
-    } else {
-      m_outgoing.emplace_back(std::move(m_free.back()));
-      m_free.pop_back();
     }
+    return Buffer{};
+  }
+  Buffer buf = std::move(m_free.back());
+  m_free.pop_back();
+  return buf;
+}
+
+uint8_t* DataLog::Reserve(size_t size, Shard* shard) {
+  assert(size <= kBlockSize);
+  if (shard) {
+    if (shard->bufs.empty() || size > shard->bufs.back().GetRemaining()) {
+      std::scoped_lock lock{m_mutex};
+      shard->bufs.emplace_back(AllocBuffer());
+    }
+    return shard->bufs.back().Reserve(size);
+  }
+  if (m_outgoing.empty() || size > m_outgoing.back().GetRemaining()) {
+    if (m_outgoing.size() == kMaxBufferCount / 2) {
+      [[unlikely]] BufferHalfFull();
+    }
+    m_outgoing.emplace_back(AllocBuffer());
   }
   return m_outgoing.back().Reserve(size);
 }
 
 uint8_t* DataLog::StartRecord(uint32_t entry, uint64_t timestamp,
-                              uint32_t payloadSize, size_t reserveSize) {
-  uint8_t* buf = Reserve(kRecordMaxHeaderSize + reserveSize);
+                              uint32_t payloadSize, size_t reserveSize,
+                              Shard* shard) {
+  size_t size = kRecordMaxHeaderSize + reserveSize;
+  if (shard && !shard->bufs.empty() &&
+      (shard->bufs.size() > 1 || size > shard->bufs.back().GetRemaining())) {
+    // At a record boundary, so full buffers can be moved to the outgoing
+    // queue without splitting a record across shards.  Grab a new buffer at
+    // the same time to avoid locking twice.
+    std::scoped_lock lock{m_mutex};
+    ReleaseShard(*shard);
+    shard->bufs.emplace_back(AllocBuffer());
+  }
+  uint8_t* buf = Reserve(size, shard);
   auto headerLen = WriteRecordHeader(buf, entry, timestamp, payloadSize);
-  m_outgoing.back().Unreserve(kRecordMaxHeaderSize - headerLen);
+  (shard ? shard->bufs : m_outgoing)
+      .back()
+      .Unreserve(kRecordMaxHeaderSize - headerLen);
   buf += headerLen;
   return buf;
 }
 
-void DataLog::AppendImpl(std::span<const uint8_t> data) {
+void DataLog::AppendImpl(std::span<const uint8_t> data, Shard* shard) {
   while (data.size() > kBlockSize) {
-    uint8_t* buf = Reserve(kBlockSize);
+    uint8_t* buf = Reserve(kBlockSize, shard);
     std::memcpy(buf, data.data(), kBlockSize);
     data = data.subspan(kBlockSize);
   }
   if (!data.empty()) {
-    uint8_t* buf = Reserve(data.size());
+    uint8_t* buf = Reserve(data.size(), shard);
     std::memcpy(buf, data.data(), data.size());
   }
 }
 
-void DataLog::AppendStringImpl(std::string_view str) {
-  uint8_t* buf = Reserve(4);
+void DataLog::AppendStringImpl(std::string_view str, Shard* shard) {
+  uint8_t* buf = Reserve(4, shard);
   wpi::support::endian::write32le(buf, str.size());
-  AppendImpl({reinterpret_cast<const uint8_t*>(str.data()), str.size()});
+  AppendImpl({reinterpret_cast<const uint8_t*>(str.data()), str.size()},
+             shard);
 }
 
 void DataLog::AppendRaw(int entry, std::span<const uint8_t> data,
@@ -313,12 +444,53 @@ void DataLog::AppendRaw(int entry, std::span<const uint8_t> data,
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  StartRecord(entry, timestamp, data.size(), 0);
-  AppendImpl(data);
+  auto& shard = GetShard();
+  std::scoped_lock lock{shard.mutex};
+  StartRecord(entry, timestamp, data.size(), 0, &shard);
+  AppendImpl(data, &shard);
+}
+
+template <typename T>
+void DataLog::AppendDeltaArray(int entry, std::span<const T> arr,
+                               int64_t timestamp) {
+  if (entry <= 0) {
+    return;
+  }
+  if (m_paused) {
+    [[unlikely]] return;
+  }
+  wpi::SmallVector<uint8_t, 256> buf;
+  // Each record depends on the previous one, so unlike other data records,
+  // these are written directly to the outgoing queue to keep them in order.
+  std::scoped_lock lock{m_mutex};
+  auto it = m_entryIds.find(entry);
+  EntryInfo2* info = it != m_entryIds.end() ? &it->second : nullptr;
+  bool keyframe = !info || info->deltaRemaining == 0 ||
+                  info->deltaLast.size() != arr.size();
+  buf.push_back(keyframe ? impl::kDeltaKeyframe : impl::kDeltaDelta);
+  WriteUleb128(buf, arr.size());
+  for (size_t i = 0; i < arr.size(); ++i) {
+    uint64_t val = std::bit_cast<uint64_t>(arr[i]);
+    uint64_t prev = keyframe ? 0 : info->deltaLast[i];
+    if constexpr (std::same_as<T, double>) {
+      WriteDoubleDelta(buf, val, prev);
+    } else {
+      WriteIntegerDelta(buf, val, prev);
+    }
+  }
+  if (info) {
+    info->deltaLast.resize(arr.size());
+    for (size_t i = 0; i < arr.size(); ++i) {
+      info->deltaLast[i] = std::bit_cast<uint64_t>(arr[i]);
+    }
+    info->deltaRemaining =
+        keyframe ? kDeltaKeyframeInterval : info->deltaRemaining - 1;
+  }
+  StartRecord(entry, timestamp, buf.size(), 0);
+  AppendImpl(buf);
 }
 
 void DataLog::AppendRaw2(int entry,
@@ -327,17 +499,18 @@ void DataLog::AppendRaw2(int entry,
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
+  auto& shard = GetShard();
+  std::scoped_lock lock{shard.mutex};
   size_t size = 0;
   for (auto&& chunk : data) {
     size += chunk.size();
   }
-  StartRecord(entry, timestamp, size, 0);
+  StartRecord(entry, timestamp, size, 0, &shard);
   for (auto chunk : data) {
-    AppendImpl(chunk);
+    AppendImpl(chunk, &shard);
   }
 }
 
@@ -345,11 +518,12 @@ void DataLog::AppendBoolean(int entry, bool value, int64_t timestamp) {
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  uint8_t* buf = StartRecord(entry, timestamp, 1, 1);
+  auto& shard = GetShard();
+  std::scoped_lock lock{shard.mutex};
+  uint8_t* buf = StartRecord(entry, timestamp, 1, 1, &shard);
   buf[0] = value ? 1 : 0;
 }
 
@@ -357,11 +531,12 @@ void DataLog::AppendInteger(int entry, int64_t value, int64_t timestamp) {
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  uint8_t* buf = StartRecord(entry, timestamp, 8, 8);
+  auto& shard = GetShard();
+  std::scoped_lock lock{shard.mutex};
+  uint8_t* buf = StartRecord(entry, timestamp, 8, 8, &shard);
   wpi::support::endian::write64le(buf, value);
 }
 
@@ -369,11 +544,12 @@ void DataLog::AppendFloat(int entry, float value, int64_t timestamp) {
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  uint8_t* buf = StartRecord(entry, timestamp, 4, 4);
+  auto& shard = GetShard();
+  std::scoped_lock lock{shard.mutex};
+  uint8_t* buf = StartRecord(entry, timestamp, 4, 4, &shard);
   if constexpr (std::endian::native == std::endian::little) {
     std::memcpy(buf, &value, 4);
   } else {
@@ -385,11 +561,12 @@ void DataLog::AppendDouble(int entry, double value, int64_t timestamp) {
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  uint8_t* buf = StartRecord(entry, timestamp, 8, 8);
+  auto& shard = GetShard();
+  std::scoped_lock lock{shard.mutex};
+  uint8_t* buf = StartRecord(entry, timestamp, 8, 8, &shard);
   if constexpr (std::endian::native == std::endian::little) {
     std::memcpy(buf, &value, 8);
   } else {
@@ -409,20 +586,21 @@ void DataLog::AppendBooleanArray(int entry, std::span<const bool> arr,
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  StartRecord(entry, timestamp, arr.size(), 0);
+  auto& shard = GetShard();
+  std::scoped_lock lock{shard.mutex};
+  StartRecord(entry, timestamp, arr.size(), 0, &shard);
   uint8_t* buf;
   while (arr.size() > kBlockSize) {
-    buf = Reserve(kBlockSize);
+    buf = Reserve(kBlockSize, &shard);
     for (auto val : arr.subspan(0, kBlockSize)) {
       *buf++ = val ? 1 : 0;
     }
     arr = arr.subspan(kBlockSize);
   }
-  buf = Reserve(arr.size());
+  buf = Reserve(arr.size(), &shard);
   for (auto val : arr) {
     *buf++ = val ? 1 : 0;
   }
@@ -433,20 +611,21 @@ void DataLog::AppendBooleanArray(int entry, std::span<const int> arr,
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  StartRecord(entry, timestamp, arr.size(), 0);
+  auto& shard = GetShard();
+  std::scoped_lock lock{shard.mutex};
+  StartRecord(entry, timestamp, arr.size(), 0, &shard);
   uint8_t* buf;
   while (arr.size() > kBlockSize) {
-    buf = Reserve(kBlockSize);
+    buf = Reserve(kBlockSize, &shard);
     for (auto val : arr.subspan(0, kBlockSize)) {
       *buf++ = val & 1;
     }
     arr = arr.subspan(kBlockSize);
   }
-  buf = Reserve(arr.size());
+  buf = Reserve(arr.size(), &shard);
   for (auto val : arr) {
     *buf++ = val & 1;
   }
@@ -467,21 +646,22 @@ void DataLog::AppendIntegerArray(int entry, std::span<const int64_t> arr,
     if (entry <= 0) {
       return;
     }
-    std::scoped_lock lock{m_mutex};
     if (m_paused) {
       [[unlikely]] return;
     }
-    StartRecord(entry, timestamp, arr.size() * 8, 0);
+    auto& shard = GetShard();
+    std::scoped_lock lock{shard.mutex};
+    StartRecord(entry, timestamp, arr.size() * 8, 0, &shard);
     uint8_t* buf;
     while ((arr.size() * 8) > kBlockSize) {
-      buf = Reserve(kBlockSize);
+      buf = Reserve(kBlockSize, &shard);
       for (auto val : arr.subspan(0, kBlockSize / 8)) {
         wpi::support::endian::write64le(buf, val);
         buf += 8;
       }
       arr = arr.subspan(kBlockSize / 8);
     }
-    buf = Reserve(arr.size() * 8);
+    buf = Reserve(arr.size() * 8, &shard);
     for (auto val : arr) {
       wpi::support::endian::write64le(buf, val);
       buf += 8;
@@ -499,21 +679,22 @@ void DataLog::AppendFloatArray(int entry, std::span<const float> arr,
     if (entry <= 0) {
       return;
     }
-    std::scoped_lock lock{m_mutex};
     if (m_paused) {
       [[unlikely]] return;
     }
-    StartRecord(entry, timestamp, arr.size() * 4, 0);
+    auto& shard = GetShard();
+    std::scoped_lock lock{shard.mutex};
+    StartRecord(entry, timestamp, arr.size() * 4, 0, &shard);
     uint8_t* buf;
     while ((arr.size() * 4) > kBlockSize) {
-      buf = Reserve(kBlockSize);
+      buf = Reserve(kBlockSize, &shard);
       for (auto val : arr.subspan(0, kBlockSize / 4)) {
         wpi::support::endian::write32le(buf, std::bit_cast<uint32_t>(val));
         buf += 4;
       }
       arr = arr.subspan(kBlockSize / 4);
     }
-    buf = Reserve(arr.size() * 4);
+    buf = Reserve(arr.size() * 4, &shard);
     for (auto val : arr) {
       wpi::support::endian::write32le(buf, std::bit_cast<uint32_t>(val));
       buf += 4;
@@ -531,21 +712,22 @@ void DataLog::AppendDoubleArray(int entry, std::span<const double> arr,
     if (entry <= 0) {
       return;
     }
-    std::scoped_lock lock{m_mutex};
     if (m_paused) {
       [[unlikely]] return;
     }
-    StartRecord(entry, timestamp, arr.size() * 8, 0);
+    auto& shard = GetShard();
+    std::scoped_lock lock{shard.mutex};
+    StartRecord(entry, timestamp, arr.size() * 8, 0, &shard);
     uint8_t* buf;
     while ((arr.size() * 8) > kBlockSize) {
-      buf = Reserve(kBlockSize);
+      buf = Reserve(kBlockSize, &shard);
       for (auto val : arr.subspan(0, kBlockSize / 8)) {
         wpi::support::endian::write64le(buf, std::bit_cast<uint64_t>(val));
         buf += 8;
       }
       arr = arr.subspan(kBlockSize / 8);
     }
-    buf = Reserve(arr.size() * 8);
+    buf = Reserve(arr.size() * 8, &shard);
     for (auto val : arr) {
       wpi::support::endian::write64le(buf, std::bit_cast<uint64_t>(val));
       buf += 8;
@@ -553,6 +735,16 @@ void DataLog::AppendDoubleArray(int entry, std::span<const double> arr,
   }
 }
 
+void DataLog::AppendDeltaIntegerArray(int entry, std::span<const int64_t> arr,
+                                      int64_t timestamp) {
+  AppendDeltaArray(entry, arr, timestamp);
+}
+
+void DataLog::AppendDeltaDoubleArray(int entry, std::span<const double> arr,
+                                     int64_t timestamp) {
+  AppendDeltaArray(entry, arr, timestamp);
+}
+
 void DataLog::AppendStringArray(int entry, std::span<const std::string> arr,
                                 int64_t timestamp) {
   if (entry <= 0) {
@@ -564,14 +756,15 @@ void DataLog::AppendStringArray(int entry, std::span<const std::string> arr,
   for (auto&& str : arr) {
     size += 4 + str.size();
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  uint8_t* buf = StartRecord(entry, timestamp, size, 4);
+  auto& shard = GetShard();
+  std::scoped_lock lock{shard.mutex};
+  uint8_t* buf = StartRecord(entry, timestamp, size, 4, &shard);
   wpi::support::endian::write32le(buf, arr.size());
   for (auto&& str : arr) {
-    AppendStringImpl(str);
+    AppendStringImpl(str, &shard);
   }
 }
 
@@ -587,14 +780,15 @@ void DataLog::AppendStringArray(int entry,
   for (auto&& str : arr) {
     size += 4 + str.size();
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  uint8_t* buf = StartRecord(entry, timestamp, size, 4);
+  auto& shard = GetShard();
+  std::scoped_lock lock{shard.mutex};
+  uint8_t* buf = StartRecord(entry, timestamp, size, 4, &shard);
   wpi::support::endian::write32le(buf, arr.size());
   for (auto&& sv : arr) {
-    AppendStringImpl(sv);
+    AppendStringImpl(sv, &shard);
   }
 }
 
@@ -610,14 +804,15 @@ void DataLog::AppendStringArray(int entry,
   for (auto&& str : arr) {
     size += 4 + str.len;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  uint8_t* buf = StartRecord(entry, timestamp, size, 4);
+  auto& shard = GetShard();
+  std::scoped_lock lock{shard.mutex};
+  uint8_t* buf = StartRecord(entry, timestamp, size, 4, &shard);
   wpi::support::endian::write32le(buf, arr.size());
   for (auto&& sv : arr) {
-    AppendStringImpl(sv.str);
+    AppendStringImpl(sv.str, &shard);
   }
 }
 
@@ -706,6 +901,22 @@ void DoubleArrayLogEntry::Update(std::span<const double> arr,
   }
 }
 
+void DeltaIntegerArrayLogEntry::Update(std::span<const int64_t> arr,
+                                       int64_t timestamp) {
+  std::scoped_lock lock{m_mutex};
+  if (UpdateImpl(m_lastValue, arr)) {
+    Append(arr, timestamp);
+  }
+}
+
+void DeltaDoubleArrayLogEntry::Update(std::span<const double> arr,
+                                      int64_t timestamp) {
+  std::scoped_lock lock{m_mutex};
+  if (UpdateImpl(m_lastValue, arr)) {
+    Append(arr, timestamp);
+  }
+}
+
 void StringArrayLogEntry::Update(std::span<const std::string> arr,
                                  int64_t timestamp) {
   std::scoped_lock lock{m_mutex};
@@ -49,32 +49,36 @@ static std::string FormatBytesSize(uintmax_t value) {
 DataLogBackgroundWriter::DataLogBackgroundWriter(std::string_view dir,
                                                  std::string_view filename,
                                                  double period,
-                                                 std::string_view extraHeader)
+                                                 std::string_view extraHeader,
+                                                 bool compress)
     : DataLogBackgroundWriter{s_defaultMessageLog, dir, filename, period,
-                              extraHeader} {}
+                              extraHeader, compress} {}
 
 DataLogBackgroundWriter::DataLogBackgroundWriter(wpi::Logger& msglog,
                                                  std::string_view dir,
                                                  std::string_view filename,
                                                  double period,
-                                                 std::string_view extraHeader)
+                                                 std::string_view extraHeader,
+                                                 bool compress)
     : DataLog{msglog, extraHeader},
       m_period{period},
+      m_compress{compress},
       m_newFilename{filename},
       m_thread{[this, dir = std::string{dir}] { WriterThreadMain(dir); }} {}
 
 DataLogBackgroundWriter::DataLogBackgroundWriter(
     std::function<void(std::span<const uint8_t> data)> write, double period,
-    std::string_view extraHeader)
+    std::string_view extraHeader, bool compress)
     : DataLogBackgroundWriter{s_defaultMessageLog, std::move(write), period,
-                              extraHeader} {}
+                              extraHeader, compress} {}
 
 DataLogBackgroundWriter::DataLogBackgroundWriter(
     wpi::Logger& msglog,
     std::function<void(std::span<const uint8_t> data)> write, double period,
-    std::string_view extraHeader)
+    std::string_view extraHeader, bool compress)
     : DataLog{msglog, extraHeader},
       m_period{period},
+      m_compress{compress},
       m_thread{[this, write = std::move(write)] {
         WriterThreadMain(std::move(write));
       }} {}
@@ -274,6 +278,11 @@ void DataLogBackgroundWriter::StartLogFile(WriterThreadState& state) {
 
   // start file
   if (state.f != fs::kInvalidFile) {
+    if (m_compress) {
+      std::vector<uint8_t> header;
+      impl::AppendCompressedHeader(&header);
+      WriteToFile(state.f, header, state.filename, m_msglog);
+    }
     StartFile();
   }
 }
@@ -291,6 +300,7 @@ void DataLogBackgroundWriter::WriterThreadMain(std::string_view dir) {
 
   std::error_code ec;
   std::vector<DataLog::Buffer> toWrite;
+  std::vector<uint8_t> compressed;
   int freeSpaceCount = 0;
   int checkExistCount = 0;
   bool blocked = false;
@@ -390,9 +400,16 @@ void DataLogBackgroundWriter::WriterThreadMain(std::string_view dir) {
 
         // write buffers to file
         for (auto&& buf : toWrite) {
+          std::span<const uint8_t> data = buf.GetData();
+          if (m_compress && !data.empty()) {
+            compressed.clear();
+            impl::AppendCompressedBlock(data, &compressed);
+            data = compressed;
+          }
+
           // stop writing when we go below the minimum free space
-          state.freeSpace -= buf.GetData().size();
-          written += buf.GetData().size();
+          state.freeSpace -= data.size();
+          written += data.size();
           if (state.freeSpace < kMinFreeSpace) {
             [[unlikely]] WPI_ERROR(
                 m_msglog,
@@ -401,7 +418,7 @@ void DataLogBackgroundWriter::WriterThreadMain(std::string_view dir) {
             blocked = true;
             break;
           }
-          WriteToFile(state.f, buf.GetData(), state.filename, m_msglog);
+          WriteToFile(state.f, data, state.filename, m_msglog);
         }
 
         // sync to storage
@@ -426,6 +443,12 @@ void DataLogBackgroundWriter::WriterThreadMain(
     std::function<void(std::span<const uint8_t> data)> write) {
   std::chrono::duration<double> periodTime{m_period};
 
+  std::vector<uint8_t> compressed;
+  if (m_compress) {
+    impl::AppendCompressedHeader(&compressed);
+    write(compressed);
+  }
+
   StartFile();
 
   std::vector<DataLog::Buffer> toWrite;
@@ -449,7 +472,14 @@ void DataLogBackgroundWriter::WriterThreadMain(
       lock.unlock();
       // write buffers
       for (auto&& buf : toWrite) {
-        if (!buf.GetData().empty()) {
+        if (buf.GetData().empty()) {
+          continue;
+        }
+        if (m_compress) {
+          compressed.clear();
+          impl::AppendCompressedBlock(buf.GetData(), &compressed);
+          write(compressed);
+        } else {
           write(buf.GetData());
         }
       }
@@ -0,0 +1,355 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/DataLogIndex.h"
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "wpi/DenseMap.h"
+#include "wpi/Endian.h"
+#include "wpi/raw_ostream.h"
+
+using namespace wpi::log;
+
+// Saved index format (all values little endian):
+// 8-byte magic "WPILOGIX"
+// 2-byte version
+// 8-byte log size
+// 4-byte entry count
+// for each entry:
+//   4-byte entry ID
+//   8-byte start timestamp
+//   8-byte finish timestamp
+//   name, type, metadata strings (4-byte length + contents)
+//   4-byte record count
+//   for each record: 8-byte timestamp, 8-byte position
+static constexpr std::string_view kMagic = "WPILOGIX";
+static constexpr uint16_t kVersion = 0x0100;
+
+static bool TimestampLess(const DataLogIndex::RecordInfo& a,
+                          const DataLogIndex::RecordInfo& b) {
+  return a.timestamp < b.timestamp;
+}
+
+static void Write16(wpi::raw_ostream& os, uint16_t val) {
+  uint8_t buf[2];
+  wpi::support::endian::write16le(buf, val);
+  os << std::span<const uint8_t>{buf};
+}
+
+static void Write32(wpi::raw_ostream& os, uint32_t val) {
+  uint8_t buf[4];
+  wpi::support::endian::write32le(buf, val);
+  os << std::span<const uint8_t>{buf};
+}
+
+static void Write64(wpi::raw_ostream& os, uint64_t val) {
+  uint8_t buf[8];
+  wpi::support::endian::write64le(buf, val);
+  os << std::span<const uint8_t>{buf};
+}
+
+static void WriteString(wpi::raw_ostream& os, std::string_view str) {
+  Write32(os, str.size());
+  os << str;
+}
+
+static bool Read16(std::span<const uint8_t>* buf, uint16_t* val) {
+  if (buf->size() < 2) {
+    return false;
+  }
+  *val = wpi::support::endian::read16le(buf->data());
+  *buf = buf->subspan(2);
+  return true;
+}
+
+static bool Read32(std::span<const uint8_t>* buf, uint32_t* val) {
+  if (buf->size() < 4) {
+    return false;
+  }
+  *val = wpi::support::endian::read32le(buf->data());
+  *buf = buf->subspan(4);
+  return true;
+}
+
+static bool Read64(std::span<const uint8_t>* buf, uint64_t* val) {
+  if (buf->size() < 8) {
+    return false;
+  }
+  *val = wpi::support::endian::read64le(buf->data());
+  *buf = buf->subspan(8);
+  return true;
+}
+
+static bool ReadString(std::span<const uint8_t>* buf, std::string* str) {
+  uint32_t len;
+  if (!Read32(buf, &len) || len > buf->size()) {
+    return false;
+  }
+  str->assign(reinterpret_cast<const char*>(buf->data()), len);
+  *buf = buf->subspan(len);
+  return true;
+}
+
+void DataLogIndex::Clear() {
+  m_logSize = 0;
+  m_entries.clear();
+  m_nameMap.clear();
+}
+
+namespace {
+// Results of scanning one range of the log.  As ranges are scanned
+// independently, the entry a data record belongs to is not known until the
+// ranges are merged.  Data records are instead grouped by entry ID into
+// segments separated by start and finish records for that entry ID; segment 0
+// belongs to whatever entry was active with that ID at the start of the range,
+// segment N to the entry active after the Nth start/finish record.
+struct RangeIndex {
+  struct Control {
+    uint64_t pos;
+    int entry;  // entry ID for start and finish records, 0 otherwise
+  };
+  std::vector<Control> controls;
+  wpi::DenseMap<int, std::vector<std::vector<DataLogIndex::RecordInfo>>>
+      segments;
+};
+}  // namespace
+
+bool DataLogIndex::Build(const DataLogReader& reader,
+                         unsigned int numThreads) {
+  Clear();
+  if (!reader.IsValid()) {
+    return false;
+  }
+  m_logSize = reader.m_buf->size();
+
+  if (numThreads == 0) {
+    numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  std::vector<RangeIndex> ranges;
+  ranges.resize(numThreads);
+  ranges.resize(reader.ForEachRange(
+      numThreads, [&](size_t index, auto it, auto end) {
+        auto& out = ranges[index];
+        for (; it != end; ++it) {
+          auto& record = *it;
+          if (record.IsControl()) {
+            int entry = 0;
+            StartRecordData data;
+            if (record.GetStartData(&data)) {
+              entry = data.entry;
+            } else {
+              record.GetFinishEntry(&entry);
+            }
+            if (entry != 0) {
+              auto& segments = out.segments[entry];
+              if (segments.empty()) {
+                segments.emplace_back();
+              }
+              segments.emplace_back();
+            }
+            out.controls.emplace_back(RangeIndex::Control{it.m_pos, entry});
+          } else {
+            auto& segments = out.segments[record.GetEntry()];
+            if (segments.empty()) {
+              segments.emplace_back();
+            }
+            segments.back().emplace_back(
+                RecordInfo{record.GetTimestamp(), it.m_pos});
+          }
+        }
+      }));
+
+  // map from entry ID to index in m_entries of currently started entries
+  wpi::DenseMap<int, size_t> active;
+
+  auto addSegment = [&](int entry, std::vector<RecordInfo>* records) {
+    auto it = active.find(entry);
+    if (it == active.end()) {
+      return;  // no start record; drop
+    }
+    auto& dest = m_entries[it->second].records;
+    if (dest.empty()) {
+      dest = std::move(*records);
+    } else {
+      dest.insert(dest.end(), records->begin(), records->end());
+    }
+  };
+
+  for (auto&& range : ranges) {
+    for (auto&& segments : range.segments) {
+      addSegment(segments.first, &segments.second.front());
+    }
+    wpi::DenseMap<int, size_t> segmentIndex;
+    for (auto&& control : range.controls) {
+      DataLogRecord record;
+      if (!ReadRecord(reader, RecordInfo{0, control.pos}, &record)) {
+        continue;
+      }
+      if (record.IsStart()) {
+        StartRecordData data;
+        if (!record.GetStartData(&data)) {
+          continue;
+        }
+        size_t index = m_entries.size();
+        auto& info = m_entries.emplace_back();
+        info.entry = data.entry;
+        info.name = data.name;
+        info.type = data.type;
+        info.metadata = data.metadata;
+        info.startTimestamp = record.GetTimestamp();
+        active[data.entry] = index;
+        m_nameMap[data.name] = index;
+      } else if (record.IsFinish()) {
+        int entry;
+        if (!record.GetFinishEntry(&entry)) {
+          continue;
+        }
+        auto it = active.find(entry);
+        if (it != active.end()) {
+          m_entries[it->second].finishTimestamp = record.GetTimestamp();
+          active.erase(it);
+        }
+      } else if (record.IsSetMetadata()) {
+        MetadataRecordData data;
+        if (!record.GetSetMetadataData(&data)) {
+          continue;
+        }
+        auto it = active.find(data.entry);
+        if (it != active.end()) {
+          m_entries[it->second].metadata = data.metadata;
+        }
+      }
+      if (control.entry != 0) {
+        addSegment(control.entry, &range.segments[control.entry]
+                                       [++segmentIndex[control.entry]]);
+      }
+    }
+  }
+
+  // records are not guaranteed to be written in timestamp order
+  for (auto&& info : m_entries) {
+    if (!std::is_sorted(info.records.begin(), info.records.end(),
+                        TimestampLess)) {
+      std::stable_sort(info.records.begin(), info.records.end(),
+                       TimestampLess);
+    }
+  }
+  return true;
+}
+
+const DataLogIndex::EntryInfo* DataLogIndex::Find(std::string_view name) const {
+  auto it = m_nameMap.find(name);
+  if (it == m_nameMap.end()) {
+    return nullptr;
+  }
+  return &m_entries[it->second];
+}
+
+std::span<const DataLogIndex::RecordInfo> DataLogIndex::GetRecords(
+    const EntryInfo& entry, int64_t start, int64_t end) {
+  auto first = std::lower_bound(entry.records.begin(), entry.records.end(),
+                                RecordInfo{start, 0}, TimestampLess);
+  auto last = std::lower_bound(first, entry.records.end(), RecordInfo{end, 0},
+                               TimestampLess);
+  return {first, last};
+}
+
+const DataLogIndex::RecordInfo* DataLogIndex::FindAtOrBefore(
+    const EntryInfo& entry, int64_t timestamp) {
+  auto it = std::upper_bound(entry.records.begin(), entry.records.end(),
+                             RecordInfo{timestamp, 0}, TimestampLess);
+  if (it == entry.records.begin()) {
+    return nullptr;
+  }
+  return &*(it - 1);
+}
+
+bool DataLogIndex::ReadRecord(const DataLogReader& reader,
+                              const RecordInfo& record, DataLogRecord* out) {
+  size_t pos = record.pos;
+  return reader.GetRecord(&pos, out);
+}
+
+void DataLogIndex::Save(wpi::raw_ostream& os) const {
+  os << kMagic;
+  Write16(os, kVersion);
+  Write64(os, m_logSize);
+  Write32(os, m_entries.size());
+  for (auto&& info : m_entries) {
+    Write32(os, info.entry);
+    Write64(os, info.startTimestamp);
+    Write64(os, info.finishTimestamp);
+    WriteString(os, info.name);
+    WriteString(os, info.type);
+    WriteString(os, info.metadata);
+    Write32(os, info.records.size());
+    for (auto&& record : info.records) {
+      Write64(os, record.timestamp);
+      Write64(os, record.pos);
+    }
+  }
+}
+
+bool DataLogIndex::Load(const DataLogReader& reader,
+                        std::span<const uint8_t> data) {
+  Clear();
+  if (!reader.IsValid() || data.size() < kMagic.size() ||
+      std::string_view{reinterpret_cast<const char*>(data.data()),
+                       kMagic.size()} != kMagic) {
+    return false;
+  }
+  data = data.subspan(kMagic.size());
+
+  uint16_t version;
+  uint64_t logSize;
+  uint32_t numEntries;
+  if (!Read16(&data, &version) || version != kVersion ||
+      !Read64(&data, &logSize) || logSize != reader.m_buf->size() ||
+      !Read32(&data, &numEntries)) {
+    return false;
+  }
+
+  m_logSize = logSize;
+  for (uint32_t i = 0; i < numEntries; ++i) {
+    auto& info = m_entries.emplace_back();
+    uint32_t entry;
+    uint64_t startTimestamp;
+    uint64_t finishTimestamp;
+    uint32_t numRecords;
+    if (!Read32(&data, &entry) || !Read64(&data, &startTimestamp) ||
+        !Read64(&data, &finishTimestamp) || !ReadString(&data, &info.name) ||
+        !ReadString(&data, &info.type) || !ReadString(&data, &info.metadata) ||
+        !Read32(&data, &numRecords) || numRecords > (data.size() / 16)) {
+      Clear();
+      return false;
+    }
+    info.entry = entry;
+    info.startTimestamp = startTimestamp;
+    info.finishTimestamp = finishTimestamp;
+    info.records.reserve(numRecords);
+    // record count was checked against the remaining size above
+    for (uint32_t j = 0; j < numRecords; ++j) {
+      int64_t timestamp = wpi::support::endian::read64le(data.data());
+      uint64_t pos = wpi::support::endian::read64le(data.data() + 8);
+      data = data.subspan(16);
+      if (pos >= logSize) {
+        Clear();
+        return false;
+      }
+      info.records.emplace_back(RecordInfo{timestamp, pos});
+    }
+    m_nameMap[info.name] = i;
+  }
+
+  // any left over?  treat as corrupt
+  if (!data.empty()) {
+    Clear();
+    return false;
+  }
+  return true;
+}
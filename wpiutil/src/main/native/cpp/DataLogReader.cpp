@@ -4,11 +4,19 @@
 
 #include "wpi/DataLogReader.h"
 
+#include <algorithm>
 #include <bit>
+#include <concepts>
+#include <cstring>
+#include <memory>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "wpi/DataLog.h"
 #include "wpi/Endian.h"
+#include "wpi/leb128.h"
+#include "wpi/lz4.h"
 
 using namespace wpi::log;
 
@@ -161,6 +169,96 @@ bool DataLogRecord::GetDoubleArray(std::vector<double>* arr) const {
   return true;
 }
 
+bool DataLogRecord::IsDeltaKeyframe() const {
+  return !m_data.empty() && m_data[0] == impl::kDeltaKeyframe;
+}
+
+static bool ReadUleb128(std::span<const uint8_t>* buf, uint64_t* val) {
+  wpi::Uleb128Reader reader;
+  auto result = reader.ReadOne(buf);
+  if (!result) {
+    return false;
+  }
+  *val = *result;
+  return true;
+}
+
+static bool ReadIntegerDelta(std::span<const uint8_t>* buf, uint64_t* val) {
+  uint64_t zigzag;
+  if (!ReadUleb128(buf, &zigzag)) {
+    return false;
+  }
+  *val += (zigzag >> 1) ^ (0 - (zigzag & 1));
+  return true;
+}
+
+static bool ReadDoubleDelta(std::span<const uint8_t>* buf, uint64_t* val) {
+  if (buf->empty()) {
+    return false;
+  }
+  unsigned int leading = (*buf)[0] >> 4;
+  unsigned int trailing = (*buf)[0] & 0xf;
+  if (leading + trailing > 8) {
+    return false;
+  }
+  size_t len = 8 - leading - trailing;
+  if (buf->size() < len + 1) {
+    return false;
+  }
+  uint64_t x = 0;
+  for (size_t i = len; i > 0; --i) {
+    x = (x << 8) | (*buf)[i];
+  }
+  if (len != 0) {
+    *val ^= x << (trailing * 8);
+  }
+  *buf = buf->subspan(len + 1);
+  return true;
+}
+
+template <typename T>
+static bool GetDeltaArray(std::span<const uint8_t> buf, std::vector<T>* arr) {
+  if (buf.empty() || buf[0] > impl::kDeltaDelta) {
+    return false;
+  }
+  bool keyframe = buf[0] == impl::kDeltaKeyframe;
+  buf = buf.subspan(1);
+  uint64_t size;
+  // each element takes at least one byte
+  if (!ReadUleb128(&buf, &size) || size > buf.size() ||
+      (!keyframe && size != arr->size())) {
+    return false;
+  }
+  arr->resize(size);
+  for (auto&& elem : *arr) {
+    uint64_t val = keyframe ? 0 : std::bit_cast<uint64_t>(elem);
+    bool ok;
+    if constexpr (std::same_as<T, double>) {
+      ok = ReadDoubleDelta(&buf, &val);
+    } else {
+      ok = ReadIntegerDelta(&buf, &val);
+    }
+    if (!ok) {
+      arr->clear();
+      return false;
+    }
+    elem = std::bit_cast<T>(val);
+  }
+  if (!buf.empty()) {
+    arr->clear();
+    return false;
+  }
+  return true;
+}
+
+bool DataLogRecord::GetDeltaIntegerArray(std::vector<int64_t>* arr) const {
+  return GetDeltaArray(m_data, arr);
+}
+
+bool DataLogRecord::GetDeltaDoubleArray(std::vector<double>* arr) const {
+  return GetDeltaArray(m_data, arr);
+}
+
 bool DataLogRecord::GetStringArray(std::vector<std::string_view>* arr) const {
   arr->clear();
   if (m_data.size() < 4) {
@@ -189,8 +287,63 @@ bool DataLogRecord::GetStringArray(std::vector<std::string_view>* arr) const {
   return true;
 }
 
+// Returns nullptr if the buffer is not a compressed data log.
+static std::unique_ptr<wpi::MemoryBuffer> Decompress(
+    const wpi::MemoryBuffer& buffer) {
+  auto buf = buffer.GetBuffer();
+  if (buf.size() < impl::kCompressedHeaderSize ||
+      std::string_view{reinterpret_cast<const char*>(buf.data()),
+                       impl::kCompressedMagic.size()} !=
+          impl::kCompressedMagic ||
+      wpi::support::endian::read16le(&buf[impl::kCompressedMagic.size()]) !=
+          impl::kCompressedVersion) {
+    return nullptr;
+  }
+  buf = buf.subspan(impl::kCompressedHeaderSize);
+
+  // find total size; stop at first incomplete or corrupt block.  Limiting the
+  // block size keeps a corrupt header from causing a huge allocation.
+  size_t total = 0;
+  for (auto blocks = buf; blocks.size() >= impl::kCompressedBlockHeaderSize;) {
+    uint32_t size = wpi::support::endian::read32le(blocks.data());
+    uint32_t usize = wpi::support::endian::read32le(blocks.data() + 4);
+    blocks = blocks.subspan(impl::kCompressedBlockHeaderSize);
+    if (size > blocks.size() || size > usize ||
+        usize > impl::kCompressedMaxBlockSize || usize > SIZE_MAX - total) {
+      break;
+    }
+    blocks = blocks.subspan(size);
+    total += usize;
+  }
+
+  auto out = wpi::WritableMemoryBuffer::GetNewUninitMemBuffer(
+      total, buffer.GetBufferIdentifier());
+  auto dest = out->GetBuffer();
+  size_t pos = 0;
+  while (pos < total) {
+    uint32_t size = wpi::support::endian::read32le(buf.data());
+    uint32_t usize = wpi::support::endian::read32le(buf.data() + 4);
+    auto data = buf.subspan(impl::kCompressedBlockHeaderSize, size);
+    buf = buf.subspan(impl::kCompressedBlockHeaderSize + size);
+    if (size == usize) {
+      std::memcpy(&dest[pos], data.data(), size);
+    } else if (wpi::Lz4Decompress(data, dest.subspan(pos, usize)) != usize) {
+      [[unlikely]] return wpi::MemoryBuffer::GetMemBufferCopy(
+          dest.subspan(0, pos), buffer.GetBufferIdentifier());
+    }
+    pos += usize;
+  }
+  return out;
+}
+
 DataLogReader::DataLogReader(std::unique_ptr<MemoryBuffer> buffer)
-    : m_buf{std::move(buffer)} {}
+    : m_buf{std::move(buffer)} {
+  if (m_buf) {
+    if (auto decompressed = Decompress(*m_buf)) {
+      m_buf = std::move(decompressed);
+    }
+  }
+}
 
 bool DataLogReader::IsValid() const {
   if (!m_buf) {
@@ -243,6 +396,64 @@ DataLogReader::iterator DataLogReader::begin() const {
   return DataLogIterator{this, 12 + size};
 }
 
+std::vector<std::pair<DataLogReader::iterator, DataLogReader::iterator>>
+DataLogReader::Split(size_t numRanges) const {
+  std::vector<std::pair<iterator, iterator>> ranges;
+  auto it = begin();
+  if (it == end()) {
+    return ranges;
+  }
+  size_t start = it.m_pos;
+  size_t total = m_buf->size() - start;
+  size_t pos = start;
+  size_t rangeStart = start;
+  for (size_t i = 1; i < numRanges; ++i) {
+    size_t target = start + total / numRanges * i;
+    while (pos < target) {
+      if (!GetNextRecord(&pos)) {
+        pos = SIZE_MAX;
+        break;
+      }
+    }
+    if (pos == SIZE_MAX) {
+      break;
+    }
+    if (pos != rangeStart) {
+      ranges.emplace_back(DataLogIterator{this, rangeStart},
+                          DataLogIterator{this, pos});
+      rangeStart = pos;
+    }
+  }
+  ranges.emplace_back(DataLogIterator{this, rangeStart}, end());
+  return ranges;
+}
+
+size_t DataLogReader::ForEachRange(
+    unsigned int numThreads,
+    wpi::function_ref<void(size_t index, iterator begin, iterator end)> func)
+    const {
+  if (numThreads == 0) {
+    numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  auto ranges = Split(numThreads);
+  if (ranges.empty()) {
+    return 0;
+  }
+
+  // the first range is processed on the calling thread
+  std::vector<std::thread> threads;
+  threads.reserve(ranges.size() - 1);
+  for (size_t i = 1; i < ranges.size(); ++i) {
+    threads.emplace_back(
+        [&, i] { func(i, ranges[i].first, ranges[i].second); });
+  }
+  func(0, ranges[0].first, ranges[0].second);
+  for (auto&& thr : threads) {
+    thr.join();
+  }
+  return ranges.size();
+}
+
 static uint64_t ReadVarInt(std::span<const uint8_t> buf) {
   uint64_t val = 0;
   int shift = 0;
@@ -0,0 +1,207 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/lz4.h"
+
+#include <cstring>
+
+#include "wpi/Endian.h"
+
+// This implements the LZ4 block format as documented at
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+//
+// Each sequence is a token byte (4-bit literal length, 4-bit match length),
+// optional extra literal length bytes, the literals, a 2-byte little endian
+// match offset, and optional extra match length bytes.  The last sequence
+// contains only literals.  For compatibility with other decoders, the last 5
+// bytes of a block are always literals, and the last match starts at least 12
+// bytes before the end of the block.
+
+static constexpr size_t kMinMatch = 4;
+static constexpr size_t kLastLiterals = 5;
+static constexpr size_t kMatchFindLimit = 12;
+static constexpr size_t kMaxOffset = 65535;
+static constexpr int kHashLog = 12;
+
+static inline uint32_t Hash(uint32_t seq) {
+  return (seq * 2654435761u) >> (32 - kHashLog);
+}
+
+static inline size_t LengthBytes(size_t len) {
+  return len >= 15 ? (len - 15) / 255 + 1 : 0;
+}
+
+static inline uint8_t* WriteLength(uint8_t* op, size_t len) {
+  len -= 15;
+  for (; len >= 255; len -= 255) {
+    *op++ = 255;
+  }
+  *op++ = len;
+  return op;
+}
+
+static uint8_t* WriteSequence(uint8_t* op, uint8_t* oend,
+                              const uint8_t* literals, size_t numLiterals,
+                              size_t offset, size_t matchLen) {
+  size_t needed = 1 + LengthBytes(numLiterals) + numLiterals;
+  if (matchLen != 0) {
+    needed += 2 + LengthBytes(matchLen - kMinMatch);
+  }
+  if (needed > static_cast<size_t>(oend - op)) {
+    return nullptr;
+  }
+
+  uint8_t* token = op++;
+  *token = (numLiterals >= 15 ? 15 : numLiterals) << 4;
+  if (numLiterals >= 15) {
+    op = WriteLength(op, numLiterals);
+  }
+  std::memcpy(op, literals, numLiterals);
+  op += numLiterals;
+
+  if (matchLen != 0) {
+    wpi::support::endian::write16le(op, offset);
+    op += 2;
+    matchLen -= kMinMatch;
+    *token |= matchLen >= 15 ? 15 : matchLen;
+    if (matchLen >= 15) {
+      op = WriteLength(op, matchLen);
+    }
+  }
+  return op;
+}
+
+size_t wpi::Lz4Compress(std::span<const uint8_t> in, std::span<uint8_t> out) {
+  const uint8_t* const base = in.data();
+  const uint8_t* const end = base + in.size();
+  const uint8_t* ip = base;
+  const uint8_t* anchor = base;
+  uint8_t* op = out.data();
+  uint8_t* const oend = op + out.size();
+
+  if (in.size() > kMatchFindLimit) {
+    const uint8_t* const mflimit = end - kMatchFindLimit;
+    const uint8_t* const matchlimit = end - kLastLiterals;
+    uint32_t table[1 << kHashLog] = {};
+    unsigned int misses = 0;
+
+    while (ip < mflimit) {
+      uint32_t seq = wpi::support::endian::read32le(ip);
+      uint32_t h = Hash(seq);
+      const uint8_t* ref = base + table[h];
+      table[h] = ip - base;
+      if (ref >= ip || static_cast<size_t>(ip - ref) > kMaxOffset ||
+          wpi::support::endian::read32le(ref) != seq) {
+        // skip ahead faster through incompressible data
+        ip += 1 + (misses++ >> 6);
+        continue;
+      }
+      misses = 0;
+
+      // extend match backwards into pending literals
+      while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+        --ip;
+        --ref;
+      }
+
+      // extend match forwards
+      const uint8_t* matchEnd = ip + kMinMatch;
+      const uint8_t* refEnd = ref + kMinMatch;
+      while (matchEnd < matchlimit && *matchEnd == *refEnd) {
+        ++matchEnd;
+        ++refEnd;
+      }
+
+      op = WriteSequence(op, oend, anchor, ip - anchor, ip - ref,
+                         matchEnd - ip);
+      if (!op) {
+        return 0;
+      }
+      ip = matchEnd;
+      anchor = ip;
+    }
+  }
+
+  // last literals
+  op = WriteSequence(op, oend, anchor, end - anchor, 0, 0);
+  if (!op) {
+    return 0;
+  }
+  return op - out.data();
+}
+
+static inline bool ReadLength(const uint8_t** ip, const uint8_t* iend,
+                              size_t* len) {
+  uint8_t b;
+  do {
+    if (*ip >= iend) {
+      return false;
+    }
+    b = *(*ip)++;
+    *len += b;
+  } while (b == 255);
+  return true;
+}
+
+std::optional<size_t> wpi::Lz4Decompress(std::span<const uint8_t> in,
+                                         std::span<uint8_t> out) {
+  const uint8_t* ip = in.data();
+  const uint8_t* const iend = ip + in.size();
+  uint8_t* const obase = out.data();
+  uint8_t* op = obase;
+  uint8_t* const oend = op + out.size();
+
+  while (ip < iend) {
+    uint8_t token = *ip++;
+
+    // literals
+    size_t len = token >> 4;
+    if (len == 15 && !ReadLength(&ip, iend, &len)) {
+      return {};
+    }
+    if (len > static_cast<size_t>(iend - ip) ||
+        len > static_cast<size_t>(oend - op)) {
+      return {};
+    }
+    std::memcpy(op, ip, len);
+    ip += len;
+    op += len;
+
+    // last sequence has no match
+    if (ip == iend) {
+      return op - obase;
+    }
+
+    // match
+    if (iend - ip < 2) {
+      return {};
+    }
+    size_t offset = wpi::support::endian::read16le(ip);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - obase)) {
+      return {};
+    }
+    len = token & 0xf;
+    if (len == 15 && !ReadLength(&ip, iend, &len)) {
+      return {};
+    }
+    len += kMinMatch;
+    if (len > static_cast<size_t>(oend - op)) {
+      return {};
+    }
+    const uint8_t* ref = op - offset;
+    if (offset >= len) {
+      std::memcpy(op, ref, len);
+      op += len;
+    } else {
+      // overlapping copy (repeating pattern)
+      for (size_t i = 0; i < len; ++i) {
+        *op++ = *ref++;
+      }
+    }
+  }
+
+  // empty input is not a valid block
+  return {};
+}
@@ -7,6 +7,8 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <concepts>
 #include <initializer_list>
 #include <optional>
@@ -43,6 +45,48 @@ enum ControlRecordType {
   kControlSetMetadata
 };
 
+// Delta-encoded array records ("delta:int64[]" and "delta:double[]" entries)
+// consist of a record type byte, the ULEB128 element count, and the encoded
+// elements.  Keyframe records are encoded relative to all-zero values; delta
+// records are encoded relative to the previous record of the same entry, and
+// always have the same number of elements as that record.  Integers are stored
+// as the ZigZag ULEB128 difference from the previous value.  Doubles are XORed
+// with the previous value, and stored as a byte containing the number of
+// leading (high nibble) and trailing (low nibble) zero bytes of the result,
+// followed by the remaining bytes in little endian order.
+enum DeltaRecordType { kDeltaKeyframe = 0, kDeltaDelta };
+
+// A compressed data log starts with kCompressedMagic and a 2-byte little
+// endian version, followed by a sequence of blocks.  Each block consists of a
+// 4-byte little endian compressed size, a 4-byte little endian uncompressed
+// size, and the LZ4 compressed data (or the raw data if the two sizes are
+// equal).  Blocks are compressed independently, and the uncompressed contents
+// of all blocks, concatenated, are a normal (uncompressed) data log.  Each
+// block holds one writer buffer, so it's at most kCompressedMaxBlockSize bytes
+// uncompressed.
+inline constexpr std::string_view kCompressedMagic = "WPILZ4";
+inline constexpr uint16_t kCompressedVersion = 0x0100;
+inline constexpr size_t kCompressedHeaderSize = 8;
+inline constexpr size_t kCompressedBlockHeaderSize = 8;
+inline constexpr size_t kCompressedMaxBlockSize = 16 * 1024;
+
+/**
+ * Appends the compressed data log file header.
+ *
+ * @param out output buffer
+ */
+void AppendCompressedHeader(std::vector<uint8_t>* out);
+
+/**
+ * Compresses a block of data log contents and appends it, including the block
+ * header, to a buffer.
+ *
+ * @param data uncompressed data
+ * @param out output buffer
+ */
+void AppendCompressedBlock(std::span<const uint8_t> data,
+                           std::vector<uint8_t>* out);
+
 }  // namespace impl
 
 /**
@@ -61,11 +105,15 @@ enum ControlRecordType {
  *
  * DataLog calls are thread safe.  DataLog uses a typical multiple-supplier,
  * single-consumer setup.  Writes to the log are atomic, but there is no
- * guaranteed order in the log when multiple threads are writing to it;
- * whichever thread grabs the write mutex first will get written first.
- * For this reason (as well as the fact that timestamps can be set to
- * arbitrary values), records in the log are not guaranteed to be sorted by
- * timestamp.
+ * guaranteed order in the log when multiple threads are writing to it.
+ * To reduce contention, data records are buffered separately for different
+ * threads, so records from different threads may be interleaved in the log
+ * in blocks rather than in the order the Append calls were made.  Records
+ * appended from a single thread are always written in order, and all data
+ * records appended before a Finish() or SetMetadata() call are written before
+ * that control record. For these reasons (as well as the fact that timestamps
+ * can be set to arbitrary values), records in the log are not guaranteed to be
+ * sorted by timestamp.
  */
 class DataLog {
  public:
@@ -244,6 +292,42 @@ class DataLog {
   void AppendRaw2(int entry, std::span<const std::span<const uint8_t>> data,
                   int64_t timestamp);
 
+  /**
+   * Appends a raw record to the log, with the record data written directly
+   * into the log buffer by a callback instead of being copied from a separate
+   * buffer.  This is intended for serializers such as Struct::Pack() that can
+   * write into a caller-provided buffer of known size.
+   *
+   * The callback is called with an internal lock held, so it must not call
+   * back into the log.  If the log is paused, the callback is not called.
+   *
+   * @param entry Entry index, as returned by Start()
+   * @param size Record data size, in bytes
+   * @param fill Callback that fills in the record data; called with a buffer
+   *             of exactly size bytes, all of which must be written
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  template <std::invocable<std::span<uint8_t>> F>
+  void AppendRawInPlace(int entry, size_t size, F&& fill, int64_t timestamp) {
+    if (entry <= 0) {
+      return;
+    }
+    if (m_paused) {
+      [[unlikely]] return;
+    }
+    if (size > kBlockSize - kRecordMaxHeaderSize) {
+      // too large to be contiguous in a single buffer
+      std::vector<uint8_t> buf(size);
+      fill(std::span<uint8_t>{buf});
+      AppendRaw(entry, buf, timestamp);
+      return;
+    }
+    auto& shard = GetShard();
+    std::scoped_lock lock{shard.mutex};
+    fill(std::span<uint8_t>{StartRecord(entry, timestamp, size, size, &shard),
+                            size});
+  }
+
   /**
    * Appends a boolean record to the log.
    *
@@ -349,6 +433,36 @@ class DataLog {
   void AppendDoubleArray(int entry, std::span<const double> arr,
                          int64_t timestamp);
 
+  /**
+   * Appends a delta-encoded integer array record to the log.  The entry must
+   * have been started with the "delta:int64[]" type.  Each value is stored as
+   * a variable-length difference from the previous record of the same entry,
+   * so slowly changing arrays take much less space than AppendIntegerArray().
+   * Records are periodically written in full (keyframes) so a reader can
+   * start decoding partway through the log.
+   *
+   * @param entry Entry index, as returned by Start()
+   * @param arr Integer array to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void AppendDeltaIntegerArray(int entry, std::span<const int64_t> arr,
+                               int64_t timestamp);
+
+  /**
+   * Appends a delta-encoded double array record to the log.  The entry must
+   * have been started with the "delta:double[]" type.  Each value is stored
+   * XORed with the value in the previous record of the same entry, with zero
+   * bytes dropped, so unchanged and slowly changing values take much less
+   * space than AppendDoubleArray().  Records are periodically written in full
+   * (keyframes) so a reader can start decoding partway through the log.
+   *
+   * @param entry Entry index, as returned by Start()
+   * @param arr Double array to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void AppendDeltaDoubleArray(int entry, std::span<const double> arr,
+                              int64_t timestamp);
+
   /**
    * Appends a string array record to the log.
    *
@@ -381,6 +495,7 @@ class DataLog {
 
  protected:
   static constexpr size_t kBlockSize = 16 * 1024;
+  static_assert(kBlockSize <= impl::kCompressedMaxBlockSize);
   static wpi::Logger s_defaultMessageLog;
 
   class Buffer {
@@ -489,15 +604,38 @@ class DataLog {
  private:
   static constexpr size_t kMaxBufferCount = 1024 * 1024 / kBlockSize;
   static constexpr size_t kMaxFreeCount = 256 * 1024 / kBlockSize;
+  static constexpr size_t kNumShards = 8;
+  static constexpr size_t kRecordMaxHeaderSize = 17;
+
+  // Data records are appended into per-thread shards (each thread is assigned
+  // to one shard) so concurrent appends from different threads don't contend
+  // on m_mutex.  Buffers are moved from a shard to m_outgoing only at record
+  // boundaries, so a record is never split across shards.
+  struct alignas(64) Shard {
+    wpi::mutex mutex;
+    std::vector<Buffer> bufs;
+  };
+
+  Shard& GetShard();
+
+  // moves all shard buffers to m_outgoing; must be called without m_mutex held
+  void DrainShards();
 
   // must be called with m_mutex held
   int StartImpl(std::string_view name, std::string_view type,
                 std::string_view metadata, int64_t timestamp);
+  void ReleaseShard(Shard& shard);
+  Buffer AllocBuffer();
+
+  // must be called with m_mutex held (if shard is null) or with the shard
+  // mutex held (if shard is non-null)
   uint8_t* StartRecord(uint32_t entry, uint64_t timestamp, uint32_t payloadSize,
-                       size_t reserveSize);
-  uint8_t* Reserve(size_t size);
-  void AppendImpl(std::span<const uint8_t> data);
-  void AppendStringImpl(std::string_view str);
+                       size_t reserveSize, Shard* shard = nullptr);
+  uint8_t* Reserve(size_t size, Shard* shard = nullptr);
+  void AppendImpl(std::span<const uint8_t> data, Shard* shard = nullptr);
+  void AppendStringImpl(std::string_view str, Shard* shard = nullptr);
+  template <typename T>
+  void AppendDeltaArray(int entry, std::span<const T> arr, int64_t timestamp);
   void AppendStartRecord(int id, std::string_view name, std::string_view type,
                          std::string_view metadata, int64_t timestamp);
   void DoReleaseBufs(std::vector<Buffer>* bufs);
@@ -508,10 +646,11 @@ class DataLog {
  private:
   mutable wpi::mutex m_mutex;
   bool m_active = false;
-  bool m_paused = false;
+  std::atomic_bool m_paused = false;
   std::string m_extraHeader;
   std::vector<Buffer> m_free;
   std::vector<Buffer> m_outgoing;
+  std::array<Shard, kNumShards> m_shards;
   struct EntryInfo {
     std::string type;
     std::vector<uint8_t> schemaData;  // only set for schema entries
@@ -521,6 +660,9 @@ class DataLog {
   struct EntryInfo2 {
     std::string metadata;
     unsigned int count;
+    // delta-encoded array state: previous value and records until keyframe
+    std::vector<uint64_t> deltaLast;
+    unsigned int deltaRemaining = 0;
   };
   wpi::DenseMap<int, EntryInfo2> m_entryIds;
   int m_lastId = 0;
@@ -1202,6 +1344,134 @@ class DoubleArrayLogEntry : public DataLogValueEntryImpl<std::vector<double>> {
   }
 };
 
+/**
+ * Log array of integer values, delta encoded (see
+ * DataLog::AppendDeltaIntegerArray()).
+ */
+class DeltaIntegerArrayLogEntry
+    : public DataLogValueEntryImpl<std::vector<int64_t>> {
+ public:
+  static constexpr const char* kDataType = "delta:int64[]";
+
+  DeltaIntegerArrayLogEntry() = default;
+  DeltaIntegerArrayLogEntry(DataLog& log, std::string_view name,
+                            int64_t timestamp = 0)
+      : DeltaIntegerArrayLogEntry{log, name, {}, timestamp} {}
+  DeltaIntegerArrayLogEntry(DataLog& log, std::string_view name,
+                            std::string_view metadata, int64_t timestamp = 0)
+      : DataLogValueEntryImpl{log, name, kDataType, metadata, timestamp} {}
+
+  /**
+   * Appends a record to the log.
+   *
+   * @param arr Values to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Append(std::span<const int64_t> arr, int64_t timestamp = 0) {
+    m_log->AppendDeltaIntegerArray(m_entry, arr, timestamp);
+  }
+
+  /**
+   * Appends a record to the log.
+   *
+   * @param arr Values to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Append(std::initializer_list<int64_t> arr, int64_t timestamp = 0) {
+    Append({arr.begin(), arr.end()}, timestamp);
+  }
+
+  /**
+   * Updates the last value and appends a record to the log if it has changed.
+   *
+   * @note The last value is local to this class instance; using Update() with
+   * two instances pointing to the same underlying log entry name will likely
+   * result in unexpected results.
+   *
+   * @param arr Values to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Update(std::span<const int64_t> arr, int64_t timestamp = 0);
+
+  /**
+   * Updates the last value and appends a record to the log if it has changed.
+   *
+   * @note The last value is local to this class instance; using Update() with
+   * two instances pointing to the same underlying log entry name will likely
+   * result in unexpected results.
+   *
+   * @param arr Values to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Update(std::initializer_list<int64_t> arr, int64_t timestamp = 0) {
+    Update({arr.begin(), arr.end()}, timestamp);
+  }
+};
+
+/**
+ * Log array of double values, delta encoded (see
+ * DataLog::AppendDeltaDoubleArray()).
+ */
+class DeltaDoubleArrayLogEntry
+    : public DataLogValueEntryImpl<std::vector<double>> {
+ public:
+  static constexpr const char* kDataType = "delta:double[]";
+
+  DeltaDoubleArrayLogEntry() = default;
+  DeltaDoubleArrayLogEntry(DataLog& log, std::string_view name,
+                           int64_t timestamp = 0)
+      : DeltaDoubleArrayLogEntry{log, name, {}, timestamp} {}
+  DeltaDoubleArrayLogEntry(DataLog& log, std::string_view name,
+                           std::string_view metadata, int64_t timestamp = 0)
+      : DataLogValueEntryImpl{log, name, kDataType, metadata, timestamp} {}
+
+  /**
+   * Appends a record to the log.
+   *
+   * @param arr Values to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Append(std::span<const double> arr, int64_t timestamp = 0) {
+    m_log->AppendDeltaDoubleArray(m_entry, arr, timestamp);
+  }
+
+  /**
+   * Appends a record to the log.
+   *
+   * @param arr Values to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Append(std::initializer_list<double> arr, int64_t timestamp = 0) {
+    Append({arr.begin(), arr.end()}, timestamp);
+  }
+
+  /**
+   * Updates the last value and appends a record to the log if it has changed.
+   *
+   * @note The last value is local to this class instance; using Update() with
+   * two instances pointing to the same underlying log entry name will likely
+   * result in unexpected results.
+   *
+   * @param arr Values to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Update(std::span<const double> arr, int64_t timestamp = 0);
+
+  /**
+   * Updates the last value and appends a record to the log if it has changed.
+   *
+   * @note The last value is local to this class instance; using Update() with
+   * two instances pointing to the same underlying log entry name will likely
+   * result in unexpected results.
+   *
+   * @param arr Values to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Update(std::initializer_list<double> arr, int64_t timestamp = 0) {
+    Update({arr.begin(), arr.end()}, timestamp);
+  }
+};
+
 /**
  * Log array of string values.
  */
@@ -1333,18 +1603,14 @@ class StructLogEntry : public DataLogEntry {
    * @param timestamp Time stamp (may be 0 to indicate now)
    */
   void Append(const T& data, int64_t timestamp = 0) {
-    if constexpr (sizeof...(I) == 0) {
-      if constexpr (wpi::is_constexpr([] { S::GetSize(); })) {
-        uint8_t buf[S::GetSize()];
-        S::Pack(buf, data);
-        m_log->AppendRaw(m_entry, buf, timestamp);
-        return;
-      }
-    }
-    wpi::SmallVector<uint8_t, 128> buf;
-    buf.resize_for_overwrite(std::apply(S::GetSize, m_info));
-    std::apply([&](const I&... info) { S::Pack(buf, data, info...); }, m_info);
-    m_log->AppendRaw(m_entry, buf, timestamp);
+    // pack directly into the log buffer
+    m_log->AppendRawInPlace(
+        m_entry, std::apply(S::GetSize, m_info),
+        [&](std::span<uint8_t> buf) {
+          std::apply([&](const I&... info) { S::Pack(buf, data, info...); },
+                     m_info);
+        },
+        timestamp);
   }
 
   /**
@@ -1602,12 +1868,11 @@ class ProtobufLogEntry : public DataLogEntry {
    * @param timestamp Time stamp (may be 0 to indicate now)
    */
   void Append(const T& data, int64_t timestamp = 0) {
-    SmallVector<uint8_t, 128> buf;
-    {
-      std::scoped_lock lock{m_mutex};
-      m_msg.Pack(buf, data);
-    }
-    m_log->AppendRaw(m_entry, buf, timestamp);
+    // the packed size is not known in advance, so pack into a reused buffer
+    std::scoped_lock lock{m_mutex};
+    m_buf.clear();
+    m_msg.Pack(m_buf, data);
+    m_log->AppendRaw(m_entry, m_buf, timestamp);
   }
 
   /**
@@ -1622,15 +1887,15 @@ class ProtobufLogEntry : public DataLogEntry {
    */
   void Update(const T& data, int64_t timestamp = 0) {
     std::scoped_lock lock{m_mutex};
-    wpi::SmallVector<uint8_t, 128> buf;
-    m_msg.Pack(buf, data);
+    m_buf.clear();
+    m_msg.Pack(m_buf, data);
     if (!m_lastValue.has_value()) {
-      m_lastValue = std::vector(buf.begin(), buf.end());
-      m_log->AppendRaw(m_entry, buf, timestamp);
-    } else if (!std::equal(buf.begin(), buf.end(), m_lastValue->begin(),
+      m_lastValue = std::vector(m_buf.begin(), m_buf.end());
+      m_log->AppendRaw(m_entry, m_buf, timestamp);
+    } else if (!std::equal(m_buf.begin(), m_buf.end(), m_lastValue->begin(),
                            m_lastValue->end())) {
-      m_lastValue->assign(buf.begin(), buf.end());
-      m_log->AppendRaw(m_entry, buf, timestamp);
+      m_lastValue->assign(m_buf.begin(), m_buf.end());
+      m_log->AppendRaw(m_entry, m_buf, timestamp);
     }
   }
 
@@ -1663,6 +1928,7 @@ class ProtobufLogEntry : public DataLogEntry {
  private:
   mutable wpi::mutex m_mutex;
   ProtobufMessage<T> m_msg;
+  wpi::SmallVector<uint8_t, 128> m_buf;
   std::optional<std::vector<uint8_t>> m_lastValue;
 };
 
@@ -34,6 +34,10 @@ namespace wpi::log {
  * The data log is periodically flushed to disk.  It can also be explicitly
  * flushed to disk by using the Flush() function.  This operation is, however,
  * non-blocking.
+ *
+ * Optionally, the log can be compressed as it is written.  Compression is done
+ * on the background thread one buffer block at a time, so it does not slow
+ * down Append calls, and each block can be decompressed independently.
  */
 class DataLogBackgroundWriter final : public DataLog {
  public:
@@ -47,11 +51,14 @@ class DataLogBackgroundWriter final : public DataLog {
    * @param period time between automatic flushes to disk, in seconds;
    *               this is a time/storage tradeoff
    * @param extraHeader extra header data
+   * @param compress compress the log in blocks as it is written; compressed
+   *                 logs are decompressed transparently by DataLogReader
    */
   explicit DataLogBackgroundWriter(std::string_view dir = "",
                                    std::string_view filename = "",
                                    double period = 0.25,
-                                   std::string_view extraHeader = "");
+                                   std::string_view extraHeader = "",
+                                   bool compress = false);
 
   /**
    * Construct a new Data Log.  The log will be initially created with a
@@ -64,12 +71,15 @@ class DataLogBackgroundWriter final : public DataLog {
    * @param period time between automatic flushes to disk, in seconds;
    *               this is a time/storage tradeoff
    * @param extraHeader extra header data
+   * @param compress compress the log in blocks as it is written; compressed
+   *                 logs are decompressed transparently by DataLogReader
    */
   explicit DataLogBackgroundWriter(wpi::Logger& msglog,
                                    std::string_view dir = "",
                                    std::string_view filename = "",
                                    double period = 0.25,
-                                   std::string_view extraHeader = "");
+                                   std::string_view extraHeader = "",
+                                   bool compress = false);
 
   /**
    * Construct a new Data Log that passes its output to the provided function
@@ -81,10 +91,13 @@ class DataLogBackgroundWriter final : public DataLog {
    * @param period time between automatic calls to write, in seconds;
    *               this is a time/storage tradeoff
    * @param extraHeader extra header data
+   * @param compress compress the log in blocks as it is written; compressed
+   *                 logs are decompressed transparently by DataLogReader
    */
   explicit DataLogBackgroundWriter(
       std::function<void(std::span<const uint8_t> data)> write,
-      double period = 0.25, std::string_view extraHeader = "");
+      double period = 0.25, std::string_view extraHeader = "",
+      bool compress = false);
 
   /**
    * Construct a new Data Log that passes its output to the provided function
@@ -97,11 +110,14 @@ class DataLogBackgroundWriter final : public DataLog {
    * @param period time between automatic calls to write, in seconds;
    *               this is a time/storage tradeoff
    * @param extraHeader extra header data
+   * @param compress compress the log in blocks as it is written; compressed
+   *                 logs are decompressed transparently by DataLogReader
    */
   explicit DataLogBackgroundWriter(
       wpi::Logger& msglog,
       std::function<void(std::span<const uint8_t> data)> write,
-      double period = 0.25, std::string_view extraHeader = "");
+      double period = 0.25, std::string_view extraHeader = "",
+      bool compress = false);
 
   ~DataLogBackgroundWriter() final;
   DataLogBackgroundWriter(const DataLogBackgroundWriter&) = delete;
@@ -163,6 +179,7 @@ class DataLogBackgroundWriter final : public DataLog {
     kStopped,
   } m_state = kActive;
   double m_period;
+  bool m_compress;
   std::string m_newFilename;
   std::thread m_thread;
 };
@@ -0,0 +1,182 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "wpi/DataLogReader.h"
+#include "wpi/StringMap.h"
+
+namespace wpi {
+class raw_ostream;
+}  // namespace wpi
+
+namespace wpi::log {
+
+/**
+ * Index of the data records in a data log, grouped by entry.
+ *
+ * Building the index requires a single pass over the log.  Once built, the
+ * records of a single entry can be located by timestamp in O(log n) and
+ * iterated without touching the rest of the log.  The index can also be saved
+ * to and loaded from a sidecar file so the scan only needs to be done once per
+ * log file.
+ *
+ * The index refers to records by their byte offset in the log; it is only
+ * valid for the exact log it was built from.
+ */
+class DataLogIndex {
+ public:
+  /** Location of a single data record in the log. */
+  struct RecordInfo {
+    /** Record timestamp, in integer microseconds. */
+    int64_t timestamp;
+
+    /** Byte offset of the record in the log. */
+    uint64_t pos;
+  };
+
+  /**
+   * Information about an entry.  Entry IDs may be reused after an entry is
+   * finished, so each start record results in a separate EntryInfo.
+   */
+  struct EntryInfo {
+    /** Entry ID. */
+    int entry = 0;
+
+    /** Entry name. */
+    std::string name;
+
+    /** Data type. */
+    std::string type;
+
+    /** Metadata (most recent value set in the log). */
+    std::string metadata;
+
+    /** Timestamp of the start record. */
+    int64_t startTimestamp = 0;
+
+    /** Timestamp of the finish record (INT64_MAX if not finished). */
+    int64_t finishTimestamp = INT64_MAX;
+
+    /** Data records, sorted by timestamp. */
+    std::vector<RecordInfo> records;
+  };
+
+  DataLogIndex() = default;
+
+  /**
+   * Builds an index of a data log.
+   *
+   * @param reader data log reader
+   * @param numThreads number of threads used to scan the log (0 to use the
+   *                   number of hardware threads)
+   */
+  explicit DataLogIndex(const DataLogReader& reader,
+                        unsigned int numThreads = 1) {
+    Build(reader, numThreads);
+  }
+
+  /**
+   * Builds (or rebuilds) the index by scanning the entire data log.  With
+   * more than one thread, the log is split into ranges with
+   * DataLogReader::ForEachRange() and scanned in parallel.
+   *
+   * @param reader data log reader
+   * @param numThreads number of threads used to scan the log (0 to use the
+   *                   number of hardware threads)
+   * @return False if the log is invalid
+   */
+  bool Build(const DataLogReader& reader, unsigned int numThreads = 1);
+
+  /**
+   * Gets the size of the log the index was built from.
+   *
+   * @return Log size in bytes
+   */
+  uint64_t GetLogSize() const { return m_logSize; }
+
+  /**
+   * Gets all entries in the log, in start record order.
+   *
+   * @return Entries
+   */
+  std::span<const EntryInfo> GetEntries() const { return m_entries; }
+
+  /**
+   * Finds an entry by name.  If the name was started more than once, the last
+   * one is returned.
+   *
+   * @param name Entry name
+   * @return Entry information, or nullptr if not found
+   */
+  const EntryInfo* Find(std::string_view name) const;
+
+  /**
+   * Gets the records of an entry within a time range.
+   *
+   * @param entry Entry information
+   * @param start Start timestamp (inclusive), in integer microseconds
+   * @param end End timestamp (exclusive), in integer microseconds
+   * @return Records with start <= timestamp < end
+   */
+  static std::span<const RecordInfo> GetRecords(const EntryInfo& entry,
+                                                int64_t start,
+                                                int64_t end = INT64_MAX);
+
+  /**
+   * Finds the last record of an entry at or before a given time, e.g. to get
+   * the value of an entry at a particular time.
+   *
+   * @param entry Entry information
+   * @param timestamp Timestamp, in integer microseconds
+   * @return Record information, or nullptr if there are no records at or
+   *         before the timestamp
+   */
+  static const RecordInfo* FindAtOrBefore(const EntryInfo& entry,
+                                          int64_t timestamp);
+
+  /**
+   * Reads an indexed record from the log.
+   *
+   * @param reader data log reader (must be the log the index was built from)
+   * @param record record information
+   * @param[out] out record (if successful)
+   * @return True on success, false on error
+   */
+  static bool ReadRecord(const DataLogReader& reader, const RecordInfo& record,
+                         DataLogRecord* out);
+
+  /**
+   * Saves the index (e.g. to a sidecar file).
+   *
+   * @param os output stream
+   */
+  void Save(wpi::raw_ostream& os) const;
+
+  /**
+   * Loads a previously saved index.  Fails if the saved index is corrupt or
+   * does not match the size of the log.
+   *
+   * @param reader data log reader the index will be used with
+   * @param data saved index contents
+   * @return True on success, false on error (index is left empty)
+   */
+  bool Load(const DataLogReader& reader, std::span<const uint8_t> data);
+
+ private:
+  void Clear();
+
+  uint64_t m_logSize = 0;
+  std::vector<EntryInfo> m_entries;
+  wpi::StringMap<size_t> m_nameMap;
+};
+
+}  // namespace wpi::log
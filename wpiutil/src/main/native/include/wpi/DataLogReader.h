@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "wpi/MemoryBuffer.h"
+#include "wpi/function_ref.h"
 
 namespace wpi::log {
 
@@ -239,6 +240,47 @@ class DataLogRecord {
    */
   bool GetStringArray(std::vector<std::string_view>* arr) const;
 
+  /**
+   * Determines if a delta-encoded array record ("delta:int64[]" or
+   * "delta:double[]" data type) is a keyframe, i.e. it can be decoded without
+   * the previous record of the entry.  Decoding can start at any keyframe.
+   *
+   * @return True if keyframe
+   */
+  bool IsDeltaKeyframe() const;
+
+  /**
+   * Decodes a data record as a delta-encoded integer array. Note if the data
+   * type (as indicated in the corresponding start control record for this
+   * entry) is not "delta:int64[]", invalid results may be returned.
+   *
+   * Unless the record is a keyframe, it is decoded relative to the previous
+   * record of the same entry, so records must be decoded in order, starting
+   * from a keyframe, reusing the same array.
+   *
+   * @param[in,out] arr integer array; on input, the previous value of the
+   *                    entry (ignored for keyframes)
+   * @return True on success, false on error (including a missing or mismatched
+   *         previous value)
+   */
+  bool GetDeltaIntegerArray(std::vector<int64_t>* arr) const;
+
+  /**
+   * Decodes a data record as a delta-encoded double array. Note if the data
+   * type (as indicated in the corresponding start control record for this
+   * entry) is not "delta:double[]", invalid results may be returned.
+   *
+   * Unless the record is a keyframe, it is decoded relative to the previous
+   * record of the same entry, so records must be decoded in order, starting
+   * from a keyframe, reusing the same array.
+   *
+   * @param[in,out] arr double array; on input, the previous value of the entry
+   *                    (ignored for keyframes)
+   * @return True on success, false on error (including a missing or mismatched
+   *         previous value)
+   */
+  bool GetDeltaDoubleArray(std::vector<double>* arr) const;
+
  private:
   int64_t m_timestamp{0};
   std::span<const uint8_t> m_data;
@@ -246,9 +288,13 @@ class DataLogRecord {
 };
 
 class DataLogReader;
+class DataLogIndex;
 
 /** DataLogReader iterator. */
 class DataLogIterator {
+  friend class DataLogIndex;
+  friend class DataLogReader;
+
  public:
   using iterator_category = std::forward_iterator_tag;
   using value_type = DataLogRecord;
@@ -298,11 +344,26 @@ class DataLogIterator {
 /** Data log reader (reads logs written by the DataLog class). */
 class DataLogReader {
   friend class DataLogIterator;
+  friend class DataLogIndex;
 
  public:
   using iterator = DataLogIterator;
 
-  /** Constructs from a memory buffer. */
+  /**
+   * Constructs from a memory buffer.  Compressed logs (see
+   * DataLogBackgroundWriter) are detected and decompressed into memory up
+   * front; if a compressed log is truncated or corrupt, only the blocks before
+   * the damaged one are read.
+   *
+   * Decompressing a log takes memory equal to its uncompressed size, as records
+   * and the strings and arrays decoded from them refer directly into the
+   * reader's buffer and remain valid for the lifetime of the reader (and may be
+   * used from several threads with ForEachRange()), which rules out
+   * decompressing blocks on demand and discarding them.  Uncompressed logs are
+   * read in place (e.g. from a memory-mapped file).
+   *
+   * @param buffer data log contents
+   */
   explicit DataLogReader(std::unique_ptr<MemoryBuffer> buffer);
 
   /** Returns true if the data log is valid (e.g. has a valid header). */
@@ -341,6 +402,40 @@ class DataLogReader {
   /** Returns end iterator. */
   iterator end() const { return DataLogIterator{this, SIZE_MAX}; }
 
+  /**
+   * Splits the log into consecutive ranges of records of roughly equal byte
+   * size, e.g. for decoding the log in parallel.  Range boundaries are found by
+   * walking just the record headers, which is much cheaper than decoding the
+   * records.
+   *
+   * @param numRanges maximum number of ranges
+   * @return Ranges (begin and end iterators), in log order; fewer than
+   *         numRanges ranges are returned if the log is small
+   */
+  std::vector<std::pair<iterator, iterator>> Split(size_t numRanges) const;
+
+  /**
+   * Processes the log in parallel.  The log is split into ranges with Split()
+   * and each range is passed to func on a separate thread.  Records within
+   * a range should be processed in order; results are typically accumulated
+   * per range (using the range index) and merged in range order once this
+   * function returns.
+   *
+   * Note a range may contain data records for entries started in an earlier
+   * range, so start records generally need to be resolved during the merge.
+   *
+   * @param numThreads maximum number of threads (0 to use the number of
+   *                   hardware threads)
+   * @param func function called for each range with the range index and the
+   *             range begin and end iterators; called concurrently from
+   *             multiple threads
+   * @return Number of ranges
+   */
+  size_t ForEachRange(
+      unsigned int numThreads,
+      wpi::function_ref<void(size_t index, iterator begin, iterator end)> func)
+      const;
+
  private:
   std::unique_ptr<MemoryBuffer> m_buf;
 
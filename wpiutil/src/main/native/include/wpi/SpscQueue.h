@@ -0,0 +1,145 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace wpi {
+
+/**
+ * An unbounded lock-free queue for a single producer thread and a single
+ * consumer thread.
+ *
+ * Elements are stored in a linked list of fixed-size blocks. Enqueue is
+ * wait-free except when a new block needs to be allocated; dequeue is always
+ * wait-free (it may free a fully consumed block). The API mirrors FastQueue,
+ * which is the single-threaded equivalent.
+ *
+ * Only the producer thread may call enqueue() and emplace(); only the
+ * consumer thread may call try_dequeue() and empty().
+ *
+ * @tparam T element type
+ * @tparam BlockSize number of elements per block
+ */
+template <typename T, size_t BlockSize = 64>
+class SpscQueue {
+ public:
+  static_assert(BlockSize > 0, "Block size cannot be zero.");
+
+  using value_type = T;
+
+  SpscQueue() : m_front{new Block}, m_tail{m_front} {}
+
+  ~SpscQueue() {
+    while (m_front) {
+      size_t count = m_front->count.load(std::memory_order_acquire);
+      for (; m_frontPos < count; ++m_frontPos) {
+        m_front->Slot(m_frontPos)->~T();
+      }
+      Block* next = m_front->next.load(std::memory_order_acquire);
+      delete m_front;
+      m_front = next;
+      m_frontPos = 0;
+    }
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /**
+   * Enqueues an element. Producer only.
+   *
+   * @param element element
+   */
+  void enqueue(const T& element) { emplace(element); }
+
+  /**
+   * Enqueues an element. Producer only.
+   *
+   * @param element element
+   */
+  void enqueue(T&& element) { emplace(std::move(element)); }
+
+  /**
+   * Constructs an element in place at the end of the queue. Producer only.
+   *
+   * @param args constructor arguments
+   */
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    if (m_tailPos == BlockSize) {
+      // only the consumer frees blocks, and it will not do so until it sees
+      // the next pointer, so this is the last time the producer touches it
+      auto block = new Block;
+      m_tail->next.store(block, std::memory_order_release);
+      m_tail = block;
+      m_tailPos = 0;
+    }
+    new (m_tail->Raw(m_tailPos)) T(std::forward<Args>(args)...);
+    m_tail->count.store(++m_tailPos, std::memory_order_release);
+  }
+
+  /**
+   * Dequeues the element at the front of the queue. Consumer only.
+   *
+   * @param result element (output)
+   * @return False if the queue is empty
+   */
+  bool try_dequeue(T& result) {
+    if (m_frontPos == BlockSize) {
+      Block* next = m_front->next.load(std::memory_order_acquire);
+      if (!next) {
+        return false;
+      }
+      delete m_front;
+      m_front = next;
+      m_frontPos = 0;
+    }
+    if (m_frontPos == m_front->count.load(std::memory_order_acquire)) {
+      return false;
+    }
+    T* element = m_front->Slot(m_frontPos++);
+    result = std::move(*element);
+    element->~T();
+    return true;
+  }
+
+  /**
+   * Returns true if the queue is empty. Consumer only; the producer may
+   * enqueue more elements at any time.
+   *
+   * @return True if empty
+   */
+  bool empty() const {
+    if (m_frontPos == BlockSize) {
+      Block* next = m_front->next.load(std::memory_order_acquire);
+      return !next || next->count.load(std::memory_order_acquire) == 0;
+    }
+    return m_frontPos == m_front->count.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct Block {
+    void* Raw(size_t i) { return data + i * sizeof(T); }
+    T* Slot(size_t i) { return std::launder(static_cast<T*>(Raw(i))); }
+
+    alignas(T) unsigned char data[sizeof(T) * BlockSize];
+    // number of elements constructed by the producer
+    std::atomic<size_t> count{0};
+    std::atomic<Block*> next{nullptr};
+  };
+
+  // keep consumer and producer state on separate cache lines
+  alignas(64) Block* m_front;
+  size_t m_frontPos = 0;
+  alignas(64) Block* m_tail;
+  size_t m_tailPos = 0;
+};
+
+}  // namespace wpi
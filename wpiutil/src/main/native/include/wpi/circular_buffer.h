@@ -107,6 +107,11 @@ class circular_buffer {
    */
   constexpr size_t size() const { return m_length; }
 
+  /**
+   * Returns true if the buffer has no elements
+   */
+  constexpr bool empty() const { return m_length == 0; }
+
   /**
    * Returns value at front of buffer
    */
@@ -0,0 +1,54 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef WPIUTIL_WPI_LZ4_H_
+#define WPIUTIL_WPI_LZ4_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <span>
+
+namespace wpi {
+
+/**
+ * Gets the maximum compressed size of an input of a given size.  An output
+ * buffer of this size is always large enough for Lz4Compress() to succeed.
+ *
+ * @param size input size, in bytes
+ * @return Maximum compressed size, in bytes
+ */
+constexpr size_t Lz4CompressBound(size_t size) {
+  return size + size / 255 + 16;
+}
+
+/**
+ * Compresses data into a single LZ4 block (raw block format, no frame
+ * header).  The compressor is a fast greedy single-pass compressor intended
+ * for streaming data such as data logs; it trades compression ratio for
+ * speed.
+ *
+ * @param in input data
+ * @param out output buffer
+ * @return Compressed size, or 0 if the output buffer is too small
+ */
+size_t Lz4Compress(std::span<const uint8_t> in, std::span<uint8_t> out);
+
+/**
+ * Decompresses a single LZ4 block (raw block format, no frame header).
+ * The input is fully validated; malformed input results in an error rather
+ * than out of bounds accesses.
+ *
+ * @param in compressed data
+ * @param out output buffer
+ * @return Decompressed size, or empty if the input is malformed or the output
+ *         buffer is too small
+ */
+std::optional<size_t> Lz4Decompress(std::span<const uint8_t> in,
+                                    std::span<uint8_t> out);
+
+}  // namespace wpi
+
+#endif  // WPIUTIL_WPI_LZ4_H_
@@ -0,0 +1,160 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <memory>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include "wpi/DataLogIndex.h"
+#include "wpi/DataLogWriter.h"
+#include "wpi/Logger.h"
+#include "wpi/MemoryBuffer.h"
+#include "wpi/raw_ostream.h"
+
+class DataLogIndexTest : public ::testing::Test {
+ public:
+  DataLogIndexTest() {
+    wpi::Logger msglog;
+    wpi::log::DataLogWriter log{
+        msglog, std::make_unique<wpi::raw_uvector_ostream>(data)};
+    int a = log.Start("a", "int64", "", 1);
+    int b = log.Start("b", "double", "", 1);
+    for (int64_t i = 1; i <= 100; ++i) {
+      log.AppendInteger(a, i, i * 10);
+      log.AppendDouble(b, i * 0.5, i * 10 + 5);
+    }
+    // out of order record
+    log.AppendInteger(a, 0, 5);
+    log.SetMetadata(b, "meta", 2000);
+    log.Finish(b, 2000);
+    log.Flush();
+  }
+
+  std::vector<uint8_t> data;
+};
+
+TEST_F(DataLogIndexTest, Build) {
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  wpi::log::DataLogIndex index{reader};
+  ASSERT_EQ(index.GetEntries().size(), 2u);
+  ASSERT_EQ(index.GetLogSize(), data.size());
+
+  auto a = index.Find("a");
+  ASSERT_TRUE(a);
+  EXPECT_EQ(a->type, "int64");
+  EXPECT_EQ(a->finishTimestamp, INT64_MAX);
+  ASSERT_EQ(a->records.size(), 101u);
+  EXPECT_EQ(a->records.front().timestamp, 5);
+
+  auto b = index.Find("b");
+  ASSERT_TRUE(b);
+  EXPECT_EQ(b->metadata, "meta");
+  EXPECT_EQ(b->finishTimestamp, 2000);
+  EXPECT_EQ(b->records.size(), 100u);
+
+  EXPECT_FALSE(index.Find("c"));
+}
+
+TEST_F(DataLogIndexTest, Seek) {
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  wpi::log::DataLogIndex index{reader};
+  auto b = index.Find("b");
+  ASSERT_TRUE(b);
+
+  auto records = wpi::log::DataLogIndex::GetRecords(*b, 100, 200);
+  ASSERT_EQ(records.size(), 10u);
+  wpi::log::DataLogRecord record;
+  double value;
+  ASSERT_TRUE(
+      wpi::log::DataLogIndex::ReadRecord(reader, records.front(), &record));
+  EXPECT_EQ(record.GetTimestamp(), 105);
+  ASSERT_TRUE(record.GetDouble(&value));
+  EXPECT_EQ(value, 5.0);
+
+  auto rec = wpi::log::DataLogIndex::FindAtOrBefore(*b, 104);
+  ASSERT_TRUE(rec);
+  EXPECT_EQ(rec->timestamp, 95);
+  EXPECT_FALSE(wpi::log::DataLogIndex::FindAtOrBefore(*b, 14));
+}
+
+TEST_F(DataLogIndexTest, SaveLoad) {
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  wpi::log::DataLogIndex index{reader};
+  std::vector<uint8_t> saved;
+  wpi::raw_uvector_ostream os{saved};
+  index.Save(os);
+
+  wpi::log::DataLogIndex loaded;
+  ASSERT_TRUE(loaded.Load(reader, saved));
+  ASSERT_EQ(loaded.GetEntries().size(), 2u);
+  auto a = loaded.Find("a");
+  ASSERT_TRUE(a);
+  ASSERT_EQ(a->records.size(), 101u);
+  EXPECT_EQ(a->records.back().pos, index.Find("a")->records.back().pos);
+
+  // truncated index
+  saved.pop_back();
+  EXPECT_FALSE(loaded.Load(reader, saved));
+  EXPECT_TRUE(loaded.GetEntries().empty());
+}
+
+TEST_F(DataLogIndexTest, Split) {
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  auto ranges = reader.Split(4);
+  ASSERT_EQ(ranges.size(), 4u);
+  EXPECT_EQ(ranges.front().first, reader.begin());
+  EXPECT_EQ(ranges.back().second, reader.end());
+  size_t count = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (i > 0) {
+      EXPECT_EQ(ranges[i - 1].second, ranges[i].first);
+    }
+    for (auto it = ranges[i].first; it != ranges[i].second; ++it) {
+      ++count;
+    }
+  }
+  // 2 start records, 201 integer/double records, 1 metadata, 1 finish
+  EXPECT_EQ(count, 205u);
+}
+
+TEST(DataLogIndexParallelTest, Build) {
+  std::vector<uint8_t> data;
+  {
+    wpi::Logger msglog;
+    wpi::log::DataLogWriter log{
+        msglog, std::make_unique<wpi::raw_uvector_ostream>(data)};
+    // restart entries so IDs are reused across ranges
+    for (int64_t gen = 0; gen < 10; ++gen) {
+      int a = log.Start("a", "int64", "", gen * 1000 + 1);
+      int b = log.Start(fmt::format("b{}", gen), "int64", "", gen * 1000 + 1);
+      for (int64_t i = 1; i <= 50; ++i) {
+        log.AppendInteger(a, i, gen * 1000 + i * 10);
+        log.AppendInteger(b, i, gen * 1000 + i * 10);
+      }
+      log.Finish(a, gen * 1000 + 999);
+      log.Finish(b, gen * 1000 + 999);
+    }
+    log.Flush();
+  }
+
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  wpi::log::DataLogIndex serial{reader, 1};
+  wpi::log::DataLogIndex parallel{reader, 7};
+  ASSERT_EQ(serial.GetEntries().size(), 20u);
+  ASSERT_EQ(parallel.GetEntries().size(), 20u);
+  for (size_t i = 0; i < serial.GetEntries().size(); ++i) {
+    auto& s = serial.GetEntries()[i];
+    auto& p = parallel.GetEntries()[i];
+    EXPECT_EQ(s.entry, p.entry);
+    EXPECT_EQ(s.name, p.name);
+    EXPECT_EQ(s.finishTimestamp, p.finishTimestamp);
+    ASSERT_EQ(s.records.size(), 50u);
+    ASSERT_EQ(p.records.size(), 50u);
+    for (size_t j = 0; j < s.records.size(); ++j) {
+      EXPECT_EQ(s.records[j].pos, p.records[j].pos);
+    }
+  }
+}
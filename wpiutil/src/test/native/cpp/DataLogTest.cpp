@@ -4,13 +4,20 @@
 
 #include <array>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#include <fmt/format.h>
 #include <gtest/gtest.h>
 
+#include "wpi/DataLogBackgroundWriter.h"
+#include "wpi/DataLogReader.h"
 #include "wpi/DataLogWriter.h"
 #include "wpi/Logger.h"
+#include "wpi/MemoryBuffer.h"
 #include "wpi/raw_ostream.h"
 
 namespace {
@@ -142,6 +149,201 @@ TEST_F(DataLogTest, SimpleInt) {
   ASSERT_EQ(data.size(), 54u);
 }
 
+TEST_F(DataLogTest, MultiThreadAppend) {
+  constexpr int kNumThreads = 10;
+  constexpr int64_t kNumRecords = 5000;
+  std::vector<int> entries;
+  for (int i = 0; i < kNumThreads; ++i) {
+    entries.push_back(log.Start(fmt::format("t{}", i), "int64", "", 1));
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, entry = entries[i]] {
+      for (int64_t j = 0; j < kNumRecords; ++j) {
+        log.AppendInteger(entry, j, j + 1);
+      }
+    });
+  }
+  for (auto&& thr : threads) {
+    thr.join();
+  }
+  log.Finish(entries[0], 1);
+  log.Flush();
+
+  // every record should be present, in order per entry, and before the finish
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  std::vector<int64_t> next(kNumThreads + 1, 0);
+  bool finished = false;
+  for (auto&& record : reader) {
+    if (record.IsFinish()) {
+      finished = true;
+    } else if (!record.IsControl()) {
+      ASSERT_FALSE(finished);
+      int64_t value;
+      ASSERT_TRUE(record.GetInteger(&value));
+      ASSERT_EQ(value, next[record.GetEntry()]++);
+    }
+  }
+  ASSERT_TRUE(finished);
+  for (int entry : entries) {
+    ASSERT_EQ(next[entry], kNumRecords);
+  }
+}
+
+TEST(DataLogBackgroundWriterTest, FlushFullShards) {
+  // moving the per-thread buffers to the outgoing queue when flushing must not
+  // deadlock when that makes the queue half full; each record fills most of a
+  // buffer, so one of these counts (around 32 buffers) hits the threshold
+  // while flushing
+  std::vector<uint8_t> value(10000);
+  for (size_t count = 24; count <= 40; ++count) {
+    size_t written = 0;
+    {
+      wpi::log::DataLogBackgroundWriter log{
+          [&](std::span<const uint8_t> data) { written += data.size(); }};
+      int entry = log.Start("raw", "raw");
+      for (size_t i = 0; i < count; ++i) {
+        log.AppendRaw(entry, value, 1);
+      }
+    }
+    ASSERT_GT(written, count * value.size());
+  }
+}
+
+TEST_F(DataLogTest, DeltaArrays) {
+  wpi::log::DeltaIntegerArrayLogEntry ints{log, "ints", 1};
+  wpi::log::DeltaDoubleArrayLogEntry doubles{log, "doubles", 1};
+  wpi::log::DoubleArrayLogEntry plain{log, "plain", 1};
+  auto intValue = [](int64_t i) {
+    return std::vector<int64_t>{i, -i, 1000000, i / 3 - 500};
+  };
+  auto doubleValue = [](int64_t i) {
+    return std::vector<double>{0.0, i * 0.25, 1.0 / 3 + i * 1e-9, -2.5};
+  };
+  for (int64_t i = 0; i < 200; ++i) {
+    // change the array size partway through
+    auto ivalue = intValue(i);
+    if (i >= 150) {
+      ivalue.push_back(i);
+    }
+    ints.Append(ivalue, i + 10);
+  }
+  log.Flush();
+  size_t start = data.size();
+  for (int64_t i = 0; i < 200; ++i) {
+    doubles.Append(doubleValue(i), i + 10);
+  }
+  log.Flush();
+  size_t deltaSize = data.size() - start;
+  start = data.size();
+  for (int64_t i = 0; i < 200; ++i) {
+    plain.Append(doubleValue(i), i + 10);
+  }
+  log.Flush();
+  size_t plainSize = data.size() - start;
+  EXPECT_LT(deltaSize * 2, plainSize);
+
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  std::vector<int64_t> iarr;
+  std::vector<double> darr;
+  int64_t icount = 0;
+  int64_t dcount = 0;
+  int keyframes = 0;
+  int intsEntry = 0;
+  int doublesEntry = 0;
+  for (auto&& record : reader) {
+    wpi::log::StartRecordData start;
+    if (record.GetStartData(&start)) {
+      if (start.name == "ints") {
+        EXPECT_EQ(start.type, "delta:int64[]");
+        intsEntry = start.entry;
+      } else if (start.name == "doubles") {
+        doublesEntry = start.entry;
+      }
+    } else if (record.GetEntry() == intsEntry) {
+      ASSERT_TRUE(record.GetDeltaIntegerArray(&iarr));
+      auto expected = intValue(icount);
+      if (icount >= 150) {
+        expected.push_back(icount);
+      }
+      ASSERT_EQ(iarr, expected);
+      ++icount;
+    } else if (record.GetEntry() == doublesEntry) {
+      if (record.IsDeltaKeyframe()) {
+        ++keyframes;
+      }
+      ASSERT_TRUE(record.GetDeltaDoubleArray(&darr));
+      ASSERT_EQ(darr, doubleValue(dcount));
+      ++dcount;
+    }
+  }
+  EXPECT_EQ(icount, 200);
+  EXPECT_EQ(dcount, 200);
+  EXPECT_GT(keyframes, 1);
+
+  // decoding a delta record without the previous value fails
+  for (auto&& record : reader) {
+    if (record.GetEntry() == doublesEntry && !record.IsDeltaKeyframe()) {
+      darr.clear();
+      EXPECT_FALSE(record.GetDeltaDoubleArray(&darr));
+      break;
+    }
+  }
+}
+
+TEST(DataLogCompressedTest, RoundTrip) {
+  std::vector<uint8_t> data;
+  {
+    wpi::Logger msglog;
+    wpi::log::DataLogBackgroundWriter log{
+        msglog,
+        [&](auto chunk) {
+          data.insert(data.end(), chunk.begin(), chunk.end());
+        },
+        0.25, "", true};
+    int entry = log.Start("a", "int64", "", 1);
+    for (int64_t i = 0; i < 20000; ++i) {
+      log.AppendInteger(entry, i % 100, i + 1);
+    }
+  }
+
+  // should be considerably smaller than the uncompressed size
+  ASSERT_GT(data.size(), 8u);
+  EXPECT_EQ((std::string_view{reinterpret_cast<const char*>(data.data()), 6}),
+            "WPILZ4");
+  EXPECT_LT(data.size(), 20000u * 6);
+
+  auto check = [](const wpi::log::DataLogReader& reader, int64_t minCount) {
+    ASSERT_TRUE(reader.IsValid());
+    int64_t count = 0;
+    for (auto&& record : reader) {
+      if (record.IsControl()) {
+        continue;
+      }
+      int64_t value;
+      ASSERT_TRUE(record.GetInteger(&value));
+      ASSERT_EQ(value, count % 100);
+      ++count;
+    }
+    ASSERT_GE(count, minCount);
+  };
+  check(wpi::log::DataLogReader{wpi::MemoryBuffer::GetMemBuffer(data)},
+        20000);
+
+  // truncated file still readable up to the damaged block
+  data.resize(data.size() - 10);
+  check(wpi::log::DataLogReader{wpi::MemoryBuffer::GetMemBuffer(data)}, 1);
+
+  // a block claiming a huge uncompressed size is treated as corrupt instead
+  // of being allocated
+  std::vector<uint8_t> corrupt(data.begin(), data.begin() + 8);
+  corrupt.insert(corrupt.end(),
+                 {4, 0, 0, 0, 0xff, 0xff, 0xff, 0xff, 1, 2, 3, 4});
+  EXPECT_FALSE(
+      wpi::log::DataLogReader{wpi::MemoryBuffer::GetMemBuffer(corrupt)}
+          .IsValid());
+}
+
 TEST_F(DataLogTest, BooleanAppend) {
   wpi::log::BooleanLogEntry entry{log, "a", 5};
   entry.Append(false, 7);
@@ -516,6 +718,56 @@ TEST_F(DataLogTest, StructA) {
   entry.Append(ThingA{}, 7);
 }
 
+TEST_F(DataLogTest, StructAppendContents) {
+  wpi::log::StructLogEntry<ThingA> entry{log, "a", 5};
+  entry.Append(ThingA{.x = 42}, 7);
+  log.Flush();
+
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  int count = 0;
+  for (auto&& record : reader) {
+    // skip the schema record
+    if (record.IsControl() || record.GetTimestamp() != 7) {
+      continue;
+    }
+    ASSERT_EQ(record.GetSize(), 1u);
+    EXPECT_EQ(record.GetRaw()[0], 42);
+    ++count;
+  }
+  EXPECT_EQ(count, 1);
+}
+
+TEST_F(DataLogTest, AppendRawInPlace) {
+  int entry = log.Start("a", "raw", "", 1);
+  // small (written in place) and larger than a buffer block (copied)
+  for (size_t size : {5u, 100000u}) {
+    log.AppendRawInPlace(
+        entry, size,
+        [&](std::span<uint8_t> buf) {
+          ASSERT_EQ(buf.size(), size);
+          for (size_t i = 0; i < buf.size(); ++i) {
+            buf[i] = i & 0xff;
+          }
+        },
+        2);
+  }
+  log.Flush();
+
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  std::vector<size_t> sizes;
+  for (auto&& record : reader) {
+    if (record.IsControl()) {
+      continue;
+    }
+    auto raw = record.GetRaw();
+    for (size_t i = 0; i < raw.size(); ++i) {
+      ASSERT_EQ(raw[i], i & 0xff);
+    }
+    sizes.push_back(raw.size());
+  }
+  EXPECT_EQ(sizes, (std::vector<size_t>{5u, 100000u}));
+}
+
 TEST_F(DataLogTest, StructUpdate) {
   wpi::log::StructLogEntry<ThingA> entry{log, "a", 5};
   ASSERT_FALSE(entry.GetLastValue().has_value());
@@ -0,0 +1,71 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "wpi/SpscQueue.h"
+
+TEST(SpscQueueTest, Basic) {
+  wpi::SpscQueue<int> q;
+  EXPECT_TRUE(q.empty());
+  q.enqueue(25);
+  EXPECT_FALSE(q.empty());
+
+  int item;
+  ASSERT_TRUE(q.try_dequeue(item));
+  EXPECT_EQ(item, 25);
+  EXPECT_TRUE(q.empty());
+  EXPECT_FALSE(q.try_dequeue(item));
+}
+
+TEST(SpscQueueTest, CrossBlocks) {
+  wpi::SpscQueue<int, 4> q;
+  for (int i = 0; i < 10; ++i) {
+    q.enqueue(i);
+  }
+  int item;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(q.try_dequeue(item));
+    EXPECT_EQ(item, i);
+  }
+  EXPECT_TRUE(q.empty());
+  EXPECT_FALSE(q.try_dequeue(item));
+}
+
+TEST(SpscQueueTest, DestroyNonEmpty) {
+  auto ptr = std::make_shared<int>(5);
+  {
+    wpi::SpscQueue<std::shared_ptr<int>, 2> q;
+    for (int i = 0; i < 5; ++i) {
+      q.enqueue(ptr);
+    }
+    std::shared_ptr<int> item;
+    ASSERT_TRUE(q.try_dequeue(item));
+    EXPECT_EQ(ptr.use_count(), 6);
+  }
+  EXPECT_EQ(ptr.use_count(), 1);
+}
+
+TEST(SpscQueueTest, Threaded) {
+  static constexpr int kCount = 100000;
+  wpi::SpscQueue<int, 16> q;
+  std::thread producer{[&] {
+    for (int i = 0; i < kCount; ++i) {
+      q.emplace(i);
+    }
+  }};
+  int expected = 0;
+  int item;
+  while (expected < kCount) {
+    if (q.try_dequeue(item)) {
+      EXPECT_EQ(item, expected);
+      ++expected;
+    }
+  }
+  producer.join();
+  EXPECT_TRUE(q.empty());
+}
@@ -0,0 +1,100 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "wpi/lz4.h"
+
+namespace {
+
+std::vector<uint8_t> RoundTrip(const std::vector<uint8_t>& in) {
+  std::vector<uint8_t> compressed(wpi::Lz4CompressBound(in.size()));
+  size_t size = wpi::Lz4Compress(in, compressed);
+  EXPECT_NE(size, 0u);
+  compressed.resize(size);
+  std::vector<uint8_t> out(in.size());
+  auto outSize = wpi::Lz4Decompress(compressed, out);
+  EXPECT_TRUE(outSize);
+  EXPECT_EQ(outSize.value_or(0), in.size());
+  return out;
+}
+
+}  // namespace
+
+TEST(Lz4Test, Empty) {
+  std::vector<uint8_t> in;
+  EXPECT_EQ(RoundTrip(in), in);
+}
+
+TEST(Lz4Test, Short) {
+  std::vector<uint8_t> in{1, 2, 3, 4, 1, 2, 3, 4, 1, 2};
+  EXPECT_EQ(RoundTrip(in), in);
+}
+
+TEST(Lz4Test, Repetitive) {
+  std::vector<uint8_t> in;
+  for (int i = 0; i < 100000; ++i) {
+    in.push_back(i % 7);
+  }
+  std::vector<uint8_t> compressed(wpi::Lz4CompressBound(in.size()));
+  EXPECT_LT(wpi::Lz4Compress(in, compressed), in.size() / 50);
+  EXPECT_EQ(RoundTrip(in), in);
+}
+
+TEST(Lz4Test, Random) {
+  std::mt19937 rng{1234};
+  std::vector<uint8_t> in;
+  for (int i = 0; i < 70000; ++i) {
+    // mix of random and repeated runs, with matches beyond the max offset
+    in.push_back((i / 1000) % 2 == 0 ? rng() : i % 13);
+  }
+  EXPECT_EQ(RoundTrip(in), in);
+}
+
+TEST(Lz4Test, OutputTooSmall) {
+  std::vector<uint8_t> in(1000, 5);
+  std::vector<uint8_t> compressed(4);
+  EXPECT_EQ(wpi::Lz4Compress(in, compressed), 0u);
+
+  compressed.resize(wpi::Lz4CompressBound(in.size()));
+  compressed.resize(wpi::Lz4Compress(in, compressed));
+  std::vector<uint8_t> out(999);
+  EXPECT_FALSE(wpi::Lz4Decompress(compressed, out));
+}
+
+TEST(Lz4Test, Malformed) {
+  std::vector<uint8_t> out(100);
+  // match offset beyond start of output
+  std::vector<uint8_t> bad{0x10, 'a', 0x05, 0x00};
+  EXPECT_FALSE(wpi::Lz4Decompress(bad, out));
+  // zero offset
+  bad = {0x10, 'a', 0x00, 0x00};
+  EXPECT_FALSE(wpi::Lz4Decompress(bad, out));
+  // literal length beyond input
+  bad = {0xf0, 0x10, 'a'};
+  EXPECT_FALSE(wpi::Lz4Decompress(bad, out));
+  // truncated offset
+  bad = {0x10, 'a', 0x01};
+  EXPECT_FALSE(wpi::Lz4Decompress(bad, out));
+  // empty
+  EXPECT_FALSE(wpi::Lz4Decompress({}, out));
+}
+
+TEST(Lz4Test, Overlap) {
+  // 'a' followed by a match of length 10 at offset 1
+  std::vector<uint8_t> in{0x16, 'a', 0x01, 0x00, 0x50, 'b', 'b', 'b', 'b', 'b'};
+  std::vector<uint8_t> out(16);
+  auto size = wpi::Lz4Decompress(in, out);
+  ASSERT_TRUE(size);
+  ASSERT_EQ(*size, 16u);
+  for (int i = 0; i < 11; ++i) {
+    EXPECT_EQ(out[i], 'a');
+  }
+  EXPECT_EQ(out[11], 'b');
+}